@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <malloc.h>
+
+namespace Library
+{
+	template <typename T, std::size_t Alignment = 16>
+	class AlignedAllocator
+	{
+	public:
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind
+		{
+			typedef AlignedAllocator<U, Alignment> other;
+		};
+
+		AlignedAllocator() = default;
+
+		template <typename U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>&) { }
+
+		T* allocate(std::size_t count)
+		{
+			void* memory = _mm_malloc(count * sizeof(T), Alignment);
+			if (memory == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+
+			return static_cast<T*>(memory);
+		}
+
+		void deallocate(T* pointer, std::size_t)
+		{
+			_mm_free(pointer);
+		}
+
+		template <typename U>
+		bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+
+		template <typename U>
+		bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+	};
+
+	template <typename T, std::size_t Alignment = 32>
+	using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace Library
+{
+	// A read-only view of contiguous elements that lives elsewhere, in a vector or a mapped file; it never owns them
+	template <typename T>
+	class ArraySpan final
+	{
+	public:
+		ArraySpan() :
+			mData(nullptr), mSize(0)
+		{
+		}
+
+		ArraySpan(const T* data, std::uint32_t size) :
+			mData(data), mSize(size)
+		{
+			assert(data != nullptr || size == 0);
+		}
+
+		ArraySpan(const std::vector<T>& elements) :
+			mData(elements.data()), mSize(static_cast<std::uint32_t>(elements.size()))
+		{
+		}
+
+		const T* Data() const
+		{
+			return mData;
+		}
+
+		std::uint32_t Size() const
+		{
+			return mSize;
+		}
+
+		bool IsEmpty() const
+		{
+			return (mSize == 0);
+		}
+
+		const T& operator[](std::uint32_t index) const
+		{
+			assert(index < mSize);
+			return mData[index];
+		}
+
+		const T* begin() const
+		{
+			return mData;
+		}
+
+		const T* end() const
+		{
+			return mData + mSize;
+		}
+
+	private:
+		const T* mData;
+		std::uint32_t mSize;
+	};
+}
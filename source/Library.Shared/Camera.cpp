@@ -98,6 +98,13 @@ namespace Library
 		mPosition = position;
 	}
 
+	void Camera::SetOrientation(const XMFLOAT3& direction, const XMFLOAT3& up, const XMFLOAT3& right)
+	{
+		mDirection = direction;
+		mUp = up;
+		mRight = right;
+	}
+
 	void Camera::Reset()
 	{
 		mPosition = Vector3Helper::Zero;
@@ -39,6 +39,7 @@ namespace Library
 		virtual void SetPosition(float x, float y, float z);
 		virtual void SetPosition(DirectX::FXMVECTOR position);
 		virtual void SetPosition(const DirectX::XMFLOAT3& position);
+		virtual void SetOrientation(const DirectX::XMFLOAT3& direction, const DirectX::XMFLOAT3& up, const DirectX::XMFLOAT3& right);
 
 		virtual void Reset();
 		virtual void Initialize() override;
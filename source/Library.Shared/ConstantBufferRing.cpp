@@ -0,0 +1,66 @@
+#include "pch.h"
+#include "ConstantBufferRing.h"
+
+using namespace std;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(ConstantBufferRing)
+
+	const uint32_t ConstantBufferRing::DefaultCapacity = 1024 * 1024;
+
+	ConstantBufferRing::ConstantBufferRing(uint32_t capacity) :
+		mAllocator(capacity)
+	{
+	}
+
+	void ConstantBufferRing::Initialize(ID3D11Device* device)
+	{
+		assert(device != nullptr);
+
+		// Binding part of a constant buffer, and mapping one without overwrite, need Direct3D 11.1 driver support; without it
+		// the ring stays unavailable and its users fall back to their own buffers
+		mBuffer.Reset();
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+		if (FAILED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) || !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer)
+		{
+			return;
+		}
+
+		D3D11_BUFFER_DESC bufferDesc = { 0 };
+		bufferDesc.ByteWidth = mAllocator.Capacity();
+		bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		ThrowIfFailed(device->CreateBuffer(&bufferDesc, nullptr, mBuffer.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+
+		mAllocator.Reset();
+	}
+
+	bool ConstantBufferRing::IsAvailable() const
+	{
+		return (mBuffer != nullptr);
+	}
+
+	ConstantBufferAllocation ConstantBufferRing::Upload(ID3D11DeviceContext* deviceContext, const void* data, uint32_t size)
+	{
+		assert(IsAvailable());
+		assert(deviceContext != nullptr && data != nullptr);
+
+		// Blocks since the last discard are never written twice, so mapping without overwrite does not wait on the GPU
+		const RingAllocation allocation = mAllocator.Allocate(size);
+		D3D11_MAPPED_SUBRESOURCE mappedBuffer;
+		ThrowIfFailed(deviceContext->Map(mBuffer.Get(), 0, (allocation.Discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE), 0, &mappedBuffer), "ID3D11DeviceContext::Map() failed.");
+		memcpy(static_cast<char*>(mappedBuffer.pData) + allocation.Offset, data, size);
+		deviceContext->Unmap(mBuffer.Get(), 0);
+
+		// Offsets and sizes are counted in 16-byte constants
+		const ConstantBufferAllocation constants = { mBuffer.Get(), allocation.Offset / 16, allocation.Size / 16 };
+		return constants;
+	}
+
+	const ConstantRingAllocator& ConstantBufferRing::Allocator() const
+	{
+		return mAllocator;
+	}
+}
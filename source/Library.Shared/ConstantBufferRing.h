@@ -0,0 +1,43 @@
+#pragma once
+
+#include "RTTI.h"
+#include "ConstantRingAllocator.h"
+#include <wrl.h>
+#include <d3d11_2.h>
+#include <cstdint>
+
+namespace Library
+{
+	struct ConstantBufferAllocation
+	{
+		ID3D11Buffer* Buffer;
+		UINT FirstConstant;
+		UINT ConstantCount;
+	};
+
+	class ConstantBufferRing final : public RTTI
+	{
+		RTTI_DECLARATIONS(ConstantBufferRing, RTTI)
+
+	public:
+		static const std::uint32_t DefaultCapacity;
+
+		explicit ConstantBufferRing(std::uint32_t capacity = DefaultCapacity);
+		ConstantBufferRing(const ConstantBufferRing&) = delete;
+		ConstantBufferRing& operator=(const ConstantBufferRing&) = delete;
+		ConstantBufferRing(ConstantBufferRing&&) = delete;
+		ConstantBufferRing& operator=(ConstantBufferRing&&) = delete;
+		~ConstantBufferRing() = default;
+
+		void Initialize(ID3D11Device* device);
+		bool IsAvailable() const;
+
+		ConstantBufferAllocation Upload(ID3D11DeviceContext* deviceContext, const void* data, std::uint32_t size);
+
+		const ConstantRingAllocator& Allocator() const;
+
+	private:
+		ConstantRingAllocator mAllocator;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mBuffer;
+	};
+}
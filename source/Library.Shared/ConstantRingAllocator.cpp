@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "ConstantRingAllocator.h"
+
+using namespace std;
+
+namespace Library
+{
+	const uint32_t ConstantRingAllocator::Alignment;
+
+	ConstantRingAllocator::ConstantRingAllocator(uint32_t capacity) :
+		mCapacity(capacity - capacity % Alignment), mHead(0), mAllocationCount(0), mDiscardCount(0), mDiscardPending(true)
+	{
+		if (mCapacity == 0)
+		{
+			throw GameException("A constant ring must hold at least one aligned block.");
+		}
+	}
+
+	RingAllocation ConstantRingAllocator::Allocate(uint32_t size)
+	{
+		const uint32_t alignedSize = AlignedSize(size);
+		if (alignedSize == 0 || alignedSize > mCapacity)
+		{
+			throw GameException("Constant ring allocation is empty or larger than the ring.");
+		}
+
+		// Running off the end starts the ring over. The buffer is discarded rather than waited on, so the driver hands back
+		// fresh memory and whatever the GPU is still reading stays intact; until then every block is written once, which is
+		// what lets the others be mapped without overwriting.
+		if (mHead + alignedSize > mCapacity)
+		{
+			mHead = 0;
+			mDiscardPending = true;
+		}
+
+		const RingAllocation allocation = { mHead, alignedSize, mDiscardPending };
+		if (mDiscardPending)
+		{
+			++mDiscardCount;
+			mDiscardPending = false;
+		}
+
+		mHead += alignedSize;
+		++mAllocationCount;
+
+		return allocation;
+	}
+
+	void ConstantRingAllocator::Reset()
+	{
+		mHead = 0;
+		mAllocationCount = 0;
+		mDiscardCount = 0;
+		mDiscardPending = true;
+	}
+
+	uint32_t ConstantRingAllocator::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	uint32_t ConstantRingAllocator::Head() const
+	{
+		return mHead;
+	}
+
+	uint32_t ConstantRingAllocator::AllocationCount() const
+	{
+		return mAllocationCount;
+	}
+
+	uint32_t ConstantRingAllocator::DiscardCount() const
+	{
+		return mDiscardCount;
+	}
+
+	uint32_t ConstantRingAllocator::AlignedSize(uint32_t size)
+	{
+		// Constant buffer offsets are bound in units of 16 constants, so every block starts and ends on 256 bytes
+		return (size + Alignment - 1) & ~(Alignment - 1);
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Library
+{
+	struct RingAllocation
+	{
+		std::uint32_t Offset;
+		std::uint32_t Size;
+		bool Discard;
+	};
+
+	class ConstantRingAllocator final
+	{
+	public:
+		static const std::uint32_t Alignment = 256;
+
+		explicit ConstantRingAllocator(std::uint32_t capacity);
+		ConstantRingAllocator(const ConstantRingAllocator&) = delete;
+		ConstantRingAllocator& operator=(const ConstantRingAllocator&) = delete;
+		ConstantRingAllocator(ConstantRingAllocator&&) = delete;
+		ConstantRingAllocator& operator=(ConstantRingAllocator&&) = delete;
+		~ConstantRingAllocator() = default;
+
+		RingAllocation Allocate(std::uint32_t size);
+		void Reset();
+
+		std::uint32_t Capacity() const;
+		std::uint32_t Head() const;
+		std::uint32_t AllocationCount() const;
+		std::uint32_t DiscardCount() const;
+
+		static std::uint32_t AlignedSize(std::uint32_t size);
+
+	private:
+		std::uint32_t mCapacity;
+		std::uint32_t mHead;
+		std::uint32_t mAllocationCount;
+		std::uint32_t mDiscardCount;
+		bool mDiscardPending;
+	};
+}
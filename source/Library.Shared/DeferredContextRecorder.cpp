@@ -0,0 +1,89 @@
+#include "pch.h"
+#include "DeferredContextRecorder.h"
+
+using namespace std;
+using namespace Microsoft::WRL;
+
+namespace Library
+{
+	DeferredContextRecorder::DeferredContextRecorder(Game& game, uint32_t contextCount) :
+		mGame(&game), mContextCount(contextCount)
+	{
+		if (contextCount == 0)
+		{
+			throw GameException("A deferred context recorder needs at least one context.");
+		}
+	}
+
+	void DeferredContextRecorder::Initialize()
+	{
+		ID3D11Device2* direct3DDevice = mGame->Direct3DDevice();
+		assert(direct3DDevice != nullptr);
+
+		// Contexts belong to the device they came from, so they are created again whenever the device is
+		mDeferredContexts.clear();
+		mCommandLists.clear();
+		mDeferredContexts.resize(mContextCount);
+		for (ComPtr<ID3D11DeviceContext1>& deferredContext : mDeferredContexts)
+		{
+			ThrowIfFailed(direct3DDevice->CreateDeferredContext1(0, deferredContext.ReleaseAndGetAddressOf()), "ID3D11Device1::CreateDeferredContext1() failed.");
+		}
+	}
+
+	void DeferredContextRecorder::AddPass(const PassFunction& pass)
+	{
+		assert(pass != nullptr);
+
+		// Every pass gets its own command list slot up front, so recording threads never resize or share the vector's elements
+		mPasses.push_back(pass);
+		mCommandLists.emplace_back();
+	}
+
+	void DeferredContextRecorder::Clear()
+	{
+		mPasses.clear();
+		mCommandLists.clear();
+	}
+
+	uint32_t DeferredContextRecorder::PassCount() const
+	{
+		return static_cast<uint32_t>(mPasses.size());
+	}
+
+	ID3D11DeviceContext1* DeferredContextRecorder::DeferredContext(uint32_t context) const
+	{
+		assert(context < mDeferredContexts.size());
+
+		return mDeferredContexts[context].Get();
+	}
+
+	uint32_t DeferredContextRecorder::ContextCount() const
+	{
+		return static_cast<uint32_t>(mDeferredContexts.size());
+	}
+
+	void DeferredContextRecorder::RecordPass(uint32_t pass, uint32_t context)
+	{
+		assert(pass < mPasses.size());
+		assert(context < mDeferredContexts.size());
+
+		// A command list starts from the default state, render targets included, so each pass binds the game's targets first
+		ID3D11DeviceContext1* deferredContext = mDeferredContexts[context].Get();
+		ID3D11RenderTargetView* renderTargetView = mGame->RenderTargetView();
+		deferredContext->OMSetRenderTargets(1, &renderTargetView, mGame->DepthStencilView());
+		deferredContext->RSSetViewports(1, &mGame->Viewport());
+
+		mPasses[pass](deferredContext);
+
+		ThrowIfFailed(deferredContext->FinishCommandList(FALSE, mCommandLists[pass].ReleaseAndGetAddressOf()), "ID3D11DeviceContext::FinishCommandList() failed.");
+	}
+
+	void DeferredContextRecorder::ExecutePass(uint32_t pass)
+	{
+		assert(pass < mCommandLists.size() && mCommandLists[pass] != nullptr);
+
+		// The immediate context's own state is restored afterwards, so whatever draws next on it is unaffected
+		mGame->Direct3DDeviceContext()->ExecuteCommandList(mCommandLists[pass].Get(), TRUE);
+		mCommandLists[pass].Reset();
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ICommandRecorder.h"
+#include <wrl.h>
+#include <d3d11_2.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Library
+{
+	class Game;
+
+	class DeferredContextRecorder final : public ICommandRecorder
+	{
+	public:
+		typedef std::function<void(ID3D11DeviceContext1* deviceContext)> PassFunction;
+
+		DeferredContextRecorder(Game& game, std::uint32_t contextCount);
+		DeferredContextRecorder() = delete;
+		DeferredContextRecorder(const DeferredContextRecorder&) = delete;
+		DeferredContextRecorder& operator=(const DeferredContextRecorder&) = delete;
+		DeferredContextRecorder(DeferredContextRecorder&&) = delete;
+		DeferredContextRecorder& operator=(DeferredContextRecorder&&) = delete;
+		~DeferredContextRecorder() = default;
+
+		void Initialize();
+
+		void AddPass(const PassFunction& pass);
+		void Clear();
+		std::uint32_t PassCount() const;
+		ID3D11DeviceContext1* DeferredContext(std::uint32_t context) const;
+
+		virtual std::uint32_t ContextCount() const override;
+		virtual void RecordPass(std::uint32_t pass, std::uint32_t context) override;
+		virtual void ExecutePass(std::uint32_t pass) override;
+
+	private:
+		Game* mGame;
+		std::uint32_t mContextCount;
+		std::vector<Microsoft::WRL::ComPtr<ID3D11DeviceContext1>> mDeferredContexts;
+		std::vector<PassFunction> mPasses;
+		std::vector<Microsoft::WRL::ComPtr<ID3D11CommandList>> mCommandLists;
+	};
+}
@@ -45,4 +45,15 @@ namespace Library
 	{
 		UNREFERENCED_PARAMETER(gameTime);
 	}
+
+	bool DrawableGameComponent::CanRecordDeferred() const
+	{
+		return false;
+	}
+
+	void DrawableGameComponent::Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext)
+	{
+		UNREFERENCED_PARAMETER(gameTime);
+		UNREFERENCED_PARAMETER(deviceContext);
+	}
 }
\ No newline at end of file
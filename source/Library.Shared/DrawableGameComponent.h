@@ -3,6 +3,8 @@
 #include "GameComponent.h"
 #include <memory>
 
+struct ID3D11DeviceContext1;
+
 namespace Library
 {
     class Camera;
@@ -29,6 +31,11 @@ namespace Library
 
         virtual void Draw(const GameTime& gameTime);
 
+		// Components that only touch the context they are handed, and none of the game's shared per-frame state, can be
+		// recorded into a deferred context on a worker thread instead of drawing on the immediate context
+		virtual bool CanRecordDeferred() const;
+		virtual void Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext);
+
     protected:
         bool mVisible;
 		std::shared_ptr<Camera> mCamera;
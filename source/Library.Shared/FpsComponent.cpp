@@ -37,12 +37,13 @@ namespace Library
 			mFrameRate = mFrameCount;
 			mFrameCount = 0;
 		}
-
-		++mFrameCount;
 	}
 
 	void FpsComponent::Draw(const GameTime& gameTime)
 	{
+		// Counted when drawn, since a fixed time step can update more or less often than once per frame
+		++mFrameCount;
+
 		mSpriteBatch->Begin();
 
 		wostringstream fpsLabel;
@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "Frustum.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace Library
+{
+	const uint32_t Frustum::PlaneCount;
+
+	Frustum::Frustum()
+	{
+		// Zero planes accept everything until a matrix is set
+		for (XMFLOAT4& plane : mPlanes)
+		{
+			plane = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+		}
+	}
+
+	Frustum::Frustum(CXMMATRIX viewProjection)
+	{
+		SetMatrix(viewProjection);
+	}
+
+	void Frustum::SetMatrix(CXMMATRIX viewProjection)
+	{
+		// Points are row vectors, so clip = (x, y, z, 1) * M and each clip coordinate is a dot product with a column of M.
+		// A point is inside when -w <= x <= w, -w <= y <= w and 0 <= z <= w; each inequality is one plane, with the
+		// normal pointing inwards. Normalizing makes a plane's distance a true distance, for comparing against radii.
+		const XMMATRIX columns = XMMatrixTranspose(viewProjection);
+
+		XMStoreFloat4(&mPlanes[static_cast<uint32_t>(FrustumPlane::Left)], XMPlaneNormalize(XMVectorAdd(columns.r[3], columns.r[0])));
+		XMStoreFloat4(&mPlanes[static_cast<uint32_t>(FrustumPlane::Right)], XMPlaneNormalize(XMVectorSubtract(columns.r[3], columns.r[0])));
+		XMStoreFloat4(&mPlanes[static_cast<uint32_t>(FrustumPlane::Bottom)], XMPlaneNormalize(XMVectorAdd(columns.r[3], columns.r[1])));
+		XMStoreFloat4(&mPlanes[static_cast<uint32_t>(FrustumPlane::Top)], XMPlaneNormalize(XMVectorSubtract(columns.r[3], columns.r[1])));
+		XMStoreFloat4(&mPlanes[static_cast<uint32_t>(FrustumPlane::Near)], XMPlaneNormalize(columns.r[2]));
+		XMStoreFloat4(&mPlanes[static_cast<uint32_t>(FrustumPlane::Far)], XMPlaneNormalize(XMVectorSubtract(columns.r[3], columns.r[2])));
+	}
+
+	const XMFLOAT4& Frustum::Plane(FrustumPlane plane) const
+	{
+		return mPlanes[static_cast<uint32_t>(plane)];
+	}
+
+	const XMFLOAT4* Frustum::Planes() const
+	{
+		return mPlanes;
+	}
+
+	bool Frustum::Intersects(FXMVECTOR center, float radius) const
+	{
+		for (const XMFLOAT4& plane : mPlanes)
+		{
+			if (XMVectorGetX(XMPlaneDotCoord(XMLoadFloat4(&plane), center)) < -radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
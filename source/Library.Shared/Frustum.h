@@ -0,0 +1,36 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace Library
+{
+	enum class FrustumPlane : std::uint32_t
+	{
+		Left = 0,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far
+	};
+
+	class Frustum final
+	{
+	public:
+		static const std::uint32_t PlaneCount = 6;
+
+		Frustum();
+		explicit Frustum(DirectX::CXMMATRIX viewProjection);
+
+		void SetMatrix(DirectX::CXMMATRIX viewProjection);
+
+		const DirectX::XMFLOAT4& Plane(FrustumPlane plane) const;
+		const DirectX::XMFLOAT4* Planes() const;
+
+		bool Intersects(DirectX::FXMVECTOR center, float radius) const;
+
+	private:
+		DirectX::XMFLOAT4 mPlanes[PlaneCount];
+	};
+}
@@ -26,6 +26,16 @@ namespace Library
 		CreateDeviceResources();
 	}
 
+	Game::Game() :
+		RenderTarget(),
+		mFeatureLevel(D3D_FEATURE_LEVEL_9_1), mFrameRate(DefaultFrameRate), mIsFullScreen(false),
+		mMultiSamplingCount(DefaultMultiSamplingCount), mMultiSamplingQualityLevels(0),
+		mRenderTargetSize(), mDeviceNotify(nullptr)
+	{
+		// No window and no device; only the component update loop is usable
+		CreateDeviceIndependentResources();
+	}
+
 	ID3D11Device2* Game::Direct3DDevice() const
 	{
 		return mDirect3DDevice.Get();
@@ -96,6 +106,43 @@ namespace Library
 		return mServices;
 	}
 
+	JobSystem& Game::Jobs()
+	{
+		return mJobSystem;
+	}
+
+	GameClock& Game::Clock()
+	{
+		return mGameClock;
+	}
+
+	bool Game::DeferredRecordingEnabled() const
+	{
+		return (mDeferredContextRecorder != nullptr);
+	}
+
+	const DeferredContextRecorder* Game::DeferredRecorder() const
+	{
+		return mDeferredContextRecorder.get();
+	}
+
+	void Game::EnableDeferredRecording(uint32_t contextCount)
+	{
+		if (mDirect3DDevice == nullptr)
+		{
+			throw GameException("Deferred recording needs a Direct3D device.");
+		}
+
+		// One context per thread that can record at once is enough; more would only sit idle
+		mDeferredContextRecorder = make_unique<DeferredContextRecorder>(*this, (contextCount > 0 ? contextCount : mJobSystem.ThreadCount()));
+		mDeferredContextRecorder->Initialize();
+	}
+
+	void Game::DisableDeferredRecording()
+	{
+		mDeferredContextRecorder.reset();
+	}
+
 	void Game::Initialize()
 	{
 		mGameClock.Reset();
@@ -109,19 +156,37 @@ namespace Library
 	void Game::Run()
 	{
 		mGameClock.UpdateGameTime(mGameTime);
-		Update(mGameTime);
+
+		if (mGameClock.FixedTimeStepEnabled())
+		{
+			// As many fixed steps as real time allows, possibly none; drawing interpolates between the last two of them
+			while (mGameClock.StepFixedGameTime(mGameTime))
+			{
+				Update(mGameTime);
+			}
+		}
+		else
+		{
+			Update(mGameTime);
+		}
+
 		Draw(mGameTime);
 	}
 
 	void Game::Shutdown()
 	{
 		// Free up all D3D resources.
-		mDirect3DDeviceContext->ClearState();
-		mDirect3DDeviceContext->Flush();
+		if (mDirect3DDeviceContext != nullptr)
+		{
+			mDirect3DDeviceContext->ClearState();
+			mDirect3DDeviceContext->Flush();
+		}
 		
 		mComponents.clear();
 		mComponents.shrink_to_fit();
 
+		mDeferredContextRecorder.reset();
+
 		mDepthStencilView = nullptr;
 		mRenderTargetView = nullptr;
 		mSwapChain = nullptr;
@@ -147,9 +212,34 @@ namespace Library
 			DrawableGameComponent* drawableGameComponent = component->As<DrawableGameComponent>();
 			if (drawableGameComponent != nullptr && drawableGameComponent->Visible())
 			{
-				drawableGameComponent->Draw(gameTime);
+				if (mDeferredContextRecorder != nullptr && drawableGameComponent->CanRecordDeferred())
+				{
+					mDeferredContextRecorder->AddPass([drawableGameComponent, &gameTime](ID3D11DeviceContext1* deviceContext)
+					{
+						drawableGameComponent->Record(gameTime, deviceContext);
+					});
+				}
+				else
+				{
+					// Whatever was recorded before this component reaches the screen first, so the draw order is unchanged
+					FlushDeferredRecording();
+					drawableGameComponent->Draw(gameTime);
+				}
 			}
 		}
+
+		FlushDeferredRecording();
+	}
+
+	void Game::FlushDeferredRecording()
+	{
+		if (mDeferredContextRecorder == nullptr || mDeferredContextRecorder->PassCount() == 0)
+		{
+			return;
+		}
+
+		RecordingScheduler::Run(mJobSystem, *mDeferredContextRecorder, mDeferredContextRecorder->PassCount());
+		mDeferredContextRecorder->Clear();
 	}
 
 	void Game::UpdateRenderTargetSize()
@@ -383,6 +473,11 @@ namespace Library
 		CreateDeviceResources();
 		CreateWindowSizeDependentResources();
 
+		if (mDeferredContextRecorder != nullptr)
+		{
+			mDeferredContextRecorder->Initialize();
+		}
+
 		if (mDeviceNotify != nullptr)
 		{
 			mDeviceNotify->OnDeviceRestored();
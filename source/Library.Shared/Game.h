@@ -17,6 +17,8 @@
 #include "GameTime.h"
 #include "ServiceContainer.h"
 #include "RenderTarget.h"
+#include "JobSystem.h"
+#include "DeferredContextRecorder.h"
 
 namespace Library
 {
@@ -61,6 +63,13 @@ namespace Library
 
 		const std::vector<std::shared_ptr<GameComponent>>& Components() const;
 		const ServiceContainer& Services() const;			
+		JobSystem& Jobs();
+		GameClock& Clock();
+
+		bool DeferredRecordingEnabled() const;
+		const DeferredContextRecorder* DeferredRecorder() const;
+		void EnableDeferredRecording(std::uint32_t contextCount = 0);
+		void DisableDeferredRecording();
 
         virtual void Initialize();
 		virtual void Run();
@@ -72,9 +81,12 @@ namespace Library
 		std::function<void*()> GetWindowCallback() const;
 
     protected:
+		Game();
+
 		virtual void Update(const GameTime& gameTime);
 		virtual void Draw(const GameTime& gameTime);
 		virtual void HandleDeviceLost();
+		void FlushDeferredRecording();
 
 		virtual void Begin() override;
 		virtual void End() override;
@@ -111,5 +123,7 @@ namespace Library
         GameTime mGameTime;
 		std::vector<std::shared_ptr<GameComponent>> mComponents;
 		ServiceContainer mServices;
+		JobSystem mJobSystem;
+		std::unique_ptr<DeferredContextRecorder> mDeferredContextRecorder;
     };
 }
\ No newline at end of file
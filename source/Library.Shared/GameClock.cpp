@@ -1,10 +1,16 @@
 #include "pch.h"
 
+using namespace std;
 using namespace std::chrono;
 
 namespace Library
 {
-	GameClock::GameClock()
+	// 1/120 s, two steps per frame at 60 Hz
+	const nanoseconds GameClock::DefaultFixedTimeStep = nanoseconds(8333333);
+	const uint32_t GameClock::DefaultMaxFixedSteps = 5;
+
+	GameClock::GameClock() :
+		mFixedTimeStep(DefaultFixedTimeStep), mMaxFixedSteps(DefaultMaxFixedSteps), mFixedTimeStepEnabled(false)
 	{
 		Reset();
 	}
@@ -24,20 +30,99 @@ namespace Library
 		return mLastTime;
 	}
 
+	bool GameClock::FixedTimeStepEnabled() const
+	{
+		return mFixedTimeStepEnabled;
+	}
+
+	void GameClock::SetFixedTimeStepEnabled(bool enabled)
+	{
+		// Fixed steps carry on from the time already shown, rather than from zero
+		mFixedTimeStepEnabled = enabled;
+		mAccumulatedTime = high_resolution_clock::duration::zero();
+		mFixedTotalGameTime = duration_cast<nanoseconds>(mLastTime - mStartTime);
+	}
+
+	const nanoseconds& GameClock::FixedTimeStep() const
+	{
+		return mFixedTimeStep;
+	}
+
+	void GameClock::SetFixedTimeStep(const nanoseconds& fixedTimeStep)
+	{
+		assert(fixedTimeStep.count() > 0);
+		mFixedTimeStep = fixedTimeStep;
+	}
+
+	uint32_t GameClock::MaxFixedSteps() const
+	{
+		return mMaxFixedSteps;
+	}
+
+	void GameClock::SetMaxFixedSteps(uint32_t maxFixedSteps)
+	{
+		assert(maxFixedSteps > 0);
+		mMaxFixedSteps = maxFixedSteps;
+	}
+
 	void GameClock::Reset()
 	{
-		mStartTime = high_resolution_clock::now();
+		Reset(high_resolution_clock::now());
+	}
+
+	void GameClock::Reset(const high_resolution_clock::time_point& startTime)
+	{
+		mStartTime = startTime;
 		mCurrentTime = mStartTime;
 		mLastTime = mCurrentTime;
+		mAccumulatedTime = high_resolution_clock::duration::zero();
+		mFixedTotalGameTime = nanoseconds::zero();
 	}
 
 	void GameClock::UpdateGameTime(GameTime& gameTime)
 	{
-		mCurrentTime = high_resolution_clock::now();
+		UpdateGameTime(gameTime, high_resolution_clock::now());
+	}
 
+	void GameClock::UpdateGameTime(GameTime& gameTime, const high_resolution_clock::time_point& currentTime)
+	{
+		// Counter values other than now, e.g. synthetic frame times, take exactly the same path as real ones
+		mCurrentTime = currentTime;
 		gameTime.SetCurrentTime(mCurrentTime);
-		gameTime.SetTotalGameTime(duration_cast<milliseconds>(mCurrentTime - mStartTime));
-		gameTime.SetElapsedGameTime(duration_cast<milliseconds>(mCurrentTime - mLastTime));
+
+		if (mFixedTimeStepEnabled)
+		{
+			// Catch up on at most MaxFixedSteps steps per frame. Time beyond that is dropped, so a long stall slows the
+			// simulation down for a moment instead of making every following frame spend even longer catching up.
+			const high_resolution_clock::duration maxAccumulatedTime = duration_cast<high_resolution_clock::duration>(mFixedTimeStep * mMaxFixedSteps);
+			mAccumulatedTime += mCurrentTime - mLastTime;
+			mAccumulatedTime = (mAccumulatedTime > maxAccumulatedTime ? maxAccumulatedTime : mAccumulatedTime);
+		}
+		else
+		{
+			gameTime.SetTotalGameTime(duration_cast<nanoseconds>(mCurrentTime - mStartTime));
+			gameTime.SetElapsedGameTime(duration_cast<nanoseconds>(mCurrentTime - mLastTime));
+			gameTime.SetInterpolation(1.0f);
+		}
+
 		mLastTime = mCurrentTime;
 	}
+
+	bool GameClock::StepFixedGameTime(GameTime& gameTime)
+	{
+		const high_resolution_clock::duration fixedTimeStep = duration_cast<high_resolution_clock::duration>(mFixedTimeStep);
+		if (!mFixedTimeStepEnabled || mAccumulatedTime < fixedTimeStep)
+		{
+			// Whatever is left over says how far the frame being drawn is between the last two steps
+			gameTime.SetInterpolation(mFixedTimeStepEnabled ? static_cast<float>(mAccumulatedTime.count()) / fixedTimeStep.count() : 1.0f);
+			return false;
+		}
+
+		mAccumulatedTime -= fixedTimeStep;
+		mFixedTotalGameTime += mFixedTimeStep;
+		gameTime.SetTotalGameTime(mFixedTotalGameTime);
+		gameTime.SetElapsedGameTime(mFixedTimeStep);
+
+		return true;
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <exception>
 #include <chrono>
+#include <cstdint>
 
 namespace Library
 {
@@ -10,6 +11,9 @@ namespace Library
 	class GameClock final
 	{
 	public:
+		static const std::chrono::nanoseconds DefaultFixedTimeStep;
+		static const std::uint32_t DefaultMaxFixedSteps;
+
 		GameClock();
 		GameClock(const GameClock&) = delete;
 		GameClock& operator=(const GameClock&) = delete;
@@ -21,12 +25,27 @@ namespace Library
 		const std::chrono::high_resolution_clock::time_point& CurrentTime() const;
 		const std::chrono::high_resolution_clock::time_point& LastTime() const;
 
+		bool FixedTimeStepEnabled() const;
+		void SetFixedTimeStepEnabled(bool enabled);
+		const std::chrono::nanoseconds& FixedTimeStep() const;
+		void SetFixedTimeStep(const std::chrono::nanoseconds& fixedTimeStep);
+		std::uint32_t MaxFixedSteps() const;
+		void SetMaxFixedSteps(std::uint32_t maxFixedSteps);
+
 		void Reset();
+		void Reset(const std::chrono::high_resolution_clock::time_point& startTime);
 		void UpdateGameTime(GameTime& gameTime);
+		void UpdateGameTime(GameTime& gameTime, const std::chrono::high_resolution_clock::time_point& currentTime);
+		bool StepFixedGameTime(GameTime& gameTime);
 
 	private:
 		std::chrono::high_resolution_clock::time_point mStartTime;
 		std::chrono::high_resolution_clock::time_point mCurrentTime;
 		std::chrono::high_resolution_clock::time_point mLastTime;
+		std::chrono::high_resolution_clock::duration mAccumulatedTime;
+		std::chrono::nanoseconds mFixedTimeStep;
+		std::chrono::nanoseconds mFixedTotalGameTime;
+		std::uint32_t mMaxFixedSteps;
+		bool mFixedTimeStepEnabled;
 	};
 }
\ No newline at end of file
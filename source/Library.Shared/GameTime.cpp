@@ -5,7 +5,7 @@ using namespace std::chrono;
 namespace Library
 {
 	GameTime::GameTime() :
-		mTotalGameTime(0), mElapsedGameTime(0)
+		mTotalGameTime(0), mElapsedGameTime(0), mInterpolation(1.0f)
 	{
 	}
 
@@ -19,22 +19,32 @@ namespace Library
 		mCurrentTime = currentTime;
 	}
 
-	const milliseconds& GameTime::TotalGameTime() const
+	milliseconds GameTime::TotalGameTime() const
+	{
+		return duration_cast<milliseconds>(mTotalGameTime);
+	}
+
+	const nanoseconds& GameTime::TotalGameTimeNanoseconds() const
 	{
 		return mTotalGameTime;
 	}
 
-	void GameTime::SetTotalGameTime(const std::chrono::milliseconds& totalGameTime)
+	void GameTime::SetTotalGameTime(const std::chrono::nanoseconds& totalGameTime)
 	{
 		mTotalGameTime = totalGameTime;
 	}
 
-	const milliseconds& GameTime::ElapsedGameTime() const
+	milliseconds GameTime::ElapsedGameTime() const
+	{
+		return duration_cast<milliseconds>(mElapsedGameTime);
+	}
+
+	const nanoseconds& GameTime::ElapsedGameTimeNanoseconds() const
 	{
 		return mElapsedGameTime;
 	}
 
-	void GameTime::SetElapsedGameTime(const std::chrono::milliseconds& elapsedGameTime)
+	void GameTime::SetElapsedGameTime(const std::chrono::nanoseconds& elapsedGameTime)
 	{
 		mElapsedGameTime = elapsedGameTime;
 	}
@@ -48,4 +58,20 @@ namespace Library
 	{
 		return duration_cast<duration<float>>(mElapsedGameTime);
 	}
+
+	duration<double> GameTime::TotalSimulationTime() const
+	{
+		// A float runs out of sub-millisecond precision after a few hours; a double keeps it for centuries
+		return duration_cast<duration<double>>(mTotalGameTime);
+	}
+
+	float GameTime::Interpolation() const
+	{
+		return mInterpolation;
+	}
+
+	void GameTime::SetInterpolation(float interpolation)
+	{
+		mInterpolation = interpolation;
+	}
 }
\ No newline at end of file
@@ -12,18 +12,25 @@ namespace Library
 		const std::chrono::high_resolution_clock::time_point& CurrentTime() const;
 		void SetCurrentTime(const std::chrono::high_resolution_clock::time_point& currentTime);
 
-		const std::chrono::milliseconds& TotalGameTime() const;
-		void SetTotalGameTime(const std::chrono::milliseconds& totalGameTime);
+		std::chrono::milliseconds TotalGameTime() const;
+		const std::chrono::nanoseconds& TotalGameTimeNanoseconds() const;
+		void SetTotalGameTime(const std::chrono::nanoseconds& totalGameTime);
 
-		const std::chrono::milliseconds& ElapsedGameTime() const;
-		void SetElapsedGameTime(const std::chrono::milliseconds& elapsedGameTime);
+		std::chrono::milliseconds ElapsedGameTime() const;
+		const std::chrono::nanoseconds& ElapsedGameTimeNanoseconds() const;
+		void SetElapsedGameTime(const std::chrono::nanoseconds& elapsedGameTime);
 
 		std::chrono::duration<float> TotalGameTimeSeconds() const;
 		std::chrono::duration<float> ElapsedGameTimeSeconds() const;
+		std::chrono::duration<double> TotalSimulationTime() const;
+
+		float Interpolation() const;
+		void SetInterpolation(float interpolation);
 
 	private:
 		std::chrono::high_resolution_clock::time_point mCurrentTime;
-		std::chrono::milliseconds mTotalGameTime;
-		std::chrono::milliseconds mElapsedGameTime;
+		std::chrono::nanoseconds mTotalGameTime;
+		std::chrono::nanoseconds mElapsedGameTime;
+		float mInterpolation;
 	};
 }
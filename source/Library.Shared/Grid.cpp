@@ -111,28 +111,37 @@ namespace Library
 	}
 
 	void Grid::Draw(const GameTime& gameTime)
+	{
+		Record(gameTime, mGame->Direct3DDeviceContext());
+	}
+
+	bool Grid::CanRecordDeferred() const
+	{
+		return true;
+	}
+
+	void Grid::Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext)
 	{
 		UNREFERENCED_PARAMETER(gameTime);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
+		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+		deviceContext->IASetInputLayout(mInputLayout.Get());
 
 		UINT stride = sizeof(VertexPositionColor);
 		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
+		deviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
 
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
+		deviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
+		deviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
 		
 		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
 		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
 		XMStoreFloat4x4(&mVertexCBufferPerObjectData.WorldViewProjection, XMMatrixTranspose(wvp));
 
-		direct3DDeviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
-		direct3DDeviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
+		deviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
+		deviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
 		
-		direct3DDeviceContext->Draw((mSize + 1) * 4, 0);
+		deviceContext->Draw((mSize + 1) * 4, 0);
 	}
 
 	void Grid::InitializeGrid()
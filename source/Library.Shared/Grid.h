@@ -32,6 +32,8 @@ namespace Library
 
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool CanRecordDeferred() const override;
+		virtual void Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext) override;
 
 	private:
 		struct VertexCBufferPerObject
@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "HeadlessGame.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(HeadlessGame)
+
+	HeadlessGame::HeadlessGame() :
+		Game()
+	{
+	}
+
+	void HeadlessGame::Step(const nanoseconds& elapsedGameTime)
+	{
+		// Game time comes from the caller rather than the wall clock, so a batch run goes as fast as the updates allow
+		// and the same step sequence always produces the same simulation
+		mGameTime.SetElapsedGameTime(elapsedGameTime);
+		mGameTime.SetTotalGameTime(mGameTime.TotalGameTimeNanoseconds() + elapsedGameTime);
+		mGameTime.SetInterpolation(1.0f);
+
+		Update(mGameTime);
+	}
+
+	void HeadlessGame::Step(const nanoseconds& elapsedGameTime, uint32_t frameCount)
+	{
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			Step(elapsedGameTime);
+		}
+	}
+
+	void HeadlessGame::UnbindPixelShaderResources(UINT startSlot, UINT count)
+	{
+		UNREFERENCED_PARAMETER(startSlot);
+		UNREFERENCED_PARAMETER(count);
+	}
+
+	void HeadlessGame::Draw(const GameTime& gameTime)
+	{
+		UNREFERENCED_PARAMETER(gameTime);
+	}
+
+	void HeadlessGame::HandleDeviceLost()
+	{
+	}
+
+	void HeadlessGame::Begin()
+	{
+	}
+
+	void HeadlessGame::End()
+	{
+	}
+
+	void HeadlessGame::CreateDeviceResources()
+	{
+	}
+
+	void HeadlessGame::CreateWindowSizeDependentResources()
+	{
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Game.h"
+#include <chrono>
+
+namespace Library
+{
+	class HeadlessGame : public Game
+	{
+		RTTI_DECLARATIONS(HeadlessGame, Game)
+
+	public:
+		HeadlessGame();
+		HeadlessGame(const HeadlessGame&) = delete;
+		HeadlessGame& operator=(const HeadlessGame&) = delete;
+		HeadlessGame(HeadlessGame&&) = delete;
+		HeadlessGame& operator=(HeadlessGame&&) = delete;
+		virtual ~HeadlessGame() = default;
+
+		void Step(const std::chrono::nanoseconds& elapsedGameTime);
+		void Step(const std::chrono::nanoseconds& elapsedGameTime, std::uint32_t frameCount);
+
+		virtual void UnbindPixelShaderResources(UINT startSlot, UINT count) override;
+
+	protected:
+		virtual void Draw(const GameTime& gameTime) override;
+		virtual void HandleDeviceLost() override;
+
+		virtual void Begin() override;
+		virtual void End() override;
+
+		virtual void CreateDeviceResources() override;
+		virtual void CreateWindowSizeDependentResources() override;
+	};
+}
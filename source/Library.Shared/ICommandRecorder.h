@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Library
+{
+	class ICommandRecorder
+	{
+	public:
+		virtual ~ICommandRecorder() { };
+
+		// Passes are recorded in parallel, each on one of ContextCount() contexts, and then executed one after another in
+		// pass order on the calling thread. A context is only ever recorded into from one thread at a time.
+		virtual std::uint32_t ContextCount() const = 0;
+		virtual void RecordPass(std::uint32_t pass, std::uint32_t context) = 0;
+		virtual void ExecutePass(std::uint32_t pass) = 0;
+
+	protected:
+		ICommandRecorder() { };
+	};
+}
@@ -0,0 +1,221 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+using namespace std;
+
+namespace Library
+{
+	namespace
+	{
+		// Queue owned by the calling thread; threads outside the pool share queue 0
+		thread_local const JobSystem* CurrentJobSystem = nullptr;
+		thread_local uint32_t CurrentQueue = 0;
+	}
+
+	JobSystem::JobSystem(uint32_t workerCount) :
+		mQueuedJobs(0), mNextQueue(0), mShutdown(false)
+	{
+		mQueues.reserve(workerCount + 1);
+		for (uint32_t i = 0; i <= workerCount; ++i)
+		{
+			mQueues.push_back(make_unique<WorkQueue>());
+		}
+
+		mWorkers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; ++i)
+		{
+			mWorkers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			lock_guard<mutex> lock(mWakeMutex);
+			mShutdown = true;
+		}
+
+		mWakeCondition.notify_all();
+		for (auto& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	uint32_t JobSystem::DefaultWorkerCount()
+	{
+		// The thread calling ParallelFor works too, so leave it a core
+		const uint32_t hardwareThreads = thread::hardware_concurrency();
+		return (hardwareThreads > 1 ? hardwareThreads - 1 : 0);
+	}
+
+	uint32_t JobSystem::WorkerCount() const
+	{
+		return static_cast<uint32_t>(mWorkers.size());
+	}
+
+	uint32_t JobSystem::ThreadCount() const
+	{
+		return WorkerCount() + 1;
+	}
+
+	void JobSystem::ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& function)
+	{
+		assert(begin <= end);
+
+		const uint32_t count = end - begin;
+		if (count == 0)
+		{
+			return;
+		}
+
+		if (grainSize == 0)
+		{
+			// A few chunks per thread leaves room to balance uneven work by stealing
+			grainSize = count / (ThreadCount() * 4);
+			grainSize = (grainSize > 0 ? grainSize : 1);
+		}
+
+		if (mWorkers.empty() || count <= grainSize)
+		{
+			function(begin, end);
+			return;
+		}
+
+		const uint32_t jobCount = (count + grainSize - 1) / grainSize;
+		ParallelForState state;
+		state.Function = &function;
+		state.PendingJobs.store(jobCount, memory_order_relaxed);
+
+		// Deal the chunks out across every queue so workers start on local work instead of all stealing from one
+		const uint32_t queueCount = static_cast<uint32_t>(mQueues.size());
+		uint32_t queueIndex = mNextQueue.fetch_add(1, memory_order_relaxed) % queueCount;
+		mQueuedJobs.fetch_add(jobCount, memory_order_release);
+		uint32_t chunkBegin = begin;
+		for (uint32_t i = 0; i < jobCount; ++i)
+		{
+			const uint32_t chunkEnd = (end - chunkBegin > grainSize ? chunkBegin + grainSize : end);
+			WorkQueue& queue = *mQueues[queueIndex];
+			{
+				lock_guard<mutex> lock(queue.Mutex);
+				queue.Jobs.push_back({ &state, chunkBegin, chunkEnd });
+			}
+
+			chunkBegin = chunkEnd;
+			queueIndex = (queueIndex + 1) % queueCount;
+		}
+
+		{
+			lock_guard<mutex> lock(mWakeMutex);
+		}
+		mWakeCondition.notify_all();
+
+		// Help out until every chunk has finished; this also runs nested parallel-fors issued from inside a job
+		const uint32_t callerQueue = CurrentQueueIndex();
+		while (state.PendingJobs.load(memory_order_acquire) > 0)
+		{
+			if (!TryRunJob(callerQueue))
+			{
+				this_thread::yield();
+			}
+		}
+
+		if (state.Exception != nullptr)
+		{
+			rethrow_exception(state.Exception);
+		}
+	}
+
+	void JobSystem::WorkerMain(uint32_t queueIndex)
+	{
+		CurrentJobSystem = this;
+		CurrentQueue = queueIndex;
+
+		for (;;)
+		{
+			if (TryRunJob(queueIndex))
+			{
+				continue;
+			}
+
+			unique_lock<mutex> lock(mWakeMutex);
+			mWakeCondition.wait(lock, [&]() { return mShutdown || mQueuedJobs.load(memory_order_acquire) > 0; });
+			if (mShutdown)
+			{
+				break;
+			}
+		}
+	}
+
+	bool JobSystem::TryRunJob(uint32_t queueIndex)
+	{
+		Job job;
+		if (TryPop(queueIndex, job) || TrySteal(queueIndex, job))
+		{
+			mQueuedJobs.fetch_sub(1, memory_order_relaxed);
+			Execute(job);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool JobSystem::TryPop(uint32_t queueIndex, Job& job)
+	{
+		// The owner works from the back, where its most recently queued (and cache-warm) chunks are
+		WorkQueue& queue = *mQueues[queueIndex];
+		lock_guard<mutex> lock(queue.Mutex);
+		if (queue.Jobs.empty())
+		{
+			return false;
+		}
+
+		job = queue.Jobs.back();
+		queue.Jobs.pop_back();
+		return true;
+	}
+
+	bool JobSystem::TrySteal(uint32_t thiefIndex, Job& job)
+	{
+		// Thieves take from the front, away from the owner
+		const uint32_t queueCount = static_cast<uint32_t>(mQueues.size());
+		for (uint32_t offset = 1; offset < queueCount; ++offset)
+		{
+			WorkQueue& queue = *mQueues[(thiefIndex + offset) % queueCount];
+			lock_guard<mutex> lock(queue.Mutex);
+			if (!queue.Jobs.empty())
+			{
+				job = queue.Jobs.front();
+				queue.Jobs.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	uint32_t JobSystem::CurrentQueueIndex() const
+	{
+		return (CurrentJobSystem == this ? CurrentQueue : 0);
+	}
+
+	void JobSystem::Execute(const Job& job)
+	{
+		ParallelForState& state = *job.State;
+		try
+		{
+			(*state.Function)(job.Begin, job.End);
+		}
+		catch (...)
+		{
+			lock_guard<mutex> lock(state.ExceptionMutex);
+			if (state.Exception == nullptr)
+			{
+				state.Exception = current_exception();
+			}
+		}
+
+		// The caller may release the state as soon as this reaches zero
+		state.PendingJobs.fetch_sub(1, memory_order_release);
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Library
+{
+	class JobSystem final
+	{
+	public:
+		typedef std::function<void(std::uint32_t begin, std::uint32_t end)> RangeFunction;
+
+		explicit JobSystem(std::uint32_t workerCount = DefaultWorkerCount());
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+		~JobSystem();
+
+		static std::uint32_t DefaultWorkerCount();
+
+		std::uint32_t WorkerCount() const;
+		std::uint32_t ThreadCount() const;
+
+		void ParallelFor(std::uint32_t begin, std::uint32_t end, std::uint32_t grainSize, const RangeFunction& function);
+
+	private:
+		struct ParallelForState
+		{
+			const RangeFunction* Function;
+			std::atomic<std::uint32_t> PendingJobs;
+			std::mutex ExceptionMutex;
+			std::exception_ptr Exception;
+		};
+
+		struct Job
+		{
+			ParallelForState* State;
+			std::uint32_t Begin;
+			std::uint32_t End;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex Mutex;
+			std::deque<Job> Jobs;
+		};
+
+		void WorkerMain(std::uint32_t queueIndex);
+		bool TryRunJob(std::uint32_t queueIndex);
+		bool TryPop(std::uint32_t queueIndex, Job& job);
+		bool TrySteal(std::uint32_t thiefIndex, Job& job);
+		std::uint32_t CurrentQueueIndex() const;
+		static void Execute(const Job& job);
+
+		std::vector<std::unique_ptr<WorkQueue>> mQueues;
+		std::vector<std::thread> mWorkers;
+		std::atomic<std::uint32_t> mQueuedJobs;
+		std::atomic<std::uint32_t> mNextQueue;
+		std::mutex mWakeMutex;
+		std::condition_variable mWakeCondition;
+		bool mShutdown;
+	};
+}
@@ -0,0 +1,73 @@
+#include "pch.h"
+#include "MemoryMappedFile.h"
+
+using namespace std;
+
+namespace Library
+{
+	MemoryMappedFile::MemoryMappedFile(const wstring& filename) :
+		mFile(INVALID_HANDLE_VALUE), mMapping(nullptr), mData(nullptr), mSize(0)
+	{
+		mFile = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (mFile == INVALID_HANDLE_VALUE)
+		{
+			throw GameException("CreateFileW() failed.", HRESULT_FROM_WIN32(GetLastError()));
+		}
+
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(mFile, &size) == FALSE)
+		{
+			const HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+			CloseHandle(mFile);
+			throw GameException("GetFileSizeEx() failed.", hr);
+		}
+
+		mSize = static_cast<uint64_t>(size.QuadPart);
+
+		// An empty file cannot be mapped; it simply has no data
+		if (mSize > 0)
+		{
+			mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mMapping == nullptr)
+			{
+				const HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+				CloseHandle(mFile);
+				throw GameException("CreateFileMappingW() failed.", hr);
+			}
+
+			mData = reinterpret_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+			if (mData == nullptr)
+			{
+				const HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+				CloseHandle(mMapping);
+				CloseHandle(mFile);
+				throw GameException("MapViewOfFile() failed.", hr);
+			}
+		}
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		if (mData != nullptr)
+		{
+			UnmapViewOfFile(mData);
+		}
+
+		if (mMapping != nullptr)
+		{
+			CloseHandle(mMapping);
+		}
+
+		CloseHandle(mFile);
+	}
+
+	const uint8_t* MemoryMappedFile::Data() const
+	{
+		return mData;
+	}
+
+	uint64_t MemoryMappedFile::Size() const
+	{
+		return mSize;
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <string>
+
+namespace Library
+{
+	class MemoryMappedFile final
+	{
+	public:
+		explicit MemoryMappedFile(const std::wstring& filename);
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+		MemoryMappedFile(MemoryMappedFile&&) = delete;
+		MemoryMappedFile& operator=(MemoryMappedFile&&) = delete;
+		~MemoryMappedFile();
+
+		const std::uint8_t* Data() const;
+		std::uint64_t Size() const;
+
+	private:
+		HANDLE mFile;
+		HANDLE mMapping;
+		const std::uint8_t* mData;
+		std::uint64_t mSize;
+	};
+}
@@ -9,7 +9,7 @@ using namespace Library;
 MeshData::MeshData() :
 	Material(nullptr), Name(), Vertices(),
 	Normals(), Tangents(), BiNormals(), TextureCoordinates(), VertexColors(),
-	FaceCount(0), Indices()
+	FaceCount(0), Indices(), InterleavedVertices()
 {
 }
 
@@ -17,7 +17,7 @@ MeshData::MeshData(MeshData&& rhs) :
 	Material(move(rhs.Material)), Name(move(rhs.Name)), Vertices(move(rhs.Vertices)),
 	Normals(move(rhs.Normals)), Tangents(move(rhs.Tangents)), BiNormals(move(rhs.BiNormals)),
 	TextureCoordinates(move(rhs.TextureCoordinates)), VertexColors(move(rhs.VertexColors)), FaceCount(rhs.FaceCount),
-	Indices(move(rhs.Indices))
+	Indices(move(rhs.Indices)), InterleavedVertices(move(rhs.InterleavedVertices))
 {
 	rhs.FaceCount = 0U;
 }
@@ -37,6 +37,7 @@ MeshData& MeshData::operator=(MeshData&& rhs)
 		VertexColors = move(rhs.VertexColors);
 		FaceCount = rhs.FaceCount;
 		Indices = move(rhs.Indices);
+		InterleavedVertices = move(rhs.InterleavedVertices);
 
 		rhs.FaceCount = 0U;
 	}
@@ -65,18 +66,26 @@ void MeshData::Clear()
 #pragma endregion
 
 Mesh::Mesh(Model& model, InputStreamHelper& streamHelper) :
-	mModel(&model), mData()
+	mModel(&model), mData(), mSpans(), mFile(nullptr)
 {
 	Load(streamHelper);
+	BindSpans();
 }
 
 Mesh::Mesh(Model& model, MeshData&& meshData) :
-	mModel(&model), mData(move(meshData))
+	mModel(&model), mData(move(meshData)), mSpans(), mFile(nullptr)
 {
+	BindSpans();
+}
+
+Mesh::Mesh(Model& model, MeshData&& meshData, MeshSpans&& spans, const shared_ptr<const MemoryMappedFile>& file) :
+	mModel(&model), mData(move(meshData)), mSpans(move(spans)), mFile(file)
+{
+	assert(mFile != nullptr);
 }
 
 Mesh::Mesh(Mesh&& rhs) :
-	mModel(move(rhs.mModel)), mData(move(rhs.mData))
+	mModel(move(rhs.mModel)), mData(move(rhs.mData)), mSpans(move(rhs.mSpans)), mFile(move(rhs.mFile))
 {
 }
 
@@ -86,6 +95,8 @@ Mesh& Mesh::operator=(Mesh&& rhs)
 	{
 		mModel = move(rhs.mModel);
 		mData = move(rhs.mData);
+		mSpans = move(rhs.mSpans);
+		mFile = move(rhs.mFile);
 	}
 
 	return *this;
@@ -146,17 +157,68 @@ const vector<uint32_t>& Mesh::Indices() const
 	return mData.Indices;
 }
 
+const MeshSpans& Mesh::Spans() const
+{
+	return mSpans;
+}
+
+bool Mesh::IsMapped() const
+{
+	return (mFile != nullptr);
+}
+
+void Mesh::BakeInterleavedVertices(VertexFormat format)
+{
+	if (IsMapped())
+	{
+		throw GameException("A mapped mesh cannot be baked.");
+	}
+
+	vector<uint8_t>& vertices = mData.InterleavedVertices[format];
+	VertexFormatHelper::Interleave(format, mSpans, vertices);
+	mSpans.InterleavedVertices[format] = ArraySpan<uint8_t>(vertices);
+}
+
+ArraySpan<uint8_t> Mesh::InterleavedVertices(VertexFormat format) const
+{
+	auto found = mSpans.InterleavedVertices.find(format);
+	return (found != mSpans.InterleavedVertices.end() ? found->second : ArraySpan<uint8_t>());
+}
+
+void Mesh::CreateVertexBuffer(ID3D11Device& device, VertexFormat format, ID3D11Buffer** vertexBuffer) const
+{
+	assert(vertexBuffer != nullptr);
+
+	vector<uint8_t> interleavedVertices;
+	ArraySpan<uint8_t> vertices = InterleavedVertices(format);
+	if (vertices.IsEmpty())
+	{
+		VertexFormatHelper::Interleave(format, mSpans, interleavedVertices);
+		vertices = ArraySpan<uint8_t>(interleavedVertices);
+	}
+
+	D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
+	vertexBufferDesc.ByteWidth = vertices.Size();
+	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+	D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
+	vertexSubResourceData.pSysMem = vertices.Data();
+
+	ThrowIfFailed(device.CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
+}
+
 void Mesh::CreateIndexBuffer(ID3D11Device& device, ID3D11Buffer** indexBuffer)
 {
 	assert(indexBuffer != nullptr);
 
 	D3D11_BUFFER_DESC indexBufferDesc = { 0 };
-	indexBufferDesc.ByteWidth = static_cast<uint32_t>(sizeof(uint32_t) * mData.Indices.size());
+	indexBufferDesc.ByteWidth = static_cast<uint32_t>(sizeof(uint32_t) * mSpans.Indices.Size());
 	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
 	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 
 	D3D11_SUBRESOURCE_DATA indexSubResourceData = { 0 };
-	indexSubResourceData.pSysMem = &mData.Indices[0];
+	indexSubResourceData.pSysMem = mSpans.Indices.Data();
 
 	ThrowIfFailed(device.CreateBuffer(&indexBufferDesc, &indexSubResourceData, indexBuffer), "ID3D11Device::CreateBuffer() failed.");
 }
@@ -169,63 +231,29 @@ void Mesh::Save(OutputStreamHelper& streamHelper) const
 	// Serialize name
 	streamHelper << mData.Name;
 
-	// Serialize vertices
-	streamHelper << static_cast<uint32_t>(mData.Vertices.size());
-	for (const XMFLOAT3& vertex : mData.Vertices)
-	{
-		streamHelper << vertex.x << vertex.y << vertex.z;
-	}
-
-	// Serialize normals
-	streamHelper << static_cast<uint32_t>(mData.Normals.size());
-	for (const XMFLOAT3& normal : mData.Normals)
-	{
-		streamHelper << normal.x << normal.y << normal.z;
-	}
-
-	// Serialize tangents
-	streamHelper << static_cast<uint32_t>(mData.Tangents.size());
-	for (const XMFLOAT3& tangents : mData.Tangents)
-	{
-		streamHelper << tangents.x << tangents.y << tangents.z;
-	}
-
-	// Serialize binormals
-	streamHelper << static_cast<uint32_t>(mData.BiNormals.size());
-	for (const XMFLOAT3& binormal : mData.BiNormals)
-	{
-		streamHelper << binormal.x << binormal.y << binormal.z;
-	}
+	// Serialize vertices, normals, tangents and binormals; each is a count and then one block of floats
+	streamHelper.WriteArray(mSpans.Vertices);
+	streamHelper.WriteArray(mSpans.Normals);
+	streamHelper.WriteArray(mSpans.Tangents);
+	streamHelper.WriteArray(mSpans.BiNormals);
 
 	// Serialize texture coordinates
-	streamHelper << static_cast<uint32_t>(mData.TextureCoordinates.size());
-	for (const auto& uvList : mData.TextureCoordinates)
+	streamHelper << static_cast<uint32_t>(mSpans.TextureCoordinates.size());
+	for (const auto& uvList : mSpans.TextureCoordinates)
 	{
-		streamHelper << static_cast<uint32_t>(uvList->size());
-		for (const XMFLOAT3& uv : *uvList)
-		{
-			streamHelper << uv.x << uv.y << uv.z;
-		}
+		streamHelper.WriteArray(uvList);
 	}
 
 	// Serialize vertex colors
-	streamHelper << static_cast<uint32_t>(mData.VertexColors.size());
-	for (const auto& vertexColorList : mData.VertexColors)
+	streamHelper << static_cast<uint32_t>(mSpans.VertexColors.size());
+	for (const auto& vertexColorList : mSpans.VertexColors)
 	{
-		streamHelper << vertexColorList->size();
-		for (const XMFLOAT4& vertexColor : *vertexColorList)
-		{
-			streamHelper << vertexColor.x << vertexColor.y << vertexColor.z << vertexColor.w;
-		}
+		streamHelper.WriteArray(vertexColorList);
 	}
 
 	// Serialize indices
 	streamHelper << mData.FaceCount;
-	streamHelper << static_cast<uint32_t>(mData.Indices.size());
-	for (const uint32_t& index : mData.Indices)
-	{
-		streamHelper << index;
-	}
+	streamHelper.WriteArray(mSpans.Indices);
 }
 
 void Mesh::Load(InputStreamHelper& streamHelper)
@@ -246,70 +274,23 @@ void Mesh::Load(InputStreamHelper& streamHelper)
 	// Deserialize name
 	streamHelper >> mData.Name;
 
-	// Deserialize vertices
-	uint32_t vertexCount;
-	streamHelper >> vertexCount;
-	mData.Vertices.reserve(vertexCount);
-	for (uint32_t i = 0; i < vertexCount; i++)
-	{
-		XMFLOAT3 vertex;
-		streamHelper >> vertex.x >> vertex.y >> vertex.z;
-		mData.Vertices.push_back(vertex);
-	}
-
-	// Deserialize normals
-	uint32_t normalCount;
-	streamHelper >> normalCount;
-	mData.Normals.reserve(normalCount);
-	for (uint32_t i = 0; i < normalCount; i++)
-	{
-		XMFLOAT3 normal;
-		streamHelper >> normal.x >> normal.y >> normal.z;
-		mData.Normals.push_back(normal);
-	}
-
-	// Deserialize tangents
-	uint32_t tangentCount;
-	streamHelper >> tangentCount;
-	mData.Tangents.reserve(tangentCount);
-	for (uint32_t i = 0; i < tangentCount; i++)
-	{
-		XMFLOAT3 tangent;
-		streamHelper >> tangent.x >> tangent.y >> tangent.z;
-		mData.Tangents.push_back(tangent);
-	}
-
-	// Deserialize binormals
-	uint32_t binormalCount;
-	streamHelper >> binormalCount;
-	mData.BiNormals.reserve(binormalCount);
-	for (uint32_t i = 0; i < binormalCount; i++)
-	{
-		XMFLOAT3 binormal;
-		streamHelper >> binormal.x >> binormal.y >> binormal.z;
-		mData.BiNormals.push_back(binormal);
-	}
+	// Deserialize vertices, normals, tangents and binormals, one read per stream
+	streamHelper.ReadArray(mData.Vertices);
+	streamHelper.ReadArray(mData.Normals);
+	streamHelper.ReadArray(mData.Tangents);
+	streamHelper.ReadArray(mData.BiNormals);
 
-	// Deserialize texture coordinates
+	// Deserialize texture coordinates; empty channels are dropped
 	uint32_t textureCoordinateCount;
 	streamHelper >> textureCoordinateCount;
 	mData.TextureCoordinates.reserve(textureCoordinateCount);
 	for (uint32_t i = 0; i < textureCoordinateCount; i++)
 	{
-		uint32_t uvListCount;
-		streamHelper >> uvListCount;
-		if (uvListCount > 0)
+		unique_ptr<vector<XMFLOAT3>> uvs = make_unique<vector<XMFLOAT3>>();
+		streamHelper.ReadArray(*uvs);
+		if (uvs->size() > 0)
 		{
-			std::vector<XMFLOAT3>* uvs = new std::vector<XMFLOAT3>();
-			uvs->reserve(uvListCount);
-			mData.TextureCoordinates.push_back(uvs);
-
-			for (uint32_t j = 0; j < uvListCount; j++)
-			{
-				XMFLOAT3 uv;
-				streamHelper >> uv.x >> uv.y >> uv.z;
-				uvs->push_back(uv);
-			}
+			mData.TextureCoordinates.push_back(uvs.release());
 		}
 	}
 
@@ -319,32 +300,43 @@ void Mesh::Load(InputStreamHelper& streamHelper)
 	mData.VertexColors.reserve(vertexColorCount);
 	for (uint32_t i = 0; i < vertexColorCount; i++)
 	{
-		uint32_t vertexColorListCount;
-		streamHelper >> vertexColorListCount;
-		if (vertexColorListCount > 0)
+		unique_ptr<vector<XMFLOAT4>> vertexColors = make_unique<vector<XMFLOAT4>>();
+		streamHelper.ReadArray(*vertexColors);
+		if (vertexColors->size() > 0)
 		{
-			std::vector<XMFLOAT4>* vertexColors = new std::vector<XMFLOAT4>();
-			vertexColors->reserve(vertexColorListCount);
-			mData.VertexColors.push_back(vertexColors);
-
-			for (uint32_t j = 0; j < vertexColorListCount; j++)
-			{
-				XMFLOAT4 vertexColor;
-				streamHelper >> vertexColor.x >> vertexColor.y >> vertexColor.z >> vertexColor.w;
-				vertexColors->push_back(vertexColor);
-			}
+			mData.VertexColors.push_back(vertexColors.release());
 		}
 	}
 
-	// Deserialize indexes	
+	// Deserialize indexes
 	streamHelper >> mData.FaceCount;
-	uint32_t indexCount;
-	streamHelper >> indexCount;
-	mData.Indices.reserve(indexCount);
-	for (uint32_t i = 0; i < indexCount; i++)
+	streamHelper.ReadArray(mData.Indices);
+}
+
+void Mesh::BindSpans()
+{
+	// An owned mesh views its own vectors; they keep their storage when the mesh is moved, so the views stay valid
+	mSpans.Vertices = ArraySpan<XMFLOAT3>(mData.Vertices);
+	mSpans.Normals = ArraySpan<XMFLOAT3>(mData.Normals);
+	mSpans.Tangents = ArraySpan<XMFLOAT3>(mData.Tangents);
+	mSpans.BiNormals = ArraySpan<XMFLOAT3>(mData.BiNormals);
+	mSpans.Indices = ArraySpan<uint32_t>(mData.Indices);
+
+	mSpans.TextureCoordinates.clear();
+	for (const vector<XMFLOAT3>* textureCoordinates : mData.TextureCoordinates)
+	{
+		mSpans.TextureCoordinates.emplace_back(*textureCoordinates);
+	}
+
+	mSpans.VertexColors.clear();
+	for (const vector<XMFLOAT4>* vertexColors : mData.VertexColors)
+	{
+		mSpans.VertexColors.emplace_back(*vertexColors);
+	}
+
+	mSpans.InterleavedVertices.clear();
+	for (const auto& interleavedVertices : mData.InterleavedVertices)
 	{
-		uint32_t index;
-		streamHelper >> index;
-		mData.Indices.push_back(index);
+		mSpans.InterleavedVertices[interleavedVertices.first] = ArraySpan<uint8_t>(interleavedVertices.second);
 	}
 }
\ No newline at end of file
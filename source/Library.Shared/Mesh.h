@@ -2,9 +2,12 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <cstdint>
 #include <DirectXMath.h>
 #include <d3d11_2.h>
+#include "ArraySpan.h"
+#include "VertexFormat.h"
 
 namespace Library
 {
@@ -13,6 +16,7 @@ namespace Library
     class ModelMaterial;
 	class OutputStreamHelper;
 	class InputStreamHelper;
+	class MemoryMappedFile;
 
 	struct MeshData
 	{
@@ -26,6 +30,7 @@ namespace Library
 		std::vector<std::vector<DirectX::XMFLOAT4>*> VertexColors;
 		std::uint32_t FaceCount;
 		std::vector<std::uint32_t> Indices;
+		std::map<VertexFormat, std::vector<std::uint8_t>> InterleavedVertices;
 
 		MeshData();
 		MeshData(const MeshData&) = delete;
@@ -38,11 +43,24 @@ namespace Library
 		void Clear();
 	};
 
+	struct MeshSpans
+	{
+		ArraySpan<DirectX::XMFLOAT3> Vertices;
+		ArraySpan<DirectX::XMFLOAT3> Normals;
+		ArraySpan<DirectX::XMFLOAT3> Tangents;
+		ArraySpan<DirectX::XMFLOAT3> BiNormals;
+		std::vector<ArraySpan<DirectX::XMFLOAT3>> TextureCoordinates;
+		std::vector<ArraySpan<DirectX::XMFLOAT4>> VertexColors;
+		ArraySpan<std::uint32_t> Indices;
+		std::map<VertexFormat, ArraySpan<std::uint8_t>> InterleavedVertices;
+	};
+
     class Mesh
     {
     public:
 		Mesh(Library::Model& model, InputStreamHelper& streamHelper);
 		Mesh(Library::Model& model, MeshData&& meshData);
+		Mesh(Library::Model& model, MeshData&& meshData, MeshSpans&& spans, const std::shared_ptr<const MemoryMappedFile>& file);
 		Mesh(const Mesh&) = delete;
 		Mesh& operator=(const Mesh&) = delete;
 		Mesh(Mesh&& rhs);
@@ -61,13 +79,27 @@ namespace Library
 		std::uint32_t FaceCount() const;
 		const std::vector<std::uint32_t>& Indices() const;
 
+		// Every mesh can be read through its spans. A mesh mapped from a model file keeps its data in the file, so the
+		// vectors above are empty for it and the spans point into the mapping.
+		const MeshSpans& Spans() const;
+		bool IsMapped() const;
+
+		// Interleaved vertices are baked by the model pipeline and saved with the model file, so creating a vertex buffer
+		// from them is a single upload. A format that was not baked is interleaved when the buffer is created.
+		void BakeInterleavedVertices(VertexFormat format);
+		ArraySpan<std::uint8_t> InterleavedVertices(VertexFormat format) const;
+
+		void CreateVertexBuffer(ID3D11Device& device, VertexFormat format, ID3D11Buffer** vertexBuffer) const;
         void CreateIndexBuffer(ID3D11Device& device, ID3D11Buffer** indexBuffer);
 		void Save(OutputStreamHelper& streamHelper) const;
 
     private:
 		void Load(InputStreamHelper& streamHelper);
+		void BindSpans();
 
         Library::Model* mModel;
 		MeshData mData;
+		MeshSpans mSpans;
+		std::shared_ptr<const MemoryMappedFile> mFile;
     };
 }
\ No newline at end of file
@@ -82,13 +82,7 @@ namespace Library
 
 	void Model::Save(const string& filename) const
 	{
-		ofstream file(filename.c_str(), ios::binary);
-		if (!file.good())
-		{
-			throw exception("Could not open file.");
-		}
-
-		Save(file);
+		ModelFile::Save(*this, filename);
 	}
 
 	void Model::Save(ofstream& file) const
@@ -112,6 +106,15 @@ namespace Library
 
 	void Model::Load(const string& filename)
 	{
+		// Files in the mapped layout are used in place; anything older goes through the stream reader below
+		shared_ptr<const MemoryMappedFile> mappedFile = make_shared<MemoryMappedFile>(Utility::ToWideString(filename));
+		if (ModelFile::IsModelFile(*mappedFile))
+		{
+			mData = ModelFile::Load(*this, mappedFile);
+			return;
+		}
+
+		mappedFile.reset();
 		ifstream file(filename.c_str(), ios::binary);
 		if (!file.good())
 		{
@@ -44,6 +44,7 @@ namespace Library
 
 		ModelData& Data();
 
+		// A named file gets the mapped layout of ModelFile; a stream gets the legacy layout, which Load still reads
 		void Save(const std::string& filename) const;
 		void Save(std::ofstream& file) const;
 
@@ -0,0 +1,440 @@
+#include "pch.h"
+#include "ModelFile.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace Library
+{
+	const uint32_t ModelFile::Magic = 0x4C444F4D; // "MODL"
+	const uint32_t ModelFile::Version = 2;
+	const uint32_t ModelFile::BlobAlignment;
+
+	namespace
+	{
+		struct FileHeader
+		{
+			uint32_t Magic;
+			uint32_t Version;
+			uint32_t MaterialCount;
+			uint32_t TextureCount;
+			uint32_t MeshCount;
+			uint32_t ChannelCount;
+			uint32_t LayoutCount;
+			uint32_t Reserved;
+			uint64_t StringsOffset;
+			uint64_t StringsSize;
+		};
+
+		struct StringRecord
+		{
+			uint32_t Offset;
+			uint32_t Length;
+		};
+
+		struct MaterialRecord
+		{
+			StringRecord Name;
+			uint32_t FirstTexture;
+			uint32_t TextureCount;
+		};
+
+		struct TextureRecord
+		{
+			int32_t Type;
+			StringRecord Filename;
+		};
+
+		struct BlobRecord
+		{
+			uint64_t Offset;
+			uint32_t Count;
+			uint32_t Reserved;
+		};
+
+		// Texture coordinate and vertex colour channels are blob records of their own, the texture coordinates first
+		struct MeshRecord
+		{
+			StringRecord Name;
+			StringRecord MaterialName;
+			uint32_t FaceCount;
+			uint32_t FirstChannel;
+			uint32_t TextureCoordinateChannelCount;
+			uint32_t VertexColorChannelCount;
+			uint32_t FirstLayout;
+			uint32_t LayoutCount;
+			BlobRecord Vertices;
+			BlobRecord Normals;
+			BlobRecord Tangents;
+			BlobRecord BiNormals;
+			BlobRecord Indices;
+		};
+
+		// A baked vertex layout; its blob's count is in bytes, a whole number of vertices of the format's stride
+		struct LayoutRecord
+		{
+			uint32_t Format;
+			uint32_t Stride;
+			BlobRecord Vertices;
+		};
+
+		uint64_t AlignBlob(uint64_t offset)
+		{
+			return (offset + ModelFile::BlobAlignment - 1) & ~static_cast<uint64_t>(ModelFile::BlobAlignment - 1);
+		}
+
+		// The records follow the header in this order, and the string table follows the records
+		uint64_t MaterialsOffset()
+		{
+			return sizeof(FileHeader);
+		}
+
+		uint64_t TexturesOffset(const FileHeader& header)
+		{
+			return MaterialsOffset() + static_cast<uint64_t>(header.MaterialCount) * sizeof(MaterialRecord);
+		}
+
+		uint64_t MeshesOffset(const FileHeader& header)
+		{
+			return TexturesOffset(header) + static_cast<uint64_t>(header.TextureCount) * sizeof(TextureRecord);
+		}
+
+		uint64_t ChannelsOffset(const FileHeader& header)
+		{
+			return MeshesOffset(header) + static_cast<uint64_t>(header.MeshCount) * sizeof(MeshRecord);
+		}
+
+		uint64_t LayoutsOffset(const FileHeader& header)
+		{
+			return ChannelsOffset(header) + static_cast<uint64_t>(header.ChannelCount) * sizeof(BlobRecord);
+		}
+
+		uint64_t RecordsEnd(const FileHeader& header)
+		{
+			return LayoutsOffset(header) + static_cast<uint64_t>(header.LayoutCount) * sizeof(LayoutRecord);
+		}
+
+		// Records are copied out rather than cast in place, since nothing keeps them aligned to their own width
+		template <typename T>
+		T ReadRecord(const MemoryMappedFile& file, uint64_t offset)
+		{
+			T record;
+			memcpy(&record, file.Data() + offset, sizeof(T));
+
+			return record;
+		}
+
+		template <typename T>
+		ArraySpan<T> MapBlob(const MemoryMappedFile& file, const BlobRecord& record, uint64_t blobsOffset)
+		{
+			if (record.Count == 0)
+			{
+				return ArraySpan<T>();
+			}
+
+			if (record.Offset % ModelFile::BlobAlignment != 0 || record.Offset < blobsOffset || record.Offset + static_cast<uint64_t>(record.Count) * sizeof(T) > file.Size())
+			{
+				throw GameException("Model file is corrupt.");
+			}
+
+			return ArraySpan<T>(reinterpret_cast<const T*>(file.Data() + record.Offset), record.Count);
+		}
+
+		struct ModelFileWriter
+		{
+			StringRecord AddString(const string& value)
+			{
+				const StringRecord record = { static_cast<uint32_t>(Strings.size()), static_cast<uint32_t>(value.size()) };
+				Strings += value;
+
+				return record;
+			}
+
+			// Offsets are relative to the first blob until the size of everything in front of the blobs is known
+			template <typename T>
+			BlobRecord AddBlob(const ArraySpan<T>& elements)
+			{
+				BlobRecord record = { 0, elements.Size(), 0 };
+				if (!elements.IsEmpty())
+				{
+					record.Offset = AlignBlob(BlobsSize);
+					BlobsSize = record.Offset + static_cast<uint64_t>(elements.Size()) * sizeof(T);
+					Blobs.push_back({ elements.Data(), record.Offset, BlobsSize - record.Offset });
+				}
+
+				return record;
+			}
+
+			struct PendingBlob
+			{
+				const void* Data;
+				uint64_t Offset;
+				uint64_t Size;
+			};
+
+			vector<MaterialRecord> Materials;
+			vector<TextureRecord> Textures;
+			vector<MeshRecord> Meshes;
+			vector<BlobRecord> Channels;
+			vector<LayoutRecord> Layouts;
+			string Strings;
+			vector<PendingBlob> Blobs;
+			uint64_t BlobsSize = 0;
+		};
+	}
+
+	bool ModelFile::IsModelFile(const MemoryMappedFile& file)
+	{
+		// The legacy stream layout starts with a material count, which is never anywhere near the magic number
+		if (file.Size() < sizeof(FileHeader))
+		{
+			return false;
+		}
+
+		uint32_t magic;
+		memcpy(&magic, file.Data(), sizeof(magic));
+		return (magic == Magic);
+	}
+
+	void ModelFile::Save(const Model& model, const string& filename)
+	{
+		ModelFileWriter writer;
+		for (const auto& material : model.Materials())
+		{
+			const MaterialRecord record = { writer.AddString(material->Name()), static_cast<uint32_t>(writer.Textures.size()), 0 };
+			writer.Materials.push_back(record);
+
+			for (const auto& texturePair : material->Textures())
+			{
+				for (const string& texture : *texturePair.second)
+				{
+					writer.Textures.push_back({ static_cast<int32_t>(texturePair.first), writer.AddString(texture) });
+					++writer.Materials.back().TextureCount;
+				}
+			}
+		}
+
+		for (const auto& mesh : model.Meshes())
+		{
+			const MeshSpans& spans = mesh->Spans();
+			const shared_ptr<ModelMaterial> material = mesh->GetMaterial();
+
+			MeshRecord record;
+			record.Name = writer.AddString(mesh->Name());
+			record.MaterialName = writer.AddString(material != nullptr ? material->Name() : "");
+			record.FaceCount = mesh->FaceCount();
+			record.FirstChannel = static_cast<uint32_t>(writer.Channels.size());
+			record.TextureCoordinateChannelCount = static_cast<uint32_t>(spans.TextureCoordinates.size());
+			record.VertexColorChannelCount = static_cast<uint32_t>(spans.VertexColors.size());
+			record.FirstLayout = static_cast<uint32_t>(writer.Layouts.size());
+			record.LayoutCount = static_cast<uint32_t>(spans.InterleavedVertices.size());
+			record.Vertices = writer.AddBlob(spans.Vertices);
+			record.Normals = writer.AddBlob(spans.Normals);
+			record.Tangents = writer.AddBlob(spans.Tangents);
+			record.BiNormals = writer.AddBlob(spans.BiNormals);
+			record.Indices = writer.AddBlob(spans.Indices);
+
+			for (const ArraySpan<XMFLOAT3>& textureCoordinates : spans.TextureCoordinates)
+			{
+				writer.Channels.push_back(writer.AddBlob(textureCoordinates));
+			}
+
+			for (const ArraySpan<XMFLOAT4>& vertexColors : spans.VertexColors)
+			{
+				writer.Channels.push_back(writer.AddBlob(vertexColors));
+			}
+
+			for (const auto& interleavedVertices : spans.InterleavedVertices)
+			{
+				const LayoutRecord layout = { static_cast<uint32_t>(interleavedVertices.first), VertexFormatHelper::Stride(interleavedVertices.first), writer.AddBlob(interleavedVertices.second) };
+				writer.Layouts.push_back(layout);
+			}
+
+			writer.Meshes.push_back(record);
+		}
+
+		FileHeader header = { Magic, Version, static_cast<uint32_t>(writer.Materials.size()), static_cast<uint32_t>(writer.Textures.size()), static_cast<uint32_t>(writer.Meshes.size()), static_cast<uint32_t>(writer.Channels.size()), static_cast<uint32_t>(writer.Layouts.size()), 0, 0, writer.Strings.size() };
+		header.StringsOffset = RecordsEnd(header);
+
+		// Now that the blobs' place in the file is known, their records can hold absolute offsets
+		const uint64_t blobsOffset = AlignBlob(header.StringsOffset + header.StringsSize);
+		auto relocate = [blobsOffset](BlobRecord& record)
+		{
+			if (record.Count > 0)
+			{
+				record.Offset += blobsOffset;
+			}
+		};
+
+		for (MeshRecord& record : writer.Meshes)
+		{
+			relocate(record.Vertices);
+			relocate(record.Normals);
+			relocate(record.Tangents);
+			relocate(record.BiNormals);
+			relocate(record.Indices);
+		}
+
+		for_each(writer.Channels.begin(), writer.Channels.end(), relocate);
+		for (LayoutRecord& layout : writer.Layouts)
+		{
+			relocate(layout.Vertices);
+		}
+
+		ofstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw GameException("Could not open file.");
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+		file.write(reinterpret_cast<const char*>(writer.Materials.data()), writer.Materials.size() * sizeof(MaterialRecord));
+		file.write(reinterpret_cast<const char*>(writer.Textures.data()), writer.Textures.size() * sizeof(TextureRecord));
+		file.write(reinterpret_cast<const char*>(writer.Meshes.data()), writer.Meshes.size() * sizeof(MeshRecord));
+		file.write(reinterpret_cast<const char*>(writer.Channels.data()), writer.Channels.size() * sizeof(BlobRecord));
+		file.write(reinterpret_cast<const char*>(writer.Layouts.data()), writer.Layouts.size() * sizeof(LayoutRecord));
+		file.write(writer.Strings.data(), writer.Strings.size());
+
+		// Each blob is padded up to its aligned offset, so the file can be used in place once it is mapped
+		const char padding[BlobAlignment] = { 0 };
+		uint64_t position = header.StringsOffset + header.StringsSize;
+		for (const ModelFileWriter::PendingBlob& blob : writer.Blobs)
+		{
+			const uint64_t offset = blobsOffset + blob.Offset;
+			file.write(padding, static_cast<streamsize>(offset - position));
+			file.write(reinterpret_cast<const char*>(blob.Data), static_cast<streamsize>(blob.Size));
+			position = offset + blob.Size;
+		}
+
+		if (!file.good())
+		{
+			throw GameException("Could not write model.");
+		}
+	}
+
+	ModelData ModelFile::Load(Model& model, const shared_ptr<const MemoryMappedFile>& file)
+	{
+		assert(file != nullptr);
+
+		if (!IsModelFile(*file))
+		{
+			throw GameException("Unsupported model file.");
+		}
+
+		const FileHeader header = ReadRecord<FileHeader>(*file, 0);
+		if (header.Version != Version)
+		{
+			throw GameException("Unsupported model file.");
+		}
+
+		if (header.StringsOffset != RecordsEnd(header) || header.StringsOffset + header.StringsSize > file->Size())
+		{
+			throw GameException("Model file is corrupt.");
+		}
+
+		const char* strings = reinterpret_cast<const char*>(file->Data() + header.StringsOffset);
+		auto readString = [&header, strings](const StringRecord& record)
+		{
+			if (static_cast<uint64_t>(record.Offset) + record.Length > header.StringsSize)
+			{
+				throw GameException("Model file is corrupt.");
+			}
+
+			return string(strings + record.Offset, record.Length);
+		};
+
+		// Materials and names are small and copied out; the meshes' streams stay in the mapping
+		ModelData modelData;
+		modelData.Materials.reserve(header.MaterialCount);
+		for (uint32_t i = 0; i < header.MaterialCount; ++i)
+		{
+			const MaterialRecord record = ReadRecord<MaterialRecord>(*file, MaterialsOffset() + static_cast<uint64_t>(i) * sizeof(MaterialRecord));
+			if (static_cast<uint64_t>(record.FirstTexture) + record.TextureCount > header.TextureCount)
+			{
+				throw GameException("Model file is corrupt.");
+			}
+
+			ModelMaterialData materialData;
+			materialData.Name = readString(record.Name);
+			for (uint32_t j = 0; j < record.TextureCount; ++j)
+			{
+				const TextureRecord texture = ReadRecord<TextureRecord>(*file, TexturesOffset(header) + static_cast<uint64_t>(record.FirstTexture + j) * sizeof(TextureRecord));
+				vector<string>*& textures = materialData.Textures[TextureType(texture.Type)];
+				if (textures == nullptr)
+				{
+					textures = new vector<string>();
+				}
+
+				textures->push_back(readString(texture.Filename));
+			}
+
+			modelData.Materials.push_back(make_shared<ModelMaterial>(model, move(materialData)));
+		}
+
+		const uint64_t blobsOffset = AlignBlob(header.StringsOffset + header.StringsSize);
+		modelData.Meshes.reserve(header.MeshCount);
+		for (uint32_t i = 0; i < header.MeshCount; ++i)
+		{
+			const MeshRecord record = ReadRecord<MeshRecord>(*file, MeshesOffset(header) + static_cast<uint64_t>(i) * sizeof(MeshRecord));
+			if (static_cast<uint64_t>(record.FirstChannel) + record.TextureCoordinateChannelCount + record.VertexColorChannelCount > header.ChannelCount ||
+				static_cast<uint64_t>(record.FirstLayout) + record.LayoutCount > header.LayoutCount)
+			{
+				throw GameException("Model file is corrupt.");
+			}
+
+			MeshData meshData;
+			meshData.Name = readString(record.Name);
+			meshData.FaceCount = record.FaceCount;
+
+			const string materialName = readString(record.MaterialName);
+			for (const auto& material : modelData.Materials)
+			{
+				if (material->Name() == materialName)
+				{
+					meshData.Material = material;
+					break;
+				}
+			}
+
+			MeshSpans spans;
+			spans.Vertices = MapBlob<XMFLOAT3>(*file, record.Vertices, blobsOffset);
+			spans.Normals = MapBlob<XMFLOAT3>(*file, record.Normals, blobsOffset);
+			spans.Tangents = MapBlob<XMFLOAT3>(*file, record.Tangents, blobsOffset);
+			spans.BiNormals = MapBlob<XMFLOAT3>(*file, record.BiNormals, blobsOffset);
+			spans.Indices = MapBlob<uint32_t>(*file, record.Indices, blobsOffset);
+
+			uint64_t channelOffset = ChannelsOffset(header) + static_cast<uint64_t>(record.FirstChannel) * sizeof(BlobRecord);
+			for (uint32_t j = 0; j < record.TextureCoordinateChannelCount; ++j, channelOffset += sizeof(BlobRecord))
+			{
+				spans.TextureCoordinates.push_back(MapBlob<XMFLOAT3>(*file, ReadRecord<BlobRecord>(*file, channelOffset), blobsOffset));
+			}
+
+			for (uint32_t j = 0; j < record.VertexColorChannelCount; ++j, channelOffset += sizeof(BlobRecord))
+			{
+				spans.VertexColors.push_back(MapBlob<XMFLOAT4>(*file, ReadRecord<BlobRecord>(*file, channelOffset), blobsOffset));
+			}
+
+			// Formats this build does not know are skipped; those it knows must hold whole vertices for every position
+			for (uint32_t j = 0; j < record.LayoutCount; ++j)
+			{
+				const LayoutRecord layout = ReadRecord<LayoutRecord>(*file, LayoutsOffset(header) + static_cast<uint64_t>(record.FirstLayout + j) * sizeof(LayoutRecord));
+				if (layout.Format >= static_cast<uint32_t>(VertexFormat::End))
+				{
+					continue;
+				}
+
+				const VertexFormat format = static_cast<VertexFormat>(layout.Format);
+				if (layout.Stride != VertexFormatHelper::Stride(format) || layout.Vertices.Count != static_cast<uint64_t>(spans.Vertices.Size()) * layout.Stride)
+				{
+					throw GameException("Model file is corrupt.");
+				}
+
+				spans.InterleavedVertices[format] = MapBlob<uint8_t>(*file, layout.Vertices, blobsOffset);
+			}
+
+			modelData.Meshes.push_back(make_shared<Mesh>(model, move(meshData), move(spans), file));
+		}
+
+		return modelData;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Library
+{
+	class Model;
+	class MemoryMappedFile;
+	struct ModelData;
+
+	// The mapped model layout: a header and fixed-size records, a string table, then every vertex stream and index list
+	// as a contiguous blob aligned to BlobAlignment, including any interleaved vertex layouts the mesh was baked into.
+	// Loading maps the file and points each mesh's spans at its blobs, so nothing past the records and strings is copied.
+	class ModelFile final
+	{
+	public:
+		static const std::uint32_t Magic;
+		static const std::uint32_t Version;
+		static const std::uint32_t BlobAlignment = 16;
+
+		ModelFile() = delete;
+		ModelFile(const ModelFile&) = delete;
+		ModelFile& operator=(const ModelFile&) = delete;
+		ModelFile(ModelFile&&) = delete;
+		ModelFile& operator=(ModelFile&&) = delete;
+		~ModelFile() = default;
+
+		static bool IsModelFile(const MemoryMappedFile& file);
+		static void Save(const Model& model, const std::string& filename);
+		static ModelData Load(Model& model, const std::shared_ptr<const MemoryMappedFile>& file);
+	};
+}
@@ -88,11 +88,7 @@ void ModelMaterial::Save(OutputStreamHelper& streamHelper) const
 	for (const auto& texturePair : mData.Textures)
 	{
 		streamHelper << static_cast<int32_t>(texturePair.first);
-		streamHelper << static_cast<uint32_t>(texturePair.second->size());
-		for (const auto& texture : *(texturePair.second))
-		{
-			streamHelper << texture;
-		}
+		streamHelper.WriteArray(*texturePair.second);
 	}
 }
 
@@ -109,15 +105,6 @@ void ModelMaterial::Load(InputStreamHelper& streamHelper)
 
 		vector<string>* textures = new vector<string>();
 		mData.Textures.insert(pair<TextureType, vector<string>*>(TextureType(textureType), textures));
-
-		uint32_t textureListCount;
-		streamHelper >> textureListCount;
-		textures->reserve(textureListCount);
-		for (uint32_t j = 0; j < textureListCount; j++)
-		{
-			string texture;
-			streamHelper >> texture;
-			textures->push_back(texture);
-		}	
+		streamHelper.ReadArray(*textures);
 	}
 }
\ No newline at end of file
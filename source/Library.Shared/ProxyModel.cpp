@@ -134,9 +134,9 @@ namespace Library
 
 		// Create vertex and index buffers for the model
 		Mesh* mesh = model.Meshes().at(0).get();
-		CreateVertexBuffer(mGame->Direct3DDevice(), *mesh, mVertexBuffer.GetAddressOf());
+		mesh->CreateVertexBuffer(*mGame->Direct3DDevice(), VertexFormat::PositionColor, mVertexBuffer.GetAddressOf());
 		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mIndexBuffer.ReleaseAndGetAddressOf());
-		mIndexCount = static_cast<UINT>(mesh->Indices().size());
+		mIndexCount = mesh->Spans().Indices.Size();
 	}
 
 	void ProxyModel::Update(const GameTime& gameTime)
@@ -153,75 +153,46 @@ namespace Library
 	}
 
 	void ProxyModel::Draw(const GameTime& gameTime)
+	{
+		Record(gameTime, mGame->Direct3DDeviceContext());
+	}
+
+	bool ProxyModel::CanRecordDeferred() const
+	{
+		return true;
+	}
+
+	void ProxyModel::Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext)
 	{
 		UNREFERENCED_PARAMETER(gameTime);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
+		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		deviceContext->IASetInputLayout(mInputLayout.Get());
 
 		UINT stride = sizeof(VertexPositionColor);
 		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+		deviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
+		deviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
+		deviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
+		deviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
 
 		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
 		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
 		XMStoreFloat4x4(&mVertexCBufferPerObjectData.WorldViewProjection, XMMatrixTranspose(wvp));
 
-		direct3DDeviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
-		direct3DDeviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
+		deviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
+		deviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
 
 		if (mDisplayWireframe)
 		{
-			mGame->Direct3DDeviceContext()->RSSetState(RasterizerStates::Wireframe.Get());
-			direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
-			mGame->Direct3DDeviceContext()->RSSetState(nullptr);
+			deviceContext->RSSetState(RasterizerStates::Wireframe.Get());
+			deviceContext->DrawIndexed(mIndexCount, 0, 0);
+			deviceContext->RSSetState(nullptr);
 		}
 		else
 		{
-			direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
+			deviceContext->DrawIndexed(mIndexCount, 0, 0);
 		}
 	}
-
-	void ProxyModel::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
-	{
-		const std::vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-
-		std::vector<VertexPositionColor> vertices;
-		vertices.reserve(sourceVertices.size());
-		if (mesh.VertexColors().size() > 0)
-		{
-			std::vector<XMFLOAT4>* vertexColors = mesh.VertexColors().at(0);
-			assert(vertexColors->size() == sourceVertices.size());
-
-			for (UINT i = 0; i < sourceVertices.size(); i++)
-			{
-				const XMFLOAT3& position = sourceVertices.at(i);
-				const XMFLOAT4& color = vertexColors->at(i);
-				vertices.push_back(VertexPositionColor(XMFLOAT4(position.x, position.y, position.z, 1.0f), color));
-			}
-		}
-		else
-		{
-			XMFLOAT4 color = XMFLOAT4(reinterpret_cast<const float*>(&Colors::White));
-			for (UINT i = 0; i < sourceVertices.size(); i++)
-			{
-				const XMFLOAT3& position = sourceVertices.at(i);
-				vertices.push_back(VertexPositionColor(XMFLOAT4(position.x, position.y, position.z, 1.0f), color));
-			}
-		}
-
-		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.ByteWidth = sizeof(VertexPositionColor) * static_cast<UINT>(vertices.size());
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = &vertices[0];
-		ThrowIfFailed(device->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
-	}
 }
\ No newline at end of file
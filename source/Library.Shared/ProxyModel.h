@@ -43,6 +43,8 @@ namespace Library
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;		
 		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool CanRecordDeferred() const override;
+		virtual void Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext) override;
 
 	private:
 		struct VertexCBufferPerObject
@@ -54,8 +56,6 @@ namespace Library
 			VertexCBufferPerObject(const DirectX::XMFLOAT4X4& wvp) : WorldViewProjection(wvp) { }
 		};
 
-		void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const;
-
 		DirectX::XMFLOAT4X4 mWorldMatrix;
 		DirectX::XMFLOAT4X4 mScaleMatrix;
 		DirectX::XMFLOAT3 mPosition;
@@ -0,0 +1,37 @@
+#include "pch.h"
+#include "RecordingScheduler.h"
+
+using namespace std;
+
+namespace Library
+{
+	void RecordingScheduler::Run(JobSystem& jobSystem, ICommandRecorder& recorder, uint32_t passCount)
+	{
+		if (passCount == 0)
+		{
+			return;
+		}
+
+		const uint32_t contextCount = min(recorder.ContextCount(), passCount);
+		assert(contextCount > 0);
+
+		// Each context is one job, which records its passes in order, so no context is ever shared between threads. Passes
+		// are dealt out round-robin, which keeps neighbouring (often similarly sized) passes on different cores.
+		jobSystem.ParallelFor(0, contextCount, 1, [&recorder, passCount, contextCount](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t context = begin; context < end; ++context)
+			{
+				for (uint32_t pass = context; pass < passCount; pass += contextCount)
+				{
+					recorder.RecordPass(pass, context);
+				}
+			}
+		});
+
+		// Submission order is the pass order, whichever thread finished first
+		for (uint32_t pass = 0; pass < passCount; ++pass)
+		{
+			recorder.ExecutePass(pass);
+		}
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Library
+{
+	class ICommandRecorder;
+	class JobSystem;
+
+	class RecordingScheduler final
+	{
+	public:
+		RecordingScheduler() = delete;
+		RecordingScheduler(const RecordingScheduler&) = delete;
+		RecordingScheduler& operator=(const RecordingScheduler&) = delete;
+		RecordingScheduler(RecordingScheduler&&) = delete;
+		RecordingScheduler& operator=(RecordingScheduler&&) = delete;
+		~RecordingScheduler() = default;
+
+		static void Run(JobSystem& jobSystem, ICommandRecorder& recorder, std::uint32_t passCount);
+	};
+}
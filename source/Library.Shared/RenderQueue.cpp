@@ -0,0 +1,336 @@
+#include "pch.h"
+#include "RenderQueue.h"
+
+using namespace std;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(RenderQueue)
+
+	const uint32_t DrawPacket::VertexBufferCount;
+	const uint32_t DrawPacket::ConstantBufferCount;
+	const uint32_t RenderQueue::MinimumPassSize = 128;
+	const uint64_t RenderQueue::CommandKeyBit = 1ULL << 55;
+
+	DrawPacket::DrawPacket() :
+		Topology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST), InputLayout(nullptr), VertexBuffers(), VertexStrides(), IndexBuffer(nullptr), IndexFormat(DXGI_FORMAT_R32_UINT),
+		VertexShader(nullptr), PixelShader(nullptr), VSConstantBuffers(), PSConstantBuffers(), PSShaderResource(nullptr), PSSampler(nullptr),
+		ObjectConstantBuffer(nullptr), IndexCount(0), InstanceCount(1), StartInstance(0), Depth(0.0f)
+	{
+	}
+
+	RenderQueueStats::RenderQueueStats() :
+		Packets(0), Commands(0), StateChangesRequested(0), StateChangesApplied(0), ConstantUpdatesRequested(0), ConstantUpdatesApplied(0)
+	{
+	}
+
+	uint32_t RenderQueueStats::StateChangesEliminated() const
+	{
+		return StateChangesRequested - StateChangesApplied;
+	}
+
+	uint32_t RenderQueueStats::ConstantUpdatesEliminated() const
+	{
+		return ConstantUpdatesRequested - ConstantUpdatesApplied;
+	}
+
+	RenderQueue::PassState::PassState() :
+		LastConstants(), LastConstantBuffer(nullptr), LastConstantsOffset(0), LastConstantsSize(0), UsesConstantBufferRing(false)
+	{
+	}
+
+	RenderQueue::RenderQueue() :
+		mConstantBufferRing(nullptr)
+	{
+	}
+
+	void RenderQueue::Submit(RenderLayer layer, const DrawPacket& packet, const void* objectConstants, uint32_t objectConstantsSize)
+	{
+		assert(packet.VertexShader != nullptr && packet.PixelShader != nullptr && packet.IndexBuffer != nullptr);
+		assert(objectConstantsSize == 0 || (objectConstants != nullptr && packet.ObjectConstantBuffer != nullptr));
+
+		// Per-object constants are copied now and uploaded just before the packet is drawn, wherever it ends up in the order
+		const QueueEntry entry = { SortKey(layer, packet), static_cast<uint32_t>(mEntries.size()), static_cast<uint32_t>(mPackets.size()), static_cast<uint32_t>(mObjectConstants.size()), objectConstantsSize };
+		if (objectConstantsSize > 0)
+		{
+			const char* constants = static_cast<const char*>(objectConstants);
+			mObjectConstants.insert(mObjectConstants.end(), constants, constants + objectConstantsSize);
+		}
+
+		mPackets.push_back(packet);
+		mEntries.push_back(entry);
+	}
+
+	void RenderQueue::Submit(RenderLayer layer, const Command& command)
+	{
+		// Commands follow the packets of their layer, in the order they were submitted
+		const QueueEntry entry = { (static_cast<uint64_t>(layer) << 56) | CommandKeyBit, static_cast<uint32_t>(mEntries.size()), static_cast<uint32_t>(mCommands.size()), 0, 0 };
+		mCommands.push_back(command);
+		mEntries.push_back(entry);
+	}
+
+	void RenderQueue::Execute(ID3D11DeviceContext1* deviceContext)
+	{
+		assert(deviceContext != nullptr);
+
+		Sort();
+		PreparePasses(1, UsesConstantBufferRing());
+		ExecutePass(0, Size(), deviceContext, *mPassStates.front());
+		FinishPasses(1);
+	}
+
+	void RenderQueue::Execute(ID3D11DeviceContext1* deviceContext, DeferredContextRecorder& recorder, JobSystem& jobSystem)
+	{
+		assert(deviceContext != nullptr);
+		assert(recorder.PassCount() == 0);
+
+		// About one pass per context, but none so short that recording it costs more than it saves. A queue that makes one
+		// pass or none gains nothing from a command list, so it is drawn on the immediate context, ring and all.
+		const uint32_t entryCount = Size();
+		const uint32_t passCount = min(recorder.ContextCount(), (entryCount + MinimumPassSize - 1) / MinimumPassSize);
+		if (passCount <= 1)
+		{
+			Execute(deviceContext);
+			return;
+		}
+
+		// The ring is left to the immediate context, since a deferred one could only map it by discarding blocks other
+		// passes still read; packets upload into their own constant buffers instead.
+		Sort();
+		PreparePasses(passCount, false);
+		for (uint32_t pass = 0; pass < passCount; ++pass)
+		{
+			const uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(entryCount) * pass / passCount);
+			const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(entryCount) * (pass + 1) / passCount);
+			PassState* state = mPassStates[pass].get();
+			recorder.AddPass([this, begin, end, state](ID3D11DeviceContext1* deviceContext)
+			{
+				ExecutePass(begin, end, deviceContext, *state);
+			});
+		}
+
+		// Passes are played back in order, so the sorted order survives the split
+		RecordingScheduler::Run(jobSystem, recorder, passCount);
+		recorder.Clear();
+		FinishPasses(passCount);
+	}
+
+	void RenderQueue::Clear()
+	{
+		mEntries.clear();
+		mPackets.clear();
+		mCommands.clear();
+		mObjectConstants.clear();
+	}
+
+	void RenderQueue::SetConstantBufferRing(ConstantBufferRing* constantBufferRing)
+	{
+		mConstantBufferRing = constantBufferRing;
+	}
+
+	uint32_t RenderQueue::Size() const
+	{
+		return static_cast<uint32_t>(mEntries.size());
+	}
+
+	const RenderQueueStats& RenderQueue::Stats() const
+	{
+		return mStats;
+	}
+
+	uint64_t RenderQueue::SortKey(RenderLayer layer, const DrawPacket& packet)
+	{
+		// Positive floats order the same as their bit patterns, so the upper half of the bits is a coarse depth
+		const float depth = max(packet.Depth, 0.0f);
+		uint32_t depthBits;
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+
+		// Layer (8 bits), command bit, pixel shader (7), vertex shader (6), texture (14), vertex buffer (12), depth (16); pixel
+		// shader changes cost the most, so they are the ones grouped first
+		return (static_cast<uint64_t>(layer) << 56) |
+			(static_cast<uint64_t>(ResourceId(packet.PixelShader, 7)) << 48) |
+			(static_cast<uint64_t>(ResourceId(packet.VertexShader, 6)) << 42) |
+			(static_cast<uint64_t>(ResourceId(packet.PSShaderResource, 14)) << 28) |
+			(static_cast<uint64_t>(ResourceId(packet.VertexBuffers[0], 12)) << 16) |
+			(depthBits >> 16);
+	}
+
+	uint32_t RenderQueue::ResourceId(const void* resource, uint32_t bits)
+	{
+		if (resource == nullptr)
+		{
+			return 0;
+		}
+
+		// Ids are handed out in the order resources are first seen and kept across frames, so the order is stable. Past the
+		// width of a field ids wrap, which only costs some grouping.
+		auto id = mResourceIds.insert(make_pair(resource, static_cast<uint32_t>(mResourceIds.size()) + 1));
+		return id.first->second & ((1U << bits) - 1);
+	}
+
+	void RenderQueue::Sort()
+	{
+		// Packets sharing shaders, textures and buffers end up next to each other, nearest first within a group
+		sort(mEntries.begin(), mEntries.end(), [](const QueueEntry& lhs, const QueueEntry& rhs)
+		{
+			return lhs.SortKey < rhs.SortKey || (lhs.SortKey == rhs.SortKey && lhs.Sequence < rhs.Sequence);
+		});
+	}
+
+	void RenderQueue::PreparePasses(uint32_t passCount, bool usesConstantBufferRing)
+	{
+		// Pass states are kept across frames; they only ever hold pointers the queue is handed again each frame
+		while (mPassStates.size() < passCount)
+		{
+			mPassStates.push_back(make_unique<PassState>());
+		}
+
+		for (uint32_t pass = 0; pass < passCount; ++pass)
+		{
+			mPassStates[pass]->UsesConstantBufferRing = usesConstantBufferRing;
+		}
+	}
+
+	void RenderQueue::ExecutePass(uint32_t begin, uint32_t end, ID3D11DeviceContext1* deviceContext, PassState& state)
+	{
+		assert(deviceContext != nullptr);
+		assert(begin <= end && end <= mEntries.size());
+
+		// Whatever was bound before the pass ran is unknown to the cache, so the first packet binds everything it uses
+		state.Stats = RenderQueueStats();
+		state.StateCache.Reset(deviceContext);
+		state.StateCache.ResetCounters();
+		state.LastConstantBuffer = nullptr;
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const QueueEntry& entry = mEntries[i];
+			if ((entry.SortKey & CommandKeyBit) != 0)
+			{
+				// A command may bind anything, so nothing cached can be trusted after it
+				mCommands[entry.Index](deviceContext);
+				state.StateCache.Invalidate();
+				state.LastConstantBuffer = nullptr;
+				++state.Stats.Commands;
+			}
+			else
+			{
+				ExecutePacket(mPackets[entry.Index], entry, deviceContext, state);
+				++state.Stats.Packets;
+			}
+		}
+
+		state.Stats.StateChangesRequested = state.StateCache.RequestedChanges();
+		state.Stats.StateChangesApplied = state.StateCache.AppliedChanges();
+	}
+
+	void RenderQueue::FinishPasses(uint32_t passCount)
+	{
+		RenderQueueStats stats;
+		for (uint32_t pass = 0; pass < passCount; ++pass)
+		{
+			const RenderQueueStats& passStats = mPassStates[pass]->Stats;
+			stats.Packets += passStats.Packets;
+			stats.Commands += passStats.Commands;
+			stats.StateChangesRequested += passStats.StateChangesRequested;
+			stats.StateChangesApplied += passStats.StateChangesApplied;
+			stats.ConstantUpdatesRequested += passStats.ConstantUpdatesRequested;
+			stats.ConstantUpdatesApplied += passStats.ConstantUpdatesApplied;
+		}
+
+		mStats = stats;
+		Clear();
+	}
+
+	void RenderQueue::ExecutePacket(const DrawPacket& packet, const QueueEntry& entry, ID3D11DeviceContext* deviceContext, PassState& state)
+	{
+		RenderStateCache& stateCache = state.StateCache;
+		RenderQueueStats& stats = state.Stats;
+
+		stateCache.SetPrimitiveTopology(packet.Topology);
+		stateCache.SetInputLayout(packet.InputLayout);
+
+		for (UINT slot = 0; slot < DrawPacket::VertexBufferCount; ++slot)
+		{
+			if (packet.VertexBuffers[slot] != nullptr)
+			{
+				stateCache.SetVertexBuffer(slot, packet.VertexBuffers[slot], packet.VertexStrides[slot], 0);
+			}
+		}
+
+		stateCache.SetIndexBuffer(packet.IndexBuffer, packet.IndexFormat, 0);
+		stateCache.SetVertexShader(packet.VertexShader);
+		stateCache.SetPixelShader(packet.PixelShader);
+
+		// An upload is skipped when the buffer already holds the same bytes. With a ring the constants get a fresh block
+		// of it instead, and the packet's object buffer is bound as that block wherever it appears.
+		const bool usesRing = (entry.ConstantsSize > 0 && state.UsesConstantBufferRing);
+		if (entry.ConstantsSize > 0)
+		{
+			++stats.ConstantUpdatesRequested;
+
+			const char* constants = &mObjectConstants[entry.ConstantsOffset];
+			if (packet.ObjectConstantBuffer != state.LastConstantBuffer || entry.ConstantsSize != state.LastConstantsSize || memcmp(constants, &mObjectConstants[state.LastConstantsOffset], entry.ConstantsSize) != 0)
+			{
+				if (usesRing)
+				{
+					state.LastConstants = mConstantBufferRing->Upload(deviceContext, constants, entry.ConstantsSize);
+				}
+				else
+				{
+					deviceContext->UpdateSubresource(packet.ObjectConstantBuffer, 0, nullptr, constants, 0, 0);
+				}
+
+				state.LastConstantBuffer = packet.ObjectConstantBuffer;
+				state.LastConstantsOffset = entry.ConstantsOffset;
+				state.LastConstantsSize = entry.ConstantsSize;
+				++stats.ConstantUpdatesApplied;
+			}
+		}
+
+		for (UINT slot = 0; slot < DrawPacket::ConstantBufferCount; ++slot)
+		{
+			if (usesRing && packet.VSConstantBuffers[slot] == packet.ObjectConstantBuffer)
+			{
+				stateCache.SetVSConstantBuffer(slot, state.LastConstants.Buffer, state.LastConstants.FirstConstant, state.LastConstants.ConstantCount);
+			}
+			else if (packet.VSConstantBuffers[slot] != nullptr)
+			{
+				stateCache.SetVSConstantBuffer(slot, packet.VSConstantBuffers[slot]);
+			}
+
+			if (usesRing && packet.PSConstantBuffers[slot] == packet.ObjectConstantBuffer)
+			{
+				stateCache.SetPSConstantBuffer(slot, state.LastConstants.Buffer, state.LastConstants.FirstConstant, state.LastConstants.ConstantCount);
+			}
+			else if (packet.PSConstantBuffers[slot] != nullptr)
+			{
+				stateCache.SetPSConstantBuffer(slot, packet.PSConstantBuffers[slot]);
+			}
+		}
+
+		if (packet.PSShaderResource != nullptr)
+		{
+			stateCache.SetPSShaderResource(0, packet.PSShaderResource);
+		}
+
+		if (packet.PSSampler != nullptr)
+		{
+			stateCache.SetPSSampler(0, packet.PSSampler);
+		}
+
+		if (packet.InstanceCount == 1 && packet.StartInstance == 0)
+		{
+			deviceContext->DrawIndexed(packet.IndexCount, 0, 0);
+		}
+		else
+		{
+			deviceContext->DrawIndexedInstanced(packet.IndexCount, packet.InstanceCount, 0, 0, packet.StartInstance);
+		}
+	}
+
+	bool RenderQueue::UsesConstantBufferRing() const
+	{
+		return (mConstantBufferRing != nullptr && mConstantBufferRing->IsAvailable());
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "RTTI.h"
+#include "RenderStateCache.h"
+#include "ConstantBufferRing.h"
+#include <d3d11_2.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Library
+{
+	class DeferredContextRecorder;
+	class JobSystem;
+
+	enum class RenderLayer : std::uint8_t
+	{
+		Opaque = 0,
+		Background,
+		Overlay
+	};
+
+	struct DrawPacket
+	{
+		static const std::uint32_t VertexBufferCount = 2;
+		static const std::uint32_t ConstantBufferCount = 2;
+
+		D3D11_PRIMITIVE_TOPOLOGY Topology;
+		ID3D11InputLayout* InputLayout;
+		ID3D11Buffer* VertexBuffers[VertexBufferCount];
+		UINT VertexStrides[VertexBufferCount];
+		ID3D11Buffer* IndexBuffer;
+		DXGI_FORMAT IndexFormat;
+		ID3D11VertexShader* VertexShader;
+		ID3D11PixelShader* PixelShader;
+		ID3D11Buffer* VSConstantBuffers[ConstantBufferCount];
+		ID3D11Buffer* PSConstantBuffers[ConstantBufferCount];
+		ID3D11ShaderResourceView* PSShaderResource;
+		ID3D11SamplerState* PSSampler;
+		ID3D11Buffer* ObjectConstantBuffer;
+		UINT IndexCount;
+		UINT InstanceCount;
+		UINT StartInstance;
+		float Depth;
+
+		DrawPacket();
+	};
+
+	struct RenderQueueStats
+	{
+		std::uint32_t Packets;
+		std::uint32_t Commands;
+		std::uint32_t StateChangesRequested;
+		std::uint32_t StateChangesApplied;
+		std::uint32_t ConstantUpdatesRequested;
+		std::uint32_t ConstantUpdatesApplied;
+
+		RenderQueueStats();
+
+		std::uint32_t StateChangesEliminated() const;
+		std::uint32_t ConstantUpdatesEliminated() const;
+	};
+
+	class RenderQueue final : public RTTI
+	{
+		RTTI_DECLARATIONS(RenderQueue, RTTI)
+
+	public:
+		typedef std::function<void(ID3D11DeviceContext1* deviceContext)> Command;
+
+		static const std::uint32_t MinimumPassSize;
+
+		RenderQueue();
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+		RenderQueue(RenderQueue&&) = delete;
+		RenderQueue& operator=(RenderQueue&&) = delete;
+		~RenderQueue() = default;
+
+		void Submit(RenderLayer layer, const DrawPacket& packet, const void* objectConstants = nullptr, std::uint32_t objectConstantsSize = 0);
+		void Submit(RenderLayer layer, const Command& command);
+
+		void Execute(ID3D11DeviceContext1* deviceContext);
+		void Execute(ID3D11DeviceContext1* deviceContext, DeferredContextRecorder& recorder, JobSystem& jobSystem);
+		void Clear();
+
+		void SetConstantBufferRing(ConstantBufferRing* constantBufferRing);
+
+		std::uint32_t Size() const;
+		const RenderQueueStats& Stats() const;
+
+	private:
+		struct QueueEntry
+		{
+			std::uint64_t SortKey;
+			std::uint32_t Sequence;
+			std::uint32_t Index;
+			std::uint32_t ConstantsOffset;
+			std::uint32_t ConstantsSize;
+		};
+
+		// What a pass knows about the context it draws on; passes recorded in parallel each have their own
+		struct PassState
+		{
+			RenderStateCache StateCache;
+			RenderQueueStats Stats;
+			ConstantBufferAllocation LastConstants;
+			ID3D11Buffer* LastConstantBuffer;
+			std::uint32_t LastConstantsOffset;
+			std::uint32_t LastConstantsSize;
+			bool UsesConstantBufferRing;
+
+			PassState();
+		};
+
+		static const std::uint64_t CommandKeyBit;
+
+		std::uint64_t SortKey(RenderLayer layer, const DrawPacket& packet);
+		std::uint32_t ResourceId(const void* resource, std::uint32_t bits);
+		void Sort();
+		void PreparePasses(std::uint32_t passCount, bool usesConstantBufferRing);
+		void ExecutePass(std::uint32_t begin, std::uint32_t end, ID3D11DeviceContext1* deviceContext, PassState& state);
+		void ExecutePacket(const DrawPacket& packet, const QueueEntry& entry, ID3D11DeviceContext* deviceContext, PassState& state);
+		void FinishPasses(std::uint32_t passCount);
+		bool UsesConstantBufferRing() const;
+
+		std::vector<QueueEntry> mEntries;
+		std::vector<DrawPacket> mPackets;
+		std::vector<Command> mCommands;
+		std::vector<char> mObjectConstants;
+		std::unordered_map<const void*, std::uint32_t> mResourceIds;
+		std::vector<std::unique_ptr<PassState>> mPassStates;
+		RenderQueueStats mStats;
+		ConstantBufferRing* mConstantBufferRing;
+	};
+}
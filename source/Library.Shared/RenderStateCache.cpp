@@ -0,0 +1,183 @@
+#include "pch.h"
+#include "RenderStateCache.h"
+
+using namespace std;
+
+namespace Library
+{
+	const uint32_t RenderStateCache::SlotCount;
+
+	RenderStateCache::RenderStateCache() :
+		mDeviceContext(nullptr), mRequestedChanges(0), mAppliedChanges(0)
+	{
+		Invalidate();
+	}
+
+	void RenderStateCache::Reset(ID3D11DeviceContext1* deviceContext)
+	{
+		mDeviceContext = deviceContext;
+		Invalidate();
+	}
+
+	void RenderStateCache::Invalidate()
+	{
+		// Nothing is assumed about what is bound, so the next change to each state always reaches the context
+		mTopology.Known = false;
+		mInputLayout.Known = false;
+		mIndexBuffer.Known = false;
+		mVertexShader.Known = false;
+		mPixelShader.Known = false;
+
+		for (uint32_t slot = 0; slot < SlotCount; ++slot)
+		{
+			mVertexBuffers[slot].Known = false;
+			mVSConstantBuffers[slot].Known = false;
+			mPSConstantBuffers[slot].Known = false;
+			mPSShaderResources[slot].Known = false;
+			mPSSamplers[slot].Known = false;
+		}
+	}
+
+	void RenderStateCache::SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+	{
+		if (Change(mTopology, topology))
+		{
+			mDeviceContext->IASetPrimitiveTopology(topology);
+		}
+	}
+
+	void RenderStateCache::SetInputLayout(ID3D11InputLayout* inputLayout)
+	{
+		if (Change(mInputLayout, inputLayout))
+		{
+			mDeviceContext->IASetInputLayout(inputLayout);
+		}
+	}
+
+	void RenderStateCache::SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset)
+	{
+		assert(slot < SlotCount);
+
+		const VertexBufferBinding binding = { buffer, stride, offset };
+		if (Change(mVertexBuffers[slot], binding))
+		{
+			mDeviceContext->IASetVertexBuffers(slot, 1, &buffer, &stride, &offset);
+		}
+	}
+
+	void RenderStateCache::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset)
+	{
+		const IndexBufferBinding binding = { buffer, format, offset };
+		if (Change(mIndexBuffer, binding))
+		{
+			mDeviceContext->IASetIndexBuffer(buffer, format, offset);
+		}
+	}
+
+	void RenderStateCache::SetVertexShader(ID3D11VertexShader* shader)
+	{
+		if (Change(mVertexShader, shader))
+		{
+			mDeviceContext->VSSetShader(shader, nullptr, 0);
+		}
+	}
+
+	void RenderStateCache::SetPixelShader(ID3D11PixelShader* shader)
+	{
+		if (Change(mPixelShader, shader))
+		{
+			mDeviceContext->PSSetShader(shader, nullptr, 0);
+		}
+	}
+
+	void RenderStateCache::SetVSConstantBuffer(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT constantCount)
+	{
+		assert(slot < SlotCount);
+
+		// A constant count of zero binds the whole buffer
+		const ConstantBufferBinding binding = { buffer, firstConstant, constantCount };
+		if (Change(mVSConstantBuffers[slot], binding))
+		{
+			if (constantCount == 0)
+			{
+				mDeviceContext->VSSetConstantBuffers(slot, 1, &buffer);
+			}
+			else
+			{
+				mDeviceContext->VSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &constantCount);
+			}
+		}
+	}
+
+	void RenderStateCache::SetPSConstantBuffer(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT constantCount)
+	{
+		assert(slot < SlotCount);
+
+		const ConstantBufferBinding binding = { buffer, firstConstant, constantCount };
+		if (Change(mPSConstantBuffers[slot], binding))
+		{
+			if (constantCount == 0)
+			{
+				mDeviceContext->PSSetConstantBuffers(slot, 1, &buffer);
+			}
+			else
+			{
+				mDeviceContext->PSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &constantCount);
+			}
+		}
+	}
+
+	void RenderStateCache::SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* shaderResource)
+	{
+		assert(slot < SlotCount);
+
+		if (Change(mPSShaderResources[slot], shaderResource))
+		{
+			mDeviceContext->PSSetShaderResources(slot, 1, &shaderResource);
+		}
+	}
+
+	void RenderStateCache::SetPSSampler(UINT slot, ID3D11SamplerState* sampler)
+	{
+		assert(slot < SlotCount);
+
+		if (Change(mPSSamplers[slot], sampler))
+		{
+			mDeviceContext->PSSetSamplers(slot, 1, &sampler);
+		}
+	}
+
+	uint32_t RenderStateCache::RequestedChanges() const
+	{
+		return mRequestedChanges;
+	}
+
+	uint32_t RenderStateCache::AppliedChanges() const
+	{
+		return mAppliedChanges;
+	}
+
+	void RenderStateCache::ResetCounters()
+	{
+		mRequestedChanges = 0;
+		mAppliedChanges = 0;
+	}
+
+	template <typename T>
+	bool RenderStateCache::Change(CachedState<T>& state, const T& value)
+	{
+		assert(mDeviceContext != nullptr);
+
+		++mRequestedChanges;
+		if (state.Known && !(state.Value != value))
+		{
+			return false;
+		}
+
+		state.Value = value;
+		state.Known = true;
+		++mAppliedChanges;
+
+		return true;
+	}
+}
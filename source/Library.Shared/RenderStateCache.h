@@ -0,0 +1,90 @@
+#pragma once
+
+#include <d3d11_2.h>
+#include <cstdint>
+
+namespace Library
+{
+	class RenderStateCache final
+	{
+	public:
+		static const std::uint32_t SlotCount = 4;
+
+		RenderStateCache();
+		RenderStateCache(const RenderStateCache&) = delete;
+		RenderStateCache& operator=(const RenderStateCache&) = delete;
+		RenderStateCache(RenderStateCache&&) = delete;
+		RenderStateCache& operator=(RenderStateCache&&) = delete;
+		~RenderStateCache() = default;
+
+		void Reset(ID3D11DeviceContext1* deviceContext);
+		void Invalidate();
+
+		void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+		void SetInputLayout(ID3D11InputLayout* inputLayout);
+		void SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset);
+		void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset);
+		void SetVertexShader(ID3D11VertexShader* shader);
+		void SetPixelShader(ID3D11PixelShader* shader);
+		void SetVSConstantBuffer(UINT slot, ID3D11Buffer* buffer, UINT firstConstant = 0, UINT constantCount = 0);
+		void SetPSConstantBuffer(UINT slot, ID3D11Buffer* buffer, UINT firstConstant = 0, UINT constantCount = 0);
+		void SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* shaderResource);
+		void SetPSSampler(UINT slot, ID3D11SamplerState* sampler);
+
+		std::uint32_t RequestedChanges() const;
+		std::uint32_t AppliedChanges() const;
+		void ResetCounters();
+
+	private:
+		template <typename T>
+		struct CachedState
+		{
+			T Value;
+			bool Known;
+		};
+
+		struct VertexBufferBinding
+		{
+			ID3D11Buffer* Buffer;
+			UINT Stride;
+			UINT Offset;
+
+			bool operator!=(const VertexBufferBinding& rhs) const { return Buffer != rhs.Buffer || Stride != rhs.Stride || Offset != rhs.Offset; }
+		};
+
+		struct IndexBufferBinding
+		{
+			ID3D11Buffer* Buffer;
+			DXGI_FORMAT Format;
+			UINT Offset;
+
+			bool operator!=(const IndexBufferBinding& rhs) const { return Buffer != rhs.Buffer || Format != rhs.Format || Offset != rhs.Offset; }
+		};
+
+		struct ConstantBufferBinding
+		{
+			ID3D11Buffer* Buffer;
+			UINT FirstConstant;
+			UINT ConstantCount;
+
+			bool operator!=(const ConstantBufferBinding& rhs) const { return Buffer != rhs.Buffer || FirstConstant != rhs.FirstConstant || ConstantCount != rhs.ConstantCount; }
+		};
+
+		template <typename T>
+		bool Change(CachedState<T>& state, const T& value);
+
+		ID3D11DeviceContext1* mDeviceContext;
+		CachedState<D3D11_PRIMITIVE_TOPOLOGY> mTopology;
+		CachedState<ID3D11InputLayout*> mInputLayout;
+		CachedState<VertexBufferBinding> mVertexBuffers[SlotCount];
+		CachedState<IndexBufferBinding> mIndexBuffer;
+		CachedState<ID3D11VertexShader*> mVertexShader;
+		CachedState<ID3D11PixelShader*> mPixelShader;
+		CachedState<ConstantBufferBinding> mVSConstantBuffers[SlotCount];
+		CachedState<ConstantBufferBinding> mPSConstantBuffers[SlotCount];
+		CachedState<ID3D11ShaderResourceView*> mPSShaderResources[SlotCount];
+		CachedState<ID3D11SamplerState*> mPSSamplers[SlotCount];
+		std::uint32_t mRequestedChanges;
+		std::uint32_t mAppliedChanges;
+	};
+}
@@ -9,7 +9,7 @@ namespace Library
 
 	Skybox::Skybox(Game& game, const shared_ptr<Camera>& camera, const wstring& cubeMapFileName, float scale) :
 		DrawableGameComponent(game, camera),
-		mCubeMapFileName(cubeMapFileName), mIndexCount(0),
+		mCubeMapFileName(cubeMapFileName), mConstantBufferRing(nullptr), mIndexCount(0),
 		mWorldMatrix(MatrixHelper::Identity), mScaleMatrix(MatrixHelper::Identity)
 	{
 		XMStoreFloat4x4(&mScaleMatrix, XMMatrixScaling(scale, scale, scale));
@@ -41,9 +41,9 @@ namespace Library
 
 		// Create vertex and index buffers for the model
 		Mesh* mesh = model.Meshes().at(0).get();
-		CreateVertexBuffer(mGame->Direct3DDevice(), *mesh, mVertexBuffer.ReleaseAndGetAddressOf());
+		mesh->CreateVertexBuffer(*mGame->Direct3DDevice(), VertexFormat::PositionTexture, mVertexBuffer.ReleaseAndGetAddressOf());
 		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mIndexBuffer.ReleaseAndGetAddressOf());
-		mIndexCount = static_cast<UINT>(mesh->Indices().size());
+		mIndexCount = mesh->Spans().Indices.Size();
 
 		ThrowIfFailed(DirectX::CreateDDSTextureFromFile(mGame->Direct3DDevice(), mCubeMapFileName.c_str(), nullptr, mSkyboxTexture.GetAddressOf()), "CreateDDSTextureFromFile() failed.");
 
@@ -52,6 +52,9 @@ namespace Library
 		constantBufferDesc.ByteWidth = sizeof(mVertexCBufferPerObjectData);
 		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
 		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVertexCBufferPerObject.GetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+
+		// Games that provide a constant buffer ring have the constants written there instead
+		mConstantBufferRing = reinterpret_cast<ConstantBufferRing*>(mGame->Services().GetService(ConstantBufferRing::TypeIdClass()));
 	}
 
 	void Skybox::Update(const GameTime& gameTime)
@@ -63,58 +66,51 @@ namespace Library
 	}
 
 	void Skybox::Draw(const GameTime& gameTime)
+	{
+		Record(gameTime, mGame->Direct3DDeviceContext());
+	}
+
+	bool Skybox::CanRecordDeferred() const
+	{
+		return true;
+	}
+
+	void Skybox::Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext)
 	{
 		UNREFERENCED_PARAMETER(gameTime);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
+		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		deviceContext->IASetInputLayout(mInputLayout.Get());
 
 		UINT stride = sizeof(VertexPositionTexture);
 		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+		deviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
+		deviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
+		deviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
+		deviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
 
 		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
 		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
 		XMStoreFloat4x4(&mVertexCBufferPerObjectData.WorldViewProjection, XMMatrixTranspose(wvp));
 
-		direct3DDeviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
-		direct3DDeviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
-
-		direct3DDeviceContext->PSSetShaderResources(0, 1, mSkyboxTexture.GetAddressOf());
-		direct3DDeviceContext->PSSetSamplers(0, 1, SamplerStates::TrilinearClamp.GetAddressOf());
-
-		direct3DDeviceContext->RSSetState(RasterizerStates::DisabledCulling.Get());
-		direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
-		direct3DDeviceContext->RSSetState(nullptr);
-	}
-
-	void Skybox::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
-	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		vector<XMFLOAT3>* textureCoordinates = mesh.TextureCoordinates().at(0);
-		assert(textureCoordinates->size() == sourceVertices.size());
-
-		vector<VertexPositionTexture> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (UINT i = 0; i < sourceVertices.size(); i++)
+		// The ring is written from the immediate context only; a deferred context could not map it without discarding anyway
+		if (mConstantBufferRing != nullptr && mConstantBufferRing->IsAvailable() && deviceContext == mGame->Direct3DDeviceContext())
+		{
+			const ConstantBufferAllocation constants = mConstantBufferRing->Upload(deviceContext, &mVertexCBufferPerObjectData, sizeof(mVertexCBufferPerObjectData));
+			deviceContext->VSSetConstantBuffers1(0, 1, &constants.Buffer, &constants.FirstConstant, &constants.ConstantCount);
+		}
+		else
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = textureCoordinates->at(i);
-			vertices.push_back(VertexPositionTexture(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y)));
+			deviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
+			deviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
 		}
 
-		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.ByteWidth = static_cast<UINT>(sizeof(VertexPositionTexture) * vertices.size());
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		deviceContext->PSSetShaderResources(0, 1, mSkyboxTexture.GetAddressOf());
+		deviceContext->PSSetSamplers(0, 1, SamplerStates::TrilinearClamp.GetAddressOf());
 
-		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = &vertices[0];
-		ThrowIfFailed(device->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
+		deviceContext->RSSetState(RasterizerStates::DisabledCulling.Get());
+		deviceContext->DrawIndexed(mIndexCount, 0, 0);
+		deviceContext->RSSetState(nullptr);
 	}
 }
\ No newline at end of file
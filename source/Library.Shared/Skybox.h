@@ -8,6 +8,7 @@
 namespace Library
 {
 	class Mesh;
+	class ConstantBufferRing;
 
 	class Skybox final : public DrawableGameComponent
 	{
@@ -25,6 +26,8 @@ namespace Library
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
 		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool CanRecordDeferred() const override;
+		virtual void Record(const GameTime& gameTime, ID3D11DeviceContext1* deviceContext) override;
 
 	private:
 		struct VertexCBufferPerObject
@@ -35,8 +38,6 @@ namespace Library
 			VertexCBufferPerObject(const DirectX::XMFLOAT4X4& wvp) : WorldViewProjection(wvp) { }
 		};
 
-		void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const;
-
 		DirectX::XMFLOAT4X4 mWorldMatrix;
 		DirectX::XMFLOAT4X4 mScaleMatrix;
 		VertexCBufferPerObject mVertexCBufferPerObjectData;
@@ -48,6 +49,7 @@ namespace Library
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mIndexBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexCBufferPerObject;
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mSkyboxTexture;
+		ConstantBufferRing* mConstantBufferRing;
 		UINT mIndexCount;		
 	};
 }
\ No newline at end of file
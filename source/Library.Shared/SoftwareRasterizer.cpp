@@ -0,0 +1,391 @@
+#include "pch.h"
+#include "SoftwareRasterizer.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace Library
+{
+	const uint32_t RasterVertex::MaxVaryings;
+	const uint32_t SoftwareRasterizer::TileSize;
+	const uint32_t SoftwareRasterizer::VertexGrainSize;
+
+	SoftwareRasterizerStats::SoftwareRasterizerStats() :
+		Draws(0), Triangles(0), TrianglesClipped(0), TrianglesCulled(0), TrianglesBinned(0), PixelsShaded(0)
+	{
+	}
+
+	SoftwareRasterizer::SoftwareRasterizer(JobSystem& jobSystem, uint32_t width, uint32_t height) :
+		mJobSystem(&jobSystem), mWidth(width), mHeight(height), mRowPitch((width + 3) & ~3U),
+		mTilesX((width + TileSize - 1) / TileSize), mTilesY((height + TileSize - 1) / TileSize)
+	{
+		if (width == 0 || height == 0)
+		{
+			throw GameException("A software render target needs a width and a height.");
+		}
+
+		// Rows are padded to a whole group of four pixels, so the last group of a row never reads into the next one
+		mColorBuffer.resize(static_cast<size_t>(mRowPitch) * height);
+		mDepthBuffer.resize(static_cast<size_t>(mRowPitch) * height);
+		mTileBins.resize(mTilesX * mTilesY);
+		mTilePixelCounts.resize(mTilesX * mTilesY);
+	}
+
+	uint32_t SoftwareRasterizer::Width() const
+	{
+		return mWidth;
+	}
+
+	uint32_t SoftwareRasterizer::Height() const
+	{
+		return mHeight;
+	}
+
+	uint32_t SoftwareRasterizer::RowPitch() const
+	{
+		return mRowPitch;
+	}
+
+	const uint32_t* SoftwareRasterizer::ColorBuffer() const
+	{
+		return mColorBuffer.data();
+	}
+
+	const float* SoftwareRasterizer::DepthBuffer() const
+	{
+		return mDepthBuffer.data();
+	}
+
+	const SoftwareRasterizerStats& SoftwareRasterizer::Stats() const
+	{
+		return mStats;
+	}
+
+	void SoftwareRasterizer::Clear(FXMVECTOR color, float depth)
+	{
+		// Clears apply at once, so anything drawn before them has to be flushed first
+		assert(mTriangles.empty());
+
+		fill(mColorBuffer.begin(), mColorBuffer.end(), SoftwareTexture::PackColor(color));
+		fill(mDepthBuffer.begin(), mDepthBuffer.end(), depth);
+		mStats = SoftwareRasterizerStats();
+	}
+
+	void SoftwareRasterizer::Draw(const void* vertices, uint32_t vertexStride, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, const ISoftwareShader& shader)
+	{
+		assert(vertices != nullptr && indices != nullptr && vertexStride > 0);
+		assert(shader.VaryingCount() <= RasterVertex::MaxVaryings);
+
+		if (indexCount % 3 != 0)
+		{
+			throw GameException("Software draws take triangle lists only.");
+		}
+
+		++mStats.Draws;
+		mStats.Triangles += indexCount / 3;
+
+		// Each vertex is shaded once, across the job system when there are enough of them to be worth it
+		const char* vertexData = static_cast<const char*>(vertices);
+		mShadedVertices.resize(vertexCount);
+		mJobSystem->ParallelFor(0, vertexCount, VertexGrainSize, [this, &shader, vertexData, vertexStride](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t vertex = begin; vertex < end; ++vertex)
+			{
+				shader.ShadeVertex(vertexData + static_cast<size_t>(vertex) * vertexStride, mShadedVertices[vertex]);
+			}
+		});
+
+		for (uint32_t index = 0; index < indexCount; index += 3)
+		{
+			assert(indices[index] < vertexCount && indices[index + 1] < vertexCount && indices[index + 2] < vertexCount);
+			ClipAndBin(mShadedVertices[indices[index]], mShadedVertices[indices[index + 1]], mShadedVertices[indices[index + 2]], shader);
+		}
+	}
+
+	void SoftwareRasterizer::Flush()
+	{
+		// Tiles share no pixels, so each one is rasterized on its own, walking its bin in submission order
+		const uint32_t tileCount = mTilesX * mTilesY;
+		mJobSystem->ParallelFor(0, tileCount, 1, [this](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t tile = begin; tile < end; ++tile)
+			{
+				mTilePixelCounts[tile] = RasterizeTile(tile);
+			}
+		});
+
+		for (uint32_t tile = 0; tile < tileCount; ++tile)
+		{
+			mStats.PixelsShaded += mTilePixelCounts[tile];
+			mTileBins[tile].clear();
+		}
+
+		mTriangles.clear();
+		mVaryings.clear();
+	}
+
+	void SoftwareRasterizer::ClipAndBin(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, const ISoftwareShader& shader)
+	{
+		const RasterVertex* vertices[3] = { &v0, &v1, &v2 };
+
+		// Triangles wholly outside one side of the view volume go no further; only the near plane is clipped, the other
+		// sides are handled by the bounding box and the far plane by the depth test
+		uint32_t outsideLeft = 0;
+		uint32_t outsideRight = 0;
+		uint32_t outsideBottom = 0;
+		uint32_t outsideTop = 0;
+		uint32_t outsideNear = 0;
+		for (const RasterVertex* vertex : vertices)
+		{
+			const XMFLOAT4& position = vertex->Position;
+			outsideLeft += (position.x < -position.w ? 1 : 0);
+			outsideRight += (position.x > position.w ? 1 : 0);
+			outsideBottom += (position.y < -position.w ? 1 : 0);
+			outsideTop += (position.y > position.w ? 1 : 0);
+			outsideNear += (position.z < 0.0f ? 1 : 0);
+		}
+
+		if (outsideLeft == 3 || outsideRight == 3 || outsideBottom == 3 || outsideTop == 3 || outsideNear == 3)
+		{
+			++mStats.TrianglesCulled;
+			return;
+		}
+
+		if (outsideNear == 0)
+		{
+			Bin(v0, v1, v2, shader);
+			return;
+		}
+
+		// Cutting a corner off leaves a quad, cutting two leaves a smaller triangle; either keeps the winding
+		++mStats.TrianglesClipped;
+		const uint32_t varyingCount = shader.VaryingCount();
+		RasterVertex polygon[4];
+		uint32_t polygonSize = 0;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			const RasterVertex& current = *vertices[i];
+			const RasterVertex& next = *vertices[(i + 1) % 3];
+			const float currentDistance = current.Position.z;
+			const float nextDistance = next.Position.z;
+
+			if (currentDistance >= 0.0f)
+			{
+				polygon[polygonSize++] = current;
+			}
+
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+			{
+				const float t = currentDistance / (currentDistance - nextDistance);
+				RasterVertex& intersection = polygon[polygonSize++];
+				XMStoreFloat4(&intersection.Position, XMVectorLerp(XMLoadFloat4(&current.Position), XMLoadFloat4(&next.Position), t));
+				for (uint32_t varying = 0; varying < varyingCount; ++varying)
+				{
+					intersection.Varyings[varying] = current.Varyings[varying] + t * (next.Varyings[varying] - current.Varyings[varying]);
+				}
+			}
+		}
+
+		assert(polygonSize == 3 || polygonSize == 4);
+		Bin(polygon[0], polygon[1], polygon[2], shader);
+		if (polygonSize == 4)
+		{
+			Bin(polygon[0], polygon[2], polygon[3], shader);
+		}
+	}
+
+	void SoftwareRasterizer::Bin(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, const ISoftwareShader& shader)
+	{
+		const RasterVertex* vertices[3] = { &v0, &v1, &v2 };
+
+		Triangle triangle;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			const XMFLOAT4& position = vertices[i]->Position;
+			triangle.InverseW[i] = 1.0f / position.w;
+			triangle.X[i] = (position.x * triangle.InverseW[i] * 0.5f + 0.5f) * mWidth;
+			triangle.Y[i] = (0.5f - position.y * triangle.InverseW[i] * 0.5f) * mHeight;
+			triangle.Z[i] = position.z * triangle.InverseW[i];
+		}
+
+		// Clockwise on screen faces the viewer, as with the default rasterizer state; anything else faces away or has no area
+		const float area = (triangle.X[1] - triangle.X[0]) * (triangle.Y[2] - triangle.Y[0]) - (triangle.Y[1] - triangle.Y[0]) * (triangle.X[2] - triangle.X[0]);
+		if (!(area > 0.0f))
+		{
+			++mStats.TrianglesCulled;
+			return;
+		}
+
+		// Pixels whose centres fall inside the bounds, clamped to the target before converting so far-off vertices cannot overflow
+		const float maxX = static_cast<float>(mWidth - 1);
+		const float maxY = static_cast<float>(mHeight - 1);
+		triangle.MinX = static_cast<int32_t>(min(max(ceilf(min({ triangle.X[0], triangle.X[1], triangle.X[2] }) - 0.5f), 0.0f), maxX + 1.0f));
+		triangle.MinY = static_cast<int32_t>(min(max(ceilf(min({ triangle.Y[0], triangle.Y[1], triangle.Y[2] }) - 0.5f), 0.0f), maxY + 1.0f));
+		triangle.MaxX = static_cast<int32_t>(max(min(floorf(max({ triangle.X[0], triangle.X[1], triangle.X[2] }) - 0.5f), maxX), -1.0f));
+		triangle.MaxY = static_cast<int32_t>(max(min(floorf(max({ triangle.Y[0], triangle.Y[1], triangle.Y[2] }) - 0.5f), maxY), -1.0f));
+		if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+		{
+			++mStats.TrianglesCulled;
+			return;
+		}
+
+		// Varyings are stored divided by w, which interpolates linearly across the screen
+		triangle.Shader = &shader;
+		triangle.VaryingCount = shader.VaryingCount();
+		triangle.VaryingsOffset = static_cast<uint32_t>(mVaryings.size());
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			for (uint32_t varying = 0; varying < triangle.VaryingCount; ++varying)
+			{
+				mVaryings.push_back(vertices[i]->Varyings[varying] * triangle.InverseW[i]);
+			}
+		}
+
+		const uint32_t index = static_cast<uint32_t>(mTriangles.size());
+		mTriangles.push_back(triangle);
+		++mStats.TrianglesBinned;
+
+		for (uint32_t tileY = triangle.MinY / TileSize; tileY <= triangle.MaxY / TileSize; ++tileY)
+		{
+			for (uint32_t tileX = triangle.MinX / TileSize; tileX <= triangle.MaxX / TileSize; ++tileX)
+			{
+				mTileBins[tileY * mTilesX + tileX].push_back(index);
+			}
+		}
+	}
+
+	uint64_t SoftwareRasterizer::RasterizeTile(uint32_t tile)
+	{
+		const int32_t tileMinX = static_cast<int32_t>((tile % mTilesX) * TileSize);
+		const int32_t tileMinY = static_cast<int32_t>((tile / mTilesX) * TileSize);
+		const int32_t tileMaxX = min(tileMinX + static_cast<int32_t>(TileSize), static_cast<int32_t>(mWidth)) - 1;
+		const int32_t tileMaxY = min(tileMinY + static_cast<int32_t>(TileSize), static_cast<int32_t>(mHeight)) - 1;
+
+		uint64_t pixelCount = 0;
+		for (uint32_t index : mTileBins[tile])
+		{
+			pixelCount += RasterizeTriangle(mTriangles[index], tileMinX, tileMinY, tileMaxX, tileMaxY);
+		}
+
+		return pixelCount;
+	}
+
+	uint64_t SoftwareRasterizer::RasterizeTriangle(const Triangle& triangle, int32_t tileMinX, int32_t tileMinY, int32_t tileMaxX, int32_t tileMaxY)
+	{
+		// Tiles start on a multiple of four, so rounding down to a whole group of four pixels stays inside the tile
+		const int32_t minX = max(triangle.MinX, tileMinX) & ~3;
+		const int32_t minY = max(triangle.MinY, tileMinY);
+		const int32_t maxX = min(triangle.MaxX, tileMaxX);
+		const int32_t maxY = min(triangle.MaxY, tileMaxY);
+		if (minX > maxX || minY > maxY)
+		{
+			return 0;
+		}
+
+		// Edge functions E(x, y) = Ax + By + C, positive inside. Each vertex's weight is the edge opposite it over the
+		// area. A pixel centre exactly on an edge belongs to the triangle only if that is a top or left edge, so
+		// triangles sharing an edge never both draw it.
+		XMVECTOR edgeA[3];
+		XMVECTOR edgeB[3];
+		XMVECTOR edgeC[3];
+		bool topLeft[3];
+		for (uint32_t edge = 0; edge < 3; ++edge)
+		{
+			const uint32_t from = (edge + 1) % 3;
+			const uint32_t to = (edge + 2) % 3;
+			const float dx = triangle.X[to] - triangle.X[from];
+			const float dy = triangle.Y[to] - triangle.Y[from];
+			edgeA[edge] = XMVectorReplicate(-dy);
+			edgeB[edge] = XMVectorReplicate(dx);
+			edgeC[edge] = XMVectorReplicate(triangle.X[from] * triangle.Y[to] - triangle.Y[from] * triangle.X[to]);
+			topLeft[edge] = (dy < 0.0f || (dy == 0.0f && dx > 0.0f));
+		}
+
+		const float area = (triangle.X[1] - triangle.X[0]) * (triangle.Y[2] - triangle.Y[0]) - (triangle.Y[1] - triangle.Y[0]) * (triangle.X[2] - triangle.X[0]);
+		const XMVECTOR inverseArea = XMVectorReplicate(1.0f / area);
+		const XMVECTOR z0 = XMVectorReplicate(triangle.Z[0]);
+		const XMVECTOR zDelta1 = XMVectorReplicate(triangle.Z[1] - triangle.Z[0]);
+		const XMVECTOR zDelta2 = XMVectorReplicate(triangle.Z[2] - triangle.Z[0]);
+		const XMVECTOR laneOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+		const XMVECTOR lastCentre = XMVectorReplicate(maxX + 0.5f);
+		const XMVECTOR four = XMVectorReplicate(4.0f);
+		const XMVECTOR zero = XMVectorZero();
+
+		const float* varyings0 = &mVaryings[triangle.VaryingsOffset];
+		const float* varyings1 = varyings0 + triangle.VaryingCount;
+		const float* varyings2 = varyings1 + triangle.VaryingCount;
+		float varyings[RasterVertex::MaxVaryings];
+
+		uint64_t pixelCount = 0;
+		for (int32_t y = minY; y <= maxY; ++y)
+		{
+			const XMVECTOR centreY = XMVectorReplicate(y + 0.5f);
+			XMVECTOR centreX = XMVectorAdd(XMVectorReplicate(static_cast<float>(minX)), laneOffsets);
+			float* depthRow = &mDepthBuffer[static_cast<size_t>(y) * mRowPitch];
+			uint32_t* colorRow = &mColorBuffer[static_cast<size_t>(y) * mRowPitch];
+
+			for (int32_t x = minX; x <= maxX; x += 4, centreX = XMVectorAdd(centreX, four))
+			{
+				// Four pixels at once: coverage of all three edges, then the depth test against what is already there
+				XMVECTOR covered = XMVectorLessOrEqual(centreX, lastCentre);
+				XMVECTOR weights[3];
+				for (uint32_t edge = 0; edge < 3; ++edge)
+				{
+					const XMVECTOR distance = XMVectorMultiplyAdd(edgeA[edge], centreX, XMVectorMultiplyAdd(edgeB[edge], centreY, edgeC[edge]));
+					covered = XMVectorAndInt(covered, (topLeft[edge] ? XMVectorGreaterOrEqual(distance, zero) : XMVectorGreater(distance, zero)));
+					weights[edge] = XMVectorMultiply(distance, inverseArea);
+				}
+
+				if (XMVector4EqualInt(covered, XMVectorFalseInt()))
+				{
+					continue;
+				}
+
+				const XMVECTOR depth = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&depthRow[x]));
+				const XMVECTOR z = XMVectorMultiplyAdd(weights[2], zDelta2, XMVectorMultiplyAdd(weights[1], zDelta1, z0));
+				const XMVECTOR passed = XMVectorAndInt(covered, XMVectorLess(z, depth));
+				if (XMVector4EqualInt(passed, XMVectorFalseInt()))
+				{
+					continue;
+				}
+
+				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&depthRow[x]), XMVectorSelect(depth, z, passed));
+
+				// Shading is per pixel, with the varyings divided back out by the interpolated 1/w
+				uint32_t passedLanes[4];
+				XMFLOAT4 weights0;
+				XMFLOAT4 weights1;
+				XMFLOAT4 weights2;
+				XMStoreInt4(passedLanes, passed);
+				XMStoreFloat4(&weights0, weights[0]);
+				XMStoreFloat4(&weights1, weights[1]);
+				XMStoreFloat4(&weights2, weights[2]);
+				const float* laneWeights0 = &weights0.x;
+				const float* laneWeights1 = &weights1.x;
+				const float* laneWeights2 = &weights2.x;
+
+				for (uint32_t lane = 0; lane < 4; ++lane)
+				{
+					if (passedLanes[lane] == 0)
+					{
+						continue;
+					}
+
+					const float w0 = laneWeights0[lane];
+					const float w1 = laneWeights1[lane];
+					const float w2 = laneWeights2[lane];
+					const float perspective = 1.0f / (w0 * triangle.InverseW[0] + w1 * triangle.InverseW[1] + w2 * triangle.InverseW[2]);
+					for (uint32_t varying = 0; varying < triangle.VaryingCount; ++varying)
+					{
+						varyings[varying] = (w0 * varyings0[varying] + w1 * varyings1[varying] + w2 * varyings2[varying]) * perspective;
+					}
+
+					colorRow[x + lane] = SoftwareTexture::PackColor(triangle.Shader->ShadePixel(varyings));
+					++pixelCount;
+				}
+			}
+		}
+
+		return pixelCount;
+	}
+}
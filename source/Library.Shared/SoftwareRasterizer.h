@@ -0,0 +1,107 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace Library
+{
+	class JobSystem;
+
+	struct RasterVertex
+	{
+		static const std::uint32_t MaxVaryings = 12;
+
+		DirectX::XMFLOAT4 Position;
+		float Varyings[MaxVaryings];
+	};
+
+	class ISoftwareShader
+	{
+	public:
+		virtual ~ISoftwareShader() { };
+
+		// The vertex stage writes a clip-space position and VaryingCount() values that reach the pixel stage perspective
+		// correct; the pixel stage returns the colour, which is written wherever the depth test passes
+		virtual std::uint32_t VaryingCount() const = 0;
+		virtual void ShadeVertex(const void* vertex, RasterVertex& output) const = 0;
+		virtual DirectX::XMVECTOR ShadePixel(const float* varyings) const = 0;
+
+	protected:
+		ISoftwareShader() { };
+	};
+
+	struct SoftwareRasterizerStats
+	{
+		std::uint32_t Draws;
+		std::uint32_t Triangles;
+		std::uint32_t TrianglesClipped;
+		std::uint32_t TrianglesCulled;
+		std::uint32_t TrianglesBinned;
+		std::uint64_t PixelsShaded;
+
+		SoftwareRasterizerStats();
+	};
+
+	class SoftwareRasterizer final
+	{
+	public:
+		static const std::uint32_t TileSize = 64;
+		static const std::uint32_t VertexGrainSize = 1024;
+
+		SoftwareRasterizer(JobSystem& jobSystem, std::uint32_t width, std::uint32_t height);
+		SoftwareRasterizer() = delete;
+		SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer(SoftwareRasterizer&&) = delete;
+		SoftwareRasterizer& operator=(SoftwareRasterizer&&) = delete;
+		~SoftwareRasterizer() = default;
+
+		std::uint32_t Width() const;
+		std::uint32_t Height() const;
+		std::uint32_t RowPitch() const;
+		const std::uint32_t* ColorBuffer() const;
+		const float* DepthBuffer() const;
+		const SoftwareRasterizerStats& Stats() const;
+
+		void Clear(DirectX::FXMVECTOR color, float depth = 1.0f);
+		void Draw(const void* vertices, std::uint32_t vertexStride, std::uint32_t vertexCount, const std::uint32_t* indices, std::uint32_t indexCount, const ISoftwareShader& shader);
+		void Flush();
+
+	private:
+		struct Triangle
+		{
+			float X[3];
+			float Y[3];
+			float Z[3];
+			float InverseW[3];
+			std::int32_t MinX;
+			std::int32_t MinY;
+			std::int32_t MaxX;
+			std::int32_t MaxY;
+			std::uint32_t VaryingsOffset;
+			std::uint32_t VaryingCount;
+			const ISoftwareShader* Shader;
+		};
+
+		void ClipAndBin(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, const ISoftwareShader& shader);
+		void Bin(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, const ISoftwareShader& shader);
+		std::uint64_t RasterizeTile(std::uint32_t tile);
+		std::uint64_t RasterizeTriangle(const Triangle& triangle, std::int32_t tileMinX, std::int32_t tileMinY, std::int32_t tileMaxX, std::int32_t tileMaxY);
+
+		JobSystem* mJobSystem;
+		std::uint32_t mWidth;
+		std::uint32_t mHeight;
+		std::uint32_t mRowPitch;
+		std::uint32_t mTilesX;
+		std::uint32_t mTilesY;
+		std::vector<std::uint32_t> mColorBuffer;
+		std::vector<float> mDepthBuffer;
+		std::vector<RasterVertex> mShadedVertices;
+		std::vector<Triangle> mTriangles;
+		std::vector<float> mVaryings;
+		std::vector<std::vector<std::uint32_t>> mTileBins;
+		std::vector<std::uint64_t> mTilePixelCounts;
+		SoftwareRasterizerStats mStats;
+	};
+}
@@ -0,0 +1,71 @@
+#include "pch.h"
+#include "SoftwareTexture.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace Library
+{
+	SoftwareTexture::SoftwareTexture(uint32_t width, uint32_t height, vector<uint32_t>&& texels) :
+		mWidth(width), mHeight(height), mTexels(move(texels))
+	{
+		if (width == 0 || height == 0 || mTexels.size() != static_cast<size_t>(width) * height)
+		{
+			throw GameException("A software texture needs width * height texels.");
+		}
+	}
+
+	uint32_t SoftwareTexture::Width() const
+	{
+		return mWidth;
+	}
+
+	uint32_t SoftwareTexture::Height() const
+	{
+		return mHeight;
+	}
+
+	const vector<uint32_t>& SoftwareTexture::Texels() const
+	{
+		return mTexels;
+	}
+
+	XMVECTOR SoftwareTexture::Sample(float u, float v) const
+	{
+		// Bilinear with wrapped addressing, as SamplerStates::TrilinearWrap does at the top mip
+		const float x = u * mWidth - 0.5f;
+		const float y = v * mHeight - 0.5f;
+		const float left = floorf(x);
+		const float top = floorf(y);
+		const float fractionX = x - left;
+		const float fractionY = y - top;
+
+		const int32_t width = static_cast<int32_t>(mWidth);
+		const int32_t height = static_cast<int32_t>(mHeight);
+		const int32_t x0 = ((static_cast<int32_t>(left) % width) + width) % width;
+		const int32_t y0 = ((static_cast<int32_t>(top) % height) + height) % height;
+		const int32_t x1 = (x0 + 1) % width;
+		const int32_t y1 = (y0 + 1) % height;
+
+		const XMVECTOR topRow = XMVectorLerp(UnpackColor(mTexels[y0 * width + x0]), UnpackColor(mTexels[y0 * width + x1]), fractionX);
+		const XMVECTOR bottomRow = XMVectorLerp(UnpackColor(mTexels[y1 * width + x0]), UnpackColor(mTexels[y1 * width + x1]), fractionX);
+
+		return XMVectorLerp(topRow, bottomRow, fractionY);
+	}
+
+	uint32_t SoftwareTexture::PackColor(FXMVECTOR color)
+	{
+		// Red in the lowest byte, the memory order of DXGI_FORMAT_R8G8B8A8_UNORM
+		XMFLOAT4 scaled;
+		XMStoreFloat4(&scaled, XMVectorMultiplyAdd(XMVectorSaturate(color), XMVectorReplicate(255.0f), XMVectorReplicate(0.5f)));
+
+		return static_cast<uint32_t>(scaled.x) | (static_cast<uint32_t>(scaled.y) << 8) | (static_cast<uint32_t>(scaled.z) << 16) | (static_cast<uint32_t>(scaled.w) << 24);
+	}
+
+	XMVECTOR SoftwareTexture::UnpackColor(uint32_t color)
+	{
+		const XMVECTOR bytes = XMVectorSet(static_cast<float>(color & 0xFF), static_cast<float>((color >> 8) & 0xFF), static_cast<float>((color >> 16) & 0xFF), static_cast<float>(color >> 24));
+
+		return XMVectorScale(bytes, 1.0f / 255.0f);
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace Library
+{
+	class SoftwareTexture final
+	{
+	public:
+		SoftwareTexture(std::uint32_t width, std::uint32_t height, std::vector<std::uint32_t>&& texels);
+		SoftwareTexture(const SoftwareTexture&) = delete;
+		SoftwareTexture& operator=(const SoftwareTexture&) = delete;
+		SoftwareTexture(SoftwareTexture&&) = default;
+		SoftwareTexture& operator=(SoftwareTexture&&) = default;
+		~SoftwareTexture() = default;
+
+		std::uint32_t Width() const;
+		std::uint32_t Height() const;
+		const std::vector<std::uint32_t>& Texels() const;
+
+		DirectX::XMVECTOR Sample(float u, float v) const;
+
+		static std::uint32_t PackColor(DirectX::FXMVECTOR color);
+		static DirectX::XMVECTOR UnpackColor(std::uint32_t color);
+
+	private:
+		std::uint32_t mWidth;
+		std::uint32_t mHeight;
+		std::vector<std::uint32_t> mTexels;
+	};
+}
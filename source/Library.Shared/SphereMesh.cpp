@@ -0,0 +1,8 @@
+#include "pch.h"
+#include "SphereMesh.h"
+
+namespace Library
+{
+	// Radius of the Sphere.obj the scene's body scales were tuned against; the generated sphere levels keep it
+	const float SphereMesh::Radius = 5.752084f;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Library
+{
+	// The unit-scale sphere every celestial body is drawn with. Body and ring scales multiply this radius, so anything
+	// sized against a body's surface has to include it.
+	class SphereMesh final
+	{
+	public:
+		static const float Radius;
+
+		SphereMesh() = delete;
+		SphereMesh(const SphereMesh&) = delete;
+		SphereMesh& operator=(const SphereMesh&) = delete;
+		SphereMesh(SphereMesh&&) = delete;
+		SphereMesh& operator=(SphereMesh&&) = delete;
+		~SphereMesh() = default;
+	};
+}
@@ -4,6 +4,20 @@ using namespace std;
 using namespace DirectX;
 using namespace Library;
 
+namespace
+{
+	// Integers are stored least significant byte first, which on a little-endian machine is already their layout in
+	// memory; floats are always stored as they sit in memory
+	bool IsLittleEndian()
+	{
+		const uint32_t value = 1;
+		uint8_t firstByte;
+		memcpy(&firstByte, &value, sizeof(firstByte));
+
+		return (firstByte == 1);
+	}
+}
+
 #pragma region OutputStreamHelper
 
 OutputStreamHelper::OutputStreamHelper(ostream& stream) :
@@ -51,6 +65,13 @@ OutputStreamHelper& OutputStreamHelper::operator<<(float value)
 	return *this;
 }
 
+OutputStreamHelper& OutputStreamHelper::operator<<(double value)
+{
+	mStream.write((char*)&value, sizeof(double));
+
+	return *this;
+}
+
 OutputStreamHelper& OutputStreamHelper::operator<<(const string& value)
 {
 	uint32_t size = static_cast<uint32_t>(value.size());
@@ -80,6 +101,60 @@ OutputStreamHelper& OutputStreamHelper::operator<<(bool value)
 	return *this;
 }
 
+OutputStreamHelper& OutputStreamHelper::WriteArray(const uint32_t* values, uint32_t count)
+{
+	assert(values != nullptr || count == 0);
+
+	if (IsLittleEndian())
+	{
+		mStream.write(reinterpret_cast<const char*>(values), static_cast<streamsize>(count) * sizeof(uint32_t));
+	}
+	else
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			WriteObject(mStream, values[i]);
+		}
+	}
+
+	return *this;
+}
+
+OutputStreamHelper& OutputStreamHelper::WriteArray(const float* values, uint32_t count)
+{
+	assert(values != nullptr || count == 0);
+
+	mStream.write(reinterpret_cast<const char*>(values), static_cast<streamsize>(count) * sizeof(float));
+
+	return *this;
+}
+
+OutputStreamHelper& OutputStreamHelper::WriteArray(const XMFLOAT3* values, uint32_t count)
+{
+	static_assert(sizeof(XMFLOAT3) == 3 * sizeof(float), "XMFLOAT3 must be three packed floats.");
+
+	return WriteArray(reinterpret_cast<const float*>(values), count * 3);
+}
+
+OutputStreamHelper& OutputStreamHelper::WriteArray(const XMFLOAT4* values, uint32_t count)
+{
+	static_assert(sizeof(XMFLOAT4) == 4 * sizeof(float), "XMFLOAT4 must be four packed floats.");
+
+	return WriteArray(reinterpret_cast<const float*>(values), count * 4);
+}
+
+OutputStreamHelper& OutputStreamHelper::WriteArray(const string* values, uint32_t count)
+{
+	assert(values != nullptr || count == 0);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		*this << values[i];
+	}
+
+	return *this;
+}
+
 template <typename T>
 void OutputStreamHelper::WriteObject(ostream& stream, T value)
 {
@@ -138,6 +213,13 @@ InputStreamHelper& InputStreamHelper::operator>>(float& value)
 	return *this;
 }
 
+InputStreamHelper& InputStreamHelper::operator>>(double& value)
+{
+	mStream.read((char*)&value, sizeof(double));
+
+	return *this;
+}
+
 InputStreamHelper& InputStreamHelper::operator>>(string& value)
 {
 	uint32_t stringLength;
@@ -172,6 +254,60 @@ InputStreamHelper& InputStreamHelper::operator>>(bool& value)
 	return *this;
 }
 
+InputStreamHelper& InputStreamHelper::ReadArray(uint32_t* values, uint32_t count)
+{
+	assert(values != nullptr || count == 0);
+
+	if (IsLittleEndian())
+	{
+		mStream.read(reinterpret_cast<char*>(values), static_cast<streamsize>(count) * sizeof(uint32_t));
+	}
+	else
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			ReadObject(mStream, values[i]);
+		}
+	}
+
+	return *this;
+}
+
+InputStreamHelper& InputStreamHelper::ReadArray(float* values, uint32_t count)
+{
+	assert(values != nullptr || count == 0);
+
+	mStream.read(reinterpret_cast<char*>(values), static_cast<streamsize>(count) * sizeof(float));
+
+	return *this;
+}
+
+InputStreamHelper& InputStreamHelper::ReadArray(XMFLOAT3* values, uint32_t count)
+{
+	static_assert(sizeof(XMFLOAT3) == 3 * sizeof(float), "XMFLOAT3 must be three packed floats.");
+
+	return ReadArray(reinterpret_cast<float*>(values), count * 3);
+}
+
+InputStreamHelper& InputStreamHelper::ReadArray(XMFLOAT4* values, uint32_t count)
+{
+	static_assert(sizeof(XMFLOAT4) == 4 * sizeof(float), "XMFLOAT4 must be four packed floats.");
+
+	return ReadArray(reinterpret_cast<float*>(values), count * 4);
+}
+
+InputStreamHelper& InputStreamHelper::ReadArray(string* values, uint32_t count)
+{
+	assert(values != nullptr || count == 0);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		*this >> values[i];
+	}
+
+	return *this;
+}
+
 template <typename T>
 void InputStreamHelper::ReadObject(istream& stream, T& value)
 {
@@ -179,7 +315,7 @@ void InputStreamHelper::ReadObject(istream& stream, T& value)
 
 	for (uint32_t size = 0; size < sizeof(T); ++size)
 	{
-		value |= stream.get() << (8 * size);
+		value |= static_cast<T>(stream.get() & 0xFF) << (8 * size);
 	}
 }
 
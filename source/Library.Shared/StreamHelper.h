@@ -1,9 +1,14 @@
 #pragma once
 
 #include <iostream>
+#include <string>
+#include <vector>
+#include "ArraySpan.h"
 
 namespace DirectX
 {
+	struct XMFLOAT3;
+	struct XMFLOAT4;
 	struct XMFLOAT4X4;
 }
 
@@ -23,10 +28,32 @@ namespace Library
 		OutputStreamHelper& operator<<(uint32_t value);
 		OutputStreamHelper& operator<<(uint64_t value);
 		OutputStreamHelper& operator<<(float value);
+		OutputStreamHelper& operator<<(double value);
 		OutputStreamHelper& operator<<(const std::string& value);
 		OutputStreamHelper& operator<<(const DirectX::XMFLOAT4X4& value);
 		OutputStreamHelper& operator<<(bool value);
-		
+
+		// Elements go out in the same layout the scalar operators give them, but numeric arrays take a single write
+		OutputStreamHelper& WriteArray(const std::uint32_t* values, std::uint32_t count);
+		OutputStreamHelper& WriteArray(const float* values, std::uint32_t count);
+		OutputStreamHelper& WriteArray(const DirectX::XMFLOAT3* values, std::uint32_t count);
+		OutputStreamHelper& WriteArray(const DirectX::XMFLOAT4* values, std::uint32_t count);
+		OutputStreamHelper& WriteArray(const std::string* values, std::uint32_t count);
+
+		// The element count first, then the elements
+		template <typename T>
+		OutputStreamHelper& WriteArray(const ArraySpan<T>& values)
+		{
+			*this << values.Size();
+			return WriteArray(values.Data(), values.Size());
+		}
+
+		template <typename T>
+		OutputStreamHelper& WriteArray(const std::vector<T>& values)
+		{
+			return WriteArray(ArraySpan<T>(values));
+		}
+
 	private:
 		template <typename T>
 		void WriteObject(std::ostream& stream, T value);
@@ -48,10 +75,28 @@ namespace Library
 		InputStreamHelper& operator>>(uint32_t& value);
 		InputStreamHelper& operator>>(uint64_t& value);
 		InputStreamHelper& operator>>(float& value);
+		InputStreamHelper& operator>>(double& value);
 		InputStreamHelper& operator>>(std::string& value);
 		InputStreamHelper& operator>>(DirectX::XMFLOAT4X4& value);
 		InputStreamHelper& operator>>(bool& value);
-		
+
+		InputStreamHelper& ReadArray(std::uint32_t* values, std::uint32_t count);
+		InputStreamHelper& ReadArray(float* values, std::uint32_t count);
+		InputStreamHelper& ReadArray(DirectX::XMFLOAT3* values, std::uint32_t count);
+		InputStreamHelper& ReadArray(DirectX::XMFLOAT4* values, std::uint32_t count);
+		InputStreamHelper& ReadArray(std::string* values, std::uint32_t count);
+
+		// Reads an element count and then that many elements, replacing whatever the vector held
+		template <typename T>
+		InputStreamHelper& ReadArray(std::vector<T>& values)
+		{
+			std::uint32_t count;
+			*this >> count;
+			values.resize(count);
+
+			return ReadArray(values.data(), count);
+		}
+
 	private:
 		template <typename T>
 		void ReadObject(std::istream& stream, T& value);
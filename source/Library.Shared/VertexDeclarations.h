@@ -1,6 +1,7 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <DirectXPackedVector.h>
 
 namespace Library
 {
@@ -70,6 +71,20 @@ namespace Library
 			Position(position), TextureCoordinates(textureCoordinates), Normal(normal) { }
 	};
 
+	// 16 bytes against VertexPositionTextureNormal's 36: the position is quantized to the mesh's bounds (R16G16B16A16_UNORM,
+	// w unused), the texture coordinates are half floats (R16G16_FLOAT) and the normal is octahedral (R16G16_SNORM)
+	struct VertexPositionTextureNormalCompact
+	{
+		DirectX::PackedVector::XMUSHORTN4 Position;
+		DirectX::PackedVector::XMHALF2 TextureCoordinates;
+		DirectX::PackedVector::XMSHORTN2 Normal;
+
+		VertexPositionTextureNormalCompact() { }
+
+		VertexPositionTextureNormalCompact(const DirectX::PackedVector::XMUSHORTN4& position, const DirectX::PackedVector::XMHALF2& textureCoordinates, const DirectX::PackedVector::XMSHORTN2& normal) :
+			Position(position), TextureCoordinates(textureCoordinates), Normal(normal) { }
+	};
+
 	struct VertexPositionTextureNormalTangent
 	{
 		DirectX::XMFLOAT4 Position;
@@ -0,0 +1,252 @@
+#include "pch.h"
+#include "VertexFormat.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+namespace Library
+{
+	namespace
+	{
+		const string Names[] =
+		{
+			"PositionColor",
+			"PositionTexture",
+			"PositionTextureNormal",
+			"PositionTextureNormalCompact"
+		};
+
+		static_assert(ARRAYSIZE(Names) == static_cast<size_t>(VertexFormat::End), "Every vertex format needs a name.");
+
+		// Vertices are built as the declared structures and copied into place, so the bytes are exactly what the input
+		// layouts that use those structures expect
+		template <typename TVertex, typename TBuild>
+		void InterleaveAs(uint32_t vertexCount, vector<uint8_t>& vertices, TBuild build)
+		{
+			vertices.resize(static_cast<size_t>(vertexCount) * sizeof(TVertex));
+			for (uint32_t i = 0; i < vertexCount; ++i)
+			{
+				const TVertex vertex = build(i);
+				memcpy(&vertices[static_cast<size_t>(i) * sizeof(TVertex)], &vertex, sizeof(TVertex));
+			}
+		}
+
+		XMFLOAT4 ToPosition(const XMFLOAT3& position)
+		{
+			return XMFLOAT4(position.x, position.y, position.z, 1.0f);
+		}
+
+		void ValidateTextureCoordinatesAndNormals(const MeshSpans& spans, uint32_t vertexCount)
+		{
+			if (spans.TextureCoordinates.empty() || spans.TextureCoordinates.front().Size() != vertexCount)
+			{
+				throw GameException("The mesh has no texture coordinates for its vertices.");
+			}
+
+			if (spans.Normals.Size() != vertexCount)
+			{
+				throw GameException("The mesh has no normals for its vertices.");
+			}
+		}
+
+		// The normal is projected onto the octahedron |x| + |y| + |z| = 1 and the lower half is folded over the upper,
+		// which maps the sphere onto the square [-1, 1]^2 with far less error than storing two of its components
+		XMFLOAT2 EncodeOctahedral(const XMFLOAT3& normal)
+		{
+			const float length = fabs(normal.x) + fabs(normal.y) + fabs(normal.z);
+			if (length == 0.0f)
+			{
+				return XMFLOAT2(0.0f, 0.0f);
+			}
+
+			float x = normal.x / length;
+			float y = normal.y / length;
+			if (normal.z < 0.0f)
+			{
+				const float foldedX = (1.0f - fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+				const float foldedY = (1.0f - fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+				x = foldedX;
+				y = foldedY;
+			}
+
+			return XMFLOAT2(x, y);
+		}
+
+		// Matches DecodeNormal in the body vertex shaders
+		XMFLOAT3 DecodeOctahedral(const XMFLOAT2& encoded)
+		{
+			XMFLOAT3 normal(encoded.x, encoded.y, 1.0f - fabs(encoded.x) - fabs(encoded.y));
+			const float fold = max(-normal.z, 0.0f);
+			normal.x += (normal.x >= 0.0f ? -fold : fold);
+			normal.y += (normal.y >= 0.0f ? -fold : fold);
+			XMStoreFloat3(&normal, XMVector3Normalize(XMLoadFloat3(&normal)));
+
+			return normal;
+		}
+
+		float Quantize(float value, float offset, float scale)
+		{
+			return (scale > 0.0f ? (value - offset) / scale : 0.0f);
+		}
+	}
+
+	uint32_t VertexFormatHelper::Stride(VertexFormat format)
+	{
+		switch (format)
+		{
+			case VertexFormat::PositionColor:
+				return sizeof(VertexPositionColor);
+
+			case VertexFormat::PositionTexture:
+				return sizeof(VertexPositionTexture);
+
+			case VertexFormat::PositionTextureNormal:
+				return sizeof(VertexPositionTextureNormal);
+
+			case VertexFormat::PositionTextureNormalCompact:
+				return sizeof(VertexPositionTextureNormalCompact);
+
+			default:
+				throw GameException("Unknown vertex format.");
+		}
+	}
+
+	const string& VertexFormatHelper::Name(VertexFormat format)
+	{
+		if (format >= VertexFormat::End)
+		{
+			throw GameException("Unknown vertex format.");
+		}
+
+		return Names[static_cast<uint32_t>(format)];
+	}
+
+	VertexFormat VertexFormatHelper::Parse(const string& name)
+	{
+		const auto found = find(begin(Names), end(Names), name);
+		if (found == end(Names))
+		{
+			throw GameException(("Unknown vertex format: " + name).c_str());
+		}
+
+		return static_cast<VertexFormat>(found - begin(Names));
+	}
+
+	void VertexFormatHelper::Interleave(VertexFormat format, const MeshSpans& spans, vector<uint8_t>& vertices)
+	{
+		const ArraySpan<XMFLOAT3>& positions = spans.Vertices;
+		const uint32_t vertexCount = positions.Size();
+
+		switch (format)
+		{
+			case VertexFormat::PositionColor:
+			{
+				if (spans.VertexColors.size() > 0)
+				{
+					const ArraySpan<XMFLOAT4>& colors = spans.VertexColors.front();
+					if (colors.Size() != vertexCount)
+					{
+						throw GameException("The mesh's vertex colours do not match its vertices.");
+					}
+
+					InterleaveAs<VertexPositionColor>(vertexCount, vertices, [&](uint32_t i) { return VertexPositionColor(ToPosition(positions[i]), colors[i]); });
+				}
+				else
+				{
+					const XMFLOAT4 white(reinterpret_cast<const float*>(&Colors::White));
+					InterleaveAs<VertexPositionColor>(vertexCount, vertices, [&](uint32_t i) { return VertexPositionColor(ToPosition(positions[i]), white); });
+				}
+
+				break;
+			}
+
+			case VertexFormat::PositionTexture:
+			{
+				if (spans.TextureCoordinates.empty() || spans.TextureCoordinates.front().Size() != vertexCount)
+				{
+					throw GameException("The mesh has no texture coordinates for its vertices.");
+				}
+
+				const ArraySpan<XMFLOAT3>& uvs = spans.TextureCoordinates.front();
+				InterleaveAs<VertexPositionTexture>(vertexCount, vertices, [&](uint32_t i) { return VertexPositionTexture(ToPosition(positions[i]), XMFLOAT2(uvs[i].x, uvs[i].y)); });
+				break;
+			}
+
+			case VertexFormat::PositionTextureNormal:
+			{
+				ValidateTextureCoordinatesAndNormals(spans, vertexCount);
+
+				const ArraySpan<XMFLOAT3>& uvs = spans.TextureCoordinates.front();
+				const ArraySpan<XMFLOAT3>& normals = spans.Normals;
+				InterleaveAs<VertexPositionTextureNormal>(vertexCount, vertices, [&](uint32_t i) { return VertexPositionTextureNormal(ToPosition(positions[i]), XMFLOAT2(uvs[i].x, uvs[i].y), normals[i]); });
+				break;
+			}
+
+			case VertexFormat::PositionTextureNormalCompact:
+			{
+				ValidateTextureCoordinatesAndNormals(spans, vertexCount);
+
+				XMFLOAT3 offset;
+				XMFLOAT3 scale;
+				PositionQuantization(positions, offset, scale);
+
+				const ArraySpan<XMFLOAT3>& uvs = spans.TextureCoordinates.front();
+				const ArraySpan<XMFLOAT3>& normals = spans.Normals;
+				InterleaveAs<VertexPositionTextureNormalCompact>(vertexCount, vertices, [&](uint32_t i) { return Compress(positions[i], XMFLOAT2(uvs[i].x, uvs[i].y), normals[i], offset, scale); });
+				break;
+			}
+
+			default:
+				throw GameException("Unknown vertex format.");
+		}
+	}
+
+	void VertexFormatHelper::PositionQuantization(const ArraySpan<XMFLOAT3>& positions, XMFLOAT3& offset, XMFLOAT3& scale)
+	{
+		if (positions.IsEmpty())
+		{
+			offset = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			scale = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			return;
+		}
+
+		XMVECTOR minimum = XMLoadFloat3(&positions[0]);
+		XMVECTOR maximum = minimum;
+		for (const XMFLOAT3& position : positions)
+		{
+			const XMVECTOR value = XMLoadFloat3(&position);
+			minimum = XMVectorMin(minimum, value);
+			maximum = XMVectorMax(maximum, value);
+		}
+
+		XMStoreFloat3(&offset, minimum);
+		XMStoreFloat3(&scale, maximum - minimum);
+	}
+
+	VertexPositionTextureNormalCompact VertexFormatHelper::Compress(const XMFLOAT3& position, const XMFLOAT2& textureCoordinates, const XMFLOAT3& normal, const XMFLOAT3& offset, const XMFLOAT3& scale)
+	{
+		const XMFLOAT2 encodedNormal = EncodeOctahedral(normal);
+
+		VertexPositionTextureNormalCompact vertex;
+		XMStoreUShortN4(&vertex.Position, XMVectorSet(Quantize(position.x, offset.x, scale.x), Quantize(position.y, offset.y, scale.y), Quantize(position.z, offset.z, scale.z), 0.0f));
+		XMStoreHalf2(&vertex.TextureCoordinates, XMLoadFloat2(&textureCoordinates));
+		XMStoreShortN2(&vertex.Normal, XMLoadFloat2(&encodedNormal));
+
+		return vertex;
+	}
+
+	VertexPositionTextureNormal VertexFormatHelper::Decompress(const VertexPositionTextureNormalCompact& vertex, const XMFLOAT3& offset, const XMFLOAT3& scale)
+	{
+		XMFLOAT3 position;
+		XMStoreFloat3(&position, XMLoadFloat3(&offset) + XMLoadUShortN4(&vertex.Position) * XMLoadFloat3(&scale));
+
+		XMFLOAT2 textureCoordinates;
+		XMStoreFloat2(&textureCoordinates, XMLoadHalf2(&vertex.TextureCoordinates));
+
+		XMFLOAT2 encodedNormal;
+		XMStoreFloat2(&encodedNormal, XMLoadShortN2(&vertex.Normal));
+
+		return VertexPositionTextureNormal(ToPosition(position), textureCoordinates, DecodeOctahedral(encodedNormal));
+	}
+}
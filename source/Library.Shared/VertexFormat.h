@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include "ArraySpan.h"
+
+namespace Library
+{
+	struct MeshSpans;
+	struct VertexPositionTextureNormal;
+	struct VertexPositionTextureNormalCompact;
+
+	// The interleaved vertex layouts of VertexDeclarations.h that a mesh can be baked into, so a vertex buffer can be
+	// created straight from the baked bytes
+	enum class VertexFormat : std::uint32_t
+	{
+		PositionColor = 0,
+		PositionTexture,
+		PositionTextureNormal,
+		PositionTextureNormalCompact,
+		End
+	};
+
+	class VertexFormatHelper final
+	{
+	public:
+		VertexFormatHelper() = delete;
+		VertexFormatHelper(const VertexFormatHelper&) = delete;
+		VertexFormatHelper& operator=(const VertexFormatHelper&) = delete;
+		VertexFormatHelper(VertexFormatHelper&&) = delete;
+		VertexFormatHelper& operator=(VertexFormatHelper&&) = delete;
+		~VertexFormatHelper() = default;
+
+		static std::uint32_t Stride(VertexFormat format);
+		static const std::string& Name(VertexFormat format);
+		static VertexFormat Parse(const std::string& name);
+
+		// Throws when the mesh lacks an attribute the format needs; a mesh without colours is white in PositionColor
+		static void Interleave(VertexFormat format, const MeshSpans& spans, std::vector<std::uint8_t>& vertices);
+
+		// Compact positions are quantized to the mesh's bounding box; a position decodes as offset + quantized * scale, so
+		// whoever draws a compact mesh needs the offset and scale of the positions it was baked from
+		static void PositionQuantization(const ArraySpan<DirectX::XMFLOAT3>& positions, DirectX::XMFLOAT3& offset, DirectX::XMFLOAT3& scale);
+		static VertexPositionTextureNormalCompact Compress(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT2& textureCoordinates, const DirectX::XMFLOAT3& normal, const DirectX::XMFLOAT3& offset, const DirectX::XMFLOAT3& scale);
+		static VertexPositionTextureNormal Decompress(const VertexPositionTextureNormalCompact& vertex, const DirectX::XMFLOAT3& offset, const DirectX::XMFLOAT3& scale);
+	};
+}
@@ -47,8 +47,13 @@
 #include "GameClock.h"
 #include "GameTime.h"
 #include "ServiceContainer.h"
+#include "JobSystem.h"
+#include "ICommandRecorder.h"
+#include "RecordingScheduler.h"
+#include "DeferredContextRecorder.h"
 #include "RenderTarget.h"
 #include "Game.h"
+#include "HeadlessGame.h"
 #include "GameComponent.h"
 #include "DrawableGameComponent.h"
 #include "VectorHelper.h"
@@ -58,6 +63,7 @@
 #include "PerspectiveCamera.h"
 #include "OrthographicCamera.h"
 #include "FirstPersonCamera.h"
+#include "Frustum.h"
 #include "Light.h"
 #include "DirectionalLight.h"
 #include "PointLight.h"
@@ -69,11 +75,21 @@
 #include "RasterizerStates.h"
 #include "SamplerStates.h"
 #include "RenderStateHelper.h"
+#include "RenderStateCache.h"
+#include "ConstantRingAllocator.h"
+#include "ConstantBufferRing.h"
+#include "SoftwareTexture.h"
+#include "SoftwareRasterizer.h"
+#include "RenderQueue.h"
 #include "FpsComponent.h"
 #include "StreamHelper.h"
+#include "MemoryMappedFile.h"
 #include "Model.h"
 #include "Mesh.h"
 #include "ModelMaterial.h"
+#include "ModelFile.h"
+#include "VertexFormat.h"
+#include "SphereMesh.h"
 #include "ProxyModel.h"
 #include "Skybox.h"
 #include "MouseComponent.h"
@@ -0,0 +1,395 @@
+#include "pch.h"
+#include "BarnesHutTree.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace SolarSystem
+{
+	const uint32_t BarnesHutTree::LeafCapacity = 8;
+	const uint32_t BarnesHutTree::MaxDepth = 21;
+	const uint32_t BarnesHutTree::GroupCapacity = 64;
+
+	namespace
+	{
+		const uint32_t QuantizedRange = 1u << 21;
+
+		// Spreads the low 21 bits of a value so that there are two zero bits between each of them
+		uint64_t SpreadBits(uint32_t value)
+		{
+			uint64_t bits = value & 0x1FFFFF;
+			bits = (bits | (bits << 32)) & 0x1F00000000FFFF;
+			bits = (bits | (bits << 16)) & 0x1F0000FF0000FF;
+			bits = (bits | (bits << 8)) & 0x100F00F00F00F00F;
+			bits = (bits | (bits << 4)) & 0x10C30C30C30C30C3;
+			bits = (bits | (bits << 2)) & 0x1249249249249249;
+			return bits;
+		}
+
+		uint32_t Quantize(float value, float origin, float scale)
+		{
+			const float quantized = (value - origin) * scale;
+			if (quantized <= 0.0f)
+			{
+				return 0;
+			}
+
+			return (quantized >= static_cast<float>(QuantizedRange - 1) ? QuantizedRange - 1 : static_cast<uint32_t>(quantized));
+		}
+
+		uint32_t Octant(uint64_t key, uint32_t depth)
+		{
+			return static_cast<uint32_t>(key >> (3 * (BarnesHutTree::MaxDepth - 1 - depth))) & 7;
+		}
+	}
+
+	BarnesHutTree::BarnesHutTree() :
+		mInverseOpeningAngle(1.0f)
+	{
+	}
+
+	void BarnesHutTree::Build(const float* positionsX, const float* positionsY, const float* positionsZ, const float* masses, uint32_t count, float openingAngle)
+	{
+		assert(openingAngle > 0.0f);
+
+		mNodes.clear();
+		mGroups.clear();
+		mInverseOpeningAngle = 1.0f / openingAngle;
+		if (count == 0)
+		{
+			mOrder.clear();
+			return;
+		}
+
+		XMFLOAT3 minimum(positionsX[0], positionsY[0], positionsZ[0]);
+		XMFLOAT3 maximum = minimum;
+		for (uint32_t i = 1; i < count; ++i)
+		{
+			minimum.x = (positionsX[i] < minimum.x ? positionsX[i] : minimum.x);
+			minimum.y = (positionsY[i] < minimum.y ? positionsY[i] : minimum.y);
+			minimum.z = (positionsZ[i] < minimum.z ? positionsZ[i] : minimum.z);
+			maximum.x = (positionsX[i] > maximum.x ? positionsX[i] : maximum.x);
+			maximum.y = (positionsY[i] > maximum.y ? positionsY[i] : maximum.y);
+			maximum.z = (positionsZ[i] > maximum.z ? positionsZ[i] : maximum.z);
+		}
+
+		// A cube around the bounding box, padded so that bodies on the boundary still fall inside
+		float size = (maximum.x - minimum.x > maximum.y - minimum.y ? maximum.x - minimum.x : maximum.y - minimum.y);
+		size = (maximum.z - minimum.z > size ? maximum.z - minimum.z : size);
+		size = size * 1.001f + 1e-3f;
+
+		SortBodies(positionsX, positionsY, positionsZ, count, minimum, size);
+
+		mBodiesX.resize(count);
+		mBodiesY.resize(count);
+		mBodiesZ.resize(count);
+		mBodyMasses.resize(count);
+		for (uint32_t slot = 0; slot < count; ++slot)
+		{
+			const uint32_t body = mOrder[slot];
+			mBodiesX[slot] = positionsX[body];
+			mBodiesY[slot] = positionsY[body];
+			mBodiesZ[slot] = positionsZ[body];
+			mBodyMasses[slot] = masses[body];
+		}
+
+		mNodes.reserve(count / 2 + 8);
+		mGroups.reserve(count / (GroupCapacity / 4) + 1);
+		BuildNode(0, count, 0, minimum, size, false);
+	}
+
+	void BarnesHutTree::Accelerations(uint32_t beginGroup, uint32_t endGroup, float softeningSquared, float scale, float* accelerationsX, float* accelerationsY, float* accelerationsZ) const
+	{
+		assert(endGroup <= GroupCount());
+
+		// One walk per group of neighbouring bodies instead of one per body; the list it gathers is then summed four
+		// sources at a time for every body in the group
+		InteractionList list;
+		for (uint32_t group = beginGroup; group < endGroup; ++group)
+		{
+			Gather(mGroups[group], list);
+			Evaluate(mGroups[group], list, softeningSquared, scale, accelerationsX, accelerationsY, accelerationsZ);
+		}
+	}
+
+	uint32_t BarnesHutTree::BodyCount() const
+	{
+		return static_cast<uint32_t>(mOrder.size());
+	}
+
+	uint32_t BarnesHutTree::NodeCount() const
+	{
+		return static_cast<uint32_t>(mNodes.size());
+	}
+
+	uint32_t BarnesHutTree::GroupCount() const
+	{
+		return static_cast<uint32_t>(mGroups.size());
+	}
+
+	void BarnesHutTree::InteractionList::Clear()
+	{
+		X.clear();
+		Y.clear();
+		Z.clear();
+		Masses.clear();
+	}
+
+	void BarnesHutTree::InteractionList::Add(float x, float y, float z, float mass)
+	{
+		X.push_back(x);
+		Y.push_back(y);
+		Z.push_back(z);
+		Masses.push_back(mass);
+	}
+
+	uint32_t BarnesHutTree::InteractionList::Size() const
+	{
+		return static_cast<uint32_t>(Masses.size());
+	}
+
+	void BarnesHutTree::SortBodies(const float* positionsX, const float* positionsY, const float* positionsZ, uint32_t count, const XMFLOAT3& origin, float size)
+	{
+		mKeys.resize(count);
+		mOrder.resize(count);
+		mSortedKeys.resize(count);
+		mSortedOrder.resize(count);
+
+		const float scale = static_cast<float>(QuantizedRange) / size;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint64_t x = SpreadBits(Quantize(positionsX[i], origin.x, scale));
+			const uint64_t y = SpreadBits(Quantize(positionsY[i], origin.y, scale));
+			const uint64_t z = SpreadBits(Quantize(positionsZ[i], origin.z, scale));
+			mKeys[i] = x | (y << 1) | (z << 2);
+			mOrder[i] = i;
+		}
+
+		// Least significant digit radix sort on the Morton keys; digits every key shares are skipped
+		for (uint32_t shift = 0; shift < 3 * MaxDepth; shift += 8)
+		{
+			uint32_t offsets[256] = { };
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				++offsets[(mKeys[i] >> shift) & 0xFF];
+			}
+
+			if (offsets[(mKeys[0] >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			uint32_t total = 0;
+			for (auto& offset : offsets)
+			{
+				const uint32_t digitCount = offset;
+				offset = total;
+				total += digitCount;
+			}
+
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const uint32_t destination = offsets[(mKeys[i] >> shift) & 0xFF]++;
+				mSortedKeys[destination] = mKeys[i];
+				mSortedOrder[destination] = mOrder[i];
+			}
+
+			mKeys.swap(mSortedKeys);
+			mOrder.swap(mSortedOrder);
+		}
+	}
+
+	uint32_t BarnesHutTree::BuildNode(uint32_t beginSlot, uint32_t endSlot, uint32_t depth, const XMFLOAT3& corner, float size, bool inGroup)
+	{
+		// Nodes are laid out depth first, so a cell's children follow it and Next skips its whole subtree
+		const uint32_t index = static_cast<uint32_t>(mNodes.size());
+		mNodes.emplace_back();
+
+		float mass = 0.0f;
+		XMFLOAT3 weightedPosition(0.0f, 0.0f, 0.0f);
+		uint32_t firstBody = beginSlot;
+		uint32_t bodyCount = endSlot - beginSlot;
+		const bool isLeaf = (bodyCount <= LeafCapacity || depth == MaxDepth);
+
+		// The largest cells that fit in a group become one, as does any leaf still too full, so every body is in exactly one
+		if (!inGroup && (bodyCount <= GroupCapacity || isLeaf))
+		{
+			AddGroup(beginSlot, endSlot);
+			inGroup = true;
+		}
+
+		if (isLeaf)
+		{
+			for (uint32_t slot = beginSlot; slot < endSlot; ++slot)
+			{
+				mass += mBodyMasses[slot];
+				weightedPosition.x += mBodyMasses[slot] * mBodiesX[slot];
+				weightedPosition.y += mBodyMasses[slot] * mBodiesY[slot];
+				weightedPosition.z += mBodyMasses[slot] * mBodiesZ[slot];
+			}
+		}
+		else
+		{
+			// Bodies are sorted by Morton key, so each octant is a contiguous run of the range
+			for (uint32_t childBegin = beginSlot; childBegin < endSlot;)
+			{
+				const uint32_t octant = Octant(mKeys[childBegin], depth);
+				uint32_t childEnd = childBegin + 1;
+				while (childEnd < endSlot && Octant(mKeys[childEnd], depth) == octant)
+				{
+					++childEnd;
+				}
+
+				const float childSize = size * 0.5f;
+				const XMFLOAT3 childCorner(corner.x + ((octant & 1) ? childSize : 0.0f), corner.y + ((octant & 2) ? childSize : 0.0f), corner.z + ((octant & 4) ? childSize : 0.0f));
+				const Node& child = mNodes[BuildNode(childBegin, childEnd, depth + 1, childCorner, childSize, inGroup)];
+				mass += child.Mass;
+				weightedPosition.x += child.Mass * child.CenterOfMass.x;
+				weightedPosition.y += child.Mass * child.CenterOfMass.y;
+				weightedPosition.z += child.Mass * child.CenterOfMass.z;
+				childBegin = childEnd;
+			}
+
+			firstBody = 0;
+			bodyCount = 0;
+		}
+
+		Node& node = mNodes[index];
+		if (mass > 0.0f)
+		{
+			const float inverseMass = 1.0f / mass;
+			node.CenterOfMass = XMFLOAT3(weightedPosition.x * inverseMass, weightedPosition.y * inverseMass, weightedPosition.z * inverseMass);
+		}
+		else
+		{
+			node.CenterOfMass = XMFLOAT3(mBodiesX[beginSlot], mBodiesY[beginSlot], mBodiesZ[beginSlot]);
+		}
+
+		node.Mass = mass;
+
+		// Barnes' offset criterion: a cell is accepted beyond size / angle plus the distance from its center to its center of mass,
+		// which keeps lopsided cells from being accepted while a body is still close to their mass
+		const float offsetX = node.CenterOfMass.x - (corner.x + size * 0.5f);
+		const float offsetY = node.CenterOfMass.y - (corner.y + size * 0.5f);
+		const float offsetZ = node.CenterOfMass.z - (corner.z + size * 0.5f);
+		const float openingRadius = size * mInverseOpeningAngle + sqrtf(offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ);
+		node.OpeningRadiusSquared = openingRadius * openingRadius;
+		node.Next = static_cast<uint32_t>(mNodes.size());
+		node.FirstBody = firstBody;
+		node.BodyCount = bodyCount;
+
+		return index;
+	}
+
+	void BarnesHutTree::AddGroup(uint32_t beginSlot, uint32_t endSlot)
+	{
+		Group group;
+		group.Minimum = XMFLOAT3(mBodiesX[beginSlot], mBodiesY[beginSlot], mBodiesZ[beginSlot]);
+		group.Maximum = group.Minimum;
+		for (uint32_t slot = beginSlot + 1; slot < endSlot; ++slot)
+		{
+			group.Minimum.x = (mBodiesX[slot] < group.Minimum.x ? mBodiesX[slot] : group.Minimum.x);
+			group.Minimum.y = (mBodiesY[slot] < group.Minimum.y ? mBodiesY[slot] : group.Minimum.y);
+			group.Minimum.z = (mBodiesZ[slot] < group.Minimum.z ? mBodiesZ[slot] : group.Minimum.z);
+			group.Maximum.x = (mBodiesX[slot] > group.Maximum.x ? mBodiesX[slot] : group.Maximum.x);
+			group.Maximum.y = (mBodiesY[slot] > group.Maximum.y ? mBodiesY[slot] : group.Maximum.y);
+			group.Maximum.z = (mBodiesZ[slot] > group.Maximum.z ? mBodiesZ[slot] : group.Maximum.z);
+		}
+
+		group.FirstBody = beginSlot;
+		group.BodyCount = endSlot - beginSlot;
+		mGroups.push_back(group);
+	}
+
+	void BarnesHutTree::Gather(const Group& group, InteractionList& list) const
+	{
+		list.Clear();
+
+		// Stackless traversal: skip to Next when a cell is accepted, otherwise step into its first child. A cell is only
+		// accepted when the nearest point of the group's bounds is outside its opening radius, so it would have been
+		// accepted for every body in the group on its own.
+		const uint32_t nodeCount = static_cast<uint32_t>(mNodes.size());
+		for (uint32_t index = 0; index < nodeCount;)
+		{
+			const Node& node = mNodes[index];
+			const float dx = max(0.0f, max(group.Minimum.x - node.CenterOfMass.x, node.CenterOfMass.x - group.Maximum.x));
+			const float dy = max(0.0f, max(group.Minimum.y - node.CenterOfMass.y, node.CenterOfMass.y - group.Maximum.y));
+			const float dz = max(0.0f, max(group.Minimum.z - node.CenterOfMass.z, node.CenterOfMass.z - group.Maximum.z));
+
+			if (dx * dx + dy * dy + dz * dz > node.OpeningRadiusSquared)
+			{
+				list.Add(node.CenterOfMass.x, node.CenterOfMass.y, node.CenterOfMass.z, node.Mass);
+				index = node.Next;
+			}
+			else if (node.BodyCount > 0)
+			{
+				const uint32_t endSlot = node.FirstBody + node.BodyCount;
+				for (uint32_t slot = node.FirstBody; slot < endSlot; ++slot)
+				{
+					list.Add(mBodiesX[slot], mBodiesY[slot], mBodiesZ[slot], mBodyMasses[slot]);
+				}
+
+				index = node.Next;
+			}
+			else
+			{
+				++index;
+			}
+		}
+
+		// Massless padding out to whole vectors
+		while ((list.Size() & 3U) != 0)
+		{
+			list.Add(0.0f, 0.0f, 0.0f, 0.0f);
+		}
+	}
+
+	void BarnesHutTree::Evaluate(const Group& group, const InteractionList& list, float softeningSquared, float scale, float* accelerationsX, float* accelerationsY, float* accelerationsZ) const
+	{
+		assert((list.Size() & 3U) == 0);
+
+		const XMVECTOR softening = XMVectorReplicate(softeningSquared);
+		const XMVECTOR zero = XMVectorZero();
+		const uint32_t endSlot = group.FirstBody + group.BodyCount;
+		const uint32_t listSize = list.Size();
+
+		for (uint32_t slot = group.FirstBody; slot < endSlot; ++slot)
+		{
+			const XMVECTOR positionX = XMVectorReplicate(mBodiesX[slot]);
+			const XMVECTOR positionY = XMVectorReplicate(mBodiesY[slot]);
+			const XMVECTOR positionZ = XMVectorReplicate(mBodiesZ[slot]);
+			XMVECTOR accelerationX = zero;
+			XMVECTOR accelerationY = zero;
+			XMVECTOR accelerationZ = zero;
+
+			for (uint32_t i = 0; i < listSize; i += 4)
+			{
+				const XMVECTOR dx = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&list.X[i])), positionX);
+				const XMVECTOR dy = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&list.Y[i])), positionY);
+				const XMVECTOR dz = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&list.Z[i])), positionZ);
+				const XMVECTOR distanceSquared = XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiplyAdd(dz, dz, softening)));
+				const XMVECTOR inverseDistance = XMVectorReciprocalSqrt(distanceSquared);
+
+				// The body itself is in the list with no offset, so it adds nothing; without softening the lane is masked
+				// so that zero over zero does not turn into NaN
+				XMVECTOR strength = XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&list.Masses[i])), XMVectorMultiply(inverseDistance, XMVectorMultiply(inverseDistance, inverseDistance)));
+				strength = XMVectorSelect(zero, strength, XMVectorGreater(distanceSquared, zero));
+				accelerationX = XMVectorMultiplyAdd(strength, dx, accelerationX);
+				accelerationY = XMVectorMultiplyAdd(strength, dy, accelerationY);
+				accelerationZ = XMVectorMultiplyAdd(strength, dz, accelerationZ);
+			}
+
+			XMFLOAT4 sumX;
+			XMFLOAT4 sumY;
+			XMFLOAT4 sumZ;
+			XMStoreFloat4(&sumX, accelerationX);
+			XMStoreFloat4(&sumY, accelerationY);
+			XMStoreFloat4(&sumZ, accelerationZ);
+
+			const uint32_t body = mOrder[slot];
+			accelerationsX[body] = scale * ((sumX.x + sumX.y) + (sumX.z + sumX.w));
+			accelerationsY[body] = scale * ((sumY.x + sumY.y) + (sumY.z + sumY.w));
+			accelerationsZ[body] = scale * ((sumZ.x + sumZ.y) + (sumZ.z + sumZ.w));
+		}
+	}
+}
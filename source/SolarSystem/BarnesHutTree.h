@@ -0,0 +1,81 @@
+#pragma once
+
+#include "AlignedAllocator.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace SolarSystem
+{
+	class BarnesHutTree final
+	{
+	public:
+		static const std::uint32_t LeafCapacity;
+		static const std::uint32_t MaxDepth;
+		static const std::uint32_t GroupCapacity;
+
+		BarnesHutTree();
+		BarnesHutTree(const BarnesHutTree&) = delete;
+		BarnesHutTree& operator=(const BarnesHutTree&) = delete;
+		BarnesHutTree(BarnesHutTree&&) = default;
+		BarnesHutTree& operator=(BarnesHutTree&&) = default;
+		~BarnesHutTree() = default;
+
+		void Build(const float* positionsX, const float* positionsY, const float* positionsZ, const float* masses, std::uint32_t count, float openingAngle);
+
+		void Accelerations(std::uint32_t beginGroup, std::uint32_t endGroup, float softeningSquared, float scale, float* accelerationsX, float* accelerationsY, float* accelerationsZ) const;
+
+		std::uint32_t BodyCount() const;
+		std::uint32_t NodeCount() const;
+		std::uint32_t GroupCount() const;
+
+	private:
+		struct Node
+		{
+			DirectX::XMFLOAT3 CenterOfMass;
+			float Mass;
+			float OpeningRadiusSquared;
+			std::uint32_t Next;
+			std::uint32_t FirstBody;
+			std::uint32_t BodyCount;
+		};
+
+		struct Group
+		{
+			DirectX::XMFLOAT3 Minimum;
+			DirectX::XMFLOAT3 Maximum;
+			std::uint32_t FirstBody;
+			std::uint32_t BodyCount;
+		};
+
+		struct InteractionList
+		{
+			Library::AlignedVector<float> X;
+			Library::AlignedVector<float> Y;
+			Library::AlignedVector<float> Z;
+			Library::AlignedVector<float> Masses;
+
+			void Clear();
+			void Add(float x, float y, float z, float mass);
+			std::uint32_t Size() const;
+		};
+
+		void SortBodies(const float* positionsX, const float* positionsY, const float* positionsZ, std::uint32_t count, const DirectX::XMFLOAT3& origin, float size);
+		std::uint32_t BuildNode(std::uint32_t beginSlot, std::uint32_t endSlot, std::uint32_t depth, const DirectX::XMFLOAT3& corner, float size, bool inGroup);
+		void AddGroup(std::uint32_t beginSlot, std::uint32_t endSlot);
+		void Gather(const Group& group, InteractionList& list) const;
+		void Evaluate(const Group& group, const InteractionList& list, float softeningSquared, float scale, float* accelerationsX, float* accelerationsY, float* accelerationsZ) const;
+
+		std::vector<Node> mNodes;
+		std::vector<Group> mGroups;
+		std::vector<std::uint64_t> mKeys;
+		std::vector<std::uint64_t> mSortedKeys;
+		std::vector<std::uint32_t> mOrder;
+		std::vector<std::uint32_t> mSortedOrder;
+		Library::AlignedVector<float> mBodiesX;
+		Library::AlignedVector<float> mBodiesY;
+		Library::AlignedVector<float> mBodiesZ;
+		Library::AlignedVector<float> mBodyMasses;
+		float mInverseOpeningAngle;
+	};
+}
@@ -0,0 +1,37 @@
+#include "pch.h"
+#include "BodyInstanceBuilder.h"
+#include "CelestialBodyStore.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace SolarSystem
+{
+	const uint32_t BodyInstanceBuilder::LitFlag = 0x1;
+
+	void BodyInstanceBuilder::Build(const CelestialBodyStore& store, const BodyInstanceSource* sources, uint32_t count, float interpolation, BodyInstance* instances)
+	{
+		// The same blend as CelestialBodyStore::InterpolatedWorldMatrix, written row by row straight into the instance.
+		// The world matrix stays row-major: the input layout feeds its rows in as the shader's matrix rows.
+		const XMFLOAT4X4* previousWorldMatrices = store.PreviousWorldMatrices();
+		const XMFLOAT4X4* worldMatrices = store.WorldMatrices();
+		const XMVECTOR blend = XMVectorReplicate(interpolation);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const BodyInstanceSource& source = sources[i];
+			const uint32_t slot = store.Slot(source.Body);
+			BodyInstance& instance = instances[i];
+
+			for (uint32_t row = 0; row < 4; ++row)
+			{
+				const XMVECTOR previous = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(previousWorldMatrices[slot].m[row]));
+				const XMVECTOR current = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(worldMatrices[slot].m[row]));
+				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(instance.World.m[row]), XMVectorLerpV(previous, current, blend));
+			}
+
+			instance.TextureIndex = source.TextureIndex;
+			instance.Flags = (store.IsLit(source.Body) ? LitFlag : 0);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace SolarSystem
+{
+	class CelestialBodyStore;
+
+	struct BodyInstanceSource
+	{
+		std::uint32_t Body;
+		std::uint32_t TextureIndex;
+	};
+
+	struct BodyInstance
+	{
+		DirectX::XMFLOAT4X4 World;
+		std::uint32_t TextureIndex;
+		std::uint32_t Flags;
+	};
+
+	class BodyInstanceBuilder final
+	{
+	public:
+		static const std::uint32_t LitFlag;
+
+		static void Build(const CelestialBodyStore& store, const BodyInstanceSource* sources, std::uint32_t count, float interpolation, BodyInstance* instances);
+
+		BodyInstanceBuilder() = delete;
+		BodyInstanceBuilder(const BodyInstanceBuilder&) = delete;
+		BodyInstanceBuilder& operator=(const BodyInstanceBuilder&) = delete;
+		BodyInstanceBuilder(BodyInstanceBuilder&&) = delete;
+		BodyInstanceBuilder& operator=(BodyInstanceBuilder&&) = delete;
+		~BodyInstanceBuilder() = default;
+	};
+}
@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "BodyLodSelector.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace SolarSystem
+{
+	const uint32_t BodyLodSelector::LodCount;
+	const uint32_t BodyLodSelector::ImpostorLod;
+
+	// Smallest projected radius, in pixels, at which each of the finer levels is still used. Each is where the next coarser
+	// sphere's silhouette would sag by more than about half a pixel (r * (1 - cos(pi / slices))). Below the last threshold
+	// a body gets the coarsest mesh, and once it is under two pixels across it is a single point.
+	const float BodyLodSelector::LodScreenRadii[] = { 256.0f, 64.0f, 16.0f };
+	const float BodyLodSelector::ImpostorScreenRadius = 1.0f;
+
+	float BodyLodSelector::ProjectionScale(CXMMATRIX projectionMatrix, float viewportHeight)
+	{
+		// A sphere of radius r at distance d covers about r * scale / d pixels of the viewport's half-height
+		XMFLOAT4X4 projection;
+		XMStoreFloat4x4(&projection, projectionMatrix);
+
+		return projection._22 * viewportHeight * 0.5f;
+	}
+
+	uint32_t BodyLodSelector::Lod(float screenRadius)
+	{
+		if (screenRadius < ImpostorScreenRadius)
+		{
+			return ImpostorLod;
+		}
+
+		uint32_t lod = 0;
+		while (lod < LodCount - 1 && screenRadius < LodScreenRadii[lod])
+		{
+			++lod;
+		}
+
+		return lod;
+	}
+
+	void BodyLodSelector::Select(const BodyLodInputs& inputs, FXMVECTOR cameraPosition, float projectionScale, const uint32_t* slots, uint32_t count, uint8_t* lods)
+	{
+		// Positions are blended the same way the bodies are drawn, as in FrustumCullingKernel
+		const XMVECTOR blend = XMVectorReplicate(inputs.Interpolation);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t slot = slots[i];
+			const XMVECTOR previous = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(inputs.PreviousWorldMatrices[slot].m[3]));
+			const XMVECTOR current = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(inputs.WorldMatrices[slot].m[3]));
+			const float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMVectorLerpV(previous, current, blend), cameraPosition)));
+			const float radius = inputs.Radii[slot] * inputs.RadiusScale;
+
+			// A camera inside or touching the sphere always gets the finest mesh
+			lods[i] = static_cast<uint8_t>(distance <= radius ? 0 : Lod(radius * projectionScale / distance));
+		}
+	}
+}
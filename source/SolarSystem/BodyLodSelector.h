@@ -0,0 +1,36 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace SolarSystem
+{
+	struct BodyLodInputs
+	{
+		const DirectX::XMFLOAT4X4* PreviousWorldMatrices;
+		const DirectX::XMFLOAT4X4* WorldMatrices;
+		const float* Radii;
+		float RadiusScale;
+		float Interpolation;
+	};
+
+	class BodyLodSelector final
+	{
+	public:
+		static const std::uint32_t LodCount = 4;
+		static const std::uint32_t ImpostorLod = LodCount;
+		static const float LodScreenRadii[LodCount - 1];
+		static const float ImpostorScreenRadius;
+
+		static float ProjectionScale(DirectX::CXMMATRIX projectionMatrix, float viewportHeight);
+		static std::uint32_t Lod(float screenRadius);
+		static void Select(const BodyLodInputs& inputs, DirectX::FXMVECTOR cameraPosition, float projectionScale, const std::uint32_t* slots, std::uint32_t count, std::uint8_t* lods);
+
+		BodyLodSelector() = delete;
+		BodyLodSelector(const BodyLodSelector&) = delete;
+		BodyLodSelector& operator=(const BodyLodSelector&) = delete;
+		BodyLodSelector(BodyLodSelector&&) = delete;
+		BodyLodSelector& operator=(BodyLodSelector&&) = delete;
+		~BodyLodSelector() = default;
+	};
+}
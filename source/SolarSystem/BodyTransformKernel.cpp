@@ -0,0 +1,230 @@
+#include "pch.h"
+#include "BodyTransformKernel.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace DirectX;
+
+namespace SolarSystem
+{
+	// The body transform is Scale * RotationY(rotation) * RotationZ(tilt) * Translation(orbit, 0, 0) * RotationY(revolution).
+	// Multiplied out, with s = scale, d = orbit and (sr, cr), (st, ct), (sv, cv) the sine/cosine pairs of the three angles:
+	//
+	//   |  s(cr ct cv - sr sv)   s cr st   -s(cr ct sv + sr cv)   0 |
+	//   | -s st cv               s ct       s st sv               0 |
+	//   |  s(sr ct cv + cr sv)   s sr st    s(cr cv - sr ct sv)   0 |
+	//   |  d cv                  0         -d sv                  1 |
+
+	uint32_t BodyTransformKernel::BatchWidth()
+	{
+#if defined(__AVX2__)
+		return 8;
+#else
+		return 4;
+#endif
+	}
+
+	void BodyTransformKernel::Compute(const BodyTransformInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+#if defined(__AVX2__)
+		const uint32_t avxEnd = begin + ((end - begin) & ~7U);
+		ComputeAVX2(inputs, begin, avxEnd, worldMatrices);
+		begin = avxEnd;
+#endif
+
+		const uint32_t vectorEnd = begin + ((end - begin) & ~3U);
+		ComputeVector(inputs, begin, vectorEnd, worldMatrices);
+		ComputeScalar(inputs, vectorEnd, end, worldMatrices);
+	}
+
+	void BodyTransformKernel::ComputeScalar(const BodyTransformInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			float sr, cr, st, ct, sv, cv;
+			XMScalarSinCos(&sr, &cr, inputs.Rotations[i]);
+			XMScalarSinCos(&st, &ct, inputs.AxialTilts[i]);
+			XMScalarSinCos(&sv, &cv, inputs.Revolutions[i]);
+
+			const float s = inputs.Scales[i];
+			const float d = inputs.OrbitalDistances[i];
+			const float crct = cr * ct;
+			const float srct = sr * ct;
+
+			worldMatrices[i] = XMFLOAT4X4(
+				s * (crct * cv - sr * sv), s * cr * st, -s * (crct * sv + sr * cv), 0.0f,
+				-s * st * cv, s * ct, s * st * sv, 0.0f,
+				s * (srct * cv + cr * sv), s * sr * st, s * (cr * cv - srct * sv), 0.0f,
+				d * cv, 0.0f, -d * sv, 1.0f);
+		}
+	}
+
+	void BodyTransformKernel::ComputeVector(const BodyTransformInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+		assert(((end - begin) & 3U) == 0);
+
+		const XMVECTOR zero = XMVectorZero();
+		const XMVECTOR one = XMVectorSplatOne();
+
+		for (uint32_t i = begin; i < end; i += 4)
+		{
+			// Each lane holds one body
+			XMVECTOR sr, cr, st, ct, sv, cv;
+			XMVectorSinCos(&sr, &cr, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.Rotations[i])));
+			XMVectorSinCos(&st, &ct, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.AxialTilts[i])));
+			XMVectorSinCos(&sv, &cv, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.Revolutions[i])));
+
+			const XMVECTOR s = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.Scales[i]));
+			const XMVECTOR d = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.OrbitalDistances[i]));
+			const XMVECTOR crct = XMVectorMultiply(cr, ct);
+			const XMVECTOR srct = XMVectorMultiply(sr, ct);
+			const XMVECTOR sst = XMVectorMultiply(s, st);
+
+			const XMVECTOR m00 = XMVectorMultiply(s, XMVectorNegativeMultiplySubtract(sr, sv, XMVectorMultiply(crct, cv)));
+			const XMVECTOR m01 = XMVectorMultiply(sst, cr);
+			const XMVECTOR m02 = XMVectorNegate(XMVectorMultiply(s, XMVectorMultiplyAdd(sr, cv, XMVectorMultiply(crct, sv))));
+			const XMVECTOR m10 = XMVectorNegate(XMVectorMultiply(sst, cv));
+			const XMVECTOR m11 = XMVectorMultiply(s, ct);
+			const XMVECTOR m12 = XMVectorMultiply(sst, sv);
+			const XMVECTOR m20 = XMVectorMultiply(s, XMVectorMultiplyAdd(cr, sv, XMVectorMultiply(srct, cv)));
+			const XMVECTOR m21 = XMVectorMultiply(sst, sr);
+			const XMVECTOR m22 = XMVectorMultiply(s, XMVectorNegativeMultiplySubtract(srct, sv, XMVectorMultiply(cr, cv)));
+			const XMVECTOR m30 = XMVectorMultiply(d, cv);
+			const XMVECTOR m32 = XMVectorNegate(XMVectorMultiply(d, sv));
+
+			// Transpose from one-body-per-lane back to one-row-per-body
+			const XMMATRIX row0 = XMMatrixTranspose(XMMATRIX(m00, m01, m02, zero));
+			const XMMATRIX row1 = XMMatrixTranspose(XMMATRIX(m10, m11, m12, zero));
+			const XMMATRIX row2 = XMMatrixTranspose(XMMATRIX(m20, m21, m22, zero));
+			const XMMATRIX row3 = XMMatrixTranspose(XMMATRIX(m30, zero, m32, one));
+
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				XMStoreFloat4x4(&worldMatrices[i + lane], XMMATRIX(row0.r[lane], row1.r[lane], row2.r[lane], row3.r[lane]));
+			}
+		}
+	}
+
+	void BodyTransformKernel::ComputeReference(const BodyTransformInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const float scale = inputs.Scales[i];
+			XMStoreFloat4x4(&worldMatrices[i], XMMatrixScaling(scale, scale, scale) * XMMatrixRotationY(inputs.Rotations[i]) * XMMatrixRotationZ(inputs.AxialTilts[i]) * XMMatrixTranslation(inputs.OrbitalDistances[i], 0.0f, 0.0f) * XMMatrixRotationY(inputs.Revolutions[i]));
+		}
+	}
+
+#if defined(__AVX2__)
+	namespace
+	{
+		// Eight-wide port of XMVectorSinCos: range reduce to [-pi, pi], reflect into [-pi/2, pi/2], then evaluate
+		// the same 11th (sine) and 10th (cosine) degree minimax polynomials.
+		inline void SinCos8(__m256 angles, __m256& sine, __m256& cosine)
+		{
+			const __m256 twoPi = _mm256_set1_ps(XM_2PI);
+			const __m256 reciprocalTwoPi = _mm256_set1_ps(XM_1DIV2PI);
+			const __m256 pi = _mm256_set1_ps(XM_PI);
+			const __m256 halfPi = _mm256_set1_ps(XM_PIDIV2);
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 negativeZero = _mm256_set1_ps(-0.0f);
+
+			__m256 x = _mm256_mul_ps(angles, reciprocalTwoPi);
+			x = _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			x = _mm256_sub_ps(angles, _mm256_mul_ps(x, twoPi));
+
+			const __m256 sign = _mm256_and_ps(x, negativeZero);
+			const __m256 reflectionPoint = _mm256_or_ps(pi, sign);
+			const __m256 absoluteX = _mm256_andnot_ps(sign, x);
+			const __m256 reflected = _mm256_sub_ps(reflectionPoint, x);
+			const __m256 inRange = _mm256_cmp_ps(absoluteX, halfPi, _CMP_LE_OQ);
+			x = _mm256_blendv_ps(reflected, x, inRange);
+			const __m256 cosineSign = _mm256_blendv_ps(_mm256_set1_ps(-1.0f), one, inRange);
+
+			const __m256 x2 = _mm256_mul_ps(x, x);
+
+			__m256 result = _mm256_set1_ps(-2.3889859e-08f);
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(2.7525562e-06f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(-0.00019840874f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(0.0083333310f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(-0.16666667f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), one);
+			sine = _mm256_mul_ps(result, x);
+
+			result = _mm256_set1_ps(-2.6051615e-07f);
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(2.4760495e-05f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(-0.0013888378f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(0.041666638f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), _mm256_set1_ps(-0.5f));
+			result = _mm256_add_ps(_mm256_mul_ps(result, x2), one);
+			cosine = _mm256_mul_ps(result, cosineSign);
+		}
+
+		// Transposes four eight-lane vectors (one body per lane) into eight four-float rows and stores row "row" of each body
+		inline void StoreRows8(__m256 x, __m256 y, __m256 z, __m256 w, uint32_t row, XMFLOAT4X4* worldMatrices)
+		{
+			const __m256 xy0 = _mm256_unpacklo_ps(x, y);
+			const __m256 xy1 = _mm256_unpackhi_ps(x, y);
+			const __m256 zw0 = _mm256_unpacklo_ps(z, w);
+			const __m256 zw1 = _mm256_unpackhi_ps(z, w);
+
+			const __m256 bodies04 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 bodies15 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2));
+			const __m256 bodies26 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 bodies37 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2));
+
+			_mm_storeu_ps(worldMatrices[0].m[row], _mm256_castps256_ps128(bodies04));
+			_mm_storeu_ps(worldMatrices[1].m[row], _mm256_castps256_ps128(bodies15));
+			_mm_storeu_ps(worldMatrices[2].m[row], _mm256_castps256_ps128(bodies26));
+			_mm_storeu_ps(worldMatrices[3].m[row], _mm256_castps256_ps128(bodies37));
+			_mm_storeu_ps(worldMatrices[4].m[row], _mm256_extractf128_ps(bodies04, 1));
+			_mm_storeu_ps(worldMatrices[5].m[row], _mm256_extractf128_ps(bodies15, 1));
+			_mm_storeu_ps(worldMatrices[6].m[row], _mm256_extractf128_ps(bodies26, 1));
+			_mm_storeu_ps(worldMatrices[7].m[row], _mm256_extractf128_ps(bodies37, 1));
+		}
+	}
+
+	void BodyTransformKernel::ComputeAVX2(const BodyTransformInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+		assert(((end - begin) & 7U) == 0);
+
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 negativeZero = _mm256_set1_ps(-0.0f);
+
+		for (uint32_t i = begin; i < end; i += 8)
+		{
+			__m256 sr, cr, st, ct, sv, cv;
+			SinCos8(_mm256_loadu_ps(&inputs.Rotations[i]), sr, cr);
+			SinCos8(_mm256_loadu_ps(&inputs.AxialTilts[i]), st, ct);
+			SinCos8(_mm256_loadu_ps(&inputs.Revolutions[i]), sv, cv);
+
+			const __m256 s = _mm256_loadu_ps(&inputs.Scales[i]);
+			const __m256 d = _mm256_loadu_ps(&inputs.OrbitalDistances[i]);
+			const __m256 crct = _mm256_mul_ps(cr, ct);
+			const __m256 srct = _mm256_mul_ps(sr, ct);
+			const __m256 sst = _mm256_mul_ps(s, st);
+
+			const __m256 m00 = _mm256_mul_ps(s, _mm256_sub_ps(_mm256_mul_ps(crct, cv), _mm256_mul_ps(sr, sv)));
+			const __m256 m01 = _mm256_mul_ps(sst, cr);
+			const __m256 m02 = _mm256_xor_ps(_mm256_mul_ps(s, _mm256_add_ps(_mm256_mul_ps(crct, sv), _mm256_mul_ps(sr, cv))), negativeZero);
+			const __m256 m10 = _mm256_xor_ps(_mm256_mul_ps(sst, cv), negativeZero);
+			const __m256 m11 = _mm256_mul_ps(s, ct);
+			const __m256 m12 = _mm256_mul_ps(sst, sv);
+			const __m256 m20 = _mm256_mul_ps(s, _mm256_add_ps(_mm256_mul_ps(srct, cv), _mm256_mul_ps(cr, sv)));
+			const __m256 m21 = _mm256_mul_ps(sst, sr);
+			const __m256 m22 = _mm256_mul_ps(s, _mm256_sub_ps(_mm256_mul_ps(cr, cv), _mm256_mul_ps(srct, sv)));
+			const __m256 m30 = _mm256_mul_ps(d, cv);
+			const __m256 m32 = _mm256_xor_ps(_mm256_mul_ps(d, sv), negativeZero);
+
+			XMFLOAT4X4* destination = &worldMatrices[i];
+			StoreRows8(m00, m01, m02, zero, 0, destination);
+			StoreRows8(m10, m11, m12, zero, 1, destination);
+			StoreRows8(m20, m21, m22, zero, 2, destination);
+			StoreRows8(m30, zero, m32, one, 3, destination);
+		}
+	}
+#endif
+}
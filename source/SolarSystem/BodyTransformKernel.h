@@ -0,0 +1,38 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace SolarSystem
+{
+	struct BodyTransformInputs
+	{
+		const float* Scales;
+		const float* Rotations;
+		const float* AxialTilts;
+		const float* OrbitalDistances;
+		const float* Revolutions;
+	};
+
+	class BodyTransformKernel final
+	{
+	public:
+		static std::uint32_t BatchWidth();
+
+		static void Compute(const BodyTransformInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+		static void ComputeScalar(const BodyTransformInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+		static void ComputeVector(const BodyTransformInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+		static void ComputeReference(const BodyTransformInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+
+#if defined(__AVX2__)
+		static void ComputeAVX2(const BodyTransformInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+#endif
+
+		BodyTransformKernel() = delete;
+		BodyTransformKernel(const BodyTransformKernel&) = delete;
+		BodyTransformKernel& operator=(const BodyTransformKernel&) = delete;
+		BodyTransformKernel(BodyTransformKernel&&) = delete;
+		BodyTransformKernel& operator=(BodyTransformKernel&&) = delete;
+		~BodyTransformKernel() = default;
+	};
+}
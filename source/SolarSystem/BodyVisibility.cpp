@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "BodyVisibility.h"
+#include "CelestialBodyStore.h"
+#include "FrustumCullingKernel.h"
+#include "Frustum.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	BodyVisibility::BodyVisibility() :
+		mVisibleCount(0), mMeshRadius(1.0f), mCullingEnabled(true), mLodEnabled(true)
+	{
+	}
+
+	float BodyVisibility::BoundingRadius(const void* positions, uint32_t count, uint32_t stride)
+	{
+		// Bodies scale the sphere, so a body's bounding radius is its scale times the mesh's own radius
+		float radius = 0.0f;
+		const uint8_t* position = static_cast<const uint8_t*>(positions);
+		for (uint32_t i = 0; i < count; ++i, position += stride)
+		{
+			radius = max(radius, XMVectorGetX(XMVector3Length(XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(position)))));
+		}
+
+		return radius;
+	}
+
+	float BodyVisibility::MeshRadius() const
+	{
+		return mMeshRadius;
+	}
+
+	void BodyVisibility::SetMeshRadius(float meshRadius)
+	{
+		mMeshRadius = meshRadius;
+	}
+
+	bool BodyVisibility::CullingEnabled() const
+	{
+		return mCullingEnabled;
+	}
+
+	void BodyVisibility::SetCullingEnabled(bool enabled)
+	{
+		mCullingEnabled = enabled;
+	}
+
+	bool BodyVisibility::LodEnabled() const
+	{
+		return mLodEnabled;
+	}
+
+	void BodyVisibility::SetLodEnabled(bool enabled)
+	{
+		mLodEnabled = enabled;
+	}
+
+	void BodyVisibility::Prepare(const CelestialBodyStore& store, CXMMATRIX viewProjectionMatrix, CXMMATRIX projectionMatrix, FXMVECTOR cameraPosition, float viewportHeight, float interpolation)
+	{
+		// The whole store is tested in slot order, straight off its arrays
+		mVisibleSlots.resize(store.Size());
+		mVisibleCount = store.Size();
+		if (mCullingEnabled)
+		{
+			const FrustumCullingInputs cullingInputs = { store.PreviousWorldMatrices(), store.WorldMatrices(), store.Scales(), mMeshRadius, interpolation };
+			mVisibleCount = FrustumCullingKernel::Cull(Frustum(viewProjectionMatrix), cullingInputs, 0, store.Size(), mVisibleSlots.data());
+		}
+		else
+		{
+			for (uint32_t slot = 0; slot < mVisibleCount; ++slot)
+			{
+				mVisibleSlots[slot] = slot;
+			}
+		}
+
+		// Only the survivors are sized on screen
+		mVisibleLods.assign(mVisibleCount, 0);
+		if (mLodEnabled)
+		{
+			const BodyLodInputs lodInputs = { store.PreviousWorldMatrices(), store.WorldMatrices(), store.Scales(), mMeshRadius, interpolation };
+			const float projectionScale = BodyLodSelector::ProjectionScale(projectionMatrix, viewportHeight);
+			BodyLodSelector::Select(lodInputs, cameraPosition, projectionScale, mVisibleSlots.data(), mVisibleCount, mVisibleLods.data());
+		}
+	}
+
+	uint32_t BodyVisibility::VisibleCount() const
+	{
+		return mVisibleCount;
+	}
+
+	const uint32_t* BodyVisibility::VisibleSlots() const
+	{
+		return mVisibleSlots.data();
+	}
+
+	const uint8_t* BodyVisibility::VisibleLods() const
+	{
+		return mVisibleLods.data();
+	}
+}
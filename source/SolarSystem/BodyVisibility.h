@@ -0,0 +1,46 @@
+#pragma once
+
+#include "BodyLodSelector.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace SolarSystem
+{
+	class CelestialBodyStore;
+
+	// Which bodies a frame draws and at what level of detail, decided the same way for every renderer that draws them
+	class BodyVisibility final
+	{
+	public:
+		BodyVisibility();
+		BodyVisibility(const BodyVisibility&) = delete;
+		BodyVisibility& operator=(const BodyVisibility&) = delete;
+		BodyVisibility(BodyVisibility&&) = delete;
+		BodyVisibility& operator=(BodyVisibility&&) = delete;
+		~BodyVisibility() = default;
+
+		static float BoundingRadius(const void* positions, std::uint32_t count, std::uint32_t stride);
+
+		float MeshRadius() const;
+		void SetMeshRadius(float meshRadius);
+		bool CullingEnabled() const;
+		void SetCullingEnabled(bool enabled);
+		bool LodEnabled() const;
+		void SetLodEnabled(bool enabled);
+
+		void Prepare(const CelestialBodyStore& store, DirectX::CXMMATRIX viewProjectionMatrix, DirectX::CXMMATRIX projectionMatrix, DirectX::FXMVECTOR cameraPosition, float viewportHeight, float interpolation);
+
+		std::uint32_t VisibleCount() const;
+		const std::uint32_t* VisibleSlots() const;
+		const std::uint8_t* VisibleLods() const;
+
+	private:
+		std::vector<std::uint32_t> mVisibleSlots;
+		std::vector<std::uint8_t> mVisibleLods;
+		std::uint32_t mVisibleCount;
+		float mMeshRadius;
+		bool mCullingEnabled;
+		bool mLodEnabled;
+	};
+}
@@ -7,31 +7,25 @@ using namespace DirectX;
 
 namespace SolarSystem
 {
-	RTTI_DEFINITIONS(CelestialBody)
-
-	CelestialBody::CelestialBody(Game* game , float rotation, const wstring& texture, float axialTilt, float orbitalDistance, float scale, float revolutionRate, CelestialBody* orbitAround, bool isLit) :
-		mRotationRate(rotation), mRevolutionRate(revolutionRate), mWorldMatrix(MatrixHelper::Identity), mAxialTilt(axialTilt), mParent(orbitAround), 
-		mRotation(0.0f), mRevolution(0.0f), mOrbit(orbitalDistance), mIsLit(isLit), mSize(scale)
+	CelestialBody::CelestialBody(CelestialBodyStore& store, uint32_t index, const Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& colorTexture) :
+		mStore(&store), mIndex(index), mColorTexture(colorTexture)
 	{
-		mScale = XMMatrixScaling(scale, scale, scale);
-		mOrbitalDistance = XMMatrixTranslation(orbitalDistance, 0.0f, 0.0f);
-
-		ThrowIfFailed(CreateWICTextureFromFile(game->Direct3DDevice(), texture.c_str(), nullptr, mColorTexture.ReleaseAndGetAddressOf()), "CreateDDSTextureFromFile() failed.");
+		assert(index < store.Size());
 	}
 
-	void* CelestialBody::operator new(size_t i)
+	uint32_t CelestialBody::Index() const
 	{
-		return _mm_malloc(i, 16);
+		return mIndex;
 	}
 
-	void CelestialBody::operator delete(void* p)
+	XMMATRIX CelestialBody::WorldMatrix() const
 	{
-		return _mm_free(p);
+		return mStore->WorldMatrix(mIndex);
 	}
 
-	XMMATRIX CelestialBody::WorldMatrix()
+	XMMATRIX CelestialBody::WorldMatrix(float interpolation) const
 	{
-		return XMLoadFloat4x4(&mWorldMatrix);
+		return mStore->InterpolatedWorldMatrix(mIndex, interpolation);
 	}
 
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> CelestialBody::ColorTexture()
@@ -39,31 +33,13 @@ namespace SolarSystem
 		return mColorTexture;
 	}
 
-	bool CelestialBody::IsLit()
-	{
-		return mIsLit;
-	}
-
-	void CelestialBody::Update(const Library::GameTime& gameTime)
+	bool CelestialBody::IsLit() const
 	{
-			mRotation += gameTime.ElapsedGameTimeSeconds().count() * mRotationRate;
-			mRevolution += gameTime.ElapsedGameTimeSeconds().count() * mRevolutionRate;
-			
-			if (mParent == nullptr)
-			{
-				XMStoreFloat4x4(&mWorldMatrix, mScale * XMMatrixRotationY(mRotation) * XMMatrixRotationZ(mAxialTilt) * mOrbitalDistance * XMMatrixRotationY(mRevolution));
-			}
-
-			else
-			{
-				XMFLOAT3 parentPosition;
-				MatrixHelper::GetTranslation(XMLoadFloat4x4(&mParent->mWorldMatrix), parentPosition);
-				XMStoreFloat4x4(&mWorldMatrix, mScale * XMMatrixRotationY(mRotation) * XMMatrixRotationZ(mAxialTilt) * mOrbitalDistance * XMMatrixRotationY(mRevolution) * XMMatrixTranslation(parentPosition.x, parentPosition.y, parentPosition.z));
-			}
+		return mStore->IsLit(mIndex);
 	}
 
-	float CelestialBody::BodySize()
+	float CelestialBody::BodySize() const
 	{
-		return mSize;
+		return mStore->Scale(mIndex);
 	}
 }
\ No newline at end of file
@@ -1,40 +1,25 @@
 #pragma once
 
-#include "DrawableGameComponent.h"
+#include "CelestialBodyStore.h"
 #include <DirectXMath.h>
-#include <string>
 
 namespace SolarSystem
 {
-	class CelestialBody final : public Library::GameComponent
+	class CelestialBody final
 	{
-		RTTI_DECLARATIONS(CelestialBody, Library::GameComponent)
-
 	public:
-		CelestialBody(Library::Game* game, float rotation, const std::wstring& texture, float axialTilt, float orbitalDistance, float scale, float revolutionRate, CelestialBody* orbitAround, bool isLit);
-		virtual void Update(const Library::GameTime& gameTime) override;
-
-		void* operator new(size_t i);
-		void operator delete(void* p);
+		CelestialBody(CelestialBodyStore& store, std::uint32_t index, const Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& colorTexture);
 
-		DirectX::XMMATRIX WorldMatrix();
+		std::uint32_t Index() const;
+		DirectX::XMMATRIX WorldMatrix() const;
+		DirectX::XMMATRIX WorldMatrix(float interpolation) const;
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> ColorTexture();
-		float BodySize();
-		bool IsLit();
+		float BodySize() const;
+		bool IsLit() const;
 
 	private:
-		float mRotationRate;
-		float mRevolutionRate;
-		float mAxialTilt;
-		float mRotation;
-		float mRevolution;
-		float mOrbit;
-		float mSize;
+		CelestialBodyStore* mStore;
+		std::uint32_t mIndex;
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mColorTexture;
-		DirectX::XMFLOAT4X4 mWorldMatrix;
-		DirectX::XMMATRIX mScale;
-		DirectX::XMMATRIX mOrbitalDistance;
-		CelestialBody* mParent;
-		bool mIsLit;
 	};
 }
\ No newline at end of file
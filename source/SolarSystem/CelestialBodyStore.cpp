@@ -0,0 +1,575 @@
+#include "pch.h"
+#include "CelestialBodyStore.h"
+#include "BodyTransformKernel.h"
+#include "KeplerOrbitKernel.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	const uint32_t CelestialBodyStore::NoParent = UINT32_MAX;
+	const uint32_t CelestialBodyStore::UpdateGrainSize = 4096;
+
+	namespace
+	{
+		// Wraps an angle into [-pi, pi) in double precision before narrowing it to float
+		float ReduceAngle(double angle)
+		{
+			const double TwoPi = 6.28318530717958647692;
+			return static_cast<float>(angle - TwoPi * floor(angle / TwoPi + 0.5));
+		}
+	}
+
+	CelestialBodyStore::CelestialBodyStore() :
+		mLevelOffsets(1, 0), mKeplerianOffsets(1, 0), mHierarchyDirty(false)
+	{
+	}
+
+	uint32_t CelestialBodyStore::Add(float rotationRate, float axialTilt, float orbitalDistance, float scale, float revolutionRate, uint32_t parent, bool isLit)
+	{
+		assert(parent == NoParent || parent < Size());
+
+		uint32_t body = Size();
+		mRotationRates.push_back(rotationRate);
+		mRevolutionRates.push_back(revolutionRate);
+		mAxialTilts.push_back(axialTilt);
+		mOrbitalDistances.push_back(orbitalDistance);
+		mScales.push_back(scale);
+		mRotations.push_back(0.0f);
+		mRevolutions.push_back(0.0f);
+		mMotionModels.push_back(MotionModel::Circular);
+		mMeanMotions.push_back(0.0f);
+		mMeanAnomalies.push_back(0.0f);
+		mMeanAnomaliesAtEpoch.push_back(0.0f);
+		mEccentricities.push_back(0.0f);
+		mMajorAxesX.push_back(0.0f);
+		mMajorAxesY.push_back(0.0f);
+		mMajorAxesZ.push_back(0.0f);
+		mMinorAxesX.push_back(0.0f);
+		mMinorAxesY.push_back(0.0f);
+		mMinorAxesZ.push_back(0.0f);
+		mParents.push_back(parent == NoParent ? NoParent : mSlots[parent]);
+		mLitFlags.push_back(static_cast<uint8_t>(isLit ? 1 : 0));
+		mWorldMatrices.push_back(MatrixHelper::Identity);
+		mPreviousWorldMatrices.push_back(MatrixHelper::Identity);
+		mSlots.push_back(body);
+		mBodies.push_back(body);
+		mHierarchyDirty = true;
+
+		return body;
+	}
+
+	uint32_t CelestialBodyStore::AddKeplerian(float rotationRate, float axialTilt, const OrbitalElements& orbit, float scale, uint32_t parent, bool isLit)
+	{
+		// The circular kernel still provides spin and tilt; with no orbit or revolution it leaves the body at its parent
+		const uint32_t body = Add(rotationRate, axialTilt, 0.0f, scale, 0.0f, parent, isLit);
+		const uint32_t slot = mSlots[body];
+
+		XMFLOAT3 majorAxis, minorAxis;
+		KeplerOrbitKernel::OrbitAxes(orbit, majorAxis, minorAxis);
+
+		mMotionModels[slot] = MotionModel::Keplerian;
+		mMeanMotions[slot] = orbit.MeanMotion;
+		mMeanAnomalies[slot] = XMScalarModAngle(orbit.MeanAnomalyAtEpoch);
+		mMeanAnomaliesAtEpoch[slot] = mMeanAnomalies[slot];
+		mEccentricities[slot] = orbit.Eccentricity;
+		mMajorAxesX[slot] = majorAxis.x;
+		mMajorAxesY[slot] = majorAxis.y;
+		mMajorAxesZ[slot] = majorAxis.z;
+		mMinorAxesX[slot] = minorAxis.x;
+		mMinorAxesY[slot] = minorAxis.y;
+		mMinorAxesZ[slot] = minorAxis.z;
+
+		return body;
+	}
+
+	void CelestialBodyStore::Reserve(uint32_t capacity)
+	{
+		mRotationRates.reserve(capacity);
+		mRevolutionRates.reserve(capacity);
+		mAxialTilts.reserve(capacity);
+		mOrbitalDistances.reserve(capacity);
+		mScales.reserve(capacity);
+		mRotations.reserve(capacity);
+		mRevolutions.reserve(capacity);
+		mMotionModels.reserve(capacity);
+		mMeanMotions.reserve(capacity);
+		mMeanAnomalies.reserve(capacity);
+		mMeanAnomaliesAtEpoch.reserve(capacity);
+		mEccentricities.reserve(capacity);
+		mMajorAxesX.reserve(capacity);
+		mMajorAxesY.reserve(capacity);
+		mMajorAxesZ.reserve(capacity);
+		mMinorAxesX.reserve(capacity);
+		mMinorAxesY.reserve(capacity);
+		mMinorAxesZ.reserve(capacity);
+		mParents.reserve(capacity);
+		mLitFlags.reserve(capacity);
+		mWorldMatrices.reserve(capacity);
+		mPreviousWorldMatrices.reserve(capacity);
+		mSlots.reserve(capacity);
+		mBodies.reserve(capacity);
+	}
+
+	void CelestialBodyStore::Clear()
+	{
+		mRotationRates.clear();
+		mRevolutionRates.clear();
+		mAxialTilts.clear();
+		mOrbitalDistances.clear();
+		mScales.clear();
+		mRotations.clear();
+		mRevolutions.clear();
+		mMotionModels.clear();
+		mMeanMotions.clear();
+		mMeanAnomalies.clear();
+		mMeanAnomaliesAtEpoch.clear();
+		mEccentricities.clear();
+		mMajorAxesX.clear();
+		mMajorAxesY.clear();
+		mMajorAxesZ.clear();
+		mMinorAxesX.clear();
+		mMinorAxesY.clear();
+		mMinorAxesZ.clear();
+		mParents.clear();
+		mLitFlags.clear();
+		mWorldMatrices.clear();
+		mPreviousWorldMatrices.clear();
+		mSlots.clear();
+		mBodies.clear();
+		mLevelOffsets.assign(1, 0);
+		mKeplerianOffsets.assign(1, 0);
+		mHierarchyDirty = false;
+	}
+
+	void CelestialBodyStore::SortByDepth()
+	{
+		const uint32_t count = Size();
+
+		// Depth of every slot; a body's parent is always added before it, but may have been re-slotted by an earlier sort.
+		vector<uint32_t> depths(count, UINT32_MAX);
+		uint32_t maxDepth = 0;
+		for (uint32_t slot = 0; slot < count; ++slot)
+		{
+			uint32_t depth = 0;
+			uint32_t ancestor = mParents[slot];
+			while (ancestor != NoParent && depths[ancestor] == UINT32_MAX)
+			{
+				if (++depth > count)
+				{
+					throw GameException("Celestial body hierarchy contains a cycle.");
+				}
+
+				ancestor = mParents[ancestor];
+			}
+
+			depth += (ancestor == NoParent ? 0 : depths[ancestor] + 1);
+
+			// Fill in the chain that was just walked
+			for (uint32_t current = slot; current != ancestor && depths[current] == UINT32_MAX; current = mParents[current])
+			{
+				depths[current] = depth--;
+			}
+		}
+
+		for (uint32_t slot = 0; slot < count; ++slot)
+		{
+			maxDepth = (depths[slot] > maxDepth ? depths[slot] : maxDepth);
+		}
+
+		// Counting sort by depth, with Keplerian bodies after circular ones within each level so that each motion model
+		// runs as one contiguous batch; bodies with the same key keep their original relative order
+		vector<uint32_t> keys(count);
+		vector<uint32_t> bucketOffsets(2 * (maxDepth + 1) + 1, 0);
+		for (uint32_t slot = 0; slot < count; ++slot)
+		{
+			keys[slot] = 2 * depths[slot] + (mMotionModels[slot] == MotionModel::Keplerian ? 1 : 0);
+			++bucketOffsets[keys[slot] + 1];
+		}
+
+		for (uint32_t bucket = 1; bucket < bucketOffsets.size(); ++bucket)
+		{
+			bucketOffsets[bucket] += bucketOffsets[bucket - 1];
+		}
+
+		mLevelOffsets.resize(maxDepth + 2);
+		mKeplerianOffsets.resize(maxDepth + 1);
+		for (uint32_t level = 0; level <= maxDepth; ++level)
+		{
+			mLevelOffsets[level] = bucketOffsets[2 * level];
+			mKeplerianOffsets[level] = bucketOffsets[2 * level + 1];
+		}
+
+		mLevelOffsets[maxDepth + 1] = count;
+
+		vector<uint32_t> order(count);
+		vector<uint32_t> newSlots(count);
+		vector<uint32_t> cursors(bucketOffsets.begin(), bucketOffsets.end() - 1);
+		for (uint32_t slot = 0; slot < count; ++slot)
+		{
+			uint32_t newSlot = cursors[keys[slot]]++;
+			order[newSlot] = slot;
+			newSlots[slot] = newSlot;
+		}
+
+		Permute(mRotationRates, order);
+		Permute(mRevolutionRates, order);
+		Permute(mAxialTilts, order);
+		Permute(mOrbitalDistances, order);
+		Permute(mScales, order);
+		Permute(mRotations, order);
+		Permute(mRevolutions, order);
+		Permute(mMotionModels, order);
+		Permute(mMeanMotions, order);
+		Permute(mMeanAnomalies, order);
+		Permute(mMeanAnomaliesAtEpoch, order);
+		Permute(mEccentricities, order);
+		Permute(mMajorAxesX, order);
+		Permute(mMajorAxesY, order);
+		Permute(mMajorAxesZ, order);
+		Permute(mMinorAxesX, order);
+		Permute(mMinorAxesY, order);
+		Permute(mMinorAxesZ, order);
+		Permute(mParents, order);
+		Permute(mLitFlags, order);
+		Permute(mWorldMatrices, order);
+
+		for (uint32_t slot = 0; slot < count; ++slot)
+		{
+			if (mParents[slot] != NoParent)
+			{
+				mParents[slot] = newSlots[mParents[slot]];
+			}
+		}
+
+		for (uint32_t body = 0; body < count; ++body)
+		{
+			uint32_t slot = newSlots[mSlots[body]];
+			mSlots[body] = slot;
+			mBodies[slot] = body;
+		}
+
+		mHierarchyDirty = false;
+
+		// Start from valid transforms, with no motion to interpolate across yet
+		for (uint32_t level = 0; level < LevelCount(); ++level)
+		{
+			UpdateWorldMatrices(LevelBegin(level), LevelEnd(level));
+		}
+
+		mPreviousWorldMatrices = mWorldMatrices;
+	}
+
+	uint32_t CelestialBodyStore::Size() const
+	{
+		return static_cast<uint32_t>(mScales.size());
+	}
+
+	uint32_t CelestialBodyStore::Slot(uint32_t body) const
+	{
+		return mSlots[body];
+	}
+
+	uint32_t CelestialBodyStore::Body(uint32_t slot) const
+	{
+		return mBodies[slot];
+	}
+
+	uint32_t CelestialBodyStore::LevelCount() const
+	{
+		return static_cast<uint32_t>(mLevelOffsets.size() - 1);
+	}
+
+	uint32_t CelestialBodyStore::LevelBegin(uint32_t level) const
+	{
+		return mLevelOffsets[level];
+	}
+
+	uint32_t CelestialBodyStore::LevelEnd(uint32_t level) const
+	{
+		return mLevelOffsets[level + 1];
+	}
+
+	uint32_t CelestialBodyStore::KeplerianBegin(uint32_t level) const
+	{
+		return mKeplerianOffsets[level];
+	}
+
+	float CelestialBodyStore::RotationRate(uint32_t body) const
+	{
+		return mRotationRates[mSlots[body]];
+	}
+
+	float CelestialBodyStore::RevolutionRate(uint32_t body) const
+	{
+		return mRevolutionRates[mSlots[body]];
+	}
+
+	float CelestialBodyStore::AxialTilt(uint32_t body) const
+	{
+		return mAxialTilts[mSlots[body]];
+	}
+
+	float CelestialBodyStore::OrbitalDistance(uint32_t body) const
+	{
+		return mOrbitalDistances[mSlots[body]];
+	}
+
+	float CelestialBodyStore::Scale(uint32_t body) const
+	{
+		return mScales[mSlots[body]];
+	}
+
+	float CelestialBodyStore::Rotation(uint32_t body) const
+	{
+		return mRotations[mSlots[body]];
+	}
+
+	float CelestialBodyStore::Revolution(uint32_t body) const
+	{
+		return mRevolutions[mSlots[body]];
+	}
+
+	MotionModel CelestialBodyStore::Motion(uint32_t body) const
+	{
+		return mMotionModels[mSlots[body]];
+	}
+
+	float CelestialBodyStore::Eccentricity(uint32_t body) const
+	{
+		return mEccentricities[mSlots[body]];
+	}
+
+	float CelestialBodyStore::MeanAnomaly(uint32_t body) const
+	{
+		return mMeanAnomalies[mSlots[body]];
+	}
+
+	uint32_t CelestialBodyStore::Parent(uint32_t body) const
+	{
+		uint32_t parentSlot = mParents[mSlots[body]];
+		return (parentSlot == NoParent ? NoParent : mBodies[parentSlot]);
+	}
+
+	bool CelestialBodyStore::IsLit(uint32_t body) const
+	{
+		return mLitFlags[mSlots[body]] != 0;
+	}
+
+	XMMATRIX CelestialBodyStore::WorldMatrix(uint32_t body) const
+	{
+		return XMLoadFloat4x4(&mWorldMatrices[mSlots[body]]);
+	}
+
+	XMMATRIX CelestialBodyStore::InterpolatedWorldMatrix(uint32_t body, float interpolation) const
+	{
+		// Blending the matrices rather than the angles is exact for the translation, and the rotation error is second
+		// order in the angle turned during one update, which is a small fraction of a radian at any sensible step
+		const uint32_t slot = mSlots[body];
+		const XMMATRIX previous = XMLoadFloat4x4(&mPreviousWorldMatrices[slot]);
+		const XMMATRIX current = XMLoadFloat4x4(&mWorldMatrices[slot]);
+
+		XMMATRIX worldMatrix;
+		worldMatrix.r[0] = XMVectorLerp(previous.r[0], current.r[0], interpolation);
+		worldMatrix.r[1] = XMVectorLerp(previous.r[1], current.r[1], interpolation);
+		worldMatrix.r[2] = XMVectorLerp(previous.r[2], current.r[2], interpolation);
+		worldMatrix.r[3] = XMVectorLerp(previous.r[3], current.r[3], interpolation);
+
+		return worldMatrix;
+	}
+
+	const float* CelestialBodyStore::Scales() const
+	{
+		return mScales.data();
+	}
+
+	const XMFLOAT4X4* CelestialBodyStore::WorldMatrices() const
+	{
+		return mWorldMatrices.data();
+	}
+
+	const XMFLOAT4X4* CelestialBodyStore::PreviousWorldMatrices() const
+	{
+		return mPreviousWorldMatrices.data();
+	}
+
+	void CelestialBodyStore::Update(float elapsedSeconds)
+	{
+		if (mHierarchyDirty)
+		{
+			SortByDepth();
+		}
+
+		// Every level only reads world matrices from the levels before it
+		const uint32_t levelCount = LevelCount();
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			copy(mWorldMatrices.begin() + LevelBegin(level), mWorldMatrices.begin() + LevelEnd(level), mPreviousWorldMatrices.begin() + LevelBegin(level));
+			AdvanceAngles(elapsedSeconds, LevelBegin(level), LevelEnd(level));
+			UpdateWorldMatrices(LevelBegin(level), LevelEnd(level));
+		}
+	}
+
+	void CelestialBodyStore::Update(float elapsedSeconds, JobSystem& jobSystem)
+	{
+		if (mHierarchyDirty)
+		{
+			SortByDepth();
+		}
+
+		// Bodies within a level are independent, so each level is split into chunks; the parallel-for returning is the barrier before the next level
+		const uint32_t levelCount = LevelCount();
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			jobSystem.ParallelFor(LevelBegin(level), LevelEnd(level), UpdateGrainSize, [this, elapsedSeconds](uint32_t beginSlot, uint32_t endSlot)
+			{
+				copy(mWorldMatrices.begin() + beginSlot, mWorldMatrices.begin() + endSlot, mPreviousWorldMatrices.begin() + beginSlot);
+				AdvanceAngles(elapsedSeconds, beginSlot, endSlot);
+				UpdateWorldMatrices(beginSlot, endSlot);
+			});
+		}
+	}
+
+	void CelestialBodyStore::EvaluateAt(double time)
+	{
+		if (mHierarchyDirty)
+		{
+			SortByDepth();
+		}
+
+		const uint32_t levelCount = LevelCount();
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			copy(mWorldMatrices.begin() + LevelBegin(level), mWorldMatrices.begin() + LevelEnd(level), mPreviousWorldMatrices.begin() + LevelBegin(level));
+			SetAngles(time, LevelBegin(level), LevelEnd(level));
+			UpdateWorldMatrices(LevelBegin(level), LevelEnd(level));
+		}
+	}
+
+	void CelestialBodyStore::EvaluateAt(double time, JobSystem& jobSystem)
+	{
+		if (mHierarchyDirty)
+		{
+			SortByDepth();
+		}
+
+		const uint32_t levelCount = LevelCount();
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			jobSystem.ParallelFor(LevelBegin(level), LevelEnd(level), UpdateGrainSize, [this, time](uint32_t beginSlot, uint32_t endSlot)
+			{
+				copy(mWorldMatrices.begin() + beginSlot, mWorldMatrices.begin() + endSlot, mPreviousWorldMatrices.begin() + beginSlot);
+				SetAngles(time, beginSlot, endSlot);
+				UpdateWorldMatrices(beginSlot, endSlot);
+			});
+		}
+	}
+
+	void CelestialBodyStore::UpdateWorldMatrices(uint32_t beginSlot, uint32_t endSlot)
+	{
+		if (beginSlot == endSlot)
+		{
+			return;
+		}
+
+		const BodyTransformInputs inputs = { mScales.data(), mRotations.data(), mAxialTilts.data(), mOrbitalDistances.data(), mRevolutions.data() };
+		BodyTransformKernel::Compute(inputs, beginSlot, endSlot, mWorldMatrices.data());
+
+		// Keplerian bodies sit at the end of their level and replace the circular orbit's translation
+		const uint32_t level = static_cast<uint32_t>(upper_bound(mLevelOffsets.begin(), mLevelOffsets.end(), beginSlot) - mLevelOffsets.begin()) - 1;
+		assert(endSlot <= LevelEnd(level));
+
+		const uint32_t keplerianBegin = (KeplerianBegin(level) > beginSlot ? KeplerianBegin(level) : beginSlot);
+		if (keplerianBegin < endSlot)
+		{
+			const KeplerOrbitInputs orbitInputs = { mMeanAnomalies.data(), mEccentricities.data(), mMajorAxesX.data(), mMajorAxesY.data(), mMajorAxesZ.data(), mMinorAxesX.data(), mMinorAxesY.data(), mMinorAxesZ.data() };
+			KeplerOrbitKernel::Compute(orbitInputs, keplerianBegin, endSlot, mWorldMatrices.data());
+		}
+
+		// Satellites orbit their parent's position
+		for (uint32_t slot = beginSlot; slot < endSlot; ++slot)
+		{
+			const uint32_t parent = mParents[slot];
+			if (parent != NoParent)
+			{
+				assert(parent < beginSlot);
+
+				const XMFLOAT4X4& parentMatrix = mWorldMatrices[parent];
+				XMFLOAT4X4& worldMatrix = mWorldMatrices[slot];
+				worldMatrix._41 += parentMatrix._41;
+				worldMatrix._42 += parentMatrix._42;
+				worldMatrix._43 += parentMatrix._43;
+			}
+		}
+	}
+
+	void CelestialBodyStore::ResetPreviousWorldMatrices()
+	{
+		mPreviousWorldMatrices = mWorldMatrices;
+	}
+
+	void CelestialBodyStore::SetTranslations(const float* positionsX, const float* positionsY, const float* positionsZ)
+	{
+		// Positions come in body order, e.g. from a simulation that was populated by walking the bodies
+		const uint32_t count = Size();
+		for (uint32_t body = 0; body < count; ++body)
+		{
+			XMFLOAT4X4& worldMatrix = mWorldMatrices[mSlots[body]];
+			worldMatrix._41 = positionsX[body];
+			worldMatrix._42 = positionsY[body];
+			worldMatrix._43 = positionsZ[body];
+		}
+	}
+
+	void CelestialBodyStore::AdvanceAngles(float elapsedSeconds, uint32_t beginSlot, uint32_t endSlot)
+	{
+		float* rotations = mRotations.data();
+		float* revolutions = mRevolutions.data();
+		float* meanAnomalies = mMeanAnomalies.data();
+		const float* rotationRates = mRotationRates.data();
+		const float* revolutionRates = mRevolutionRates.data();
+		const float* meanMotions = mMeanMotions.data();
+
+		for (uint32_t i = beginSlot; i < endSlot; ++i)
+		{
+			// Kept within [-pi, pi) so the solver's starting guess is valid and precision does not drain away over time
+			rotations[i] = XMScalarModAngle(rotations[i] + elapsedSeconds * rotationRates[i]);
+			revolutions[i] = XMScalarModAngle(revolutions[i] + elapsedSeconds * revolutionRates[i]);
+			meanAnomalies[i] = XMScalarModAngle(meanAnomalies[i] + elapsedSeconds * meanMotions[i]);
+		}
+	}
+
+	void CelestialBodyStore::SetAngles(double time, uint32_t beginSlot, uint32_t endSlot)
+	{
+		float* rotations = mRotations.data();
+		float* revolutions = mRevolutions.data();
+		float* meanAnomalies = mMeanAnomalies.data();
+		const float* rotationRates = mRotationRates.data();
+		const float* revolutionRates = mRevolutionRates.data();
+		const float* meanMotions = mMeanMotions.data();
+		const float* meanAnomaliesAtEpoch = mMeanAnomaliesAtEpoch.data();
+
+		// Products are formed and reduced in double precision, which keeps angles a thousand years out within about 1e-5 radians
+		for (uint32_t i = beginSlot; i < endSlot; ++i)
+		{
+			rotations[i] = ReduceAngle(time * rotationRates[i]);
+			revolutions[i] = ReduceAngle(time * revolutionRates[i]);
+			meanAnomalies[i] = ReduceAngle(meanAnomaliesAtEpoch[i] + time * meanMotions[i]);
+		}
+	}
+
+	template <typename T>
+	void CelestialBodyStore::Permute(AlignedVector<T>& values, const vector<uint32_t>& order)
+	{
+		AlignedVector<T> permuted;
+		permuted.reserve(values.capacity());
+		for (uint32_t source : order)
+		{
+			permuted.push_back(values[source]);
+		}
+
+		values.swap(permuted);
+	}
+}
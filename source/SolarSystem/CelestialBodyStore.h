@@ -0,0 +1,112 @@
+#pragma once
+
+#include "AlignedAllocator.h"
+#include "KeplerOrbitKernel.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace Library
+{
+	class JobSystem;
+}
+
+namespace SolarSystem
+{
+	enum class MotionModel : std::uint8_t
+	{
+		Circular,
+		Keplerian
+	};
+
+	class CelestialBodyStore final
+	{
+	public:
+		static const std::uint32_t NoParent;
+		static const std::uint32_t UpdateGrainSize;
+
+		CelestialBodyStore();
+		CelestialBodyStore(const CelestialBodyStore&) = delete;
+		CelestialBodyStore& operator=(const CelestialBodyStore&) = delete;
+		CelestialBodyStore(CelestialBodyStore&&) = delete;
+		CelestialBodyStore& operator=(CelestialBodyStore&&) = delete;
+		~CelestialBodyStore() = default;
+
+		std::uint32_t Add(float rotationRate, float axialTilt, float orbitalDistance, float scale, float revolutionRate, std::uint32_t parent, bool isLit);
+		std::uint32_t AddKeplerian(float rotationRate, float axialTilt, const OrbitalElements& orbit, float scale, std::uint32_t parent, bool isLit);
+		void Reserve(std::uint32_t capacity);
+		void Clear();
+		void SortByDepth();
+
+		std::uint32_t Size() const;
+		std::uint32_t Slot(std::uint32_t body) const;
+		std::uint32_t Body(std::uint32_t slot) const;
+		std::uint32_t LevelCount() const;
+		std::uint32_t LevelBegin(std::uint32_t level) const;
+		std::uint32_t LevelEnd(std::uint32_t level) const;
+		std::uint32_t KeplerianBegin(std::uint32_t level) const;
+
+		float RotationRate(std::uint32_t body) const;
+		float RevolutionRate(std::uint32_t body) const;
+		float AxialTilt(std::uint32_t body) const;
+		float OrbitalDistance(std::uint32_t body) const;
+		float Scale(std::uint32_t body) const;
+		float Rotation(std::uint32_t body) const;
+		float Revolution(std::uint32_t body) const;
+		MotionModel Motion(std::uint32_t body) const;
+		float Eccentricity(std::uint32_t body) const;
+		float MeanAnomaly(std::uint32_t body) const;
+		std::uint32_t Parent(std::uint32_t body) const;
+		bool IsLit(std::uint32_t body) const;
+		DirectX::XMMATRIX WorldMatrix(std::uint32_t body) const;
+		DirectX::XMMATRIX InterpolatedWorldMatrix(std::uint32_t body, float interpolation) const;
+
+		const float* Scales() const;
+		const DirectX::XMFLOAT4X4* WorldMatrices() const;
+		const DirectX::XMFLOAT4X4* PreviousWorldMatrices() const;
+
+		void Update(float elapsedSeconds);
+		void Update(float elapsedSeconds, Library::JobSystem& jobSystem);
+		void EvaluateAt(double time);
+		void EvaluateAt(double time, Library::JobSystem& jobSystem);
+		void UpdateWorldMatrices(std::uint32_t beginSlot, std::uint32_t endSlot);
+		void ResetPreviousWorldMatrices();
+		void SetTranslations(const float* positionsX, const float* positionsY, const float* positionsZ);
+
+	private:
+		template <typename T>
+		static void Permute(Library::AlignedVector<T>& values, const std::vector<std::uint32_t>& order);
+
+		void AdvanceAngles(float elapsedSeconds, std::uint32_t beginSlot, std::uint32_t endSlot);
+		void SetAngles(double time, std::uint32_t beginSlot, std::uint32_t endSlot);
+
+		std::vector<std::uint32_t> mSlots;
+		std::vector<std::uint32_t> mBodies;
+		std::vector<std::uint32_t> mLevelOffsets;
+		std::vector<std::uint32_t> mKeplerianOffsets;
+		bool mHierarchyDirty;
+
+		Library::AlignedVector<float> mRotationRates;
+		Library::AlignedVector<float> mRevolutionRates;
+		Library::AlignedVector<float> mAxialTilts;
+		Library::AlignedVector<float> mOrbitalDistances;
+		Library::AlignedVector<float> mScales;
+		Library::AlignedVector<float> mRotations;
+		Library::AlignedVector<float> mRevolutions;
+		Library::AlignedVector<MotionModel> mMotionModels;
+		Library::AlignedVector<float> mMeanMotions;
+		Library::AlignedVector<float> mMeanAnomalies;
+		Library::AlignedVector<float> mMeanAnomaliesAtEpoch;
+		Library::AlignedVector<float> mEccentricities;
+		Library::AlignedVector<float> mMajorAxesX;
+		Library::AlignedVector<float> mMajorAxesY;
+		Library::AlignedVector<float> mMajorAxesZ;
+		Library::AlignedVector<float> mMinorAxesX;
+		Library::AlignedVector<float> mMinorAxesY;
+		Library::AlignedVector<float> mMinorAxesZ;
+		Library::AlignedVector<std::uint32_t> mParents;
+		Library::AlignedVector<std::uint8_t> mLitFlags;
+		Library::AlignedVector<DirectX::XMFLOAT4X4> mWorldMatrices;
+		Library::AlignedVector<DirectX::XMFLOAT4X4> mPreviousWorldMatrices;
+	};
+}
@@ -0,0 +1,31 @@
+cbuffer CBufferPerFrame
+{
+	float3 AmbientColor;
+	float3 LightColor;
+	float3 ParticleColor;
+};
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float2 Corner : TEXCOORD0;
+	float2 SphereCoordinate : TEXCOORD1;
+	float3 LightDirection : LIGHTDIR;
+	float Attenuation : ATTENUATION;
+};
+
+float4 main(VS_OUTPUT IN) : SV_TARGET
+{
+	// A lumpy disc rather than a perfect one, so the field does not read as a cloud of dots
+	float angle = atan2(IN.Corner.y, IN.Corner.x);
+	clip(0.85f + 0.15f * cos(3.0f * angle) - length(IN.Corner));
+
+	// Shaded as a sphere facing the camera
+	float3 normal = float3(IN.SphereCoordinate, sqrt(saturate(1.0f - dot(IN.SphereCoordinate, IN.SphereCoordinate))));
+	float n_dot_l = saturate(dot(normalize(normal), normalize(IN.LightDirection)));
+
+	float3 ambient = ParticleColor * AmbientColor;
+	float3 diffuse = ParticleColor * n_dot_l * LightColor * IN.Attenuation;
+
+	return float4(saturate(ambient + diffuse), 1.0f);
+}
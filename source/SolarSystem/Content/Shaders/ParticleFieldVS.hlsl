@@ -0,0 +1,47 @@
+cbuffer CBufferPerFrame
+{
+	float4x4 ViewProjection;
+	float3 CameraRight;
+	float LightRadius;
+	float3 CameraUp;
+	float3 LightPosition;
+}
+
+struct VS_INPUT
+{
+	float2 Corner : POSITION;
+	float3 InstancePosition : INSTANCEPOSITION;
+	float InstanceScale : INSTANCESCALE;
+	float OrbitPhase : ORBITPHASE;
+};
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float2 Corner : TEXCOORD0;
+	float2 SphereCoordinate : TEXCOORD1;
+	float3 LightDirection : LIGHTDIR;
+	float Attenuation : ATTENUATION;
+};
+
+VS_OUTPUT main(VS_INPUT IN)
+{
+	VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+	// The quad faces the camera and spins with the particle's orbit, so its silhouette tumbles as it goes round
+	float phaseSine, phaseCosine;
+	sincos(IN.OrbitPhase, phaseSine, phaseCosine);
+	float2 corner = float2(IN.Corner.x * phaseCosine - IN.Corner.y * phaseSine, IN.Corner.x * phaseSine + IN.Corner.y * phaseCosine);
+
+	float3 worldPosition = IN.InstancePosition + (corner.x * CameraRight + corner.y * CameraUp) * IN.InstanceScale;
+	OUT.Position = mul(float4(worldPosition, 1.0f), ViewProjection);
+	OUT.Corner = IN.Corner;
+	OUT.SphereCoordinate = corner;
+
+	// The light direction in the quad's frame: right, up and back towards the camera
+	float3 lightDirection = LightPosition - IN.InstancePosition;
+	OUT.LightDirection = float3(dot(lightDirection, CameraRight), dot(lightDirection, CameraUp), dot(lightDirection, cross(CameraUp, CameraRight)));
+	OUT.Attenuation = saturate(1.0f - (length(lightDirection) / LightRadius));
+
+	return OUT;
+}
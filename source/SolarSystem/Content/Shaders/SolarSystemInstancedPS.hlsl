@@ -0,0 +1,53 @@
+static const uint LitFlag = 0x1;
+
+cbuffer CBufferPerFrame
+{
+	float3 CameraPosition;
+	float3 AmbientColor;
+	float3 LightPosition;
+	float3 LightColor;
+};
+
+cbuffer CBufferPerObject
+{
+	float3 SpecularColor;
+	float SpecularPower;
+}
+
+Texture2DArray ColorMaps;
+SamplerState TextureSampler;
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float3 WorldPosition : WORLDPOS;
+	float Attenuation : ATTENUATION;
+	float3 TextureCoordinate : TEXCOORD;
+	float3 Normal : NORMAL;
+	nointerpolation uint Flags : FLAGS;
+};
+
+float4 main(VS_OUTPUT IN) : SV_TARGET
+{
+	float4 color = ColorMaps.Sample(TextureSampler, IN.TextureCoordinate);
+
+	// Unlit bodies (the Sun) show their texture as it is, like SunShaderPS
+	if ((IN.Flags & LitFlag) == 0)
+	{
+		return color;
+	}
+
+	float3 viewDirection = normalize(CameraPosition - IN.WorldPosition);
+	float3 lightDirection = normalize(LightPosition - IN.WorldPosition);
+
+	float3 normal = normalize(IN.Normal);
+	float n_dot_l = dot(normal, lightDirection);
+	float3 halfVector = normalize(lightDirection + viewDirection);
+	float n_dot_h = dot(normal, halfVector);
+	float2 lightCoefficients = lit(n_dot_l, n_dot_h, SpecularPower).yz;
+
+	float3 ambient = color.rgb * AmbientColor;
+	float3 diffuse = color.rgb * lightCoefficients.x * LightColor * IN.Attenuation;
+
+	return float4(saturate(ambient + diffuse), color.a);
+}
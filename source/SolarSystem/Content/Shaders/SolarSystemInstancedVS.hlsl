@@ -0,0 +1,64 @@
+cbuffer CBufferPerFrame
+{
+	float3 LightPosition;
+	float LightRadius;
+	float3 PositionOffset;
+	float3 PositionScale;
+}
+
+cbuffer CBufferPerView
+{
+	float4x4 ViewProjection;
+}
+
+struct VS_INPUT
+{
+	float4 QuantizedPosition : POSITION;
+	float2 TextureCoordinate : TEXCOORD;
+	float2 EncodedNormal : NORMAL;
+	float4x4 World : WORLD;
+	uint TextureIndex : TEXTUREINDEX;
+	uint Flags : FLAGS;
+};
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float3 WorldPosition : WORLDPOS;
+	float Attenuation : ATTENUATION;
+	float3 TextureCoordinate : TEXCOORD;
+	float3 Normal : NORMAL;
+	nointerpolation uint Flags : FLAGS;
+};
+
+// Compact vertices carry positions quantized to the sphere's bounds and octahedral normals
+float4 DecodePosition(float4 quantizedPosition)
+{
+	return float4(PositionOffset + (quantizedPosition.xyz * PositionScale), 1.0f);
+}
+
+float3 DecodeNormal(float2 encodedNormal)
+{
+	float3 normal = float3(encodedNormal, 1.0f - abs(encodedNormal.x) - abs(encodedNormal.y));
+	float fold = saturate(-normal.z);
+	normal.xy += (normal.xy >= 0.0f ? -fold : fold);
+
+	return normalize(normal);
+}
+
+VS_OUTPUT main(VS_INPUT IN)
+{
+	VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+	float4 worldPosition = mul(DecodePosition(IN.QuantizedPosition), IN.World);
+	OUT.Position = mul(worldPosition, ViewProjection);
+	OUT.WorldPosition = worldPosition.xyz;
+	OUT.TextureCoordinate = float3(IN.TextureCoordinate, IN.TextureIndex);
+	OUT.Normal = normalize(mul(float4(DecodeNormal(IN.EncodedNormal), 0), IN.World).xyz);
+	OUT.Flags = IN.Flags;
+
+	float3 lightDirection = LightPosition - OUT.WorldPosition;
+	OUT.Attenuation = saturate(1.0f - (length(lightDirection) / LightRadius));
+
+	return OUT;
+}
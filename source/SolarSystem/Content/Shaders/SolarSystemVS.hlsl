@@ -2,6 +2,8 @@ cbuffer CBufferPerFrame
 {
 	float3 LightPosition;
 	float LightRadius;
+	float3 PositionOffset;
+	float3 PositionScale;
 }
 
 cbuffer CBufferPerObject
@@ -12,9 +14,9 @@ cbuffer CBufferPerObject
 
 struct VS_INPUT
 {
-	float4 ObjectPosition: POSITION;
+	float4 QuantizedPosition : POSITION;
 	float2 TextureCoordinate : TEXCOORD;
-	float3 Normal : NORMAL;
+	float2 EncodedNormal : NORMAL;
 };
 
 struct VS_OUTPUT
@@ -26,14 +28,30 @@ struct VS_OUTPUT
 	float3 Normal : NORMAL;	
 };
 
+// Compact vertices carry positions quantized to the sphere's bounds and octahedral normals
+float4 DecodePosition(float4 quantizedPosition)
+{
+	return float4(PositionOffset + (quantizedPosition.xyz * PositionScale), 1.0f);
+}
+
+float3 DecodeNormal(float2 encodedNormal)
+{
+	float3 normal = float3(encodedNormal, 1.0f - abs(encodedNormal.x) - abs(encodedNormal.y));
+	float fold = saturate(-normal.z);
+	normal.xy += (normal.xy >= 0.0f ? -fold : fold);
+
+	return normalize(normal);
+}
+
 VS_OUTPUT main(VS_INPUT IN)
 {
 	VS_OUTPUT OUT = (VS_OUTPUT)0;
 
-	OUT.Position = mul(IN.ObjectPosition, WorldViewProjection);
-	OUT.WorldPosition = mul(IN.ObjectPosition, World).xyz;
+	float4 objectPosition = DecodePosition(IN.QuantizedPosition);
+	OUT.Position = mul(objectPosition, WorldViewProjection);
+	OUT.WorldPosition = mul(objectPosition, World).xyz;
 	OUT.TextureCoordinate = IN.TextureCoordinate;
-	OUT.Normal = normalize(mul(float4(IN.Normal, 0), World).xyz);
+	OUT.Normal = normalize(mul(float4(DecodeNormal(IN.EncodedNormal), 0), World).xyz);
 
 	float3 lightDirection = LightPosition - OUT.WorldPosition;
 	OUT.Attenuation = saturate(1.0f - (length(lightDirection) / LightRadius));
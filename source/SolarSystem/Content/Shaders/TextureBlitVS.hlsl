@@ -0,0 +1,16 @@
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float2 TextureCoordinate : TEXCOORD;
+};
+
+VS_OUTPUT main(uint vertexID : SV_VertexID)
+{
+	VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+	// A single triangle that covers the whole target, with no vertex buffer
+	OUT.TextureCoordinate = float2((vertexID << 1) & 2, vertexID & 2);
+	OUT.Position = float4(OUT.TextureCoordinate * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f), 0.0f, 1.0f);
+
+	return OUT;
+}
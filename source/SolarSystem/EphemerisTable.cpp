@@ -0,0 +1,230 @@
+#include "pch.h"
+#include "EphemerisTable.h"
+#include "CelestialBodyStore.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	const uint32_t EphemerisTable::Magic = 0x4D485045; // "EPHM"
+	const uint32_t EphemerisTable::Version = 1;
+	const double EphemerisTable::VelocityStepFraction = 1.0 / 16.0;
+
+	namespace
+	{
+		struct HermiteWeights
+		{
+			float Start;
+			float StartTangent;
+			float End;
+			float EndTangent;
+		};
+
+		// Cubic Hermite basis at the given fraction of an interval; the tangent weights absorb the interval length so
+		// the table can store velocities in units per second
+		HermiteWeights ComputeWeights(float fraction, float interval)
+		{
+			const float fraction2 = fraction * fraction;
+			const float fraction3 = fraction2 * fraction;
+
+			return
+			{
+				2.0f * fraction3 - 3.0f * fraction2 + 1.0f,
+				(fraction3 - 2.0f * fraction2 + fraction) * interval,
+				-2.0f * fraction3 + 3.0f * fraction2,
+				(fraction3 - fraction2) * interval
+			};
+		}
+
+		XMVECTOR Interpolate(const XMFLOAT3& startPosition, const XMFLOAT3& startVelocity, const XMFLOAT3& endPosition, const XMFLOAT3& endVelocity, const HermiteWeights& weights)
+		{
+			XMVECTOR position = XMVectorScale(XMLoadFloat3(&startPosition), weights.Start);
+			position = XMVectorMultiplyAdd(XMLoadFloat3(&startVelocity), XMVectorReplicate(weights.StartTangent), position);
+			position = XMVectorMultiplyAdd(XMLoadFloat3(&endPosition), XMVectorReplicate(weights.End), position);
+			return XMVectorMultiplyAdd(XMLoadFloat3(&endVelocity), XMVectorReplicate(weights.EndTangent), position);
+		}
+	}
+
+	EphemerisTable::EphemerisTable() :
+		mHeader{ Magic, Version, 0, 0, 0.0, 0.0 }, mSamples(nullptr)
+	{
+	}
+
+	EphemerisTable::~EphemerisTable() = default;
+
+	void EphemerisTable::Build(CelestialBodyStore& store, double startTime, double sampleInterval, uint32_t sampleCount, JobSystem& jobSystem)
+	{
+		if (sampleCount < 2 || sampleInterval <= 0.0)
+		{
+			throw GameException("An ephemeris needs at least two samples and a positive sample interval.");
+		}
+
+		const uint32_t bodyCount = store.Size();
+		mFile.reset();
+		mOwnedSamples.resize(static_cast<size_t>(bodyCount) * sampleCount);
+
+		// Velocities come from a central difference much narrower than the sample spacing, so the Hermite tangents
+		// describe the motion at each sample rather than the chord between samples
+		const double velocityStep = sampleInterval * VelocityStepFraction;
+		const float inverseVelocityStep = static_cast<float>(0.5 / velocityStep);
+		vector<XMFLOAT3> before(bodyCount);
+		vector<XMFLOAT3> after(bodyCount);
+		vector<XMFLOAT3> positions(bodyCount);
+		for (uint32_t sample = 0; sample < sampleCount; ++sample)
+		{
+			const double time = startTime + sample * sampleInterval;
+			store.EvaluateAt(time - velocityStep, jobSystem);
+			GatherPositions(store, before.data());
+			store.EvaluateAt(time + velocityStep, jobSystem);
+			GatherPositions(store, after.data());
+			store.EvaluateAt(time, jobSystem);
+			GatherPositions(store, positions.data());
+
+			Sample* row = &mOwnedSamples[static_cast<size_t>(sample) * bodyCount];
+			for (uint32_t body = 0; body < bodyCount; ++body)
+			{
+				row[body].Position = positions[body];
+				XMStoreFloat3(&row[body].Velocity, XMVectorScale(XMVectorSubtract(XMLoadFloat3(&after[body]), XMLoadFloat3(&before[body])), inverseVelocityStep));
+			}
+		}
+
+		// The store is left at the last sample; nothing moved in between, so there is nothing to interpolate across
+		store.ResetPreviousWorldMatrices();
+
+		mHeader = { Magic, Version, bodyCount, sampleCount, startTime, sampleInterval };
+		mSamples = mOwnedSamples.data();
+	}
+
+	void EphemerisTable::Save(const wstring& filename) const
+	{
+		ofstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw GameException("Could not open file.");
+		}
+
+		// The file is the header followed by the samples exactly as they sit in memory, so Load can map it in place
+		file.write(reinterpret_cast<const char*>(&mHeader), sizeof(Header));
+		file.write(reinterpret_cast<const char*>(mSamples), static_cast<streamsize>(SizeInBytes() - sizeof(Header)));
+		if (!file.good())
+		{
+			throw GameException("Could not write ephemeris.");
+		}
+	}
+
+	void EphemerisTable::Load(const wstring& filename)
+	{
+		unique_ptr<MemoryMappedFile> file = make_unique<MemoryMappedFile>(filename);
+		if (file->Size() < sizeof(Header))
+		{
+			throw GameException("Ephemeris file is too small.");
+		}
+
+		Header header;
+		memcpy(&header, file->Data(), sizeof(Header));
+		if (header.Magic != Magic || header.Version != Version)
+		{
+			throw GameException("Unsupported ephemeris file.");
+		}
+
+		if (header.SampleCount < 2 || header.SampleInterval <= 0.0 || file->Size() != sizeof(Header) + static_cast<uint64_t>(header.BodyCount) * header.SampleCount * sizeof(Sample))
+		{
+			throw GameException("Ephemeris file is corrupt.");
+		}
+
+		mHeader = header;
+		mOwnedSamples.clear();
+		mOwnedSamples.shrink_to_fit();
+		mFile = move(file);
+		mSamples = reinterpret_cast<const Sample*>(mFile->Data() + sizeof(Header));
+	}
+
+	uint32_t EphemerisTable::BodyCount() const
+	{
+		return mHeader.BodyCount;
+	}
+
+	uint32_t EphemerisTable::SampleCount() const
+	{
+		return mHeader.SampleCount;
+	}
+
+	double EphemerisTable::StartTime() const
+	{
+		return mHeader.StartTime;
+	}
+
+	double EphemerisTable::EndTime() const
+	{
+		return (mHeader.SampleCount > 0 ? mHeader.StartTime + (mHeader.SampleCount - 1) * mHeader.SampleInterval : mHeader.StartTime);
+	}
+
+	double EphemerisTable::SampleInterval() const
+	{
+		return mHeader.SampleInterval;
+	}
+
+	uint64_t EphemerisTable::SizeInBytes() const
+	{
+		return sizeof(Header) + static_cast<uint64_t>(mHeader.BodyCount) * mHeader.SampleCount * sizeof(Sample);
+	}
+
+	XMFLOAT3 EphemerisTable::Position(uint32_t body, double time) const
+	{
+		assert(body < BodyCount());
+
+		float fraction;
+		const Sample* row = Locate(time, fraction);
+		const Sample& start = row[body];
+		const Sample& end = row[mHeader.BodyCount + body];
+
+		XMFLOAT3 position;
+		XMStoreFloat3(&position, Interpolate(start.Position, start.Velocity, end.Position, end.Velocity, ComputeWeights(fraction, static_cast<float>(mHeader.SampleInterval))));
+
+		return position;
+	}
+
+	void EphemerisTable::Positions(double time, XMFLOAT3* positions) const
+	{
+		// Both samples of every body sit in two adjacent rows, so a lookup streams through memory once
+		float fraction;
+		const Sample* start = Locate(time, fraction);
+		const Sample* end = start + mHeader.BodyCount;
+		const HermiteWeights weights = ComputeWeights(fraction, static_cast<float>(mHeader.SampleInterval));
+
+		const uint32_t bodyCount = mHeader.BodyCount;
+		for (uint32_t body = 0; body < bodyCount; ++body)
+		{
+			XMStoreFloat3(&positions[body], Interpolate(start[body].Position, start[body].Velocity, end[body].Position, end[body].Velocity, weights));
+		}
+	}
+
+	void EphemerisTable::GatherPositions(const CelestialBodyStore& store, XMFLOAT3* positions)
+	{
+		const XMFLOAT4X4* worldMatrices = store.WorldMatrices();
+		const uint32_t bodyCount = store.Size();
+		for (uint32_t body = 0; body < bodyCount; ++body)
+		{
+			const XMFLOAT4X4& worldMatrix = worldMatrices[store.Slot(body)];
+			positions[body] = XMFLOAT3(worldMatrix._41, worldMatrix._42, worldMatrix._43);
+		}
+	}
+
+	const EphemerisTable::Sample* EphemerisTable::Locate(double time, float& fraction) const
+	{
+		assert(mSamples != nullptr);
+
+		// Times outside the table clamp to its ends
+		const double last = static_cast<double>(mHeader.SampleCount - 1);
+		double position = (time - mHeader.StartTime) / mHeader.SampleInterval;
+		position = (position < 0.0 ? 0.0 : (position > last ? last : position));
+
+		uint32_t index = static_cast<uint32_t>(position);
+		index = (index >= mHeader.SampleCount - 1 ? mHeader.SampleCount - 2 : index);
+		fraction = static_cast<float>(position - index);
+
+		return mSamples + static_cast<size_t>(index) * mHeader.BodyCount;
+	}
+}
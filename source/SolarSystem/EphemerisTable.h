@@ -0,0 +1,72 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Library
+{
+	class JobSystem;
+	class MemoryMappedFile;
+}
+
+namespace SolarSystem
+{
+	class CelestialBodyStore;
+
+	class EphemerisTable final
+	{
+	public:
+		static const std::uint32_t Magic;
+		static const std::uint32_t Version;
+		static const double VelocityStepFraction;
+
+		EphemerisTable();
+		EphemerisTable(const EphemerisTable&) = delete;
+		EphemerisTable& operator=(const EphemerisTable&) = delete;
+		EphemerisTable(EphemerisTable&&) = delete;
+		EphemerisTable& operator=(EphemerisTable&&) = delete;
+		~EphemerisTable();
+
+		void Build(CelestialBodyStore& store, double startTime, double sampleInterval, std::uint32_t sampleCount, Library::JobSystem& jobSystem);
+		void Save(const std::wstring& filename) const;
+		void Load(const std::wstring& filename);
+
+		std::uint32_t BodyCount() const;
+		std::uint32_t SampleCount() const;
+		double StartTime() const;
+		double EndTime() const;
+		double SampleInterval() const;
+		std::uint64_t SizeInBytes() const;
+
+		DirectX::XMFLOAT3 Position(std::uint32_t body, double time) const;
+		void Positions(double time, DirectX::XMFLOAT3* positions) const;
+
+	private:
+		struct Header
+		{
+			std::uint32_t Magic;
+			std::uint32_t Version;
+			std::uint32_t BodyCount;
+			std::uint32_t SampleCount;
+			double StartTime;
+			double SampleInterval;
+		};
+
+		struct Sample
+		{
+			DirectX::XMFLOAT3 Position;
+			DirectX::XMFLOAT3 Velocity;
+		};
+
+		static void GatherPositions(const CelestialBodyStore& store, DirectX::XMFLOAT3* positions);
+		const Sample* Locate(double time, float& fraction) const;
+
+		Header mHeader;
+		std::vector<Sample> mOwnedSamples;
+		std::unique_ptr<Library::MemoryMappedFile> mFile;
+		const Sample* mSamples;
+	};
+}
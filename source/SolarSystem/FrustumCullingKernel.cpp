@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "FrustumCullingKernel.h"
+#include "Frustum.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	// A body is culled when its bounding sphere lies wholly behind any one plane. Positions are the translation rows of
+	// the world matrices, blended the same way the bodies are drawn, so nothing on screen is ever culled a frame early.
+	// Radii are body scales, times the radius of the mesh they scale.
+
+	uint32_t FrustumCullingKernel::Cull(const Frustum& frustum, const FrustumCullingInputs& inputs, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		const uint32_t vectorEnd = begin + ((end - begin) & ~3U);
+		const uint32_t visibleCount = CullVector(frustum, inputs, begin, vectorEnd, visible);
+
+		return visibleCount + CullScalar(frustum, inputs, vectorEnd, end, visible + visibleCount);
+	}
+
+	uint32_t FrustumCullingKernel::CullScalar(const Frustum& frustum, const FrustumCullingInputs& inputs, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		const XMVECTOR blend = XMVectorReplicate(inputs.Interpolation);
+		uint32_t visibleCount = 0;
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const XMVECTOR previous = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(inputs.PreviousWorldMatrices[i].m[3]));
+			const XMVECTOR current = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(inputs.WorldMatrices[i].m[3]));
+
+			// Written unconditionally and kept only when visible, so the loop has no data-dependent branch
+			visible[visibleCount] = i;
+			visibleCount += (frustum.Intersects(XMVectorLerpV(previous, current, blend), inputs.Radii[i] * inputs.RadiusScale) ? 1 : 0);
+		}
+
+		return visibleCount;
+	}
+
+	uint32_t FrustumCullingKernel::CullVector(const Frustum& frustum, const FrustumCullingInputs& inputs, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		assert(((end - begin) & 3U) == 0);
+
+		// Each plane's coefficients splatted across the lanes
+		XMVECTOR planesX[Frustum::PlaneCount];
+		XMVECTOR planesY[Frustum::PlaneCount];
+		XMVECTOR planesZ[Frustum::PlaneCount];
+		XMVECTOR planesW[Frustum::PlaneCount];
+		for (uint32_t plane = 0; plane < Frustum::PlaneCount; ++plane)
+		{
+			const XMVECTOR coefficients = XMLoadFloat4(&frustum.Planes()[plane]);
+			planesX[plane] = XMVectorSplatX(coefficients);
+			planesY[plane] = XMVectorSplatY(coefficients);
+			planesZ[plane] = XMVectorSplatZ(coefficients);
+			planesW[plane] = XMVectorSplatW(coefficients);
+		}
+
+		const XMVECTOR blend = XMVectorReplicate(inputs.Interpolation);
+		const XMVECTOR negativeRadiusScale = XMVectorReplicate(-inputs.RadiusScale);
+		uint32_t visibleCount = 0;
+
+		for (uint32_t i = begin; i < end; i += 4)
+		{
+			// Blend the four translation rows, then transpose to one body per lane
+			XMMATRIX positions;
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				const XMVECTOR previous = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(inputs.PreviousWorldMatrices[i + lane].m[3]));
+				const XMVECTOR current = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(inputs.WorldMatrices[i + lane].m[3]));
+				positions.r[lane] = XMVectorLerpV(previous, current, blend);
+			}
+
+			positions = XMMatrixTranspose(positions);
+			const XMVECTOR negativeRadii = XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.Radii[i])), negativeRadiusScale);
+
+			XMVECTOR inside = XMVectorTrueInt();
+			for (uint32_t plane = 0; plane < Frustum::PlaneCount; ++plane)
+			{
+				XMVECTOR distances = XMVectorMultiplyAdd(positions.r[0], planesX[plane], planesW[plane]);
+				distances = XMVectorMultiplyAdd(positions.r[1], planesY[plane], distances);
+				distances = XMVectorMultiplyAdd(positions.r[2], planesZ[plane], distances);
+				inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(distances, negativeRadii));
+			}
+
+			// Compact the survivors
+			XMUINT4 mask;
+			XMStoreUInt4(&mask, inside);
+			const uint32_t lanes[] = { mask.x, mask.y, mask.z, mask.w };
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				visible[visibleCount] = i + lane;
+				visibleCount += (lanes[lane] & 1U);
+			}
+		}
+
+		return visibleCount;
+	}
+}
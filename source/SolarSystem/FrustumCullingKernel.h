@@ -0,0 +1,36 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace Library
+{
+	class Frustum;
+}
+
+namespace SolarSystem
+{
+	struct FrustumCullingInputs
+	{
+		const DirectX::XMFLOAT4X4* PreviousWorldMatrices;
+		const DirectX::XMFLOAT4X4* WorldMatrices;
+		const float* Radii;
+		float RadiusScale;
+		float Interpolation;
+	};
+
+	class FrustumCullingKernel final
+	{
+	public:
+		static std::uint32_t Cull(const Library::Frustum& frustum, const FrustumCullingInputs& inputs, std::uint32_t begin, std::uint32_t end, std::uint32_t* visible);
+		static std::uint32_t CullScalar(const Library::Frustum& frustum, const FrustumCullingInputs& inputs, std::uint32_t begin, std::uint32_t end, std::uint32_t* visible);
+		static std::uint32_t CullVector(const Library::Frustum& frustum, const FrustumCullingInputs& inputs, std::uint32_t begin, std::uint32_t end, std::uint32_t* visible);
+
+		FrustumCullingKernel() = delete;
+		FrustumCullingKernel(const FrustumCullingKernel&) = delete;
+		FrustumCullingKernel& operator=(const FrustumCullingKernel&) = delete;
+		FrustumCullingKernel(FrustumCullingKernel&&) = delete;
+		FrustumCullingKernel& operator=(FrustumCullingKernel&&) = delete;
+		~FrustumCullingKernel() = default;
+	};
+}
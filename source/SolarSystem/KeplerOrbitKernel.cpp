@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "KeplerOrbitKernel.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace SolarSystem
+{
+	// Kepler's equation M = E - e sin(E) is solved with a fixed number of Halley steps from Danby's starting guess
+	// E0 = M + 0.85 e sign(M). Four steps reach float precision for every eccentricity up to 0.99, and a fixed count
+	// keeps all lanes of a batch in lockstep. The position is then r = A (cos(E) - e) + B sin(E), where A and B are the
+	// orbit's semi-major and semi-minor axis vectors.
+	const uint32_t KeplerOrbitKernel::SolverIterations = 4;
+
+	void KeplerOrbitKernel::OrbitAxes(const OrbitalElements& elements, XMFLOAT3& majorAxis, XMFLOAT3& minorAxis)
+	{
+		assert(elements.Eccentricity >= 0.0f && elements.Eccentricity < 1.0f);
+
+		float si, ci, sn, cn, sw, cw;
+		XMScalarSinCos(&si, &ci, elements.Inclination);
+		XMScalarSinCos(&sn, &cn, elements.LongitudeOfAscendingNode);
+		XMScalarSinCos(&sw, &cw, elements.ArgumentOfPeriapsis);
+
+		// Unit vectors towards periapsis (P) and 90 degrees ahead of it (Q), in ecliptic coordinates
+		const XMFLOAT3 p(cn * cw - sn * sw * ci, sn * cw + cn * sw * ci, sw * si);
+		const XMFLOAT3 q(-cn * sw - sn * cw * ci, -sn * sw + cn * cw * ci, cw * si);
+
+		// The ecliptic is the scene's XZ plane, with the ecliptic's Y axis along -Z so that a circular, uninclined
+		// orbit matches the revolution of the circular model
+		const float a = elements.SemiMajorAxis;
+		const float b = a * sqrtf(1.0f - elements.Eccentricity * elements.Eccentricity);
+		majorAxis = XMFLOAT3(a * p.x, a * p.z, -a * p.y);
+		minorAxis = XMFLOAT3(b * q.x, b * q.z, -b * q.y);
+	}
+
+	float KeplerOrbitKernel::SolveEccentricAnomaly(float meanAnomaly, float eccentricity)
+	{
+		const float m = XMScalarModAngle(meanAnomaly);
+		float anomaly = m + (m < 0.0f ? -0.85f : 0.85f) * eccentricity;
+		for (uint32_t i = 0; i < SolverIterations; ++i)
+		{
+			float sine, cosine;
+			XMScalarSinCos(&sine, &cosine, anomaly);
+
+			const float f = anomaly - eccentricity * sine - m;
+			const float f1 = 1.0f - eccentricity * cosine;
+			const float f2 = eccentricity * sine;
+			anomaly -= f / (f1 - 0.5f * f * f2 / f1);
+		}
+
+		return anomaly;
+	}
+
+	void KeplerOrbitKernel::Compute(const KeplerOrbitInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+		const uint32_t vectorEnd = begin + ((end - begin) & ~3U);
+		ComputeVector(inputs, begin, vectorEnd, worldMatrices);
+		ComputeScalar(inputs, vectorEnd, end, worldMatrices);
+	}
+
+	void KeplerOrbitKernel::ComputeScalar(const KeplerOrbitInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const float eccentricity = inputs.Eccentricities[i];
+
+			float sine, cosine;
+			XMScalarSinCos(&sine, &cosine, SolveEccentricAnomaly(inputs.MeanAnomalies[i], eccentricity));
+
+			const float x = cosine - eccentricity;
+			XMFLOAT4X4& worldMatrix = worldMatrices[i];
+			worldMatrix._41 = inputs.MajorAxesX[i] * x + inputs.MinorAxesX[i] * sine;
+			worldMatrix._42 = inputs.MajorAxesY[i] * x + inputs.MinorAxesY[i] * sine;
+			worldMatrix._43 = inputs.MajorAxesZ[i] * x + inputs.MinorAxesZ[i] * sine;
+		}
+	}
+
+	void KeplerOrbitKernel::ComputeVector(const KeplerOrbitInputs& inputs, uint32_t begin, uint32_t end, XMFLOAT4X4* worldMatrices)
+	{
+		assert(((end - begin) & 3U) == 0);
+
+		const XMVECTOR signMask = XMVectorSplatSignMask();
+		const XMVECTOR startOffset = XMVectorReplicate(0.85f);
+		const XMVECTOR half = XMVectorReplicate(0.5f);
+		const XMVECTOR one = XMVectorSplatOne();
+
+		for (uint32_t i = begin; i < end; i += 4)
+		{
+			// Each lane holds one body
+			const XMVECTOR m = XMVectorModAngles(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.MeanAnomalies[i])));
+			const XMVECTOR eccentricity = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.Eccentricities[i]));
+
+			XMVECTOR anomaly = XMVectorAdd(m, XMVectorOrInt(XMVectorMultiply(startOffset, eccentricity), XMVectorAndInt(m, signMask)));
+			XMVECTOR sine, cosine;
+			for (uint32_t iteration = 0; iteration < SolverIterations; ++iteration)
+			{
+				XMVectorSinCos(&sine, &cosine, anomaly);
+
+				const XMVECTOR f = XMVectorSubtract(XMVectorNegativeMultiplySubtract(eccentricity, sine, anomaly), m);
+				const XMVECTOR f1 = XMVectorNegativeMultiplySubtract(eccentricity, cosine, one);
+				const XMVECTOR f2 = XMVectorMultiply(eccentricity, sine);
+				const XMVECTOR denominator = XMVectorSubtract(f1, XMVectorDivide(XMVectorMultiply(half, XMVectorMultiply(f, f2)), f1));
+				anomaly = XMVectorSubtract(anomaly, XMVectorDivide(f, denominator));
+			}
+
+			XMVectorSinCos(&sine, &cosine, anomaly);
+			const XMVECTOR x = XMVectorSubtract(cosine, eccentricity);
+
+			XMFLOAT4 positionsX, positionsY, positionsZ;
+			XMStoreFloat4(&positionsX, XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.MajorAxesX[i])), x, XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.MinorAxesX[i])), sine)));
+			XMStoreFloat4(&positionsY, XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.MajorAxesY[i])), x, XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.MinorAxesY[i])), sine)));
+			XMStoreFloat4(&positionsZ, XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.MajorAxesZ[i])), x, XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&inputs.MinorAxesZ[i])), sine)));
+
+			const float* lanesX = &positionsX.x;
+			const float* lanesY = &positionsY.x;
+			const float* lanesZ = &positionsZ.x;
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				XMFLOAT4X4& worldMatrix = worldMatrices[i + lane];
+				worldMatrix._41 = lanesX[lane];
+				worldMatrix._42 = lanesY[lane];
+				worldMatrix._43 = lanesZ[lane];
+			}
+		}
+	}
+}
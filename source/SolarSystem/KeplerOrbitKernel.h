@@ -0,0 +1,50 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace SolarSystem
+{
+	struct OrbitalElements
+	{
+		float SemiMajorAxis;
+		float Eccentricity;
+		float Inclination;
+		float LongitudeOfAscendingNode;
+		float ArgumentOfPeriapsis;
+		float MeanAnomalyAtEpoch;
+		float MeanMotion;
+	};
+
+	struct KeplerOrbitInputs
+	{
+		const float* MeanAnomalies;
+		const float* Eccentricities;
+		const float* MajorAxesX;
+		const float* MajorAxesY;
+		const float* MajorAxesZ;
+		const float* MinorAxesX;
+		const float* MinorAxesY;
+		const float* MinorAxesZ;
+	};
+
+	class KeplerOrbitKernel final
+	{
+	public:
+		static const std::uint32_t SolverIterations;
+
+		static void OrbitAxes(const OrbitalElements& elements, DirectX::XMFLOAT3& majorAxis, DirectX::XMFLOAT3& minorAxis);
+		static float SolveEccentricAnomaly(float meanAnomaly, float eccentricity);
+
+		static void Compute(const KeplerOrbitInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+		static void ComputeScalar(const KeplerOrbitInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+		static void ComputeVector(const KeplerOrbitInputs& inputs, std::uint32_t begin, std::uint32_t end, DirectX::XMFLOAT4X4* worldMatrices);
+
+		KeplerOrbitKernel() = delete;
+		KeplerOrbitKernel(const KeplerOrbitKernel&) = delete;
+		KeplerOrbitKernel& operator=(const KeplerOrbitKernel&) = delete;
+		KeplerOrbitKernel(KeplerOrbitKernel&&) = delete;
+		KeplerOrbitKernel& operator=(KeplerOrbitKernel&&) = delete;
+		~KeplerOrbitKernel() = default;
+	};
+}
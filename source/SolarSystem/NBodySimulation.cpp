@@ -0,0 +1,299 @@
+#include "pch.h"
+#include "NBodySimulation.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	const float NBodySimulation::DefaultOpeningAngle = 0.5f;
+	const float NBodySimulation::DefaultSoftening = 0.01f;
+	const float NBodySimulation::DefaultMaxTimeStep = 1.0f / 120.0f;
+	const uint32_t NBodySimulation::ForceGrainSize = 8;
+	const uint32_t NBodySimulation::IntegrationGrainSize = 8192;
+
+	NBodySimulation::NBodySimulation(float gravitationalConstant) :
+		mGravitationalConstant(gravitationalConstant), mOpeningAngle(DefaultOpeningAngle), mSoftening(DefaultSoftening),
+		mMaxTimeStep(DefaultMaxTimeStep), mAccelerationsValid(false)
+	{
+	}
+
+	uint32_t NBodySimulation::Add(float mass, const XMFLOAT3& position, const XMFLOAT3& velocity)
+	{
+		assert(mass >= 0.0f);
+
+		const uint32_t particle = Size();
+		mMasses.push_back(mass);
+		mPositionsX.push_back(position.x);
+		mPositionsY.push_back(position.y);
+		mPositionsZ.push_back(position.z);
+		mVelocitiesX.push_back(velocity.x);
+		mVelocitiesY.push_back(velocity.y);
+		mVelocitiesZ.push_back(velocity.z);
+		mAccelerationsX.push_back(0.0f);
+		mAccelerationsY.push_back(0.0f);
+		mAccelerationsZ.push_back(0.0f);
+		mAccelerationsValid = false;
+
+		return particle;
+	}
+
+	void NBodySimulation::Reserve(uint32_t capacity)
+	{
+		mMasses.reserve(capacity);
+		mPositionsX.reserve(capacity);
+		mPositionsY.reserve(capacity);
+		mPositionsZ.reserve(capacity);
+		mVelocitiesX.reserve(capacity);
+		mVelocitiesY.reserve(capacity);
+		mVelocitiesZ.reserve(capacity);
+		mAccelerationsX.reserve(capacity);
+		mAccelerationsY.reserve(capacity);
+		mAccelerationsZ.reserve(capacity);
+	}
+
+	void NBodySimulation::Clear()
+	{
+		mMasses.clear();
+		mPositionsX.clear();
+		mPositionsY.clear();
+		mPositionsZ.clear();
+		mVelocitiesX.clear();
+		mVelocitiesY.clear();
+		mVelocitiesZ.clear();
+		mAccelerationsX.clear();
+		mAccelerationsY.clear();
+		mAccelerationsZ.clear();
+		mAccelerationsValid = false;
+	}
+
+	void NBodySimulation::RemoveNetMomentum()
+	{
+		// Keeps the barycenter where it started instead of letting the whole system drift off
+		double totalMass = 0.0;
+		double momentumX = 0.0, momentumY = 0.0, momentumZ = 0.0;
+		const uint32_t count = Size();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			totalMass += mMasses[i];
+			momentumX += static_cast<double>(mMasses[i]) * mVelocitiesX[i];
+			momentumY += static_cast<double>(mMasses[i]) * mVelocitiesY[i];
+			momentumZ += static_cast<double>(mMasses[i]) * mVelocitiesZ[i];
+		}
+
+		if (totalMass <= 0.0)
+		{
+			return;
+		}
+
+		const float driftX = static_cast<float>(momentumX / totalMass);
+		const float driftY = static_cast<float>(momentumY / totalMass);
+		const float driftZ = static_cast<float>(momentumZ / totalMass);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			mVelocitiesX[i] -= driftX;
+			mVelocitiesY[i] -= driftY;
+			mVelocitiesZ[i] -= driftZ;
+		}
+	}
+
+	uint32_t NBodySimulation::Size() const
+	{
+		return static_cast<uint32_t>(mMasses.size());
+	}
+
+	float NBodySimulation::Mass(uint32_t particle) const
+	{
+		return mMasses[particle];
+	}
+
+	XMFLOAT3 NBodySimulation::Position(uint32_t particle) const
+	{
+		return XMFLOAT3(mPositionsX[particle], mPositionsY[particle], mPositionsZ[particle]);
+	}
+
+	XMFLOAT3 NBodySimulation::Velocity(uint32_t particle) const
+	{
+		return XMFLOAT3(mVelocitiesX[particle], mVelocitiesY[particle], mVelocitiesZ[particle]);
+	}
+
+	XMFLOAT3 NBodySimulation::Acceleration(uint32_t particle) const
+	{
+		return XMFLOAT3(mAccelerationsX[particle], mAccelerationsY[particle], mAccelerationsZ[particle]);
+	}
+
+	const float* NBodySimulation::PositionsX() const
+	{
+		return mPositionsX.data();
+	}
+
+	const float* NBodySimulation::PositionsY() const
+	{
+		return mPositionsY.data();
+	}
+
+	const float* NBodySimulation::PositionsZ() const
+	{
+		return mPositionsZ.data();
+	}
+
+	const BarnesHutTree& NBodySimulation::Tree() const
+	{
+		return mTree;
+	}
+
+	float NBodySimulation::GravitationalConstant() const
+	{
+		return mGravitationalConstant;
+	}
+
+	void NBodySimulation::SetGravitationalConstant(float gravitationalConstant)
+	{
+		mGravitationalConstant = gravitationalConstant;
+		mAccelerationsValid = false;
+	}
+
+	float NBodySimulation::OpeningAngle() const
+	{
+		return mOpeningAngle;
+	}
+
+	void NBodySimulation::SetOpeningAngle(float openingAngle)
+	{
+		mOpeningAngle = openingAngle;
+		mAccelerationsValid = false;
+	}
+
+	float NBodySimulation::Softening() const
+	{
+		return mSoftening;
+	}
+
+	void NBodySimulation::SetSoftening(float softening)
+	{
+		mSoftening = softening;
+		mAccelerationsValid = false;
+	}
+
+	float NBodySimulation::MaxTimeStep() const
+	{
+		return mMaxTimeStep;
+	}
+
+	void NBodySimulation::SetMaxTimeStep(float maxTimeStep)
+	{
+		assert(maxTimeStep > 0.0f);
+		mMaxTimeStep = maxTimeStep;
+	}
+
+	void NBodySimulation::Advance(float elapsedSeconds, JobSystem& jobSystem)
+	{
+		if (elapsedSeconds <= 0.0f)
+		{
+			return;
+		}
+
+		// Equal sub-steps no longer than the maximum keep the integrator stable through long frames
+		const uint32_t stepCount = static_cast<uint32_t>(ceilf(elapsedSeconds / mMaxTimeStep));
+		const float timeStep = elapsedSeconds / stepCount;
+		for (uint32_t i = 0; i < stepCount; ++i)
+		{
+			Step(timeStep, jobSystem);
+		}
+	}
+
+	void NBodySimulation::Step(float timeStep, JobSystem& jobSystem)
+	{
+		const uint32_t count = Size();
+		if (!mAccelerationsValid)
+		{
+			ComputeAccelerations(jobSystem);
+		}
+
+		// Kick-drift-kick leapfrog: symplectic and time reversible, so orbits neither spiral in nor out over time
+		const float halfStep = timeStep * 0.5f;
+		jobSystem.ParallelFor(0, count, IntegrationGrainSize, [this, halfStep, timeStep](uint32_t begin, uint32_t end)
+		{
+			Kick(halfStep, begin, end);
+			Drift(timeStep, begin, end);
+		});
+
+		ComputeAccelerations(jobSystem);
+
+		jobSystem.ParallelFor(0, count, IntegrationGrainSize, [this, halfStep](uint32_t begin, uint32_t end)
+		{
+			Kick(halfStep, begin, end);
+		});
+	}
+
+	void NBodySimulation::Save(OutputStreamHelper& stream) const
+	{
+		stream << mGravitationalConstant << mOpeningAngle << mSoftening << mMaxTimeStep;
+
+		const uint32_t count = Size();
+		stream << count;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			stream << mMasses[i] << mPositionsX[i] << mPositionsY[i] << mPositionsZ[i] << mVelocitiesX[i] << mVelocitiesY[i] << mVelocitiesZ[i];
+		}
+	}
+
+	void NBodySimulation::Load(InputStreamHelper& stream, uint32_t expectedCount)
+	{
+		stream >> mGravitationalConstant >> mOpeningAngle >> mSoftening >> mMaxTimeStep;
+
+		uint32_t count;
+		stream >> count;
+		if (!stream.Stream().good() || count != expectedCount)
+		{
+			throw GameException("Simulation snapshot does not match the scene.");
+		}
+
+		// Accelerations are a pure function of the positions, so recomputing them on the first step continues the run exactly
+		Clear();
+		Reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			float mass;
+			XMFLOAT3 position;
+			XMFLOAT3 velocity;
+			stream >> mass >> position.x >> position.y >> position.z >> velocity.x >> velocity.y >> velocity.z;
+			Add(mass, position, velocity);
+		}
+	}
+
+	void NBodySimulation::ComputeAccelerations(JobSystem& jobSystem)
+	{
+		mTree.Build(mPositionsX.data(), mPositionsY.data(), mPositionsZ.data(), mMasses.data(), Size(), mOpeningAngle);
+
+		// The tree is read-only from here on, so every group's walk is independent
+		const float softeningSquared = mSoftening * mSoftening;
+		jobSystem.ParallelFor(0, mTree.GroupCount(), ForceGrainSize, [this, softeningSquared](uint32_t begin, uint32_t end)
+		{
+			mTree.Accelerations(begin, end, softeningSquared, mGravitationalConstant, mAccelerationsX.data(), mAccelerationsY.data(), mAccelerationsZ.data());
+		});
+
+		mAccelerationsValid = true;
+	}
+
+	void NBodySimulation::Kick(float timeStep, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			mVelocitiesX[i] += timeStep * mAccelerationsX[i];
+			mVelocitiesY[i] += timeStep * mAccelerationsY[i];
+			mVelocitiesZ[i] += timeStep * mAccelerationsZ[i];
+		}
+	}
+
+	void NBodySimulation::Drift(float timeStep, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			mPositionsX[i] += timeStep * mVelocitiesX[i];
+			mPositionsY[i] += timeStep * mVelocitiesY[i];
+			mPositionsZ[i] += timeStep * mVelocitiesZ[i];
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "AlignedAllocator.h"
+#include "BarnesHutTree.h"
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace Library
+{
+	class JobSystem;
+	class OutputStreamHelper;
+	class InputStreamHelper;
+}
+
+namespace SolarSystem
+{
+	class NBodySimulation final
+	{
+	public:
+		static const float DefaultOpeningAngle;
+		static const float DefaultSoftening;
+		static const float DefaultMaxTimeStep;
+		static const std::uint32_t ForceGrainSize;
+		static const std::uint32_t IntegrationGrainSize;
+
+		explicit NBodySimulation(float gravitationalConstant = 1.0f);
+		NBodySimulation(const NBodySimulation&) = delete;
+		NBodySimulation& operator=(const NBodySimulation&) = delete;
+		NBodySimulation(NBodySimulation&&) = delete;
+		NBodySimulation& operator=(NBodySimulation&&) = delete;
+		~NBodySimulation() = default;
+
+		std::uint32_t Add(float mass, const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& velocity);
+		void Reserve(std::uint32_t capacity);
+		void Clear();
+		void RemoveNetMomentum();
+
+		std::uint32_t Size() const;
+		float Mass(std::uint32_t particle) const;
+		DirectX::XMFLOAT3 Position(std::uint32_t particle) const;
+		DirectX::XMFLOAT3 Velocity(std::uint32_t particle) const;
+		DirectX::XMFLOAT3 Acceleration(std::uint32_t particle) const;
+		const float* PositionsX() const;
+		const float* PositionsY() const;
+		const float* PositionsZ() const;
+		const BarnesHutTree& Tree() const;
+
+		float GravitationalConstant() const;
+		void SetGravitationalConstant(float gravitationalConstant);
+		float OpeningAngle() const;
+		void SetOpeningAngle(float openingAngle);
+		float Softening() const;
+		void SetSoftening(float softening);
+		float MaxTimeStep() const;
+		void SetMaxTimeStep(float maxTimeStep);
+
+		void Advance(float elapsedSeconds, Library::JobSystem& jobSystem);
+		void Step(float timeStep, Library::JobSystem& jobSystem);
+
+		void Save(Library::OutputStreamHelper& stream) const;
+		void Load(Library::InputStreamHelper& stream, std::uint32_t expectedCount);
+
+	private:
+		void ComputeAccelerations(Library::JobSystem& jobSystem);
+		void Kick(float timeStep, std::uint32_t begin, std::uint32_t end);
+		void Drift(float timeStep, std::uint32_t begin, std::uint32_t end);
+
+		float mGravitationalConstant;
+		float mOpeningAngle;
+		float mSoftening;
+		float mMaxTimeStep;
+		bool mAccelerationsValid;
+		BarnesHutTree mTree;
+
+		Library::AlignedVector<float> mMasses;
+		Library::AlignedVector<float> mPositionsX;
+		Library::AlignedVector<float> mPositionsY;
+		Library::AlignedVector<float> mPositionsZ;
+		Library::AlignedVector<float> mVelocitiesX;
+		Library::AlignedVector<float> mVelocitiesY;
+		Library::AlignedVector<float> mVelocitiesZ;
+		Library::AlignedVector<float> mAccelerationsX;
+		Library::AlignedVector<float> mAccelerationsY;
+		Library::AlignedVector<float> mAccelerationsZ;
+	};
+}
@@ -0,0 +1,187 @@
+#include "pch.h"
+#include "ParticleField.h"
+#include <random>
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	namespace
+	{
+		// Wraps an angle into [-pi, pi) in double precision before narrowing it to float
+		float ReduceAngle(double angle)
+		{
+			const double TwoPi = 6.28318530717958647692;
+			return static_cast<float>(angle - TwoPi * floor(angle / TwoPi + 0.5));
+		}
+	}
+
+	const uint32_t ParticleField::UpdateGrainSize = 4096;
+	const double ParticleField::RebaseInterval = 600.0;
+
+	ParticleField::ParticleField(const ParticleFieldDescription& description) :
+		mDescription(description), mTiltSine(0.0f), mTiltCosine(1.0f), mEpoch(0.0)
+	{
+		if (description.InnerRadius <= 0.0f || description.OuterRadius < description.InnerRadius || description.MaxScale < description.MinScale)
+		{
+			throw GameException("Invalid particle field description.");
+		}
+
+		XMScalarSinCos(&mTiltSine, &mTiltCosine, description.Tilt);
+
+		// Padded to a whole batch so the vector path never reads past the end
+		const uint32_t capacity = (description.Count + 3) & ~3U;
+		mRadii.resize(capacity, 0.0f);
+		mHeights.resize(capacity, 0.0f);
+		mScales.resize(capacity, 0.0f);
+		mAngularRates.resize(capacity, 0.0f);
+		mInitialPhases.resize(capacity, 0.0f);
+
+		// Radii are drawn uniformly over the annulus' area, so the field is as dense at its outer edge as its inner one
+		mt19937 generator(description.Seed);
+		uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+		uniform_real_distribution<float> phaseDistribution(-XM_PI, XM_PI);
+		const float innerSquared = description.InnerRadius * description.InnerRadius;
+		const float outerSquared = description.OuterRadius * description.OuterRadius;
+		for (uint32_t i = 0; i < description.Count; ++i)
+		{
+			const float radius = sqrt(innerSquared + unitDistribution(generator) * (outerSquared - innerSquared));
+			mRadii[i] = radius;
+			mHeights[i] = (unitDistribution(generator) - unitDistribution(generator)) * description.Thickness * 0.5f;
+			mScales[i] = description.MinScale + unitDistribution(generator) * (description.MaxScale - description.MinScale);
+			mInitialPhases[i] = phaseDistribution(generator);
+
+			// Kepler's third law: the angular rate falls off with the radius to the power of 1.5
+			const float ratio = description.InnerRadius / radius;
+			mAngularRates[i] = description.RevolutionRate * ratio * sqrt(ratio);
+		}
+
+		mEpochPhases = mInitialPhases;
+	}
+
+	const ParticleFieldDescription& ParticleField::Description() const
+	{
+		return mDescription;
+	}
+
+	uint32_t ParticleField::Size() const
+	{
+		return mDescription.Count;
+	}
+
+	void ParticleField::Evaluate(double time, const XMFLOAT3& center, ParticleInstance* instances)
+	{
+		Rebase(time);
+		Compute(static_cast<float>(time - mEpoch), center, 0, mDescription.Count, instances);
+	}
+
+	void ParticleField::Evaluate(double time, const XMFLOAT3& center, ParticleInstance* instances, JobSystem& jobSystem)
+	{
+		Rebase(time);
+
+		const float elapsedSeconds = static_cast<float>(time - mEpoch);
+		jobSystem.ParallelFor(0, mDescription.Count, UpdateGrainSize, [this, elapsedSeconds, &center, instances](uint32_t begin, uint32_t end)
+		{
+			Compute(elapsedSeconds, center, begin, end, instances);
+		});
+	}
+
+	void ParticleField::EvaluateScalar(double time, const XMFLOAT3& center, ParticleInstance* instances)
+	{
+		Rebase(time);
+		ComputeScalar(static_cast<float>(time - mEpoch), center, 0, mDescription.Count, instances);
+	}
+
+	void ParticleField::Rebase(double time)
+	{
+		// Phases are advanced in float from a recent epoch, and the epoch is only moved (in double) once the time strays
+		// far enough from it that the float product would start losing precision, e.g. after a warp
+		if (fabs(time - mEpoch) <= RebaseInterval)
+		{
+			return;
+		}
+
+		for (uint32_t i = 0; i < mDescription.Count; ++i)
+		{
+			mEpochPhases[i] = ReduceAngle(mInitialPhases[i] + time * mAngularRates[i]);
+		}
+
+		mEpoch = time;
+	}
+
+	void ParticleField::Compute(float elapsedSeconds, const XMFLOAT3& center, uint32_t begin, uint32_t end, ParticleInstance* instances) const
+	{
+		// Grains are multiples of four, so only the last range has a scalar tail
+		const uint32_t vectorEnd = begin + ((end - begin) & ~3U);
+		ComputeVector(elapsedSeconds, center, begin, vectorEnd, instances);
+		ComputeScalar(elapsedSeconds, center, vectorEnd, end, instances);
+	}
+
+	void ParticleField::ComputeScalar(float elapsedSeconds, const XMFLOAT3& center, uint32_t begin, uint32_t end, ParticleInstance* instances) const
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const float phase = XMScalarModAngle(mEpochPhases[i] + elapsedSeconds * mAngularRates[i]);
+
+			float sine, cosine;
+			XMScalarSinCos(&sine, &cosine, phase);
+
+			// The orbit runs in the field's XZ plane, the same way the bodies revolve, then the plane is tilted about Z
+			const float x = mRadii[i] * cosine;
+			const float y = mHeights[i];
+			const float z = -mRadii[i] * sine;
+
+			ParticleInstance& instance = instances[i];
+			instance.Position = XMFLOAT3(x * mTiltCosine - y * mTiltSine + center.x, x * mTiltSine + y * mTiltCosine + center.y, z + center.z);
+			instance.Scale = mScales[i];
+			instance.OrbitPhase = phase;
+		}
+	}
+
+	void ParticleField::ComputeVector(float elapsedSeconds, const XMFLOAT3& center, uint32_t begin, uint32_t end, ParticleInstance* instances) const
+	{
+		assert(((end - begin) & 3U) == 0);
+
+		const XMVECTOR elapsed = XMVectorReplicate(elapsedSeconds);
+		const XMVECTOR tiltSine = XMVectorReplicate(mTiltSine);
+		const XMVECTOR tiltCosine = XMVectorReplicate(mTiltCosine);
+		const XMVECTOR centerX = XMVectorReplicate(center.x);
+		const XMVECTOR centerY = XMVectorReplicate(center.y);
+		const XMVECTOR centerZ = XMVectorReplicate(center.z);
+
+		for (uint32_t i = begin; i < end; i += 4)
+		{
+			// Each lane holds one particle
+			const XMVECTOR phase = XMVectorModAngles(XMVectorMultiplyAdd(elapsed, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mAngularRates[i])), XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mEpochPhases[i]))));
+
+			XMVECTOR sine, cosine;
+			XMVectorSinCos(&sine, &cosine, phase);
+
+			const XMVECTOR radius = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mRadii[i]));
+			const XMVECTOR x = XMVectorMultiply(radius, cosine);
+			const XMVECTOR y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mHeights[i]));
+			const XMVECTOR z = XMVectorNegate(XMVectorMultiply(radius, sine));
+
+			const XMVECTOR positionX = XMVectorAdd(XMVectorNegativeMultiplySubtract(y, tiltSine, XMVectorMultiply(x, tiltCosine)), centerX);
+			const XMVECTOR positionY = XMVectorAdd(XMVectorMultiplyAdd(y, tiltCosine, XMVectorMultiply(x, tiltSine)), centerY);
+			const XMVECTOR positionZ = XMVectorAdd(z, centerZ);
+			const XMVECTOR scale = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mScales[i]));
+
+			// Transpose from one-particle-per-lane back to one-row-per-particle
+			const XMMATRIX rows = XMMatrixTranspose(XMMATRIX(positionX, positionY, positionZ, scale));
+			XMFLOAT4 phases;
+			XMStoreFloat4(&phases, phase);
+			const float* lanePhases = &phases.x;
+
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				ParticleInstance& instance = instances[i + lane];
+				XMStoreFloat3(&instance.Position, rows.r[lane]);
+				instance.Scale = XMVectorGetW(rows.r[lane]);
+				instance.OrbitPhase = lanePhases[lane];
+			}
+		}
+	}
+}
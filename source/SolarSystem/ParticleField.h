@@ -0,0 +1,72 @@
+#pragma once
+
+#include "AlignedAllocator.h"
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace Library
+{
+	class JobSystem;
+}
+
+namespace SolarSystem
+{
+	struct ParticleFieldDescription
+	{
+		std::uint32_t Count;
+		std::uint32_t Parent;
+		float InnerRadius;
+		float OuterRadius;
+		float Thickness;
+		float Tilt;
+		float MinScale;
+		float MaxScale;
+		float RevolutionRate;
+		std::uint32_t Seed;
+	};
+
+	struct ParticleInstance
+	{
+		DirectX::XMFLOAT3 Position;
+		float Scale;
+		float OrbitPhase;
+	};
+
+	class ParticleField final
+	{
+	public:
+		static const std::uint32_t UpdateGrainSize;
+		static const double RebaseInterval;
+
+		explicit ParticleField(const ParticleFieldDescription& description);
+		ParticleField(const ParticleField&) = delete;
+		ParticleField& operator=(const ParticleField&) = delete;
+		ParticleField(ParticleField&&) = default;
+		ParticleField& operator=(ParticleField&&) = default;
+		~ParticleField() = default;
+
+		const ParticleFieldDescription& Description() const;
+		std::uint32_t Size() const;
+
+		void Evaluate(double time, const DirectX::XMFLOAT3& center, ParticleInstance* instances);
+		void Evaluate(double time, const DirectX::XMFLOAT3& center, ParticleInstance* instances, Library::JobSystem& jobSystem);
+		void EvaluateScalar(double time, const DirectX::XMFLOAT3& center, ParticleInstance* instances);
+
+	private:
+		void Rebase(double time);
+		void ComputeScalar(float elapsedSeconds, const DirectX::XMFLOAT3& center, std::uint32_t begin, std::uint32_t end, ParticleInstance* instances) const;
+		void ComputeVector(float elapsedSeconds, const DirectX::XMFLOAT3& center, std::uint32_t begin, std::uint32_t end, ParticleInstance* instances) const;
+		void Compute(float elapsedSeconds, const DirectX::XMFLOAT3& center, std::uint32_t begin, std::uint32_t end, ParticleInstance* instances) const;
+
+		ParticleFieldDescription mDescription;
+		float mTiltSine;
+		float mTiltCosine;
+		double mEpoch;
+		Library::AlignedVector<float> mRadii;
+		Library::AlignedVector<float> mHeights;
+		Library::AlignedVector<float> mScales;
+		Library::AlignedVector<float> mAngularRates;
+		Library::AlignedVector<float> mInitialPhases;
+		Library::AlignedVector<float> mEpochPhases;
+	};
+}
@@ -0,0 +1,165 @@
+#include "pch.h"
+#include "ParticleFieldRender.h"
+
+using namespace std;
+using namespace Library;
+using namespace DirectX;
+using namespace SolarSystem;
+
+namespace Rendering
+{
+	RTTI_DEFINITIONS(ParticleFieldRender)
+
+	const XMFLOAT3 ParticleFieldRender::AmbientColor(0.04f, 0.04f, 0.04f);
+	const XMFLOAT3 ParticleFieldRender::ParticleColor(0.72f, 0.66f, 0.58f);
+
+	ParticleFieldRender::ParticleFieldRender(Game& game, const shared_ptr<Camera>& camera, const shared_ptr<SolarSystemSimulation>& simulation) :
+		DrawableGameComponent(game, camera), mPointLight(game, XMFLOAT3(0.0f, 0.0f, 0.0f), 30000.0f), mSimulation(simulation), mRenderQueue(nullptr), mInstanceCount(0), mIndexCount(0)
+	{
+		assert(mSimulation != nullptr);
+	}
+
+	uint32_t ParticleFieldRender::InstanceCount() const
+	{
+		return mInstanceCount;
+	}
+
+	void ParticleFieldRender::Initialize()
+	{
+		// Load a compiled vertex shader
+		vector<char> compiledVertexShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\ParticleFieldVS.cso", compiledVertexShader);
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, mVertexShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+
+		// Load a compiled pixel shader
+		vector<char> compiledPixelShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\ParticleFieldPS.cso", compiledPixelShader);
+		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mPixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+
+		// Create an input layout; slot 0 is the shared quad and slot 1 steps once per particle
+		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "INSTANCEPOSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "INSTANCESCALE", 0, DXGI_FORMAT_R32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "ORBITPHASE", 0, DXGI_FORMAT_R32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+		};
+
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(inputElementDescriptions, ARRAYSIZE(inputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInputLayout.ReleaseAndGetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+
+		// Create the quad every particle is drawn with
+		const XMFLOAT2 corners[] = { XMFLOAT2(-1.0f, -1.0f), XMFLOAT2(-1.0f, 1.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(1.0f, -1.0f) };
+		const uint32_t indices[] = { 0, 1, 2, 0, 2, 3 };
+		mIndexCount = ARRAYSIZE(indices);
+
+		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
+		vertexBufferDesc.ByteWidth = sizeof(corners);
+		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
+		vertexSubResourceData.pSysMem = corners;
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, mVertexBuffer.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+
+		D3D11_BUFFER_DESC indexBufferDesc = { 0 };
+		indexBufferDesc.ByteWidth = sizeof(indices);
+		indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA indexSubResourceData = { 0 };
+		indexSubResourceData.pSysMem = indices;
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&indexBufferDesc, &indexSubResourceData, mIndexBuffer.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+
+		// Generate the fields around whichever of their parents the scene has
+		mFields.clear();
+		mInstanceCount = 0;
+		for (const ParticleFieldDescription& description : SolarSystemScene::ParticleFields(mSimulation->Bodies()))
+		{
+			mFields.emplace_back(description);
+			mInstanceCount += description.Count;
+		}
+
+		// Every field shares one instance buffer, rewritten each frame, so the whole lot is a single draw
+		if (mInstanceCount > 0)
+		{
+			D3D11_BUFFER_DESC instanceBufferDesc = { 0 };
+			instanceBufferDesc.ByteWidth = sizeof(ParticleInstance) * mInstanceCount;
+			instanceBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+			instanceBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			instanceBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&instanceBufferDesc, nullptr, mInstanceBuffer.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+		}
+
+		// Create constant buffers
+		D3D11_BUFFER_DESC constantBufferDesc = { 0 };
+		constantBufferDesc.ByteWidth = sizeof(VSCBufferPerFrame);
+		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVSCBufferPerFrame.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+
+		constantBufferDesc.ByteWidth = sizeof(PSCBufferPerFrame);
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mPSCBufferPerFrame.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+
+		// Retrieve the render queue service
+		mRenderQueue = reinterpret_cast<RenderQueue*>(mGame->Services().GetService(RenderQueue::TypeIdClass()));
+		assert(mRenderQueue != nullptr);
+
+		// Setup the point light
+		mVSCBufferPerFrameData.LightPosition = mPointLight.Position();
+		mVSCBufferPerFrameData.LightRadius = mPointLight.Radius();
+
+		const PSCBufferPerFrame psCBufferPerFrameData(AmbientColor, ColorHelper::ToFloat3(mPointLight.Color(), true), ParticleColor);
+		mGame->Direct3DDeviceContext()->UpdateSubresource(mPSCBufferPerFrame.Get(), 0, nullptr, &psCBufferPerFrameData, 0, 0);
+	}
+
+	void ParticleFieldRender::Draw(const GameTime& gameTime)
+	{
+		assert(mCamera != nullptr);
+
+		if (mInstanceCount == 0)
+		{
+			return;
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+
+		// Particles are written straight into the mapped buffer, at the same point in the step the interpolated bodies are drawn at
+		D3D11_MAPPED_SUBRESOURCE mappedInstances;
+		ThrowIfFailed(direct3DDeviceContext->Map(mInstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedInstances), "ID3D11DeviceContext::Map() failed.");
+
+		ParticleInstance* instances = static_cast<ParticleInstance*>(mappedInstances.pData);
+		for (ParticleField& field : mFields)
+		{
+			XMFLOAT3 center(0.0f, 0.0f, 0.0f);
+			const uint32_t parent = field.Description().Parent;
+			if (parent != CelestialBodyStore::NoParent)
+			{
+				MatrixHelper::GetTranslation(mSimulation->BodyStore().InterpolatedWorldMatrix(parent, gameTime.Interpolation()), center);
+			}
+
+			field.Evaluate(mSimulation->InterpolatedSimulationTime(gameTime.Interpolation()), center, instances, mGame->Jobs());
+			instances += field.Size();
+		}
+
+		direct3DDeviceContext->Unmap(mInstanceBuffer.Get(), 0);
+
+		XMStoreFloat4x4(&mVSCBufferPerFrameData.ViewProjection, XMMatrixTranspose(mCamera->ViewProjectionMatrix()));
+		mVSCBufferPerFrameData.CameraRight = mCamera->Right();
+		mVSCBufferPerFrameData.CameraUp = mCamera->Up();
+		direct3DDeviceContext->UpdateSubresource(mVSCBufferPerFrame.Get(), 0, nullptr, &mVSCBufferPerFrameData, 0, 0);
+
+		DrawPacket packet;
+		packet.InputLayout = mInputLayout.Get();
+		packet.VertexBuffers[0] = mVertexBuffer.Get();
+		packet.VertexStrides[0] = sizeof(XMFLOAT2);
+		packet.VertexBuffers[1] = mInstanceBuffer.Get();
+		packet.VertexStrides[1] = sizeof(ParticleInstance);
+		packet.IndexBuffer = mIndexBuffer.Get();
+		packet.VertexShader = mVertexShader.Get();
+		packet.PixelShader = mPixelShader.Get();
+		packet.VSConstantBuffers[0] = mVSCBufferPerFrame.Get();
+		packet.PSConstantBuffers[0] = mPSCBufferPerFrame.Get();
+		packet.IndexCount = mIndexCount;
+		packet.InstanceCount = mInstanceCount;
+		mRenderQueue->Submit(RenderLayer::Opaque, packet);
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "PointLight.h"
+#include "ParticleField.h"
+#include "SolarSystemSimulation.h"
+#include <DirectXMath.h>
+#include <vector>
+
+namespace Library
+{
+	class RenderQueue;
+}
+
+namespace Rendering
+{
+	class ParticleFieldRender final : public Library::DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(ParticleFieldRender, Library::DrawableGameComponent)
+
+	public:
+		ParticleFieldRender(Library::Game& game, const std::shared_ptr<Library::Camera>& camera, const std::shared_ptr<SolarSystem::SolarSystemSimulation>& simulation);
+
+		std::uint32_t InstanceCount() const;
+
+		virtual void Initialize() override;
+		virtual void Draw(const Library::GameTime& gameTime) override;
+
+	private:
+		struct VSCBufferPerFrame
+		{
+			DirectX::XMFLOAT4X4 ViewProjection;
+			DirectX::XMFLOAT3 CameraRight;
+			float LightRadius;
+			DirectX::XMFLOAT3 CameraUp;
+			float Padding;
+			DirectX::XMFLOAT3 LightPosition;
+			float Padding2;
+
+			VSCBufferPerFrame() :
+				CameraRight(Library::Vector3Helper::Right), LightRadius(50.0f), CameraUp(Library::Vector3Helper::Up), LightPosition(Library::Vector3Helper::Zero) { }
+		};
+
+		struct PSCBufferPerFrame
+		{
+			DirectX::XMFLOAT3 AmbientColor;
+			float Padding;
+			DirectX::XMFLOAT3 LightColor;
+			float Padding2;
+			DirectX::XMFLOAT3 ParticleColor;
+			float Padding3;
+
+			PSCBufferPerFrame() :
+				AmbientColor(Library::Vector3Helper::Zero), LightColor(Library::Vector3Helper::Zero), ParticleColor(Library::Vector3Helper::Zero) { }
+			PSCBufferPerFrame(const DirectX::XMFLOAT3& ambientColor, const DirectX::XMFLOAT3& lightColor, const DirectX::XMFLOAT3& particleColor) :
+				AmbientColor(ambientColor), LightColor(lightColor), ParticleColor(particleColor) { }
+		};
+
+		static const DirectX::XMFLOAT3 AmbientColor;
+		static const DirectX::XMFLOAT3 ParticleColor;
+
+		VSCBufferPerFrame mVSCBufferPerFrameData;
+		Library::PointLight mPointLight;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> mVertexShader;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> mPixelShader;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> mInputLayout;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mIndexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mInstanceBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mVSCBufferPerFrame;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mPSCBufferPerFrame;
+		std::shared_ptr<SolarSystem::SolarSystemSimulation> mSimulation;
+		Library::RenderQueue* mRenderQueue;
+		std::vector<SolarSystem::ParticleField> mFields;
+		std::uint32_t mInstanceCount;
+		std::uint32_t mIndexCount;
+	};
+}
@@ -1,16 +1,23 @@
 #include "pch.h"
+#include "SimulationRecorder.h"
+#include "SimulationPlayer.h"
+#include "ParticleFieldRender.h"
 
 using namespace std;
 using namespace DirectX;
 using namespace Library;
+using namespace SolarSystem;
 
 namespace Rendering
 {
 	const XMVECTORF32 RenderingGame::BackgroundColor = Colors::Black;
+	const wstring RenderingGame::RecordingFilename = L"Session.simrec";
 
 	RenderingGame::RenderingGame(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback) :
 		Game(getWindowCallback, getRenderTargetSizeCallback), mRenderStateHelper(*this)
 	{
+		// Orbits advance in fixed steps, independent of the frame rate, and are drawn interpolated between steps
+		mGameClock.SetFixedTimeStepEnabled(true);
 	}
 
 	void RenderingGame::Initialize()
@@ -34,7 +41,31 @@ namespace Rendering
 		mComponents.push_back(mCamera);
 		mServices.AddService(Camera::TypeIdClass(), mCamera.get());
 
-		mSolarSystemRender = make_shared<SolarSystemRender>(*this, mCamera);
+		// Per-draw constants are written into one dynamic buffer and bound by offset, where the driver supports it
+		mConstantBufferRing.Initialize(mDirect3DDevice.Get());
+		mServices.AddService(ConstantBufferRing::TypeIdClass(), &mConstantBufferRing);
+
+		// Drawable components submit to the queue, which draws everything sorted by state once they have all run
+		mRenderQueue.SetConstantBufferRing(&mConstantBufferRing);
+		mServices.AddService(RenderQueue::TypeIdClass(), &mRenderQueue);
+
+		// The simulation updates before the render reads it, and runs just the same without one
+		mSimulation = make_shared<SolarSystemSimulation>(*this);
+
+		// Recording and replay sit between the camera and the simulation, so they see each update's inputs just before it runs
+		mRecorder = make_shared<SimulationRecorder>(*this, mSimulation, mCamera);
+		mComponents.push_back(mRecorder);
+
+		mPlayer = make_shared<SimulationPlayer>(*this, mSimulation, mCamera);
+		mComponents.push_back(mPlayer);
+
+		mComponents.push_back(mSimulation);
+		mServices.AddService(SolarSystemSimulation::TypeIdClass(), mSimulation.get());
+
+		mParticleFieldRender = make_shared<ParticleFieldRender>(*this, mCamera, mSimulation);
+		mComponents.push_back(mParticleFieldRender);
+
+		mSolarSystemRender = make_shared<SolarSystemRender>(*this, mCamera, mSimulation);
 		mComponents.push_back(mSolarSystemRender);
 
 		Game::Initialize();
@@ -54,6 +85,21 @@ namespace Rendering
 			Exit();
 		}
 
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F5))
+		{
+			ToggleRecording();
+		}
+
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F6))
+		{
+			ReplayRecording();
+		}
+
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F7))
+		{
+			ToggleDeferredRecording();
+		}
+
 		Game::Update(gameTime);
 	}
 
@@ -63,6 +109,14 @@ namespace Rendering
 		mDirect3DDeviceContext->ClearDepthStencilView(mDepthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
 		Game::Draw(gameTime);
+		if (DeferredRecordingEnabled())
+		{
+			mRenderQueue.Execute(mDirect3DDeviceContext.Get(), *mDeferredContextRecorder, mJobSystem);
+		}
+		else
+		{
+			mRenderQueue.Execute(mDirect3DDeviceContext.Get());
+		}
 
 		mRenderStateHelper.SaveAll();
 		mFpsComponent->Draw(gameTime);
@@ -91,4 +145,37 @@ namespace Rendering
 	{
 		PostQuitMessage(0);
 	}
+
+	void RenderingGame::ToggleRecording()
+	{
+		if (mRecorder->IsRecording())
+		{
+			mRecorder->Stop();
+			mRecorder->Recording().Save(RecordingFilename);
+		}
+		else if (!mPlayer->IsPlaying())
+		{
+			mRecorder->Start();
+		}
+	}
+
+	void RenderingGame::ReplayRecording()
+	{
+		if (!mRecorder->IsRecording() && mRecorder->Recording().FrameCount() > 0)
+		{
+			mPlayer->Start(mRecorder->Recording());
+		}
+	}
+
+	void RenderingGame::ToggleDeferredRecording()
+	{
+		if (DeferredRecordingEnabled())
+		{
+			DisableDeferredRecording();
+		}
+		else
+		{
+			EnableDeferredRecording();
+		}
+	}
 }
\ No newline at end of file
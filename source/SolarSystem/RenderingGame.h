@@ -2,6 +2,7 @@
 
 #include "Game.h"
 #include "RenderStateHelper.h"
+#include "RenderQueue.h"
 #include <windows.h>
 #include <functional>
 
@@ -15,9 +16,17 @@ namespace Library
 	class Grid;
 }
 
+namespace SolarSystem
+{
+	class SolarSystemSimulation;
+	class SimulationRecorder;
+	class SimulationPlayer;
+}
+
 namespace Rendering
 {
 	class SolarSystemRender;
+	class ParticleFieldRender;
 	class RenderingGame final : public Library::Game
 
 	{
@@ -33,13 +42,24 @@ namespace Rendering
 
 	private:
 		static const DirectX::XMVECTORF32 BackgroundColor;
+		static const std::wstring RecordingFilename;
+
+		void ToggleRecording();
+		void ReplayRecording();
+		void ToggleDeferredRecording();
 
 		Library::RenderStateHelper mRenderStateHelper;
+		Library::ConstantBufferRing mConstantBufferRing;
+		Library::RenderQueue mRenderQueue;
 		std::shared_ptr<Library::KeyboardComponent> mKeyboard;
 		std::shared_ptr<Library::MouseComponent> mMouse;
 		std::shared_ptr<Library::GamePadComponent> mGamePad;
 		std::shared_ptr<Library::FpsComponent> mFpsComponent;
 		std::shared_ptr<Library::Camera> mCamera;
+		std::shared_ptr<SolarSystem::SolarSystemSimulation> mSimulation;
+		std::shared_ptr<SolarSystem::SimulationRecorder> mRecorder;
+		std::shared_ptr<SolarSystem::SimulationPlayer> mPlayer;
+		std::shared_ptr<ParticleFieldRender> mParticleFieldRender;
 		std::shared_ptr<SolarSystemRender> mSolarSystemRender;
 	};
 }
@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "SimulationPlayer.h"
+#include "SolarSystemSimulation.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	RTTI_DEFINITIONS(SimulationPlayer)
+
+	SimulationPlayer::SimulationPlayer(Game& game, const shared_ptr<SolarSystemSimulation>& simulation, const shared_ptr<Camera>& camera) :
+		GameComponent(game), mSimulation(simulation), mCamera(camera), mOffset(0), mFramesPlayed(0), mIsPlaying(false), mResumePending(false), mMatched(false)
+	{
+		assert(mSimulation != nullptr);
+	}
+
+	bool SimulationPlayer::IsPlaying() const
+	{
+		return mIsPlaying;
+	}
+
+	bool SimulationPlayer::Matched() const
+	{
+		return mMatched;
+	}
+
+	uint32_t SimulationPlayer::FramesPlayed() const
+	{
+		return mFramesPlayed;
+	}
+
+	void SimulationPlayer::Start(const SimulationRecording& recording)
+	{
+		mRecording = recording;
+		mRecording.Restore(*mSimulation, mFrame);
+		mOffset = 0;
+		mFramesPlayed = 0;
+		mMatched = false;
+
+		// The player drives the simulation with the recorded frame times instead of the game clock
+		mSimulation->SetEnabled(false);
+		mIsPlaying = true;
+		mResumePending = false;
+
+		if (mRecording.FrameCount() == 0)
+		{
+			Finish();
+		}
+	}
+
+	void SimulationPlayer::Stop()
+	{
+		if (mIsPlaying || mResumePending)
+		{
+			mSimulation->SetEnabled(true);
+			mIsPlaying = false;
+			mResumePending = false;
+		}
+	}
+
+	void SimulationPlayer::Update(const GameTime& gameTime)
+	{
+		UNREFERENCED_PARAMETER(gameTime);
+
+		if (!mIsPlaying)
+		{
+			if (mResumePending)
+			{
+				Stop();
+			}
+
+			return;
+		}
+
+		mRecording.ReadFrame(mOffset, mFrame);
+
+		// Toggles go through the same calls the user made, so starting gravity derives the same initial orbits
+		mSimulation->SetAnimationEnabled(mFrame.AnimationEnabled);
+		mSimulation->SetNBodyEnabled(mFrame.NBodyEnabled);
+
+		const double simulationTime = mSimulation->SimulationTime();
+		if (memcmp(&simulationTime, &mFrame.SimulationTime, sizeof(double)) != 0)
+		{
+			mSimulation->WarpTo(mFrame.SimulationTime);
+		}
+
+		if (mCamera != nullptr)
+		{
+			mCamera->SetPosition(mFrame.CameraPosition);
+			mCamera->SetOrientation(mFrame.CameraDirection, mFrame.CameraUp, mFrame.CameraRight);
+			mCamera->UpdateViewMatrix();
+		}
+
+		mSimulation->Advance(mFrame.ElapsedTime);
+
+		if (++mFramesPlayed == mRecording.FrameCount())
+		{
+			Finish();
+		}
+	}
+
+	void SimulationPlayer::Finish()
+	{
+		mMatched = (mSimulation->Checksum() == mRecording.FinalChecksum());
+
+		// The simulation only takes over again on the next update, so the last recorded frame is not run twice
+		mIsPlaying = false;
+		mResumePending = true;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "GameComponent.h"
+#include "SimulationRecording.h"
+#include <cstdint>
+#include <memory>
+
+namespace Library
+{
+	class Camera;
+}
+
+namespace SolarSystem
+{
+	class SolarSystemSimulation;
+
+	class SimulationPlayer final : public Library::GameComponent
+	{
+		RTTI_DECLARATIONS(SimulationPlayer, Library::GameComponent)
+
+	public:
+		SimulationPlayer(Library::Game& game, const std::shared_ptr<SolarSystemSimulation>& simulation, const std::shared_ptr<Library::Camera>& camera = nullptr);
+		SimulationPlayer(const SimulationPlayer&) = delete;
+		SimulationPlayer& operator=(const SimulationPlayer&) = delete;
+		SimulationPlayer(SimulationPlayer&&) = delete;
+		SimulationPlayer& operator=(SimulationPlayer&&) = delete;
+		~SimulationPlayer() = default;
+
+		bool IsPlaying() const;
+		bool Matched() const;
+		std::uint32_t FramesPlayed() const;
+
+		void Start(const SimulationRecording& recording);
+		void Stop();
+
+		virtual void Update(const Library::GameTime& gameTime) override;
+
+	private:
+		void Finish();
+
+		std::shared_ptr<SolarSystemSimulation> mSimulation;
+		std::shared_ptr<Library::Camera> mCamera;
+		SimulationRecording mRecording;
+		SimulationFrame mFrame;
+		std::size_t mOffset;
+		std::uint32_t mFramesPlayed;
+		bool mIsPlaying;
+		bool mResumePending;
+		bool mMatched;
+	};
+}
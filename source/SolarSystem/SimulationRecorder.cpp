@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "SimulationRecorder.h"
+#include "SolarSystemSimulation.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	RTTI_DEFINITIONS(SimulationRecorder)
+
+	SimulationRecorder::SimulationRecorder(Game& game, const shared_ptr<SolarSystemSimulation>& simulation, const shared_ptr<Camera>& camera) :
+		GameComponent(game), mSimulation(simulation), mCamera(camera), mIsRecording(false)
+	{
+		assert(mSimulation != nullptr);
+	}
+
+	bool SimulationRecorder::IsRecording() const
+	{
+		return mIsRecording;
+	}
+
+	const SimulationRecording& SimulationRecorder::Recording() const
+	{
+		return mRecording;
+	}
+
+	void SimulationRecorder::Start()
+	{
+		mRecording.Begin(*mSimulation);
+		mIsRecording = true;
+	}
+
+	void SimulationRecorder::Stop()
+	{
+		if (mIsRecording)
+		{
+			mRecording.Finish(*mSimulation);
+			mIsRecording = false;
+		}
+	}
+
+	void SimulationRecorder::Update(const GameTime& gameTime)
+	{
+		if (!mIsRecording)
+		{
+			return;
+		}
+
+		// Sampled after the camera moves but before the simulation updates, so each frame holds exactly what that update sees
+		SimulationFrame frame;
+		frame.ElapsedTime = gameTime.ElapsedGameTimeNanoseconds();
+		frame.SimulationTime = mSimulation->SimulationTime();
+		frame.AnimationEnabled = mSimulation->AnimationEnabled();
+		frame.NBodyEnabled = mSimulation->NBodyEnabled();
+		if (mCamera != nullptr)
+		{
+			frame.CameraPosition = mCamera->Position();
+			frame.CameraDirection = mCamera->Direction();
+			frame.CameraUp = mCamera->Up();
+			frame.CameraRight = mCamera->Right();
+		}
+
+		mRecording.Append(frame);
+	}
+}
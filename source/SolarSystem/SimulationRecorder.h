@@ -0,0 +1,42 @@
+#pragma once
+
+#include "GameComponent.h"
+#include "SimulationRecording.h"
+#include <memory>
+
+namespace Library
+{
+	class Camera;
+}
+
+namespace SolarSystem
+{
+	class SolarSystemSimulation;
+
+	class SimulationRecorder final : public Library::GameComponent
+	{
+		RTTI_DECLARATIONS(SimulationRecorder, Library::GameComponent)
+
+	public:
+		SimulationRecorder(Library::Game& game, const std::shared_ptr<SolarSystemSimulation>& simulation, const std::shared_ptr<Library::Camera>& camera = nullptr);
+		SimulationRecorder(const SimulationRecorder&) = delete;
+		SimulationRecorder& operator=(const SimulationRecorder&) = delete;
+		SimulationRecorder(SimulationRecorder&&) = delete;
+		SimulationRecorder& operator=(SimulationRecorder&&) = delete;
+		~SimulationRecorder() = default;
+
+		bool IsRecording() const;
+		const SimulationRecording& Recording() const;
+
+		void Start();
+		void Stop();
+
+		virtual void Update(const Library::GameTime& gameTime) override;
+
+	private:
+		std::shared_ptr<SolarSystemSimulation> mSimulation;
+		std::shared_ptr<Library::Camera> mCamera;
+		SimulationRecording mRecording;
+		bool mIsRecording;
+	};
+}
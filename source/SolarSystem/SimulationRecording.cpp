@@ -0,0 +1,313 @@
+#include "pch.h"
+#include "SimulationRecording.h"
+#include "SolarSystemSimulation.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	namespace
+	{
+		const uint32_t CameraComponentCount = 12;
+
+		void GetCameraComponents(const SimulationFrame& frame, float (&components)[CameraComponentCount])
+		{
+			const XMFLOAT3* vectors[] = { &frame.CameraPosition, &frame.CameraDirection, &frame.CameraUp, &frame.CameraRight };
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				components[i * 3] = vectors[i]->x;
+				components[i * 3 + 1] = vectors[i]->y;
+				components[i * 3 + 2] = vectors[i]->z;
+			}
+		}
+
+		void SetCameraComponents(SimulationFrame& frame, const float (&components)[CameraComponentCount])
+		{
+			XMFLOAT3* vectors[] = { &frame.CameraPosition, &frame.CameraDirection, &frame.CameraUp, &frame.CameraRight };
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				*vectors[i] = XMFLOAT3(components[i * 3], components[i * 3 + 1], components[i * 3 + 2]);
+			}
+		}
+	}
+
+	SimulationFrame::SimulationFrame() :
+		ElapsedTime(0), SimulationTime(0.0), AnimationEnabled(false), NBodyEnabled(false),
+		CameraPosition(0.0f, 0.0f, 0.0f), CameraDirection(0.0f, 0.0f, 0.0f), CameraUp(0.0f, 0.0f, 0.0f), CameraRight(0.0f, 0.0f, 0.0f)
+	{
+	}
+
+	const uint32_t SimulationRecording::Magic = 0x43455253; // "SREC"
+	const uint32_t SimulationRecording::Version = 1;
+
+	SimulationRecording::SimulationRecording() :
+		mFrameCount(0), mFinalChecksum(0)
+	{
+	}
+
+	void SimulationRecording::Begin(const SolarSystemSimulation& simulation)
+	{
+		ostringstream snapshot(ios::binary);
+		OutputStreamHelper streamHelper(snapshot);
+		simulation.Save(streamHelper);
+
+		mSnapshot = snapshot.str();
+		mFrames.clear();
+		mFrameCount = 0;
+		mFinalChecksum = 0;
+
+		// Frames are encoded against the one before, and the first against the state the snapshot restores
+		mLastFrame = SimulationFrame();
+		mLastFrame.SimulationTime = simulation.SimulationTime();
+		mLastFrame.AnimationEnabled = simulation.AnimationEnabled();
+		mLastFrame.NBodyEnabled = simulation.NBodyEnabled();
+	}
+
+	void SimulationRecording::Append(const SimulationFrame& frame)
+	{
+		// Most frames repeat the last one exactly, so each only stores what changed and a steady frame costs a single byte
+		uint8_t flags = 0;
+		const int64_t elapsedTimeDelta = frame.ElapsedTime.count() - mLastFrame.ElapsedTime.count();
+		if (elapsedTimeDelta != 0)
+		{
+			flags |= ElapsedTimeChanged;
+		}
+
+		// Time only moves by the elapsed time of the previous frame unless it was warped, so only warps are stored
+		const double expectedTime = ExpectedSimulationTime(mLastFrame);
+		if (memcmp(&frame.SimulationTime, &expectedTime, sizeof(double)) != 0)
+		{
+			flags |= SimulationTimeJumped;
+		}
+
+		if (frame.AnimationEnabled != mLastFrame.AnimationEnabled)
+		{
+			flags |= AnimationToggled;
+		}
+
+		if (frame.NBodyEnabled != mLastFrame.NBodyEnabled)
+		{
+			flags |= NBodyToggled;
+		}
+
+		float components[CameraComponentCount];
+		float lastComponents[CameraComponentCount];
+		GetCameraComponents(frame, components);
+		GetCameraComponents(mLastFrame, lastComponents);
+
+		uint32_t cameraMask = 0;
+		for (uint32_t i = 0; i < CameraComponentCount; ++i)
+		{
+			if (memcmp(&components[i], &lastComponents[i], sizeof(float)) != 0)
+			{
+				cameraMask |= (1 << i);
+			}
+		}
+
+		if (cameraMask != 0)
+		{
+			flags |= CameraMoved;
+		}
+
+		WriteBytes(&flags, sizeof(flags));
+		if (flags & ElapsedTimeChanged)
+		{
+			// Zigzag keeps small negative changes small
+			WriteVarint((static_cast<uint64_t>(elapsedTimeDelta) << 1) ^ static_cast<uint64_t>(elapsedTimeDelta >> 63));
+		}
+
+		if (flags & SimulationTimeJumped)
+		{
+			WriteBytes(&frame.SimulationTime, sizeof(double));
+		}
+
+		if (flags & CameraMoved)
+		{
+			WriteVarint(cameraMask);
+			for (uint32_t i = 0; i < CameraComponentCount; ++i)
+			{
+				if (cameraMask & (1 << i))
+				{
+					WriteBytes(&components[i], sizeof(float));
+				}
+			}
+		}
+
+		mLastFrame = frame;
+		++mFrameCount;
+	}
+
+	void SimulationRecording::Finish(const SolarSystemSimulation& simulation)
+	{
+		mFinalChecksum = simulation.Checksum();
+	}
+
+	void SimulationRecording::Restore(SolarSystemSimulation& simulation, SimulationFrame& frame) const
+	{
+		istringstream snapshot(mSnapshot, ios::binary);
+		InputStreamHelper streamHelper(snapshot);
+		simulation.Load(streamHelper);
+
+		frame = SimulationFrame();
+		frame.SimulationTime = simulation.SimulationTime();
+		frame.AnimationEnabled = simulation.AnimationEnabled();
+		frame.NBodyEnabled = simulation.NBodyEnabled();
+	}
+
+	void SimulationRecording::ReadFrame(size_t& offset, SimulationFrame& frame) const
+	{
+		uint8_t flags;
+		ReadBytes(offset, &flags, sizeof(flags));
+
+		// The expected time comes from the previous frame, before any of it is overwritten
+		frame.SimulationTime = ExpectedSimulationTime(frame);
+
+		if (flags & ElapsedTimeChanged)
+		{
+			const uint64_t zigzag = ReadVarint(offset);
+			const int64_t elapsedTimeDelta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+			frame.ElapsedTime += chrono::nanoseconds(elapsedTimeDelta);
+		}
+
+		if (flags & SimulationTimeJumped)
+		{
+			ReadBytes(offset, &frame.SimulationTime, sizeof(double));
+		}
+
+		if (flags & AnimationToggled)
+		{
+			frame.AnimationEnabled = !frame.AnimationEnabled;
+		}
+
+		if (flags & NBodyToggled)
+		{
+			frame.NBodyEnabled = !frame.NBodyEnabled;
+		}
+
+		if (flags & CameraMoved)
+		{
+			const uint64_t cameraMask = ReadVarint(offset);
+
+			float components[CameraComponentCount];
+			GetCameraComponents(frame, components);
+			for (uint32_t i = 0; i < CameraComponentCount; ++i)
+			{
+				if (cameraMask & (1ULL << i))
+				{
+					ReadBytes(offset, &components[i], sizeof(float));
+				}
+			}
+
+			SetCameraComponents(frame, components);
+		}
+	}
+
+	uint32_t SimulationRecording::FrameCount() const
+	{
+		return mFrameCount;
+	}
+
+	uint64_t SimulationRecording::FinalChecksum() const
+	{
+		return mFinalChecksum;
+	}
+
+	size_t SimulationRecording::SizeInBytes() const
+	{
+		return mSnapshot.size() + mFrames.size();
+	}
+
+	void SimulationRecording::Save(const wstring& filename) const
+	{
+		ofstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw GameException("Could not open file.");
+		}
+
+		OutputStreamHelper streamHelper(file);
+		streamHelper << Magic << Version << mSnapshot << mFrameCount << mFinalChecksum << mFrames;
+		if (!file.good())
+		{
+			throw GameException("Could not write recording.");
+		}
+	}
+
+	void SimulationRecording::Load(const wstring& filename)
+	{
+		ifstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw GameException("Could not open file.");
+		}
+
+		InputStreamHelper streamHelper(file);
+		uint32_t magic;
+		uint32_t version;
+		streamHelper >> magic >> version;
+		if (magic != Magic || version != Version)
+		{
+			throw GameException("File is not a supported simulation recording.");
+		}
+
+		streamHelper >> mSnapshot >> mFrameCount >> mFinalChecksum >> mFrames;
+		if (!file.good())
+		{
+			throw GameException("Simulation recording is truncated.");
+		}
+
+		mLastFrame = SimulationFrame();
+	}
+
+	double SimulationRecording::ExpectedSimulationTime(const SimulationFrame& previous)
+	{
+		// The same sum the simulation performs, so an undisturbed frame predicts the recorded time bit for bit
+		return (previous.AnimationEnabled ? previous.SimulationTime + chrono::duration<double>(previous.ElapsedTime).count() : previous.SimulationTime);
+	}
+
+	void SimulationRecording::WriteVarint(uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			mFrames.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+
+		mFrames.push_back(static_cast<char>(value));
+	}
+
+	uint64_t SimulationRecording::ReadVarint(size_t& offset) const
+	{
+		uint64_t value = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7)
+		{
+			uint8_t encoded;
+			ReadBytes(offset, &encoded, sizeof(encoded));
+			value |= static_cast<uint64_t>(encoded & 0x7F) << shift;
+			if ((encoded & 0x80) == 0)
+			{
+				break;
+			}
+		}
+
+		return value;
+	}
+
+	void SimulationRecording::WriteBytes(const void* data, size_t size)
+	{
+		mFrames.append(reinterpret_cast<const char*>(data), size);
+	}
+
+	void SimulationRecording::ReadBytes(size_t& offset, void* data, size_t size) const
+	{
+		if (offset + size > mFrames.size())
+		{
+			throw GameException("Simulation recording is truncated.");
+		}
+
+		memcpy(data, mFrames.data() + offset, size);
+		offset += size;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace SolarSystem
+{
+	class SolarSystemSimulation;
+
+	struct SimulationFrame
+	{
+		std::chrono::nanoseconds ElapsedTime;
+		double SimulationTime;
+		bool AnimationEnabled;
+		bool NBodyEnabled;
+		DirectX::XMFLOAT3 CameraPosition;
+		DirectX::XMFLOAT3 CameraDirection;
+		DirectX::XMFLOAT3 CameraUp;
+		DirectX::XMFLOAT3 CameraRight;
+
+		SimulationFrame();
+	};
+
+	class SimulationRecording final
+	{
+	public:
+		static const std::uint32_t Magic;
+		static const std::uint32_t Version;
+
+		SimulationRecording();
+		SimulationRecording(const SimulationRecording&) = default;
+		SimulationRecording& operator=(const SimulationRecording&) = default;
+		SimulationRecording(SimulationRecording&&) = default;
+		SimulationRecording& operator=(SimulationRecording&&) = default;
+		~SimulationRecording() = default;
+
+		void Begin(const SolarSystemSimulation& simulation);
+		void Append(const SimulationFrame& frame);
+		void Finish(const SolarSystemSimulation& simulation);
+
+		void Restore(SolarSystemSimulation& simulation, SimulationFrame& frame) const;
+		void ReadFrame(std::size_t& offset, SimulationFrame& frame) const;
+
+		std::uint32_t FrameCount() const;
+		std::uint64_t FinalChecksum() const;
+		std::size_t SizeInBytes() const;
+
+		void Save(const std::wstring& filename) const;
+		void Load(const std::wstring& filename);
+
+	private:
+		enum FrameFlags : std::uint8_t
+		{
+			ElapsedTimeChanged = 0x01,
+			SimulationTimeJumped = 0x02,
+			AnimationToggled = 0x04,
+			NBodyToggled = 0x08,
+			CameraMoved = 0x10
+		};
+
+		static double ExpectedSimulationTime(const SimulationFrame& previous);
+
+		void WriteVarint(std::uint64_t value);
+		std::uint64_t ReadVarint(std::size_t& offset) const;
+		void WriteBytes(const void* data, std::size_t size);
+		void ReadBytes(std::size_t& offset, void* data, std::size_t size) const;
+
+		std::string mSnapshot;
+		std::string mFrames;
+		std::uint32_t mFrameCount;
+		std::uint64_t mFinalChecksum;
+		SimulationFrame mLastFrame;
+	};
+}
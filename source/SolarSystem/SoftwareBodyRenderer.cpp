@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "SoftwareBodyRenderer.h"
+#include "SoftwareTexture.h"
+#include "CelestialBodyStore.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Rendering
+{
+	SoftwareBodyRenderer::SoftwareBodyRenderer(JobSystem& jobSystem, uint32_t width, uint32_t height) :
+		mRasterizer(jobSystem, width, height), mLodCounts()
+	{
+		// The defaults of SolarSystemRender: a white point light at the Sun and no ambient light
+		mLighting.AmbientColor = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		mLighting.LightPosition = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		mLighting.LightColor = XMFLOAT3(1.0f, 1.0f, 1.0f);
+		mLighting.LightRadius = 30000.0f;
+	}
+
+	const SoftwareRasterizer& SoftwareBodyRenderer::Rasterizer() const
+	{
+		return mRasterizer;
+	}
+
+	uint32_t SoftwareBodyRenderer::VisibleCount() const
+	{
+		return static_cast<uint32_t>(mShaders.size());
+	}
+
+	uint32_t SoftwareBodyRenderer::BodiesAtLod(uint32_t lod) const
+	{
+		assert(lod <= BodyLodSelector::LodCount);
+
+		return mLodCounts[lod];
+	}
+
+	void SoftwareBodyRenderer::SetSphereLods(vector<SoftwareMesh>&& sphereLods)
+	{
+		if (sphereLods.size() != BodyLodSelector::LodCount)
+		{
+			throw GameException("The software renderer needs one sphere per level of detail.");
+		}
+
+		mSphereLods = move(sphereLods);
+
+		const vector<VertexPositionTextureNormal>& vertices = mSphereLods.front().Vertices;
+		mVisibility.SetMeshRadius(BodyVisibility::BoundingRadius(vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(VertexPositionTextureNormal)));
+	}
+
+	void SoftwareBodyRenderer::SetLighting(const SoftwareLighting& lighting)
+	{
+		mLighting = lighting;
+	}
+
+	void SoftwareBodyRenderer::Render(const CelestialBodyStore& store, const vector<const SoftwareTexture*>& bodyTextures, CXMMATRIX viewMatrix, CXMMATRIX projectionMatrix, FXMVECTOR cameraPosition, float interpolation)
+	{
+		assert(mSphereLods.size() == BodyLodSelector::LodCount);
+		assert(bodyTextures.size() >= store.Size());
+
+		// Visibility and levels of detail come from the same code SolarSystemRender uses
+		const XMMATRIX viewProjectionMatrix = XMMatrixMultiply(viewMatrix, projectionMatrix);
+		mVisibility.Prepare(store, viewProjectionMatrix, projectionMatrix, cameraPosition, static_cast<float>(mRasterizer.Height()), interpolation);
+		const uint32_t visibleCount = mVisibility.VisibleCount();
+		const uint32_t* visibleSlots = mVisibility.VisibleSlots();
+		const uint8_t* visibleLods = mVisibility.VisibleLods();
+
+		// Nearest first, so the depth test turns away as much as it can before anything behind is shaded
+		mWorldMatrices.resize(visibleCount);
+		mDistances.resize(visibleCount);
+		mDrawOrder.resize(visibleCount);
+		for (uint32_t i = 0; i < visibleCount; ++i)
+		{
+			const XMMATRIX worldMatrix = store.InterpolatedWorldMatrix(store.Body(visibleSlots[i]), interpolation);
+			XMStoreFloat4x4(&mWorldMatrices[i], worldMatrix);
+			mDistances[i] = XMVectorGetX(XMVector3Length(worldMatrix.r[3] - cameraPosition));
+			mDrawOrder[i] = i;
+		}
+
+		sort(mDrawOrder.begin(), mDrawOrder.end(), [this](uint32_t lhs, uint32_t rhs) { return mDistances[lhs] < mDistances[rhs]; });
+
+		// The rasterizer holds on to each shader until the flush, so the vector must not grow past what is reserved here
+		mShaders.clear();
+		mShaders.reserve(visibleCount);
+		fill(begin(mLodCounts), end(mLodCounts), 0);
+		mRasterizer.Clear(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+
+		for (uint32_t i : mDrawOrder)
+		{
+			const uint32_t body = store.Body(visibleSlots[i]);
+			const SoftwareTexture* colorTexture = bodyTextures[body];
+			if (colorTexture == nullptr)
+			{
+				continue;
+			}
+
+			// Impostors are single points on the device; here they take the coarsest sphere, unlit like the point would be
+			const uint32_t lod = visibleLods[i];
+			const SoftwareMesh& mesh = mSphereLods[min(lod, BodyLodSelector::LodCount - 1)];
+			const bool isLit = (store.IsLit(body) && lod != BodyLodSelector::ImpostorLod);
+			++mLodCounts[lod];
+
+			mShaders.emplace_back(mLighting, XMLoadFloat4x4(&mWorldMatrices[i]), viewProjectionMatrix, *colorTexture, isLit);
+			mRasterizer.Draw(mesh.Vertices.data(), sizeof(VertexPositionTextureNormal), static_cast<uint32_t>(mesh.Vertices.size()), mesh.Indices.data(), static_cast<uint32_t>(mesh.Indices.size()), mShaders.back());
+		}
+
+		mRasterizer.Flush();
+	}
+}
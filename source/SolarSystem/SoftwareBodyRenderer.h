@@ -0,0 +1,64 @@
+#pragma once
+
+#include "SoftwareRasterizer.h"
+#include "SoftwareBodyShader.h"
+#include "BodyLodSelector.h"
+#include "BodyVisibility.h"
+#include "VertexDeclarations.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace Library
+{
+	class JobSystem;
+	class SoftwareTexture;
+}
+
+namespace SolarSystem
+{
+	class CelestialBodyStore;
+}
+
+namespace Rendering
+{
+	struct SoftwareMesh
+	{
+		std::vector<Library::VertexPositionTextureNormal> Vertices;
+		std::vector<std::uint32_t> Indices;
+	};
+
+	// The body pass of SolarSystemRender on the software rasterizer: the same culling, levels of detail and lighting,
+	// without a device, so frames can be rendered and timed headless
+	class SoftwareBodyRenderer final
+	{
+	public:
+		SoftwareBodyRenderer(Library::JobSystem& jobSystem, std::uint32_t width, std::uint32_t height);
+		SoftwareBodyRenderer() = delete;
+		SoftwareBodyRenderer(const SoftwareBodyRenderer&) = delete;
+		SoftwareBodyRenderer& operator=(const SoftwareBodyRenderer&) = delete;
+		SoftwareBodyRenderer(SoftwareBodyRenderer&&) = delete;
+		SoftwareBodyRenderer& operator=(SoftwareBodyRenderer&&) = delete;
+		~SoftwareBodyRenderer() = default;
+
+		const Library::SoftwareRasterizer& Rasterizer() const;
+		std::uint32_t VisibleCount() const;
+		std::uint32_t BodiesAtLod(std::uint32_t lod) const;
+
+		void SetSphereLods(std::vector<SoftwareMesh>&& sphereLods);
+		void SetLighting(const SoftwareLighting& lighting);
+
+		void Render(const SolarSystem::CelestialBodyStore& store, const std::vector<const Library::SoftwareTexture*>& bodyTextures, DirectX::CXMMATRIX viewMatrix, DirectX::CXMMATRIX projectionMatrix, DirectX::FXMVECTOR cameraPosition, float interpolation);
+
+	private:
+		Library::SoftwareRasterizer mRasterizer;
+		std::vector<SoftwareMesh> mSphereLods;
+		SoftwareLighting mLighting;
+		SolarSystem::BodyVisibility mVisibility;
+		std::vector<DirectX::XMFLOAT4X4> mWorldMatrices;
+		std::vector<float> mDistances;
+		std::vector<std::uint32_t> mDrawOrder;
+		std::vector<SoftwareBodyShader> mShaders;
+		std::uint32_t mLodCounts[SolarSystem::BodyLodSelector::LodCount + 1];
+	};
+}
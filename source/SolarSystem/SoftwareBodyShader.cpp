@@ -0,0 +1,69 @@
+#include "pch.h"
+#include "SoftwareBodyShader.h"
+#include "SoftwareTexture.h"
+#include "VertexDeclarations.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace Rendering
+{
+	const uint32_t SoftwareBodyShader::WorldPositionVarying;
+	const uint32_t SoftwareBodyShader::AttenuationVarying;
+	const uint32_t SoftwareBodyShader::TextureCoordinateVarying;
+	const uint32_t SoftwareBodyShader::NormalVarying;
+	const uint32_t SoftwareBodyShader::OutputVaryingCount;
+
+	SoftwareBodyShader::SoftwareBodyShader(const SoftwareLighting& lighting, CXMMATRIX worldMatrix, CXMMATRIX viewProjectionMatrix, const SoftwareTexture& colorTexture, bool isLit) :
+		mLighting(&lighting), mColorTexture(&colorTexture), mIsLit(isLit)
+	{
+		XMStoreFloat4x4(&mWorldMatrix, worldMatrix);
+		XMStoreFloat4x4(&mWorldViewProjectionMatrix, worldMatrix * viewProjectionMatrix);
+	}
+
+	uint32_t SoftwareBodyShader::VaryingCount() const
+	{
+		return OutputVaryingCount;
+	}
+
+	void SoftwareBodyShader::ShadeVertex(const void* vertex, RasterVertex& output) const
+	{
+		const VertexPositionTextureNormal& input = *static_cast<const VertexPositionTextureNormal*>(vertex);
+		const XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
+		const XMVECTOR objectPosition = XMLoadFloat4(&input.Position);
+
+		XMStoreFloat4(&output.Position, XMVector4Transform(objectPosition, XMLoadFloat4x4(&mWorldViewProjectionMatrix)));
+
+		const XMVECTOR worldPosition = XMVector4Transform(objectPosition, worldMatrix);
+		const XMVECTOR normal = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&input.Normal), worldMatrix));
+		const float lightDistance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&mLighting->LightPosition) - worldPosition));
+
+		XMStoreFloat3(reinterpret_cast<XMFLOAT3*>(&output.Varyings[WorldPositionVarying]), worldPosition);
+		output.Varyings[AttenuationVarying] = min(max(1.0f - (lightDistance / mLighting->LightRadius), 0.0f), 1.0f);
+		output.Varyings[TextureCoordinateVarying] = input.TextureCoordinates.x;
+		output.Varyings[TextureCoordinateVarying + 1] = input.TextureCoordinates.y;
+		XMStoreFloat3(reinterpret_cast<XMFLOAT3*>(&output.Varyings[NormalVarying]), normal);
+	}
+
+	XMVECTOR SoftwareBodyShader::ShadePixel(const float* varyings) const
+	{
+		const XMVECTOR color = mColorTexture->Sample(varyings[TextureCoordinateVarying], varyings[TextureCoordinateVarying + 1]);
+		if (!mIsLit)
+		{
+			return color;
+		}
+
+		// lit(n_dot_l, n_dot_h, SpecularPower).y is the clamped n_dot_l; the shader computes the specular term too, but
+		// never uses it, so it is left out here
+		const XMVECTOR worldPosition = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&varyings[WorldPositionVarying]));
+		const XMVECTOR lightDirection = XMVector3Normalize(XMLoadFloat3(&mLighting->LightPosition) - worldPosition);
+		const XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&varyings[NormalVarying])));
+		const float diffuseCoefficient = max(XMVectorGetX(XMVector3Dot(normal, lightDirection)), 0.0f);
+
+		const XMVECTOR ambient = XMVectorMultiply(color, XMLoadFloat3(&mLighting->AmbientColor));
+		const XMVECTOR diffuse = XMVectorScale(XMVectorMultiply(color, XMLoadFloat3(&mLighting->LightColor)), diffuseCoefficient * varyings[AttenuationVarying]);
+
+		return XMVectorSetW(XMVectorSaturate(XMVectorAdd(ambient, diffuse)), XMVectorGetW(color));
+	}
+}
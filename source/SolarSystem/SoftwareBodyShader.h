@@ -0,0 +1,51 @@
+#pragma once
+
+#include "SoftwareRasterizer.h"
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace Library
+{
+	class SoftwareTexture;
+}
+
+namespace Rendering
+{
+	struct SoftwareLighting
+	{
+		DirectX::XMFLOAT3 AmbientColor;
+		DirectX::XMFLOAT3 LightPosition;
+		DirectX::XMFLOAT3 LightColor;
+		float LightRadius;
+	};
+
+	// SolarSystemVS followed by SolarSystemPS, or by SunShaderPS for bodies that are not lit
+	class SoftwareBodyShader final : public Library::ISoftwareShader
+	{
+	public:
+		SoftwareBodyShader(const SoftwareLighting& lighting, DirectX::CXMMATRIX worldMatrix, DirectX::CXMMATRIX viewProjectionMatrix, const Library::SoftwareTexture& colorTexture, bool isLit);
+		SoftwareBodyShader(const SoftwareBodyShader&) = default;
+		SoftwareBodyShader& operator=(const SoftwareBodyShader&) = default;
+		SoftwareBodyShader(SoftwareBodyShader&&) = default;
+		SoftwareBodyShader& operator=(SoftwareBodyShader&&) = default;
+		~SoftwareBodyShader() = default;
+
+		virtual std::uint32_t VaryingCount() const override;
+		virtual void ShadeVertex(const void* vertex, Library::RasterVertex& output) const override;
+		virtual DirectX::XMVECTOR ShadePixel(const float* varyings) const override;
+
+	private:
+		// The members of VS_OUTPUT after SV_Position, in order
+		static const std::uint32_t WorldPositionVarying = 0;
+		static const std::uint32_t AttenuationVarying = 3;
+		static const std::uint32_t TextureCoordinateVarying = 4;
+		static const std::uint32_t NormalVarying = 6;
+		static const std::uint32_t OutputVaryingCount = 9;
+
+		const SoftwareLighting* mLighting;
+		DirectX::XMFLOAT4X4 mWorldMatrix;
+		DirectX::XMFLOAT4X4 mWorldViewProjectionMatrix;
+		const Library::SoftwareTexture* mColorTexture;
+		bool mIsLit;
+	};
+}
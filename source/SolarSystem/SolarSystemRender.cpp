@@ -11,21 +11,16 @@ namespace Rendering
 
 	const float SolarSystemRender::LightModulationRate = UCHAR_MAX;
 	const float SolarSystemRender::LightMovementRate = 10.0f;
+	const double SolarSystemRender::WarpStepYears = 10.0;
+	const UINT SolarSystemRender::TextureArrayWidth = 2048;
+	const UINT SolarSystemRender::TextureArrayHeight = 1024;
+	const uint32_t SolarSystemRender::NoSource = UINT32_MAX;
 
-	SolarSystemRender::SolarSystemRender(Game& game, const shared_ptr<Camera>& camera) :
+	SolarSystemRender::SolarSystemRender(Game& game, const shared_ptr<Camera>& camera, const shared_ptr<SolarSystemSimulation>& simulation) :
 		DrawableGameComponent(game, camera), mPointLight(game, XMFLOAT3(0.0f, 0.0f, 0.0f), 30000.0f),
-		mRenderStateHelper(game), mIndexCount(0), mTextPosition(0.0f, 40.0f), mAnimationEnabled(true), mSkyBox(game, camera, L"Content\\Textures\\stars.dds", 1000.0f), mCurrentPlanet(0)
+		mRenderStateHelper(game), mKeyboard(nullptr), mRenderQueue(nullptr), mTextPosition(0.0f, 40.0f), mSkyBox(game, camera, L"Content\\Textures\\stars.dds", 1000.0f), mSimulation(simulation), mLodCounts(), mCulledCount(0), mCurrentPlanet(0), mInstancingEnabled(true)
 	{
-	}
-
-	bool SolarSystemRender::AnimationEnabled() const
-	{
-		return mAnimationEnabled;
-	}
-
-	void SolarSystemRender::SetAnimationEnabled(bool enabled)
-	{
-		mAnimationEnabled = enabled;
+		assert(mSimulation != nullptr);
 	}
 
 	void SolarSystemRender::Initialize()
@@ -44,24 +39,76 @@ namespace Rendering
 		Utility::LoadBinaryFile(L"Content\\Shaders\\SolarSystemPS.cso", compiledPixelShader);
 		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mPixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
 
-		// Create an input layout
+		// Create an input layout; the spheres are VertexPositionTextureNormalCompact, decoded by the vertex shaders
 		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 		};
 
 		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(inputElementDescriptions, ARRAYSIZE(inputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInputLayout.ReleaseAndGetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
 
-		// Load the model
-		Library::Model model("Content\\Models\\Sphere.obj.bin");
+		// Load the instanced shaders, which draw every body in one call
+		compiledVertexShader.clear();
+		Utility::LoadBinaryFile(L"Content\\Shaders\\SolarSystemInstancedVS.cso", compiledVertexShader);
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, mInstancedVertexShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+
+		compiledPixelShader.clear();
+		Utility::LoadBinaryFile(L"Content\\Shaders\\SolarSystemInstancedPS.cso", compiledPixelShader);
+		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mInstancedPixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+
+		// Slot 0 is the sphere and slot 1 steps once per body
+		D3D11_INPUT_ELEMENT_DESC instancedInputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "TEXTUREINDEX", 0, DXGI_FORMAT_R32_UINT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "FLAGS", 0, DXGI_FORMAT_R32_UINT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+		};
 
-		// Create vertex and index buffers for the model
-		Library::Mesh* mesh = model.Meshes().at(0).get();
-		CreateVertexBuffer(*mesh, mVertexBuffer.ReleaseAndGetAddressOf());
-		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mIndexBuffer.ReleaseAndGetAddressOf());
-		mIndexCount = static_cast<uint32_t>(mesh->Indices().size());
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(instancedInputElementDescriptions, ARRAYSIZE(instancedInputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInstancedInputLayout.ReleaseAndGetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+
+		// Load the sphere at each level of detail, finest first, as written by the model pipeline's -spheres mode
+		for (uint32_t lod = 0; lod < BodyLodSelector::LodCount; ++lod)
+		{
+			Library::Model model("Content\\Models\\SphereLod" + to_string(lod) + ".bin");
+			Library::Mesh* mesh = model.Meshes().at(0).get();
+			mesh->CreateVertexBuffer(*mGame->Direct3DDevice(), VertexFormat::PositionTextureNormalCompact, mSphereLods[lod].VertexBuffer.ReleaseAndGetAddressOf());
+			mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mSphereLods[lod].IndexBuffer.ReleaseAndGetAddressOf());
+			mSphereLods[lod].IndexCount = mesh->Spans().Indices.Size();
+
+			// The vertex shaders decode every level with one offset and scale, so every level must share its bounds
+			XMFLOAT3 positionOffset;
+			XMFLOAT3 positionScale;
+			VertexFormatHelper::PositionQuantization(mesh->Spans().Vertices, positionOffset, positionScale);
+			if (lod == 0)
+			{
+				mVSCBufferPerFrameData.PositionOffset = positionOffset;
+				mVSCBufferPerFrameData.PositionScale = positionScale;
+			}
+			else if (memcmp(&positionOffset, &mVSCBufferPerFrameData.PositionOffset, sizeof(XMFLOAT3)) != 0 || memcmp(&positionScale, &mVSCBufferPerFrameData.PositionScale, sizeof(XMFLOAT3)) != 0)
+			{
+				throw GameException("Every sphere level of detail must have the same bounds.");
+			}
+
+			if (lod == 0)
+			{
+				const ArraySpan<XMFLOAT3>& vertices = mesh->Spans().Vertices;
+				mBodyVisibility.SetMeshRadius(BodyVisibility::BoundingRadius(vertices.Data(), vertices.Size(), sizeof(XMFLOAT3)));
+			}
+		}
+
+		// Bodies too small to see as spheres are drawn as a single point
+		SphereLod& impostor = mSphereLods[BodyLodSelector::ImpostorLod];
+		CreateImpostorBuffers(impostor.VertexBuffer.ReleaseAndGetAddressOf(), impostor.IndexBuffer.ReleaseAndGetAddressOf());
+		impostor.IndexCount = 1;
+		impostor.Topology = D3D11_PRIMITIVE_TOPOLOGY_POINTLIST;
 
 		// Create constant buffers
 		D3D11_BUFFER_DESC constantBufferDesc = { 0 };
@@ -72,6 +119,9 @@ namespace Rendering
 		constantBufferDesc.ByteWidth = sizeof(VSCBufferPerObject);
 		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVSCBufferPerObject.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
 
+		constantBufferDesc.ByteWidth = sizeof(VSCBufferPerView);
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVSCBufferPerView.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+
 		constantBufferDesc.ByteWidth = sizeof(PSCBufferPerFrame);
 		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mPSCBufferPerFrame.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
 
@@ -84,6 +134,10 @@ namespace Rendering
 
 		// Retrieve the keyboard service
 		mKeyboard = reinterpret_cast<KeyboardComponent*>(mGame->Services().GetService(KeyboardComponent::TypeIdClass()));
+
+		// Retrieve the render queue service
+		mRenderQueue = reinterpret_cast<RenderQueue*>(mGame->Services().GetService(RenderQueue::TypeIdClass()));
+		assert(mRenderQueue != nullptr);
 		
 		// Setup the point light
 		mVSCBufferPerFrameData.LightPosition = mPointLight.Position();
@@ -97,41 +151,50 @@ namespace Rendering
 
 		mSkyBox.Initialize();
 
-		// Earth properties declarations
-		const float earthRotation = XM_PI;
-		const float earthAxialTilt = 0.4101524f;
-		const float earthScale = 1.0f;
-		const float earthOrbitalDistance = 500.0f;
-		const float earthRevolution = earthRotation / 365;
-
-		// Populate the planet list
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.0408f, L"Content\\Textures\\2k_sun.jpg", earthAxialTilt * 0, earthOrbitalDistance * 0.01f, earthScale * 20.0f, earthRevolution, nullptr, false)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.017f, L"Content\\Textures\\mercurymap.jpg", earthAxialTilt * 0, earthOrbitalDistance * 0.387f, earthScale * 0.382f, earthRevolution * 4.149f, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.004f, L"Content\\Textures\\venusmap.jpg", earthAxialTilt * 0.959f, earthOrbitalDistance * 0.723f, earthScale * 0.949f, earthRevolution * 1.624f, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation, L"Content\\Textures\\EarthComposite.jpg", earthAxialTilt, earthOrbitalDistance, earthScale, earthRevolution, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRevolution * 12, L"Content\\Textures\\moonmap2k.jpg", earthAxialTilt * 0, earthOrbitalDistance * 0.05f, earthScale / 20, earthRevolution * 12, mCelestialBodiesList[3].get(), true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation, L"Content\\Textures\\marsmap1k.jpg", 0.4392f, earthOrbitalDistance * 1.524f, earthScale * 0.532f, earthRevolution * 0.531f, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 2.4f, L"Content\\Textures\\jupiter2_2k.jpg", 0.05352f, earthOrbitalDistance * 5.203f, earthScale * 11.19f, earthRevolution * 0.084f, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.01f, L"Content\\Textures\\callisto.jpg", earthAxialTilt * 0, earthOrbitalDistance * 0.4f, earthScale / 3, earthRotation * 2.4f / 16.7f, mCelestialBodiesList[6].get(), true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.2f, L"Content\\Textures\\europa.jpg", earthAxialTilt * 0, earthOrbitalDistance * 0.3f, earthScale / 4, earthRotation * 2.4f / 3.551f, mCelestialBodiesList[6].get(), true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.05f, L"Content\\Textures\\ganymede.jpg", earthAxialTilt * 0, earthOrbitalDistance * 0.35f, earthScale / 2.5f, earthRotation * 2.4f / 7.155f, mCelestialBodiesList[6].get(), true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.4f, L"Content\\Textures\\Io.png", earthAxialTilt * 0, earthOrbitalDistance * 0.25f, earthScale / 3, earthRotation * 2.4f / 1.769f, mCelestialBodiesList[6].get(), true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 2.3f, L"Content\\Textures\\saturnmap.jpg", 0.4712f, earthOrbitalDistance * 9.582f, earthScale * 9.26f, earthRevolution * 0.034f, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 1.39f, L"Content\\Textures\\uranusmap.jpg", 1.6927f, earthOrbitalDistance * 19.20f, earthScale * 4.01f, earthRevolution * 0.011f, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 1.489f, L"Content\\Textures\\neptunemap.jpg", 0.5166f, earthOrbitalDistance * 30.5f, earthScale * 3.88f, earthRevolution * 0.0061f, nullptr, true)));
-		mCelestialBodiesList.push_back(make_unique<CelestialBody>(CelestialBody(mGame, earthRotation * 0.156f, L"Content\\Textures\\plutomap2k.jpg", 2.129f, earthOrbitalDistance * 39.48f, earthScale * 0.18f, earthRevolution * 0.004f, nullptr, true)));
-	}
-
-	void SolarSystemRender::Update(const GameTime& gameTime)
-	{
-		if (mAnimationEnabled)
+		// One view per textured body; the simulation has already populated the store in scene order. Scenes loaded from
+		// a catalog reuse a few textures across many bodies, so each file is only loaded once.
+		const vector<BodyDescription>& bodies = mSimulation->Bodies();
+		map<wstring, uint32_t> textureIndices;
+		vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> textures;
+		mCelestialBodiesList.reserve(bodies.size());
+		mInstanceSources.clear();
+		mSourceIndices.assign(bodies.size(), NoSource);
+		for (uint32_t body = 0; body < bodies.size(); ++body)
 		{
-			for (uint32_t i = 0; i < mCelestialBodiesList.size(); ++i)
+			if (bodies[body].Texture.empty())
+			{
+				continue;
+			}
+
+			auto texture = textureIndices.insert(make_pair(bodies[body].Texture, static_cast<uint32_t>(textures.size())));
+			if (texture.second)
 			{
-				mCelestialBodiesList[i]->Update(gameTime);
+				textures.emplace_back();
+				ThrowIfFailed(CreateWICTextureFromFile(mGame->Direct3DDevice(), bodies[body].Texture.c_str(), nullptr, textures.back().ReleaseAndGetAddressOf()), "CreateWICTextureFromFile() failed.");
 			}
+
+			mSourceIndices[body] = static_cast<uint32_t>(mInstanceSources.size());
+			mCelestialBodiesList.push_back(make_unique<CelestialBody>(mSimulation->BodyStore(), body, textures[texture.first->second]));
+			mInstanceSources.push_back({ body, texture.first->second });
+		}
+
+		// The instanced path reads its textures from one array, with a slice per file, and its instances from a buffer
+		// rewritten each frame. A scene with more textures than an array can hold keeps to the per-body path.
+		if (!mInstanceSources.empty() && textures.size() <= D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION)
+		{
+			CreateTextureArray(textures, mColorTextureArray.ReleaseAndGetAddressOf());
+
+			D3D11_BUFFER_DESC instanceBufferDesc = { 0 };
+			instanceBufferDesc.ByteWidth = sizeof(BodyInstance) * static_cast<UINT>(mInstanceSources.size());
+			instanceBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+			instanceBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			instanceBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&instanceBufferDesc, nullptr, mInstanceBuffer.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
 		}
+	}
 
+	void SolarSystemRender::Update(const GameTime& gameTime)
+	{
 		if (mKeyboard != nullptr)
 		{
 			if (mKeyboard->WasKeyPressedThisFrame(Keys::Space))
@@ -146,6 +209,30 @@ namespace Rendering
 			{
 				JumpToNextPlanet();
 			}
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::N))
+			{
+				ToggleNBodySimulation();
+			}
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::I))
+			{
+				ToggleInstancing();
+			}
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::C))
+			{
+				ToggleCulling();
+			}
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::L))
+			{
+				ToggleLod();
+			}
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::PageUp))
+			{
+				mSimulation->WarpBy(WarpStepYears * mSimulation->YearLength());
+			}
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::PageDown))
+			{
+				mSimulation->WarpBy(-WarpStepYears * mSimulation->YearLength());
+			}
 		}
 
 		mSkyBox.Update(gameTime);
@@ -155,56 +242,70 @@ namespace Rendering
 	{
 		assert(mCamera != nullptr);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
+		// Both paths read the camera from the same buffer, so it is updated once a frame rather than once a body
+		mPSCBufferPerFrameData.CameraPosition = mCamera->Position();
+		mGame->Direct3DDeviceContext()->UpdateSubresource(mPSCBufferPerFrame.Get(), 0, nullptr, &mPSCBufferPerFrameData, 0, 0);
 
-		UINT stride = sizeof(VertexPositionTextureNormal);
-		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+		PrepareVisibleBodies(gameTime);
+		ReleaseStaleSpriteBatches();
 
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
+		if (mInstancingEnabled && mInstanceBuffer != nullptr)
+		{
+			SubmitBodiesInstanced(gameTime);
+		}
+		else
+		{
+			SubmitBodies(gameTime);
+		}
+
+		// The sky fills in around the bodies, and the help text goes over everything
+		mRenderQueue->Submit(RenderLayer::Background, [this, gameTime](ID3D11DeviceContext1* deviceContext) { mSkyBox.Record(gameTime, deviceContext); });
+		mRenderQueue->Submit(RenderLayer::Overlay, [this](ID3D11DeviceContext1* deviceContext) { DrawHelpText(deviceContext); });
+	}
 
-		for (uint32_t i = 0; i < mCelestialBodiesList.size(); ++i)
+	void SolarSystemRender::ReleaseStaleSpriteBatches()
+	{
+		// Toggling recording or losing the device replaces the deferred contexts. A batch holds a reference to its context,
+		// so its key cannot be reused by a new one, but it has to be let go of for the old context to be freed.
+		const DeferredContextRecorder* recorder = mGame->DeferredRecorder();
+		for (auto it = mDeferredSpriteBatches.begin(); it != mDeferredSpriteBatches.end();)
 		{
-			if (mCelestialBodiesList[i]->IsLit())
-			{
-				direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
-			}
-			else
+			bool current = false;
+			const uint32_t contextCount = (recorder != nullptr ? recorder->ContextCount() : 0);
+			for (uint32_t context = 0; context < contextCount && !current; ++context)
 			{
-				direct3DDeviceContext->PSSetShader(mSunShader.Get(), nullptr, 0);
+				current = (recorder->DeferredContext(context) == it->first);
 			}
 
-			XMMATRIX worldMatrix = mCelestialBodiesList[i]->WorldMatrix();
-			XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
-			wvp = XMMatrixTranspose(wvp);
-			XMStoreFloat4x4(&mVSCBufferPerObjectData.WorldViewProjection, wvp);
-			XMStoreFloat4x4(&mVSCBufferPerObjectData.World, XMMatrixTranspose(worldMatrix));
-			direct3DDeviceContext->UpdateSubresource(mVSCBufferPerObject.Get(), 0, nullptr, &mVSCBufferPerObjectData, 0, 0);
-
-			ID3D11Buffer* VSConstantBuffers[] = { mVSCBufferPerFrame.Get(), mVSCBufferPerObject.Get() };
-			direct3DDeviceContext->VSSetConstantBuffers(0, ARRAYSIZE(VSConstantBuffers), VSConstantBuffers);
-
-			mPSCBufferPerFrameData.CameraPosition = mCamera->Position();
-			direct3DDeviceContext->UpdateSubresource(mPSCBufferPerFrame.Get(), 0, nullptr, &mPSCBufferPerFrameData, 0, 0);
-
-			ID3D11Buffer* PSConstantBuffers[] = { mPSCBufferPerFrame.Get(), mPSCBufferPerObject.Get() };
-			direct3DDeviceContext->PSSetConstantBuffers(0, ARRAYSIZE(PSConstantBuffers), PSConstantBuffers);
+			it = (current ? next(it) : mDeferredSpriteBatches.erase(it));
+		}
+	}
 
-			ID3D11ShaderResourceView* PSShaderResources[] = { mCelestialBodiesList[i]->ColorTexture().Get() };
-			direct3DDeviceContext->PSSetShaderResources(0, ARRAYSIZE(PSShaderResources), PSShaderResources);
-			direct3DDeviceContext->PSSetSamplers(0, 1, SamplerStates::TrilinearWrap.GetAddressOf());
+	void SolarSystemRender::DrawHelpText(ID3D11DeviceContext1* deviceContext)
+	{
+		// The queue is still running when this is drawn, so its statistics are the previous frame's
+		const RenderQueueStats& renderQueueStats = mRenderQueue->Stats();
+
+		// A sprite batch draws on the context it was made for, so each deferred context the text lands on gets its own. A
+		// command list starts from default state and leaves the immediate context's alone, so only there is it saved.
+		const bool immediate = (deviceContext == mGame->Direct3DDeviceContext());
+		SpriteBatch* spriteBatch = mSpriteBatch.get();
+		if (!immediate)
+		{
+			unique_ptr<SpriteBatch>& deferredSpriteBatch = mDeferredSpriteBatches[deviceContext];
+			if (deferredSpriteBatch == nullptr)
+			{
+				deferredSpriteBatch = make_unique<SpriteBatch>(deviceContext);
+			}
 
-			direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
+			spriteBatch = deferredSpriteBatch.get();
+		}
+		else
+		{
+			mRenderStateHelper.SaveAll();
 		}
 
-		mSkyBox.Draw(gameTime);
-		
-		// Draw help text
-		mRenderStateHelper.SaveAll();
-		mSpriteBatch->Begin();
+		spriteBatch->Begin();
 
 		wostringstream helpLabel;
 		helpLabel << L"Move(Mouse + WASD)" << "\n";
@@ -212,41 +313,256 @@ namespace Rendering
 		helpLabel << L"Jump to next celestial body (Up)" << "\n";
 		helpLabel << L"Return to Sun (R)" << "\n";
 		helpLabel << L"Toggle Animation (Space)" << "\n";
+		helpLabel << L"Toggle N-Body Gravity (N): " << (mSimulation->NBodyEnabled() ? L"On" : L"Off") << "\n";
+		helpLabel << L"Toggle Instancing (I): " << (mInstancingEnabled ? L"On" : L"Off") << "\n";
+		helpLabel << L"Toggle Frustum Culling (C): " << (mBodyVisibility.CullingEnabled() ? L"On" : L"Off") << L", " << mCulledCount << L" Culled" << "\n";
+		helpLabel << L"Toggle Level of Detail (L): " << (mBodyVisibility.LodEnabled() ? L"On" : L"Off") << L", " << mLodCounts[BodyLodSelector::ImpostorLod] << L" Impostors" << "\n";
+		helpLabel << L"Warp " << WarpStepYears << L" Years (Page Up/Down): Year " << static_cast<int>(floor(mSimulation->SimulationTime() / mSimulation->YearLength())) << "\n";
+		helpLabel << L"Record/Replay Session (F5/F6)" << "\n";
+		helpLabel << L"Toggle Deferred Recording (F7): " << (mGame->DeferredRecordingEnabled() ? L"On" : L"Off") << "\n";
+		helpLabel << L"Render Queue: " << renderQueueStats.Packets << L" Draws, " << renderQueueStats.StateChangesEliminated() << L"/" << renderQueueStats.StateChangesRequested << L" State Changes Eliminated" << "\n";
 	
-		mSpriteFont->DrawString(mSpriteBatch.get(), helpLabel.str().c_str(), mTextPosition);
-		mSpriteBatch->End();
-		mRenderStateHelper.RestoreAll();
+		mSpriteFont->DrawString(spriteBatch, helpLabel.str().c_str(), mTextPosition);
+		spriteBatch->End();
+
+		if (immediate)
+		{
+			mRenderStateHelper.RestoreAll();
+		}
 	}
 
-	void SolarSystemRender::CreateVertexBuffer(const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	void SolarSystemRender::PrepareVisibleBodies(const GameTime& gameTime)
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		const vector<XMFLOAT3>& sourceNormals = mesh.Normals();
-		const auto& sourceUVs = mesh.TextureCoordinates().at(0);
+		const CelestialBodyStore& store = mSimulation->BodyStore();
+		mBodyVisibility.Prepare(store, mCamera->ViewProjectionMatrix(), mCamera->ProjectionMatrix(), mCamera->PositionVector(), mGame->Viewport().Height, gameTime.Interpolation());
+
+		// Bodies without a texture are never drawn, so they are dropped here
+		const uint32_t* visibleSlots = mBodyVisibility.VisibleSlots();
+		const uint8_t* visibleLods = mBodyVisibility.VisibleLods();
+		mVisibleBodies.clear();
+		mVisibleBodyLods.clear();
+		fill(begin(mLodCounts), end(mLodCounts), 0);
+		for (uint32_t i = 0; i < mBodyVisibility.VisibleCount(); ++i)
+		{
+			const uint32_t source = mSourceIndices[store.Body(visibleSlots[i])];
+			if (source != NoSource)
+			{
+				mVisibleBodies.push_back(source);
+				mVisibleBodyLods.push_back(visibleLods[i]);
+				++mLodCounts[visibleLods[i]];
+			}
+		}
 
-		vector<VertexPositionTextureNormal> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (UINT i = 0; i < sourceVertices.size(); i++)
+		mCulledCount = static_cast<uint32_t>(mCelestialBodiesList.size() - mVisibleBodies.size());
+	}
+
+	void SolarSystemRender::SubmitBodies(const GameTime& gameTime)
+	{
+		// Every body shares the constant buffers; only the mesh, pixel shader, texture and transforms differ, and the queue
+		// binds just those
+		DrawPacket packet;
+		packet.InputLayout = mInputLayout.Get();
+		packet.VertexStrides[0] = sizeof(VertexPositionTextureNormalCompact);
+		packet.VertexShader = mVertexShader.Get();
+		packet.VSConstantBuffers[0] = mVSCBufferPerFrame.Get();
+		packet.VSConstantBuffers[1] = mVSCBufferPerObject.Get();
+		packet.PSConstantBuffers[0] = mPSCBufferPerFrame.Get();
+		packet.PSConstantBuffers[1] = mPSCBufferPerObject.Get();
+		packet.PSSampler = SamplerStates::TrilinearWrap.Get();
+		packet.ObjectConstantBuffer = mVSCBufferPerObject.Get();
+
+		const XMMATRIX viewProjectionMatrix = mCamera->ViewProjectionMatrix();
+		const XMVECTOR cameraPosition = mCamera->PositionVector();
+		for (uint32_t i = 0; i < mVisibleBodies.size(); ++i)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = sourceUVs->at(i);
-			const XMFLOAT3& normal = sourceNormals.at(i);
+			const unique_ptr<CelestialBody>& celestialBody = mCelestialBodiesList[mVisibleBodies[i]];
+			XMMATRIX worldMatrix = celestialBody->WorldMatrix(gameTime.Interpolation());
+			XMStoreFloat4x4(&mVSCBufferPerObjectData.WorldViewProjection, XMMatrixTranspose(worldMatrix * viewProjectionMatrix));
+			XMStoreFloat4x4(&mVSCBufferPerObjectData.World, XMMatrixTranspose(worldMatrix));
+
+			// An impostor has no surface to light, so it shows its texture as it is
+			const uint32_t lod = mVisibleBodyLods[i];
+			const SphereLod& sphereLod = mSphereLods[lod];
+			packet.Topology = sphereLod.Topology;
+			packet.VertexBuffers[0] = sphereLod.VertexBuffer.Get();
+			packet.IndexBuffer = sphereLod.IndexBuffer.Get();
+			packet.IndexCount = sphereLod.IndexCount;
+			packet.PixelShader = (celestialBody->IsLit() && lod != BodyLodSelector::ImpostorLod ? mPixelShader.Get() : mSunShader.Get());
+			packet.PSShaderResource = celestialBody->ColorTexture().Get();
+			packet.Depth = XMVectorGetX(XMVector3Length(worldMatrix.r[3] - cameraPosition));
+			mRenderQueue->Submit(RenderLayer::Opaque, packet, &mVSCBufferPerObjectData, sizeof(mVSCBufferPerObjectData));
+		}
+	}
+
+	void SolarSystemRender::SubmitBodiesInstanced(const GameTime& gameTime)
+	{
+		const uint32_t instanceCount = static_cast<uint32_t>(mVisibleBodies.size());
+		if (instanceCount == 0)
+		{
+			return;
+		}
+
+		// Instances are grouped by level of detail, so each level is one draw over its own range of the buffer
+		uint32_t lodOffsets[BodyLodSelector::LodCount + 1];
+		uint32_t offset = 0;
+		for (uint32_t lod = 0; lod <= BodyLodSelector::LodCount; ++lod)
+		{
+			lodOffsets[lod] = offset;
+			offset += mLodCounts[lod];
+		}
+
+		mVisibleSources.resize(instanceCount);
+		for (uint32_t i = 0; i < instanceCount; ++i)
+		{
+			mVisibleSources[lodOffsets[mVisibleBodyLods[i]]++] = mInstanceSources[mVisibleBodies[i]];
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+
+		// Instances are built straight into the mapped buffer. Impostors have no surface to light, so their flags are
+		// overwritten rather than read back from the mapped memory.
+		D3D11_MAPPED_SUBRESOURCE mappedInstances;
+		ThrowIfFailed(direct3DDeviceContext->Map(mInstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedInstances), "ID3D11DeviceContext::Map() failed.");
+		BodyInstance* instances = static_cast<BodyInstance*>(mappedInstances.pData);
+		BodyInstanceBuilder::Build(mSimulation->BodyStore(), mVisibleSources.data(), instanceCount, gameTime.Interpolation(), instances);
+		for (uint32_t i = instanceCount - mLodCounts[BodyLodSelector::ImpostorLod]; i < instanceCount; ++i)
+		{
+			instances[i].Flags = 0;
+		}
+		direct3DDeviceContext->Unmap(mInstanceBuffer.Get(), 0);
+
+		XMStoreFloat4x4(&mVSCBufferPerViewData.ViewProjection, XMMatrixTranspose(mCamera->ViewProjectionMatrix()));
+		direct3DDeviceContext->UpdateSubresource(mVSCBufferPerView.Get(), 0, nullptr, &mVSCBufferPerViewData, 0, 0);
+
+		DrawPacket packet;
+		packet.InputLayout = mInstancedInputLayout.Get();
+		packet.VertexStrides[0] = sizeof(VertexPositionTextureNormalCompact);
+		packet.VertexBuffers[1] = mInstanceBuffer.Get();
+		packet.VertexStrides[1] = sizeof(BodyInstance);
+		packet.VertexShader = mInstancedVertexShader.Get();
+		packet.PixelShader = mInstancedPixelShader.Get();
+		packet.VSConstantBuffers[0] = mVSCBufferPerFrame.Get();
+		packet.VSConstantBuffers[1] = mVSCBufferPerView.Get();
+		packet.PSConstantBuffers[0] = mPSCBufferPerFrame.Get();
+		packet.PSConstantBuffers[1] = mPSCBufferPerObject.Get();
+		packet.PSShaderResource = mColorTextureArray.Get();
+		packet.PSSampler = SamplerStates::TrilinearWrap.Get();
+
+		uint32_t startInstance = 0;
+		for (uint32_t lod = 0; lod <= BodyLodSelector::LodCount; ++lod)
+		{
+			if (mLodCounts[lod] > 0)
+			{
+				const SphereLod& sphereLod = mSphereLods[lod];
+				packet.Topology = sphereLod.Topology;
+				packet.VertexBuffers[0] = sphereLod.VertexBuffer.Get();
+				packet.IndexBuffer = sphereLod.IndexBuffer.Get();
+				packet.IndexCount = sphereLod.IndexCount;
+				packet.InstanceCount = mLodCounts[lod];
+				packet.StartInstance = startInstance;
+				mRenderQueue->Submit(RenderLayer::Opaque, packet);
+			}
 
-			vertices.push_back(VertexPositionTextureNormal(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal));
+			startInstance += mLodCounts[lod];
 		}
+	}
+
+	void SolarSystemRender::CreateImpostorBuffers(ID3D11Buffer** vertexBuffer, ID3D11Buffer** indexBuffer) const
+	{
+		// One point at the centre of the body, sampling the middle of its texture, quantized like the spheres
+		const VertexPositionTextureNormalCompact vertex = VertexFormatHelper::Compress(Vector3Helper::Zero, XMFLOAT2(0.5f, 0.5f), Vector3Helper::Up, mVSCBufferPerFrameData.PositionOffset, mVSCBufferPerFrameData.PositionScale);
+		const uint32_t index = 0;
+
 		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.ByteWidth = sizeof(VertexPositionTextureNormal) * static_cast<UINT>(vertices.size());
+		vertexBufferDesc.ByteWidth = sizeof(VertexPositionTextureNormalCompact);
 		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
 		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 
 		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = &vertices[0];
+		vertexSubResourceData.pSysMem = &vertex;
 		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
+
+		D3D11_BUFFER_DESC indexBufferDesc = { 0 };
+		indexBufferDesc.ByteWidth = sizeof(uint32_t);
+		indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA indexSubResourceData = { 0 };
+		indexSubResourceData.pSysMem = &index;
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&indexBufferDesc, &indexSubResourceData, indexBuffer), "ID3D11Device::CreateBuffer() failed.");
+	}
+
+	void SolarSystemRender::CreateTextureArray(const vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>>& textures, ID3D11ShaderResourceView** textureArray) const
+	{
+		// Every slice of an array has the same size, so each texture is drawn into its slice, stretched to fit, and the
+		// mip chain is generated afterwards
+		D3D11_TEXTURE2D_DESC textureDesc = { 0 };
+		textureDesc.Width = TextureArrayWidth;
+		textureDesc.Height = TextureArrayHeight;
+		textureDesc.MipLevels = 0;
+		textureDesc.ArraySize = static_cast<UINT>(textures.size());
+		textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.Usage = D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+		textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, texture.ReleaseAndGetAddressOf()), "ID3D11Device::CreateTexture2D() failed.");
+
+		vector<char> compiledVertexShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\TextureBlitVS.cso", compiledVertexShader);
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, vertexShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+
+		vector<char> compiledPixelShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\TextureBlitPS.cso", compiledPixelShader);
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
+		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, pixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+
+		// The game's render target is put back once the slices are drawn
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		Microsoft::WRL::ComPtr<ID3D11RenderTargetView> previousRenderTarget;
+		Microsoft::WRL::ComPtr<ID3D11DepthStencilView> previousDepthStencil;
+		direct3DDeviceContext->OMGetRenderTargets(1, previousRenderTarget.GetAddressOf(), previousDepthStencil.GetAddressOf());
+
+		const D3D11_VIEWPORT viewport = { 0.0f, 0.0f, static_cast<float>(TextureArrayWidth), static_cast<float>(TextureArrayHeight), 0.0f, 1.0f };
+		direct3DDeviceContext->RSSetViewports(1, &viewport);
+		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		direct3DDeviceContext->IASetInputLayout(nullptr);
+		direct3DDeviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
+		direct3DDeviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+		direct3DDeviceContext->PSSetSamplers(0, 1, SamplerStates::TrilinearClamp.GetAddressOf());
+
+		for (UINT slice = 0; slice < textures.size(); ++slice)
+		{
+			D3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc = {};
+			renderTargetViewDesc.Format = textureDesc.Format;
+			renderTargetViewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+			renderTargetViewDesc.Texture2DArray.MipSlice = 0;
+			renderTargetViewDesc.Texture2DArray.FirstArraySlice = slice;
+			renderTargetViewDesc.Texture2DArray.ArraySize = 1;
+
+			Microsoft::WRL::ComPtr<ID3D11RenderTargetView> renderTargetView;
+			ThrowIfFailed(mGame->Direct3DDevice()->CreateRenderTargetView(texture.Get(), &renderTargetViewDesc, renderTargetView.ReleaseAndGetAddressOf()), "ID3D11Device::CreateRenderTargetView() failed.");
+
+			direct3DDeviceContext->OMSetRenderTargets(1, renderTargetView.GetAddressOf(), nullptr);
+			direct3DDeviceContext->PSSetShaderResources(0, 1, textures[slice].GetAddressOf());
+			direct3DDeviceContext->Draw(3, 0);
+		}
+
+		ID3D11ShaderResourceView* nullShaderResource = nullptr;
+		direct3DDeviceContext->PSSetShaderResources(0, 1, &nullShaderResource);
+		direct3DDeviceContext->OMSetRenderTargets(1, previousRenderTarget.GetAddressOf(), previousDepthStencil.Get());
+		direct3DDeviceContext->RSSetViewports(1, &mGame->Viewport());
+
+		ThrowIfFailed(mGame->Direct3DDevice()->CreateShaderResourceView(texture.Get(), nullptr, textureArray), "ID3D11Device::CreateShaderResourceView() failed.");
+		direct3DDeviceContext->GenerateMips(*textureArray);
 	}
 
 	void SolarSystemRender::ToggleAnimation()
 	{
-		mAnimationEnabled = !mAnimationEnabled;
+		mSimulation->SetAnimationEnabled(!mSimulation->AnimationEnabled());
 	}
 
 	void SolarSystemRender::ReturnToStart()
@@ -264,4 +580,24 @@ namespace Rendering
 		MatrixHelper::GetTranslation(mCelestialBodiesList[mCurrentPlanet]->WorldMatrix(), translateTo);
 		mCamera->SetPosition(translateTo.x, translateTo.y, translateTo.z);
 	}
+
+	void SolarSystemRender::ToggleNBodySimulation()
+	{
+		mSimulation->SetNBodyEnabled(!mSimulation->NBodyEnabled());
+	}
+
+	void SolarSystemRender::ToggleInstancing()
+	{
+		mInstancingEnabled = !mInstancingEnabled;
+	}
+
+	void SolarSystemRender::ToggleCulling()
+	{
+		mBodyVisibility.SetCullingEnabled(!mBodyVisibility.CullingEnabled());
+	}
+
+	void SolarSystemRender::ToggleLod()
+	{
+		mBodyVisibility.SetLodEnabled(!mBodyVisibility.LodEnabled());
+	}
 }
\ No newline at end of file
@@ -4,6 +4,11 @@
 #include "RenderStateHelper.h"
 #include "PointLight.h"
 #include "CelestialBody.h"
+#include "BodyInstanceBuilder.h"
+#include "BodyLodSelector.h"
+#include "BodyVisibility.h"
+#include "SolarSystemScene.h"
+#include "SolarSystemSimulation.h"
 #include <DirectXMath.h>
 #include <DirectXColors.h>
 
@@ -12,6 +17,7 @@ namespace Library
 	class Mesh;
 	class ProxyModel;
 	class KeyboardComponent;	
+	class RenderQueue;
 }
 
 namespace DirectX
@@ -27,10 +33,7 @@ namespace Rendering
 		RTTI_DECLARATIONS(SolarSystemRender, Library::DrawableGameComponent)
 
 	public:
-		SolarSystemRender(Library::Game& game, const std::shared_ptr<Library::Camera>& camera);
-
-		bool AnimationEnabled() const;
-		void SetAnimationEnabled(bool enabled);
+		SolarSystemRender(Library::Game& game, const std::shared_ptr<Library::Camera>& camera, const std::shared_ptr<SolarSystem::SolarSystemSimulation>& simulation);
 
 		virtual void Initialize() override;
 		virtual void Update(const Library::GameTime& gameTime) override;
@@ -41,11 +44,15 @@ namespace Rendering
 		{
 			DirectX::XMFLOAT3 LightPosition;
 			float LightRadius;
+			DirectX::XMFLOAT3 PositionOffset;
+			float Padding;
+			DirectX::XMFLOAT3 PositionScale;
+			float Padding2;
 
 			VSCBufferPerFrame() :
-				LightPosition(Library::Vector3Helper::Zero), LightRadius(50.0f) { }
+				LightPosition(Library::Vector3Helper::Zero), LightRadius(50.0f), PositionOffset(Library::Vector3Helper::Zero), PositionScale(Library::Vector3Helper::One) { }
 			VSCBufferPerFrame(const DirectX::XMFLOAT3 lightPosition, float lightRadius) :
-				LightPosition(lightPosition), LightRadius(lightRadius) { }
+				LightPosition(lightPosition), LightRadius(lightRadius), PositionOffset(Library::Vector3Helper::Zero), PositionScale(Library::Vector3Helper::One) { }
 		};
 
 		struct VSCBufferPerObject
@@ -58,6 +65,13 @@ namespace Rendering
 				WorldViewProjection(wvp), World(world) { }
 		};
 
+		struct VSCBufferPerView
+		{
+			DirectX::XMFLOAT4X4 ViewProjection;
+
+			VSCBufferPerView() = default;
+		};
+
 		struct PSCBufferPerFrame
 		{
 			DirectX::XMFLOAT3 CameraPosition;
@@ -94,17 +108,43 @@ namespace Rendering
 				SpecularColor(specularColor), SpecularPower(specularPower) { }
 		};
 
-		void CreateVertexBuffer(const Library::Mesh& mesh, ID3D11Buffer** vertexBuffer) const;
+		struct SphereLod
+		{
+			Microsoft::WRL::ComPtr<ID3D11Buffer> VertexBuffer;
+			Microsoft::WRL::ComPtr<ID3D11Buffer> IndexBuffer;
+			std::uint32_t IndexCount;
+			D3D11_PRIMITIVE_TOPOLOGY Topology;
+
+			SphereLod() :
+				IndexCount(0), Topology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST) { }
+		};
+
+		void CreateImpostorBuffers(ID3D11Buffer** vertexBuffer, ID3D11Buffer** indexBuffer) const;
+		void CreateTextureArray(const std::vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>>& textures, ID3D11ShaderResourceView** textureArray) const;
+		void PrepareVisibleBodies(const Library::GameTime& gameTime);
+		void SubmitBodies(const Library::GameTime& gameTime);
+		void SubmitBodiesInstanced(const Library::GameTime& gameTime);
+		void DrawHelpText(ID3D11DeviceContext1* deviceContext);
+		void ReleaseStaleSpriteBatches();
+		void ToggleInstancing();
+		void ToggleCulling();
+		void ToggleLod();
 		void ToggleAnimation();
 		void ReturnToStart();
 		void JumpToNextPlanet();
+		void ToggleNBodySimulation();
 
 		static const float LightModulationRate;
 		static const float LightMovementRate;
+		static const double WarpStepYears;
+		static const UINT TextureArrayWidth;
+		static const UINT TextureArrayHeight;
+		static const std::uint32_t NoSource;
 
 		PSCBufferPerFrame mPSCBufferPerFrameData;
 		VSCBufferPerFrame mVSCBufferPerFrameData;
 		VSCBufferPerObject mVSCBufferPerObjectData;
+		VSCBufferPerView mVSCBufferPerViewData;
 		PSCBufferPerObject mPSCBufferPerObjectData;
 		Library::PointLight mPointLight;
 		Library::RenderStateHelper mRenderStateHelper;
@@ -113,19 +153,34 @@ namespace Rendering
 		Microsoft::WRL::ComPtr<ID3D11PixelShader> mPixelShader;
 		Microsoft::WRL::ComPtr<ID3D11PixelShader> mSunShader;
 		Microsoft::WRL::ComPtr<ID3D11InputLayout> mInputLayout;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mIndexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> mInstancedVertexShader;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> mInstancedPixelShader;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> mInstancedInputLayout;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mInstanceBuffer;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mColorTextureArray;
+		SphereLod mSphereLods[SolarSystem::BodyLodSelector::LodCount + 1];
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mVSCBufferPerFrame;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mVSCBufferPerObject;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mVSCBufferPerView;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mPSCBufferPerFrame;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mPSCBufferPerObject;
 		Library::KeyboardComponent* mKeyboard;
-		std::uint32_t mIndexCount;
+		Library::RenderQueue* mRenderQueue;
 		std::unique_ptr<DirectX::SpriteBatch> mSpriteBatch;
+		std::unordered_map<ID3D11DeviceContext1*, std::unique_ptr<DirectX::SpriteBatch>> mDeferredSpriteBatches;
 		std::unique_ptr<DirectX::SpriteFont> mSpriteFont;
 		DirectX::XMFLOAT2 mTextPosition;
+		std::shared_ptr<SolarSystem::SolarSystemSimulation> mSimulation;
 		std::vector<std::unique_ptr<SolarSystem::CelestialBody>> mCelestialBodiesList;
+		std::vector<SolarSystem::BodyInstanceSource> mInstanceSources;
+		std::vector<SolarSystem::BodyInstanceSource> mVisibleSources;
+		std::vector<std::uint32_t> mSourceIndices;
+		SolarSystem::BodyVisibility mBodyVisibility;
+		std::vector<std::uint32_t> mVisibleBodies;
+		std::vector<std::uint8_t> mVisibleBodyLods;
+		std::uint32_t mLodCounts[SolarSystem::BodyLodSelector::LodCount + 1];
+		std::uint32_t mCulledCount;
 		std::uint32_t mCurrentPlanet;
-		bool mAnimationEnabled;
+		bool mInstancingEnabled;
 	};
 }
@@ -0,0 +1,470 @@
+#include "pch.h"
+#include "SolarSystemScene.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	const uint32_t SolarSystemScene::EarthBody = 3;
+	const uint32_t SolarSystemScene::FormatVersion = 1;
+	const wstring SolarSystemScene::DefaultSceneFilename = L"Content\\Scenes\\SolarSystem.scene";
+
+	namespace
+	{
+		// Earth properties declarations
+		const float EarthRotation = XM_PI;
+		const float EarthAxialTilt = 0.4101524f;
+		const float EarthScale = 1.0f;
+		const float EarthOrbitalDistance = 500.0f;
+		const float EarthRevolution = EarthRotation / 365;
+
+		const uint32_t AsteroidBeltCount = 20000;
+		const uint32_t SaturnRingCount = 40000;
+
+		const OrbitalElements NoOrbit = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+		BodyDescription Circular(const char* name, const wchar_t* texture, float rotationRate, float axialTilt, float orbitalDistance, float scale, float revolutionRate, uint32_t parent, bool isLit, float mass)
+		{
+			return { name, texture, rotationRate, axialTilt, orbitalDistance, scale, revolutionRate, MotionModel::Circular, NoOrbit, parent, isLit, mass };
+		}
+
+		BodyDescription Keplerian(const char* name, const wchar_t* texture, float rotationRate, float axialTilt, const OrbitalElements& orbit, float scale, uint32_t parent, bool isLit, float mass)
+		{
+			return { name, texture, rotationRate, axialTilt, 0.0f, scale, 0.0f, MotionModel::Keplerian, orbit, parent, isLit, mass };
+		}
+
+		vector<BodyDescription> CreateBodies()
+		{
+			// Eccentric, inclined orbits use orbital elements (J2000) instead of the circular model
+			const OrbitalElements mercuryOrbit = { EarthOrbitalDistance * 0.387f, 0.2056f, XMConvertToRadians(7.005f), XMConvertToRadians(48.331f), XMConvertToRadians(29.124f), XMConvertToRadians(174.796f), EarthRevolution * 4.149f };
+			const OrbitalElements plutoOrbit = { EarthOrbitalDistance * 39.48f, 0.2488f, XMConvertToRadians(17.16f), XMConvertToRadians(110.299f), XMConvertToRadians(113.834f), XMConvertToRadians(14.53f), EarthRevolution * 0.004f };
+
+			const uint32_t none = CelestialBodyStore::NoParent;
+
+			// Parents refer to earlier entries; masses are in Earth masses and only the N-body mode uses them
+			const uint32_t earth = SolarSystemScene::EarthBody;
+			const uint32_t jupiter = 6;
+			return
+			{
+				Circular("Sun", L"Content\\Textures\\2k_sun.jpg", EarthRotation * 0.0408f, EarthAxialTilt * 0, EarthOrbitalDistance * 0.01f, EarthScale * 20.0f, EarthRevolution, none, false, 332946.0f),
+				Keplerian("Mercury", L"Content\\Textures\\mercurymap.jpg", EarthRotation * 0.017f, EarthAxialTilt * 0, mercuryOrbit, EarthScale * 0.382f, none, true, 0.0553f),
+				Circular("Venus", L"Content\\Textures\\venusmap.jpg", EarthRotation * 0.004f, EarthAxialTilt * 0.959f, EarthOrbitalDistance * 0.723f, EarthScale * 0.949f, EarthRevolution * 1.624f, none, true, 0.815f),
+				Circular("Earth", L"Content\\Textures\\EarthComposite.jpg", EarthRotation, EarthAxialTilt, EarthOrbitalDistance, EarthScale, EarthRevolution, none, true, 1.0f),
+				Circular("Moon", L"Content\\Textures\\moonmap2k.jpg", EarthRevolution * 12, EarthAxialTilt * 0, EarthOrbitalDistance * 0.05f, EarthScale / 20, EarthRevolution * 12, earth, true, 0.0123f),
+				Circular("Mars", L"Content\\Textures\\marsmap1k.jpg", EarthRotation, 0.4392f, EarthOrbitalDistance * 1.524f, EarthScale * 0.532f, EarthRevolution * 0.531f, none, true, 0.107f),
+				Circular("Jupiter", L"Content\\Textures\\jupiter2_2k.jpg", EarthRotation * 2.4f, 0.05352f, EarthOrbitalDistance * 5.203f, EarthScale * 11.19f, EarthRevolution * 0.084f, none, true, 317.8f),
+				Circular("Callisto", L"Content\\Textures\\callisto.jpg", EarthRotation * 0.01f, EarthAxialTilt * 0, EarthOrbitalDistance * 0.4f, EarthScale / 3, EarthRotation * 2.4f / 16.7f, jupiter, true, 0.018f),
+				Circular("Europa", L"Content\\Textures\\europa.jpg", EarthRotation * 0.2f, EarthAxialTilt * 0, EarthOrbitalDistance * 0.3f, EarthScale / 4, EarthRotation * 2.4f / 3.551f, jupiter, true, 0.008f),
+				Circular("Ganymede", L"Content\\Textures\\ganymede.jpg", EarthRotation * 0.05f, EarthAxialTilt * 0, EarthOrbitalDistance * 0.35f, EarthScale / 2.5f, EarthRotation * 2.4f / 7.155f, jupiter, true, 0.025f),
+				Circular("Io", L"Content\\Textures\\Io.png", EarthRotation * 0.4f, EarthAxialTilt * 0, EarthOrbitalDistance * 0.25f, EarthScale / 3, EarthRotation * 2.4f / 1.769f, jupiter, true, 0.015f),
+				Circular("Saturn", L"Content\\Textures\\saturnmap.jpg", EarthRotation * 2.3f, 0.4712f, EarthOrbitalDistance * 9.582f, EarthScale * 9.26f, EarthRevolution * 0.034f, none, true, 95.2f),
+				Circular("Uranus", L"Content\\Textures\\uranusmap.jpg", EarthRotation * 1.39f, 1.6927f, EarthOrbitalDistance * 19.20f, EarthScale * 4.01f, EarthRevolution * 0.011f, none, true, 14.5f),
+				Circular("Neptune", L"Content\\Textures\\neptunemap.jpg", EarthRotation * 1.489f, 0.5166f, EarthOrbitalDistance * 30.5f, EarthScale * 3.88f, EarthRevolution * 0.0061f, none, true, 17.1f),
+				Keplerian("Pluto", L"Content\\Textures\\plutomap2k.jpg", EarthRotation * 0.156f, 2.129f, plutoOrbit, EarthScale * 0.18f, none, true, 0.0022f)
+			};
+		}
+
+		// Reads the scene text in place: tokens are ranges of the mapped file and only names and textures are ever copied
+		class SceneParser final
+		{
+		public:
+			SceneParser(const char* begin, const char* end) :
+				mCursor(begin), mLineEnd(begin), mNextLine(begin), mEnd(end), mLineNumber(0)
+			{
+			}
+
+			// Moves to the next line with any content on it, skipping blank lines and # comments
+			bool NextLine()
+			{
+				while (mNextLine < mEnd)
+				{
+					mCursor = mNextLine;
+					const char* lineEnd = static_cast<const char*>(memchr(mCursor, '\n', mEnd - mCursor));
+					mLineEnd = (lineEnd != nullptr ? lineEnd : mEnd);
+					mNextLine = (lineEnd != nullptr ? lineEnd + 1 : mEnd);
+					++mLineNumber;
+
+					SkipWhitespace();
+					if (mCursor < mLineEnd && *mCursor != '#')
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			bool AtEndOfLine()
+			{
+				SkipWhitespace();
+				return (mCursor == mLineEnd || *mCursor == '#');
+			}
+
+			void NextToken(const char*& begin, const char*& end)
+			{
+				if (AtEndOfLine())
+				{
+					Fail("missing field");
+				}
+
+				begin = mCursor;
+				while (mCursor < mLineEnd && !IsWhitespace(*mCursor))
+				{
+					++mCursor;
+				}
+
+				end = mCursor;
+			}
+
+			bool NextTokenIs(const char* text)
+			{
+				const char* begin;
+				const char* end;
+				NextToken(begin, end);
+
+				return TokenEquals(begin, end, text);
+			}
+
+			float NextFloat()
+			{
+				const char* begin;
+				const char* end;
+				NextToken(begin, end);
+
+				// Only plain decimal numbers are accepted, never the hex, inf or nan forms strtof would also take
+				const char* cursor = begin;
+				if (*cursor == '-' || *cursor == '+')
+				{
+					++cursor;
+				}
+
+				bool hasDigits = false;
+				bool inFraction = false;
+				for (; cursor < end; ++cursor)
+				{
+					if (*cursor == '.' && !inFraction)
+					{
+						inFraction = true;
+					}
+					else if (*cursor >= '0' && *cursor <= '9')
+					{
+						hasDigits = true;
+					}
+					else
+					{
+						break;
+					}
+				}
+
+				if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+				{
+					++cursor;
+					if (cursor < end && (*cursor == '-' || *cursor == '+'))
+					{
+						++cursor;
+					}
+
+					const char* exponentBegin = cursor;
+					while (cursor < end && *cursor >= '0' && *cursor <= '9')
+					{
+						++cursor;
+					}
+
+					if (cursor == exponentBegin)
+					{
+						Fail("malformed number");
+					}
+				}
+
+				if (!hasDigits || cursor != end)
+				{
+					Fail("malformed number");
+				}
+
+				// strtof rounds the decimal straight to the nearest float. Going through a double first rounds twice and can
+				// land one ulp off. The token is not terminated in the mapped file, so it is copied out first.
+				char buffer[64];
+				const size_t length = static_cast<size_t>(end - begin);
+				if (length < sizeof(buffer))
+				{
+					memcpy(buffer, begin, length);
+					buffer[length] = '\0';
+					return strtof(buffer, nullptr);
+				}
+
+				return strtof(string(begin, end).c_str(), nullptr);
+			}
+
+			static bool TokenEquals(const char* begin, const char* end, const char* text)
+			{
+				const size_t length = strlen(text);
+				return (static_cast<size_t>(end - begin) == length && memcmp(begin, text, length) == 0);
+			}
+
+			[[noreturn]] void Fail(const char* message) const
+			{
+				ostringstream error;
+				error << "Scene file line " << mLineNumber << ": " << message << ".";
+				throw GameException(error.str().c_str());
+			}
+
+		private:
+			static bool IsWhitespace(char character)
+			{
+				return (character == ' ' || character == '\t' || character == '\r');
+			}
+
+			void SkipWhitespace()
+			{
+				while (mCursor < mLineEnd && IsWhitespace(*mCursor))
+				{
+					++mCursor;
+				}
+			}
+
+			const char* mCursor;
+			const char* mLineEnd;
+			const char* mNextLine;
+			const char* mEnd;
+			uint32_t mLineNumber;
+		};
+	}
+
+	const vector<BodyDescription>& SolarSystemScene::Bodies()
+	{
+		static const vector<BodyDescription> bodies = CreateBodies();
+		return bodies;
+	}
+
+	double SolarSystemScene::YearLength()
+	{
+		return XM_2PI / Bodies()[EarthBody].RevolutionRate;
+	}
+
+	double SolarSystemScene::YearLength(const vector<BodyDescription>& bodies, uint32_t body)
+	{
+		const BodyDescription& description = bodies[body];
+		return XM_2PI / (description.Motion == MotionModel::Keplerian ? description.Orbit.MeanMotion : description.RevolutionRate);
+	}
+
+	uint32_t SolarSystemScene::FindBody(const vector<BodyDescription>& bodies, const string& name)
+	{
+		for (uint32_t body = 0; body < bodies.size(); ++body)
+		{
+			if (bodies[body].Name == name)
+			{
+				return body;
+			}
+		}
+
+		return CelestialBodyStore::NoParent;
+	}
+
+	vector<ParticleFieldDescription> SolarSystemScene::ParticleFields(const vector<BodyDescription>& bodies)
+	{
+		vector<ParticleFieldDescription> fields;
+
+		// The main belt, 2.2 to 3.3 AU from the Sun, with the inner edge revolving at the rate Kepler's third law gives it
+		const uint32_t none = CelestialBodyStore::NoParent;
+		fields.push_back({ AsteroidBeltCount, none, EarthOrbitalDistance * 2.2f, EarthOrbitalDistance * 3.3f, EarthOrbitalDistance * 0.1f, 0.0f, EarthScale * 0.02f, EarthScale * 0.12f, EarthRevolution / (2.2f * sqrt(2.2f)), 1801 });
+
+		// Saturn's main rings span 1.2 to 2.3 planet radii in its equatorial plane, and the inner edge goes round in about
+		// three quarters of a Saturn day. A body's drawn radius is its scale times the sphere mesh's radius.
+		const uint32_t saturn = FindBody(bodies, "Saturn");
+		if (saturn != none)
+		{
+			const BodyDescription& planet = bodies[saturn];
+			const float radius = planet.Scale * SphereMesh::Radius;
+			fields.push_back({ SaturnRingCount, saturn, radius * 1.2f, radius * 2.3f, radius * 0.01f, planet.AxialTilt, radius * 0.002f, radius * 0.008f, planet.RotationRate * 1.35f, 1610 });
+		}
+
+		return fields;
+	}
+
+	vector<BodyDescription> SolarSystemScene::Load(const wstring& filename)
+	{
+		MemoryMappedFile file(filename);
+		const char* fileBegin = reinterpret_cast<const char*>(file.Data());
+		const char* fileEnd = fileBegin + file.Size();
+
+		SceneParser parser(fileBegin, fileEnd);
+		if (!parser.NextLine() || !parser.NextTokenIs("scene") || parser.NextFloat() != static_cast<float>(FormatVersion))
+		{
+			parser.Fail("expected a supported scene header");
+		}
+
+		// One scan for line breaks is far cheaper than letting a large catalog grow the containers step by step
+		const size_t lineCount = static_cast<size_t>(count(fileBegin, fileEnd, '\n')) + 1;
+		vector<BodyDescription> bodies;
+		bodies.reserve(lineCount);
+		unordered_map<string, uint32_t> indices;
+		indices.reserve(lineCount);
+
+		// Catalogs share a handful of textures, so consecutive repeats reuse the last conversion
+		const char* lastTextureBegin = nullptr;
+		const char* lastTextureEnd = nullptr;
+		wstring lastTexture;
+
+		while (parser.NextLine())
+		{
+			BodyDescription body;
+			const char* begin;
+			const char* end;
+
+			parser.NextToken(begin, end);
+			body.Name.assign(begin, end);
+
+			parser.NextToken(begin, end);
+			if (SceneParser::TokenEquals(begin, end, "-"))
+			{
+				body.Parent = CelestialBodyStore::NoParent;
+			}
+			else
+			{
+				const auto parent = indices.find(string(begin, end));
+				if (parent == indices.end())
+				{
+					parser.Fail("parents must be defined before their satellites");
+				}
+
+				body.Parent = parent->second;
+			}
+
+			parser.NextToken(begin, end);
+			body.IsLit = !SceneParser::TokenEquals(begin, end, "0");
+			body.Mass = parser.NextFloat();
+			body.Scale = parser.NextFloat();
+			body.RotationRate = parser.NextFloat();
+			body.AxialTilt = parser.NextFloat();
+
+			parser.NextToken(begin, end);
+			if (!SceneParser::TokenEquals(begin, end, "-"))
+			{
+				if (lastTextureBegin == nullptr || lastTextureEnd - lastTextureBegin != end - begin || memcmp(begin, lastTextureBegin, end - begin) != 0)
+				{
+					lastTexture = Utility::ToWideString(string(begin, end));
+					lastTextureBegin = begin;
+					lastTextureEnd = end;
+				}
+
+				body.Texture = lastTexture;
+			}
+
+			parser.NextToken(begin, end);
+			if (SceneParser::TokenEquals(begin, end, "circular"))
+			{
+				body.Motion = MotionModel::Circular;
+				body.Orbit = NoOrbit;
+				body.OrbitalDistance = parser.NextFloat();
+				body.RevolutionRate = parser.NextFloat();
+			}
+			else if (SceneParser::TokenEquals(begin, end, "kepler"))
+			{
+				body.Motion = MotionModel::Keplerian;
+				body.OrbitalDistance = 0.0f;
+				body.RevolutionRate = 0.0f;
+				body.Orbit.SemiMajorAxis = parser.NextFloat();
+				body.Orbit.Eccentricity = parser.NextFloat();
+				body.Orbit.Inclination = parser.NextFloat();
+				body.Orbit.LongitudeOfAscendingNode = parser.NextFloat();
+				body.Orbit.ArgumentOfPeriapsis = parser.NextFloat();
+				body.Orbit.MeanAnomalyAtEpoch = parser.NextFloat();
+				body.Orbit.MeanMotion = parser.NextFloat();
+			}
+			else
+			{
+				parser.Fail("unknown motion model");
+			}
+
+			if (!parser.AtEndOfLine())
+			{
+				parser.Fail("unexpected field after the orbit");
+			}
+
+			if (!indices.emplace(body.Name, static_cast<uint32_t>(bodies.size())).second)
+			{
+				parser.Fail("duplicate body name");
+			}
+
+			bodies.push_back(move(body));
+		}
+
+		if (bodies.empty())
+		{
+			throw GameException("Scene file has no bodies.");
+		}
+
+		return bodies;
+	}
+
+	void SolarSystemScene::Save(const wstring& filename, const vector<BodyDescription>& bodies)
+	{
+		ofstream file(filename.c_str());
+		if (!file.good())
+		{
+			throw GameException("Could not open file.");
+		}
+
+		file << "scene " << FormatVersion << "\n";
+		file << "# name parent lit mass scale rotation-rate axial-tilt texture circular orbital-distance revolution-rate\n";
+		file << "# name parent lit mass scale rotation-rate axial-tilt texture kepler semi-major-axis eccentricity inclination ascending-node periapsis mean-anomaly mean-motion\n";
+		file << "# Angles are in radians, rates in radians per second and masses in Earth masses; parents come before their satellites\n";
+
+		// Nine significant digits bring every float back bit for bit
+		file << setprecision(9);
+		for (const BodyDescription& body : bodies)
+		{
+			const string texture = (body.Texture.empty() ? "-" : Utility::ToString(body.Texture));
+			if (body.Name.empty() || body.Name.find_first_of(" \t\r\n") != string::npos || texture.find_first_of(" \t\r\n") != string::npos)
+			{
+				throw GameException("Body names and textures cannot be empty or contain whitespace.");
+			}
+
+			file << body.Name << ' ' << (body.Parent == CelestialBodyStore::NoParent ? string("-") : bodies[body.Parent].Name) << ' ' << (body.IsLit ? 1 : 0) << ' ';
+			file << body.Mass << ' ' << body.Scale << ' ' << body.RotationRate << ' ' << body.AxialTilt << ' ' << texture << ' ';
+			if (body.Motion == MotionModel::Keplerian)
+			{
+				const OrbitalElements& orbit = body.Orbit;
+				file << "kepler " << orbit.SemiMajorAxis << ' ' << orbit.Eccentricity << ' ' << orbit.Inclination << ' ' << orbit.LongitudeOfAscendingNode << ' ';
+				file << orbit.ArgumentOfPeriapsis << ' ' << orbit.MeanAnomalyAtEpoch << ' ' << orbit.MeanMotion << "\n";
+			}
+			else
+			{
+				file << "circular " << body.OrbitalDistance << ' ' << body.RevolutionRate << "\n";
+			}
+		}
+
+		if (!file.good())
+		{
+			throw GameException("Could not write scene.");
+		}
+	}
+
+	void SolarSystemScene::Populate(CelestialBodyStore& store)
+	{
+		Populate(store, Bodies());
+	}
+
+	void SolarSystemScene::Populate(CelestialBodyStore& store, const vector<BodyDescription>& bodies)
+	{
+		// Bodies are added in description order, so a description's index is its body index in an empty store
+		assert(store.Size() == 0);
+
+		store.Reserve(static_cast<uint32_t>(bodies.size()));
+		for (const BodyDescription& body : bodies)
+		{
+			if (body.Motion == MotionModel::Keplerian)
+			{
+				store.AddKeplerian(body.RotationRate, body.AxialTilt, body.Orbit, body.Scale, body.Parent, body.IsLit);
+			}
+			else
+			{
+				store.Add(body.RotationRate, body.AxialTilt, body.OrbitalDistance, body.Scale, body.RevolutionRate, body.Parent, body.IsLit);
+			}
+		}
+
+		store.SortByDepth();
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CelestialBodyStore.h"
+#include "ParticleField.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SolarSystem
+{
+	struct BodyDescription
+	{
+		std::string Name;
+		std::wstring Texture;
+		float RotationRate;
+		float AxialTilt;
+		float OrbitalDistance;
+		float Scale;
+		float RevolutionRate;
+		MotionModel Motion;
+		OrbitalElements Orbit;
+		std::uint32_t Parent;
+		bool IsLit;
+		float Mass;
+	};
+
+	class SolarSystemScene final
+	{
+	public:
+		static const std::uint32_t EarthBody;
+		static const std::uint32_t FormatVersion;
+		static const std::wstring DefaultSceneFilename;
+
+		static const std::vector<BodyDescription>& Bodies();
+		static double YearLength();
+		static double YearLength(const std::vector<BodyDescription>& bodies, std::uint32_t body);
+		static std::uint32_t FindBody(const std::vector<BodyDescription>& bodies, const std::string& name);
+
+		static std::vector<ParticleFieldDescription> ParticleFields(const std::vector<BodyDescription>& bodies);
+
+		static std::vector<BodyDescription> Load(const std::wstring& filename);
+		static void Save(const std::wstring& filename, const std::vector<BodyDescription>& bodies);
+
+		static void Populate(CelestialBodyStore& store);
+		static void Populate(CelestialBodyStore& store, const std::vector<BodyDescription>& bodies);
+
+		SolarSystemScene() = delete;
+		SolarSystemScene(const SolarSystemScene&) = delete;
+		SolarSystemScene& operator=(const SolarSystemScene&) = delete;
+		SolarSystemScene(SolarSystemScene&&) = delete;
+		SolarSystemScene& operator=(SolarSystemScene&&) = delete;
+		~SolarSystemScene() = default;
+	};
+}
@@ -0,0 +1,317 @@
+#include "pch.h"
+#include "SolarSystemSimulation.h"
+#include "SolarSystemScene.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace SolarSystem
+{
+	RTTI_DEFINITIONS(SolarSystemSimulation)
+
+	const uint32_t SolarSystemSimulation::SnapshotVersion = 1;
+
+	SolarSystemSimulation::SolarSystemSimulation(Game& game, const wstring& sceneFilename) :
+		GameComponent(game), mSceneFilename(sceneFilename), mReferenceBody(0), mSimulationTime(0.0), mPreviousSimulationTime(0.0), mAnimationEnabled(true), mNBodyEnabled(false)
+	{
+	}
+
+	CelestialBodyStore& SolarSystemSimulation::BodyStore()
+	{
+		return mBodyStore;
+	}
+
+	const CelestialBodyStore& SolarSystemSimulation::BodyStore() const
+	{
+		return mBodyStore;
+	}
+
+	const vector<BodyDescription>& SolarSystemSimulation::Bodies() const
+	{
+		return mBodies;
+	}
+
+	const vector<float>& SolarSystemSimulation::BodyMasses() const
+	{
+		return mBodyMasses;
+	}
+
+	uint32_t SolarSystemSimulation::ReferenceBody() const
+	{
+		return mReferenceBody;
+	}
+
+	double SolarSystemSimulation::YearLength() const
+	{
+		return SolarSystemScene::YearLength(mBodies, mReferenceBody);
+	}
+
+	bool SolarSystemSimulation::AnimationEnabled() const
+	{
+		return mAnimationEnabled;
+	}
+
+	void SolarSystemSimulation::SetAnimationEnabled(bool enabled)
+	{
+		// Paused updates leave the matrices alone, so the last step's motion would otherwise be interpolated across
+		// for as long as the pause lasts
+		if (!enabled && mAnimationEnabled)
+		{
+			mBodyStore.ResetPreviousWorldMatrices();
+			mPreviousSimulationTime = mSimulationTime;
+		}
+
+		mAnimationEnabled = enabled;
+	}
+
+	bool SolarSystemSimulation::NBodyEnabled() const
+	{
+		return mNBodyEnabled;
+	}
+
+	void SolarSystemSimulation::SetNBodyEnabled(bool enabled)
+	{
+		if (enabled && !mNBodyEnabled && !StartNBodySimulation())
+		{
+			return;
+		}
+
+		mNBodyEnabled = enabled;
+	}
+
+	double SolarSystemSimulation::SimulationTime() const
+	{
+		return mSimulationTime;
+	}
+
+	double SolarSystemSimulation::InterpolatedSimulationTime(float interpolation) const
+	{
+		// The time the interpolated world matrices show: part way through the last step, like the matrices themselves
+		return mSimulationTime - (1.0 - interpolation) * (mSimulationTime - mPreviousSimulationTime);
+	}
+
+	void SolarSystemSimulation::WarpTo(double time)
+	{
+		// Every body is evaluated directly at the new time, so a jump of any length costs one update
+		mSimulationTime = time;
+		mBodyStore.EvaluateAt(mSimulationTime, mGame->Jobs());
+
+		// A jump is not motion, so there is nothing to interpolate across
+		mBodyStore.ResetPreviousWorldMatrices();
+		mPreviousSimulationTime = mSimulationTime;
+
+		if (mNBodyEnabled)
+		{
+			mNBodyEnabled = StartNBodySimulation();
+		}
+	}
+
+	void SolarSystemSimulation::WarpBy(double elapsedSeconds)
+	{
+		WarpTo(mSimulationTime + elapsedSeconds);
+	}
+
+	void SolarSystemSimulation::Initialize()
+	{
+		// A missing scene file is not an error; the built-in solar system stands in for it
+		mBodies = (!mSceneFilename.empty() && ifstream(mSceneFilename.c_str()).good() ? SolarSystemScene::Load(mSceneFilename) : SolarSystemScene::Bodies());
+
+		// The Earth sets the year and the strength of gravity, or the first body after the Sun in a scene without one
+		mReferenceBody = SolarSystemScene::FindBody(mBodies, "Earth");
+		mReferenceBody = (mReferenceBody == CelestialBodyStore::NoParent ? (mBodies.size() > 1 ? 1 : 0) : mReferenceBody);
+
+		// Time warps and the year count are measured in the reference body's years, so it has to go around
+		if (!isfinite(SolarSystemScene::YearLength(mBodies, mReferenceBody)))
+		{
+			throw GameException("The reference body of the scene does not orbit.");
+		}
+
+		// Populating also groups the bodies into hierarchy levels, so every update reads finished parent transforms
+		SolarSystemScene::Populate(mBodyStore, mBodies);
+
+		// Only the N-body mode uses the masses
+		mBodyMasses.clear();
+		mBodyMasses.reserve(mBodies.size());
+		for (const BodyDescription& body : mBodies)
+		{
+			mBodyMasses.push_back(body.Mass);
+		}
+	}
+
+	void SolarSystemSimulation::Update(const GameTime& gameTime)
+	{
+		Advance(gameTime.ElapsedGameTimeNanoseconds());
+	}
+
+	void SolarSystemSimulation::Advance(const chrono::nanoseconds& elapsedTime)
+	{
+		if (mAnimationEnabled)
+		{
+			const float elapsedSeconds = chrono::duration_cast<chrono::duration<float>>(elapsedTime).count();
+			mPreviousSimulationTime = mSimulationTime;
+			mSimulationTime += chrono::duration<double>(elapsedTime).count();
+			mBodyStore.EvaluateAt(mSimulationTime, mGame->Jobs());
+
+			if (mNBodyEnabled)
+			{
+				// Spin and tilt still come from the body store, but gravity decides where the bodies are
+				mNBodySimulation.Advance(elapsedSeconds, mGame->Jobs());
+				mBodyStore.SetTranslations(mNBodySimulation.PositionsX(), mNBodySimulation.PositionsY(), mNBodySimulation.PositionsZ());
+			}
+		}
+	}
+
+	void SolarSystemSimulation::Save(OutputStreamHelper& stream) const
+	{
+		stream << SnapshotVersion << mBodyStore.Size() << mSimulationTime << mAnimationEnabled << mNBodyEnabled;
+
+		// Everything else in the body store is a function of the time, but gravity has state of its own
+		if (mNBodyEnabled)
+		{
+			mNBodySimulation.Save(stream);
+		}
+	}
+
+	void SolarSystemSimulation::Load(InputStreamHelper& stream)
+	{
+		uint32_t version;
+		uint32_t bodyCount;
+		stream >> version >> bodyCount;
+		if (version != SnapshotVersion)
+		{
+			throw GameException("Unsupported simulation snapshot version.");
+		}
+		if (bodyCount != mBodyStore.Size())
+		{
+			throw GameException("Simulation snapshot does not match the scene.");
+		}
+
+		stream >> mSimulationTime >> mAnimationEnabled >> mNBodyEnabled;
+		if (mNBodyEnabled)
+		{
+			mNBodySimulation.Load(stream, bodyCount);
+		}
+
+		if (!stream.Stream().good())
+		{
+			throw GameException("Simulation snapshot is truncated.");
+		}
+
+		mBodyStore.EvaluateAt(mSimulationTime, mGame->Jobs());
+		if (mNBodyEnabled)
+		{
+			mBodyStore.SetTranslations(mNBodySimulation.PositionsX(), mNBodySimulation.PositionsY(), mNBodySimulation.PositionsZ());
+		}
+
+		mBodyStore.ResetPreviousWorldMatrices();
+		mPreviousSimulationTime = mSimulationTime;
+	}
+
+	uint64_t SolarSystemSimulation::Checksum() const
+	{
+		// FNV-1a over the exact bits of the time and every world matrix, so two runs only match if they agree bit for bit
+		const uint64_t prime = 1099511628211ULL;
+		uint64_t hash = 14695981039346656037ULL;
+		auto hashBytes = [&hash, prime](const void* data, size_t size)
+		{
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash = (hash ^ bytes[i]) * prime;
+			}
+		};
+
+		hashBytes(&mSimulationTime, sizeof(mSimulationTime));
+		const uint32_t bodyCount = mBodyStore.Size();
+		for (uint32_t body = 0; body < bodyCount; ++body)
+		{
+			XMFLOAT4X4 worldMatrix;
+			XMStoreFloat4x4(&worldMatrix, mBodyStore.WorldMatrix(body));
+			hashBytes(&worldMatrix, sizeof(worldMatrix));
+		}
+
+		return hash;
+	}
+
+	bool SolarSystemSimulation::StartNBodySimulation()
+	{
+		// Bodies without a parent orbit the heaviest of them (the Sun), which starts at rest
+		const uint32_t bodyCount = mBodyStore.Size();
+		uint32_t centralBody = 0;
+		for (uint32_t body = 0; body < bodyCount; ++body)
+		{
+			if (mBodyStore.Parent(body) == CelestialBodyStore::NoParent && mBodyMasses[body] > mBodyMasses[centralBody])
+			{
+				centralBody = body;
+			}
+		}
+
+		vector<XMFLOAT3> positions(bodyCount);
+		for (uint32_t body = 0; body < bodyCount; ++body)
+		{
+			MatrixHelper::GetTranslation(mBodyStore.WorldMatrix(body), positions[body]);
+		}
+
+		// Orbital speeds divide by the central mass and by each body's distance to its parent, so a massless body or one
+		// sitting on its parent leaves gravity with nothing to start from
+		vector<uint32_t> parents(bodyCount);
+		vector<float> distances(bodyCount, 0.0f);
+		for (uint32_t body = 0; body < bodyCount; ++body)
+		{
+			uint32_t parent = mBodyStore.Parent(body);
+			parent = (parent == CelestialBodyStore::NoParent && body != centralBody ? centralBody : parent);
+			parents[body] = parent;
+			if (parent != CelestialBodyStore::NoParent)
+			{
+				distances[body] = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&positions[body]), XMLoadFloat3(&positions[parent]))));
+				if (!(distances[body] > 0.0f))
+				{
+					return false;
+				}
+			}
+
+			if (!(mBodyMasses[body] > 0.0f))
+			{
+				return false;
+			}
+		}
+
+		// Pick G so that the Sun gives the Earth the same year as the prescribed orbits. The scene is not to scale, so
+		// moons that sit outside their planet's sphere of influence will drift off into orbits of their own.
+		const BodyDescription& reference = mBodies[mReferenceBody];
+		const float referenceDistance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&positions[mReferenceBody]), XMLoadFloat3(&positions[centralBody]))));
+		if (!(referenceDistance > 0.0f))
+		{
+			return false;
+		}
+
+		const float referenceRevolution = (reference.Motion == MotionModel::Keplerian ? reference.Orbit.MeanMotion : reference.RevolutionRate);
+		const float gravitationalConstant = referenceRevolution * referenceRevolution * referenceDistance * referenceDistance * referenceDistance / mBodyMasses[centralBody];
+
+		// Start every body on a circular orbit around its parent; parents are always added before their satellites
+		vector<XMFLOAT3> velocities(bodyCount, XMFLOAT3(0.0f, 0.0f, 0.0f));
+		mNBodySimulation.Clear();
+		mNBodySimulation.Reserve(bodyCount);
+		mNBodySimulation.SetGravitationalConstant(gravitationalConstant);
+		for (uint32_t body = 0; body < bodyCount; ++body)
+		{
+			const uint32_t parent = parents[body];
+			if (parent != CelestialBodyStore::NoParent)
+			{
+				const XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&positions[body]), XMLoadFloat3(&positions[parent]));
+				const float speed = sqrtf(gravitationalConstant * (mBodyMasses[parent] + mBodyMasses[body]) / distances[body]);
+
+				// Same sense of rotation as the prescribed revolution
+				const XMVECTOR direction = XMVector3Normalize(XMVector3Cross(XMLoadFloat3(&Vector3Helper::Up), offset));
+				XMStoreFloat3(&velocities[body], XMVectorMultiplyAdd(direction, XMVectorReplicate(speed), XMLoadFloat3(&velocities[parent])));
+			}
+
+			mNBodySimulation.Add(mBodyMasses[body], positions[body], velocities[body]);
+		}
+
+		mNBodySimulation.RemoveNetMomentum();
+
+		return true;
+	}
+}
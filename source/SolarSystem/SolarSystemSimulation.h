@@ -0,0 +1,72 @@
+#pragma once
+
+#include "GameComponent.h"
+#include "CelestialBodyStore.h"
+#include "NBodySimulation.h"
+#include "SolarSystemScene.h"
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <chrono>
+
+namespace Library
+{
+	class OutputStreamHelper;
+	class InputStreamHelper;
+}
+
+namespace SolarSystem
+{
+	class SolarSystemSimulation final : public Library::GameComponent
+	{
+		RTTI_DECLARATIONS(SolarSystemSimulation, Library::GameComponent)
+
+	public:
+		static const std::uint32_t SnapshotVersion;
+
+		explicit SolarSystemSimulation(Library::Game& game, const std::wstring& sceneFilename = SolarSystemScene::DefaultSceneFilename);
+		SolarSystemSimulation(const SolarSystemSimulation&) = delete;
+		SolarSystemSimulation& operator=(const SolarSystemSimulation&) = delete;
+		SolarSystemSimulation(SolarSystemSimulation&&) = delete;
+		SolarSystemSimulation& operator=(SolarSystemSimulation&&) = delete;
+		~SolarSystemSimulation() = default;
+
+		CelestialBodyStore& BodyStore();
+		const CelestialBodyStore& BodyStore() const;
+		const std::vector<BodyDescription>& Bodies() const;
+		const std::vector<float>& BodyMasses() const;
+		std::uint32_t ReferenceBody() const;
+		double YearLength() const;
+
+		bool AnimationEnabled() const;
+		void SetAnimationEnabled(bool enabled);
+		bool NBodyEnabled() const;
+		void SetNBodyEnabled(bool enabled);
+		double SimulationTime() const;
+		double InterpolatedSimulationTime(float interpolation) const;
+		void WarpTo(double time);
+		void WarpBy(double elapsedSeconds);
+		void Advance(const std::chrono::nanoseconds& elapsedTime);
+
+		void Save(Library::OutputStreamHelper& stream) const;
+		void Load(Library::InputStreamHelper& stream);
+		std::uint64_t Checksum() const;
+
+		virtual void Initialize() override;
+		virtual void Update(const Library::GameTime& gameTime) override;
+
+	private:
+		bool StartNBodySimulation();
+
+		std::wstring mSceneFilename;
+		std::vector<BodyDescription> mBodies;
+		CelestialBodyStore mBodyStore;
+		std::vector<float> mBodyMasses;
+		std::uint32_t mReferenceBody;
+		NBodySimulation mNBodySimulation;
+		double mSimulationTime;
+		double mPreviousSimulationTime;
+		bool mAnimationEnabled;
+		bool mNBodyEnabled;
+	};
+}
@@ -14,6 +14,7 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <stack>
 #include <cstdint>
 #include <iomanip>
@@ -47,8 +48,13 @@
 #include "GameClock.h"
 #include "GameTime.h"
 #include "ServiceContainer.h"
+#include "JobSystem.h"
+#include "ICommandRecorder.h"
+#include "RecordingScheduler.h"
+#include "DeferredContextRecorder.h"
 #include "RenderTarget.h"
 #include "Game.h"
+#include "HeadlessGame.h"
 #include "GameComponent.h"
 #include "DrawableGameComponent.h"
 #include "VectorHelper.h"
@@ -58,6 +64,7 @@
 #include "PerspectiveCamera.h"
 #include "OrthographicCamera.h"
 #include "FirstPersonCamera.h"
+#include "Frustum.h"
 #include "Light.h"
 #include "DirectionalLight.h"
 #include "PointLight.h"
@@ -69,11 +76,21 @@
 #include "RasterizerStates.h"
 #include "SamplerStates.h"
 #include "RenderStateHelper.h"
+#include "RenderStateCache.h"
+#include "ConstantRingAllocator.h"
+#include "ConstantBufferRing.h"
+#include "SoftwareTexture.h"
+#include "SoftwareRasterizer.h"
+#include "RenderQueue.h"
 #include "FpsComponent.h"
 #include "StreamHelper.h"
+#include "MemoryMappedFile.h"
 #include "..\Library.Shared\Model.h"
 #include "..\Library.Shared\Mesh.h"
 #include "..\Library.Shared\ModelMaterial.h"
+#include "..\Library.Shared\ModelFile.h"
+#include "..\Library.Shared\VertexFormat.h"
+#include "..\Library.Shared\SphereMesh.h"
 #include "ProxyModel.h"
 #include "Skybox.h"
 #include "MouseComponent.h"
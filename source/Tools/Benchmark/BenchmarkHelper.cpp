@@ -0,0 +1,33 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Benchmark
+{
+	double BenchmarkHelper::MeasureSeconds(uint32_t iterations, const function<void()>& work)
+	{
+		assert(iterations > 0);
+
+		// Warm caches and branch predictors before timing
+		work();
+
+		const high_resolution_clock::time_point start = high_resolution_clock::now();
+		for (uint32_t i = 0; i < iterations; ++i)
+		{
+			work();
+		}
+
+		return duration_cast<duration<double>>(high_resolution_clock::now() - start).count() / iterations;
+	}
+
+	void BenchmarkHelper::ReportThroughput(const string& label, double itemsPerSecond, const string& units)
+	{
+		cout << left << setw(40) << label << right << setw(16) << fixed << setprecision(0) << itemsPerSecond << " " << units << "/s" << endl;
+	}
+
+	void BenchmarkHelper::ReportValue(const string& label, double value, const string& units)
+	{
+		cout << left << setw(40) << label << right << setw(16) << fixed << setprecision(4) << value << " " << units << endl;
+	}
+}
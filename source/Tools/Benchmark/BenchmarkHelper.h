@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Benchmark
+{
+	class BenchmarkHelper final
+	{
+	public:
+		static double MeasureSeconds(std::uint32_t iterations, const std::function<void()>& work);
+		static void ReportThroughput(const std::string& label, double itemsPerSecond, const std::string& units);
+		static void ReportValue(const std::string& label, double value, const std::string& units);
+
+		BenchmarkHelper() = delete;
+		BenchmarkHelper(const BenchmarkHelper&) = delete;
+		BenchmarkHelper& operator=(const BenchmarkHelper&) = delete;
+		BenchmarkHelper(BenchmarkHelper&&) = delete;
+		BenchmarkHelper& operator=(BenchmarkHelper&&) = delete;
+		~BenchmarkHelper() = default;
+	};
+}
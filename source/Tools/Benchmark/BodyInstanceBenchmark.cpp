@@ -0,0 +1,86 @@
+#include "pch.h"
+#include "BodyInstanceBuilder.h"
+#include "CelestialBodyStore.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		// What the per-body draw loop uploads for each body
+		struct PerObjectConstants
+		{
+			XMFLOAT4X4 WorldViewProjection;
+			XMFLOAT4X4 World;
+		};
+
+		const uint32_t TextureCount = 16;
+	}
+
+	void BodyInstanceBenchmark::Run(uint32_t bodyCount)
+	{
+		mt19937 generator(12345);
+		uniform_real_distribution<float> rateDistribution(-1.0f, 1.0f);
+		uniform_real_distribution<float> tiltDistribution(0.0f, XM_PI);
+		uniform_real_distribution<float> scaleDistribution(0.01f, 20.0f);
+		uniform_real_distribution<float> orbitDistribution(5.0f, 20000.0f);
+
+		CelestialBodyStore store;
+		store.Reserve(bodyCount);
+		vector<BodyInstanceSource> sources;
+		sources.reserve(bodyCount);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			store.Add(rateDistribution(generator), tiltDistribution(generator), orbitDistribution(generator), scaleDistribution(generator), rateDistribution(generator), CelestialBodyStore::NoParent, (i % 10) != 0);
+			sources.push_back({ i, i % TextureCount });
+		}
+
+		// Two updates, so the previous and current matrices differ and the blend does real work
+		store.Update(1.0f / 60.0f);
+		store.Update(1.0f / 60.0f);
+
+		const XMMATRIX viewProjection = XMMatrixLookAtLH(XMVectorSet(0.0f, 2.5f, 500.0f, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) * XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.01f, 100000.0f);
+		const float interpolation = 0.5f;
+		vector<PerObjectConstants> constants(bodyCount);
+		AlignedVector<BodyInstance> instances(bodyCount);
+		const uint32_t iterations = max(1U, 10000000U / max(1U, bodyCount));
+
+		cout << "Body instances: " << bodyCount << " bodies, " << iterations << " iterations" << endl;
+
+		double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]()
+		{
+			for (uint32_t i = 0; i < bodyCount; ++i)
+			{
+				const XMMATRIX worldMatrix = store.InterpolatedWorldMatrix(sources[i].Body, interpolation);
+				XMStoreFloat4x4(&constants[i].WorldViewProjection, XMMatrixTranspose(worldMatrix * viewProjection));
+				XMStoreFloat4x4(&constants[i].World, XMMatrixTranspose(worldMatrix));
+			}
+		});
+		BenchmarkHelper::ReportThroughput("Per-body constants", bodyCount / seconds, "bodies");
+		BenchmarkHelper::ReportValue("  upload per body", sizeof(PerObjectConstants), "bytes");
+
+		const double instanceSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { BodyInstanceBuilder::Build(store, sources.data(), bodyCount, interpolation, instances.data()); });
+		BenchmarkHelper::ReportThroughput("Instance buffer", bodyCount / instanceSeconds, "bodies");
+		BenchmarkHelper::ReportValue("  upload per body", sizeof(BodyInstance), "bytes");
+		BenchmarkHelper::ReportValue("  speed-up", seconds / instanceSeconds, "x");
+
+		// Both paths must hand the shader the same world matrix
+		float maxDifference = 0.0f;
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			for (uint32_t row = 0; row < 4; ++row)
+			{
+				for (uint32_t column = 0; column < 4; ++column)
+				{
+					maxDifference = max(maxDifference, fabsf(instances[i].World.m[row][column] - constants[i].World.m[column][row]));
+				}
+			}
+		}
+
+		BenchmarkHelper::ReportValue("  max difference", maxDifference, "");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class BodyInstanceBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		BodyInstanceBenchmark() = delete;
+		BodyInstanceBenchmark(const BodyInstanceBenchmark&) = delete;
+		BodyInstanceBenchmark& operator=(const BodyInstanceBenchmark&) = delete;
+		BodyInstanceBenchmark(BodyInstanceBenchmark&&) = delete;
+		BodyInstanceBenchmark& operator=(BodyInstanceBenchmark&&) = delete;
+		~BodyInstanceBenchmark() = default;
+	};
+}
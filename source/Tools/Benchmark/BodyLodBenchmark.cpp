@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "BodyLodSelector.h"
+#include "FrustumCullingKernel.h"
+#include "CelestialBodyStore.h"
+#include "Frustum.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		// Index counts of SphereLod0.bin to SphereLod3.bin and the impostor point, against the single Sphere.obj.bin every
+		// body was drawn with before
+		const uint32_t LodIndexCounts[BodyLodSelector::LodCount + 1] = { 6624, 1584, 504, 240, 1 };
+		const uint32_t SphereIndexCount = 2280;
+		const float ViewportHeight = 720.0f;
+	}
+
+	void BodyLodBenchmark::Run(uint32_t bodyCount)
+	{
+		mt19937 generator(12345);
+		uniform_real_distribution<float> rateDistribution(-1.0f, 1.0f);
+		uniform_real_distribution<float> tiltDistribution(0.0f, XM_PI);
+		uniform_real_distribution<float> scaleDistribution(0.01f, 20.0f);
+		uniform_real_distribution<float> orbitDistribution(5.0f, 20000.0f);
+
+		CelestialBodyStore store;
+		store.Reserve(bodyCount);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			store.Add(rateDistribution(generator), tiltDistribution(generator), orbitDistribution(generator), scaleDistribution(generator), rateDistribution(generator), CelestialBodyStore::NoParent, true);
+		}
+
+		store.Update(1.0f / 60.0f);
+		store.Update(1.0f / 60.0f);
+
+		// The default camera, looking in at the Sun from the edge of the inner system; only the bodies that survive culling
+		// are sized, as in the renderer
+		const XMVECTOR cameraPosition = XMVectorSet(0.0f, 2.5f, 500.0f, 1.0f);
+		const XMMATRIX projectionMatrix = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.01f, 100000.0f);
+		const Frustum frustum(XMMatrixLookAtLH(cameraPosition, XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) * projectionMatrix);
+		const FrustumCullingInputs cullingInputs = { store.PreviousWorldMatrices(), store.WorldMatrices(), store.Scales(), SphereMesh::Radius, 0.5f };
+		vector<uint32_t> visible(bodyCount);
+		const uint32_t visibleCount = FrustumCullingKernel::Cull(frustum, cullingInputs, 0, bodyCount, visible.data());
+
+		const BodyLodInputs lodInputs = { store.PreviousWorldMatrices(), store.WorldMatrices(), store.Scales(), SphereMesh::Radius, 0.5f };
+		const float projectionScale = BodyLodSelector::ProjectionScale(projectionMatrix, ViewportHeight);
+		vector<uint8_t> lods(visibleCount);
+		const uint32_t iterations = max(1U, 10000000U / max(1U, visibleCount));
+
+		cout << "Body LOD selection: " << bodyCount << " bodies, " << visibleCount << " visible, " << iterations << " iterations" << endl;
+
+		const double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { BodyLodSelector::Select(lodInputs, cameraPosition, projectionScale, visible.data(), visibleCount, lods.data()); });
+		BenchmarkHelper::ReportThroughput("Select", visibleCount / seconds, "bodies");
+
+		uint32_t lodCounts[BodyLodSelector::LodCount + 1] = {};
+		uint64_t indexCount = 0;
+		for (uint8_t lod : lods)
+		{
+			++lodCounts[lod];
+			indexCount += LodIndexCounts[lod];
+		}
+
+		for (uint32_t lod = 0; lod < BodyLodSelector::LodCount; ++lod)
+		{
+			BenchmarkHelper::ReportValue("  LOD " + to_string(lod), lodCounts[lod], "bodies");
+		}
+
+		BenchmarkHelper::ReportValue("  impostors", lodCounts[BodyLodSelector::ImpostorLod], "bodies");
+		BenchmarkHelper::ReportValue("  vertex work", 100.0 * indexCount / max<uint64_t>(1, static_cast<uint64_t>(visibleCount) * SphereIndexCount), "% of one sphere per body");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class BodyLodBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		BodyLodBenchmark() = delete;
+		BodyLodBenchmark(const BodyLodBenchmark&) = delete;
+		BodyLodBenchmark& operator=(const BodyLodBenchmark&) = delete;
+		BodyLodBenchmark(BodyLodBenchmark&&) = delete;
+		BodyLodBenchmark& operator=(BodyLodBenchmark&&) = delete;
+		~BodyLodBenchmark() = default;
+	};
+}
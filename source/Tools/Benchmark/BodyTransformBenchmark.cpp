@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "BodyTransformKernel.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		float MaxDifference(const AlignedVector<XMFLOAT4X4>& lhs, const AlignedVector<XMFLOAT4X4>& rhs)
+		{
+			float maxDifference = 0.0f;
+			for (size_t i = 0; i < lhs.size(); ++i)
+			{
+				for (uint32_t row = 0; row < 4; ++row)
+				{
+					for (uint32_t column = 0; column < 4; ++column)
+					{
+						maxDifference = max(maxDifference, fabsf(lhs[i].m[row][column] - rhs[i].m[row][column]));
+					}
+				}
+			}
+
+			return maxDifference;
+		}
+	}
+
+	void BodyTransformBenchmark::Run(uint32_t bodyCount)
+	{
+		AlignedVector<float> scales(bodyCount);
+		AlignedVector<float> rotations(bodyCount);
+		AlignedVector<float> axialTilts(bodyCount);
+		AlignedVector<float> orbitalDistances(bodyCount);
+		AlignedVector<float> revolutions(bodyCount);
+
+		mt19937 generator(12345);
+		uniform_real_distribution<float> angleDistribution(-XM_2PI, XM_2PI);
+		uniform_real_distribution<float> scaleDistribution(0.01f, 20.0f);
+		uniform_real_distribution<float> orbitDistribution(5.0f, 20000.0f);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			scales[i] = scaleDistribution(generator);
+			rotations[i] = angleDistribution(generator);
+			axialTilts[i] = angleDistribution(generator);
+			orbitalDistances[i] = orbitDistribution(generator);
+			revolutions[i] = angleDistribution(generator);
+		}
+
+		const BodyTransformInputs inputs = { scales.data(), rotations.data(), axialTilts.data(), orbitalDistances.data(), revolutions.data() };
+		AlignedVector<XMFLOAT4X4> reference(bodyCount);
+		AlignedVector<XMFLOAT4X4> results(bodyCount);
+		const uint32_t iterations = max(1U, 10000000U / max(1U, bodyCount));
+
+		cout << "Body transforms: " << bodyCount << " bodies, " << iterations << " iterations, batch width " << BodyTransformKernel::BatchWidth() << endl;
+
+		double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { BodyTransformKernel::ComputeReference(inputs, 0, bodyCount, reference.data()); });
+		BenchmarkHelper::ReportThroughput("Reference (matrix chain)", bodyCount / seconds, "bodies");
+
+		seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { BodyTransformKernel::ComputeScalar(inputs, 0, bodyCount, results.data()); });
+		BenchmarkHelper::ReportThroughput("Scalar (closed form)", bodyCount / seconds, "bodies");
+		BenchmarkHelper::ReportValue("  max difference", MaxDifference(reference, results), "");
+
+		const uint32_t vectorEnd = bodyCount & ~3U;
+		seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { BodyTransformKernel::ComputeVector(inputs, 0, vectorEnd, results.data()); });
+		BenchmarkHelper::ReportThroughput("XMVECTOR (4 wide)", vectorEnd / seconds, "bodies");
+
+#if defined(__AVX2__)
+		const uint32_t avxEnd = bodyCount & ~7U;
+		seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { BodyTransformKernel::ComputeAVX2(inputs, 0, avxEnd, results.data()); });
+		BenchmarkHelper::ReportThroughput("AVX2 (8 wide)", avxEnd / seconds, "bodies");
+#endif
+
+		seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { BodyTransformKernel::Compute(inputs, 0, bodyCount, results.data()); });
+		BenchmarkHelper::ReportThroughput("Dispatched", bodyCount / seconds, "bodies");
+		BenchmarkHelper::ReportValue("  max difference", MaxDifference(reference, results), "");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class BodyTransformBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		BodyTransformBenchmark() = delete;
+		BodyTransformBenchmark(const BodyTransformBenchmark&) = delete;
+		BodyTransformBenchmark& operator=(const BodyTransformBenchmark&) = delete;
+		BodyTransformBenchmark(BodyTransformBenchmark&&) = delete;
+		BodyTransformBenchmark& operator=(BodyTransformBenchmark&&) = delete;
+		~BodyTransformBenchmark() = default;
+	};
+}
@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "CelestialBodyStore.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		void PopulateStore(CelestialBodyStore& store, uint32_t bodyCount)
+		{
+			mt19937 generator(12345);
+			uniform_real_distribution<float> rateDistribution(-1.0f, 1.0f);
+			uniform_real_distribution<float> tiltDistribution(0.0f, XM_PI);
+			uniform_real_distribution<float> scaleDistribution(0.01f, 20.0f);
+			uniform_real_distribution<float> orbitDistribution(5.0f, 20000.0f);
+
+			// A handful of stars, a planet layer around them and moons around the planets
+			store.Reserve(bodyCount);
+			const uint32_t starCount = max(1U, bodyCount / 1000);
+			const uint32_t planetCount = max(1U, bodyCount / 10);
+			for (uint32_t i = 0; i < bodyCount; ++i)
+			{
+				uint32_t parent = CelestialBodyStore::NoParent;
+				if (i >= starCount + planetCount)
+				{
+					parent = starCount + (i % planetCount);
+				}
+				else if (i >= starCount)
+				{
+					parent = i % starCount;
+				}
+
+				store.Add(rateDistribution(generator), tiltDistribution(generator), orbitDistribution(generator), scaleDistribution(generator), rateDistribution(generator), parent, true);
+			}
+
+			store.SortByDepth();
+		}
+	}
+
+	void BodyUpdateBenchmark::Run(uint32_t bodyCount)
+	{
+		CelestialBodyStore serialStore;
+		CelestialBodyStore parallelStore;
+		PopulateStore(serialStore, bodyCount);
+		PopulateStore(parallelStore, bodyCount);
+
+		JobSystem jobSystem;
+		const float elapsedSeconds = 1.0f / 60.0f;
+		const uint32_t iterations = max(1U, 10000000U / max(1U, bodyCount));
+
+		cout << "Body update: " << bodyCount << " bodies, " << serialStore.LevelCount() << " levels, " << iterations << " iterations, " << jobSystem.ThreadCount() << " threads" << endl;
+
+		double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { serialStore.Update(elapsedSeconds); });
+		BenchmarkHelper::ReportThroughput("Single thread", bodyCount / seconds, "bodies");
+
+		const double parallelSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { parallelStore.Update(elapsedSeconds, jobSystem); });
+		BenchmarkHelper::ReportThroughput("Job system", bodyCount / parallelSeconds, "bodies");
+		BenchmarkHelper::ReportValue("  speed-up", seconds / parallelSeconds, "x");
+
+		float maxDifference = 0.0f;
+		for (uint32_t slot = 0; slot < bodyCount; ++slot)
+		{
+			for (uint32_t row = 0; row < 4; ++row)
+			{
+				for (uint32_t column = 0; column < 4; ++column)
+				{
+					maxDifference = max(maxDifference, fabsf(serialStore.WorldMatrices()[slot].m[row][column] - parallelStore.WorldMatrices()[slot].m[row][column]));
+				}
+			}
+		}
+
+		BenchmarkHelper::ReportValue("  max difference", maxDifference, "");
+
+		// A time warp evaluates the angles directly instead of accumulating them, so it costs one update however far it jumps
+		const double warpTime = 1000.0 * 365.25 * 24.0 * 3600.0;
+		const double warpSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { serialStore.EvaluateAt(warpTime); });
+		BenchmarkHelper::ReportThroughput("Evaluate 1000 years ahead", bodyCount / warpSeconds, "bodies");
+	}
+}
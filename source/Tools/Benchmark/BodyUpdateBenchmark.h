@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class BodyUpdateBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		BodyUpdateBenchmark() = delete;
+		BodyUpdateBenchmark(const BodyUpdateBenchmark&) = delete;
+		BodyUpdateBenchmark& operator=(const BodyUpdateBenchmark&) = delete;
+		BodyUpdateBenchmark(BodyUpdateBenchmark&&) = delete;
+		BodyUpdateBenchmark& operator=(BodyUpdateBenchmark&&) = delete;
+		~BodyUpdateBenchmark() = default;
+	};
+}
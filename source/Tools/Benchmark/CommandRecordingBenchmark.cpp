@@ -0,0 +1,157 @@
+#include "pch.h"
+#include "ICommandRecorder.h"
+#include "RecordingScheduler.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace Benchmark
+{
+	namespace
+	{
+		const uint32_t PassCount = 64;
+		const uint32_t FrameCount = 60;
+
+		struct RecordedDraw
+		{
+			XMFLOAT4X4 WorldViewProjection;
+			uint32_t Pass;
+			uint32_t Draw;
+		};
+
+		// Stands in for the deferred context recorder: recording a draw builds its constants and appends it to the pass's
+		// command list, executing a pass appends that list to the frame's command stream. Every call is checked against the
+		// scheduler's promises: one thread per context at a time, each pass recorded once, and execution in pass order.
+		class RecordingStub final : public ICommandRecorder
+		{
+		public:
+			RecordingStub(uint32_t contextCount, uint32_t drawCount) :
+				mContextsInUse(contextCount), mCommandLists(PassCount), mDrawsPerPass((drawCount + PassCount - 1) / PassCount), mNextPass(0), mViolations(0)
+			{
+				for (auto& inUse : mContextsInUse)
+				{
+					inUse = false;
+				}
+
+				XMStoreFloat4x4(&mViewProjection, XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.01f, 100000.0f));
+			}
+
+			virtual uint32_t ContextCount() const override
+			{
+				return static_cast<uint32_t>(mContextsInUse.size());
+			}
+
+			virtual void RecordPass(uint32_t pass, uint32_t context) override
+			{
+				if (mContextsInUse[context].exchange(true) || !mCommandLists[pass].empty())
+				{
+					++mViolations;
+				}
+
+				const XMMATRIX viewProjection = XMLoadFloat4x4(&mViewProjection);
+				vector<RecordedDraw>& commandList = mCommandLists[pass];
+				commandList.resize(mDrawsPerPass);
+				for (uint32_t draw = 0; draw < mDrawsPerPass; ++draw)
+				{
+					float sine;
+					float cosine;
+					XMScalarSinCos(&sine, &cosine, static_cast<float>(pass * mDrawsPerPass + draw) * 0.001f);
+					const XMMATRIX world = XMMatrixRotationY(sine) * XMMatrixTranslation(cosine * 100.0f, 0.0f, sine * 100.0f);
+					XMStoreFloat4x4(&commandList[draw].WorldViewProjection, XMMatrixTranspose(world * viewProjection));
+					commandList[draw].Pass = pass;
+					commandList[draw].Draw = draw;
+				}
+
+				mContextsInUse[context] = false;
+			}
+
+			virtual void ExecutePass(uint32_t pass) override
+			{
+				vector<RecordedDraw>& commandList = mCommandLists[pass];
+				if (pass != mNextPass || commandList.size() != mDrawsPerPass)
+				{
+					++mViolations;
+				}
+
+				mCommandStream.insert(mCommandStream.end(), commandList.begin(), commandList.end());
+				commandList.clear();
+				mNextPass = pass + 1;
+			}
+
+			void BeginFrame()
+			{
+				mCommandStream.clear();
+				mNextPass = 0;
+			}
+
+			uint32_t EndFrame()
+			{
+				// The stream has to hold every draw of every pass, in the order they would have been drawn on one thread
+				uint32_t violations = mViolations.exchange(0);
+				violations += (mNextPass == PassCount ? 0 : 1);
+				for (size_t i = 0; i < mCommandStream.size(); ++i)
+				{
+					const RecordedDraw& draw = mCommandStream[i];
+					violations += (draw.Pass * mDrawsPerPass + draw.Draw == i ? 0 : 1);
+				}
+
+				return violations;
+			}
+
+			uint32_t DrawCount() const
+			{
+				return mDrawsPerPass * PassCount;
+			}
+
+		private:
+			vector<atomic<bool>> mContextsInUse;
+			vector<vector<RecordedDraw>> mCommandLists;
+			vector<RecordedDraw> mCommandStream;
+			XMFLOAT4X4 mViewProjection;
+			uint32_t mDrawsPerPass;
+			uint32_t mNextPass;
+			atomic<uint32_t> mViolations;
+		};
+	}
+
+	void CommandRecordingBenchmark::Run(uint32_t drawCount)
+	{
+		JobSystem jobSystem;
+		const uint32_t iterations = max(1U, 20000000U / max(1U, drawCount));
+
+		cout << "Command recording: " << drawCount << " draws per frame in " << PassCount << " passes, " << jobSystem.ThreadCount() << " threads, " << iterations << " iterations" << endl;
+
+		// One context reproduces recording everything on the immediate context; one per thread is what the game uses
+		vector<uint32_t> contextCounts = { 1 };
+		if (jobSystem.ThreadCount() > 1)
+		{
+			contextCounts.push_back(jobSystem.ThreadCount());
+		}
+
+		double serialSeconds = 0.0;
+		for (uint32_t contextCount : contextCounts)
+		{
+			RecordingStub recorder(contextCount, drawCount);
+			const double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]()
+			{
+				recorder.BeginFrame();
+				RecordingScheduler::Run(jobSystem, recorder, PassCount);
+				recorder.EndFrame();
+			});
+
+			uint32_t violations = 0;
+			for (uint32_t frame = 0; frame < FrameCount; ++frame)
+			{
+				recorder.BeginFrame();
+				RecordingScheduler::Run(jobSystem, recorder, PassCount);
+				violations += recorder.EndFrame();
+			}
+
+			serialSeconds = (contextCount == 1 ? seconds : serialSeconds);
+			BenchmarkHelper::ReportThroughput("Record (" + to_string(contextCount) + " contexts)", recorder.DrawCount() / seconds, "draws");
+			BenchmarkHelper::ReportValue("  speedup", serialSeconds / seconds, "x");
+			BenchmarkHelper::ReportValue("  violations", violations, "");
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class CommandRecordingBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t drawCount);
+
+		CommandRecordingBenchmark() = delete;
+		CommandRecordingBenchmark(const CommandRecordingBenchmark&) = delete;
+		CommandRecordingBenchmark& operator=(const CommandRecordingBenchmark&) = delete;
+		CommandRecordingBenchmark(CommandRecordingBenchmark&&) = delete;
+		CommandRecordingBenchmark& operator=(CommandRecordingBenchmark&&) = delete;
+		~CommandRecordingBenchmark() = default;
+	};
+}
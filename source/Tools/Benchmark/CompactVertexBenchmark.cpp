@@ -0,0 +1,172 @@
+#include "pch.h"
+#include "Model.h"
+#include "Mesh.h"
+#include "VertexFormat.h"
+#include "VertexDeclarations.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace Benchmark
+{
+	namespace
+	{
+		const uint32_t Iterations = 5;
+
+		// The vertex buffers are repeated until the full-precision copy is this large, so a pass over them streams from
+		// memory instead of cache, as a GPU's vertex fetch does for a scene's worth of meshes
+		const uint64_t StreamedBytes = 128ULL * 1024ULL * 1024ULL;
+
+		// Built the way the model pipeline builds SphereLod0.bin, only denser
+		void CreateSphere(Model& model, uint32_t slices, uint32_t stacks)
+		{
+			MeshData meshData;
+			meshData.Name = "Sphere";
+			meshData.TextureCoordinates.push_back(new vector<XMFLOAT3>());
+			for (uint32_t stack = 0; stack <= stacks; ++stack)
+			{
+				const float v = static_cast<float>(stack) / stacks;
+				float sinTheta;
+				float cosTheta;
+				XMScalarSinCos(&sinTheta, &cosTheta, XM_PI * v);
+
+				for (uint32_t slice = 0; slice <= slices; ++slice)
+				{
+					const float u = static_cast<float>(slice) / slices;
+					float sinPhi;
+					float cosPhi;
+					XMScalarSinCos(&sinPhi, &cosPhi, XM_2PI * u);
+
+					const XMFLOAT3 normal(sinTheta * cosPhi, cosTheta, -sinTheta * sinPhi);
+					meshData.Vertices.push_back(XMFLOAT3(normal.x * SphereMesh::Radius, normal.y * SphereMesh::Radius, normal.z * SphereMesh::Radius));
+					meshData.Normals.push_back(normal);
+					meshData.TextureCoordinates[0]->push_back(XMFLOAT3(u, v, 0.0f));
+				}
+			}
+
+			model.Data().Meshes.push_back(make_shared<Mesh>(model, move(meshData)));
+		}
+
+		vector<uint8_t> Repeat(const ArraySpan<uint8_t>& vertices, uint32_t copies)
+		{
+			vector<uint8_t> repeated(static_cast<size_t>(vertices.Size()) * copies);
+			for (uint32_t i = 0; i < copies; ++i)
+			{
+				memcpy(&repeated[static_cast<size_t>(i) * vertices.Size()], vertices.Data(), vertices.Size());
+			}
+
+			return repeated;
+		}
+
+		// The fetches read one value of each attribute per vertex, so every byte of the buffer passes through the cache
+		template <typename TVertex, typename TFetch>
+		double Fetch(const vector<uint8_t>& vertices, TFetch fetch)
+		{
+			const uint64_t vertexCount = vertices.size() / sizeof(TVertex);
+			double sum = 0.0;
+			for (uint64_t i = 0; i < vertexCount; ++i)
+			{
+				TVertex vertex;
+				memcpy(&vertex, &vertices[i * sizeof(TVertex)], sizeof(TVertex));
+				sum += fetch(vertex);
+			}
+
+			return sum;
+		}
+	}
+
+	void CompactVertexBenchmark::Run(uint32_t vertexCount)
+	{
+		// Twice as many slices as stacks, as in every level the pipeline writes
+		const uint32_t stacks = max(2U, static_cast<uint32_t>(sqrt(vertexCount / 2.0)));
+		const uint32_t slices = stacks * 2;
+
+		Model model;
+		CreateSphere(model, slices, stacks);
+		Mesh& mesh = *model.Meshes().front();
+		mesh.BakeInterleavedVertices(VertexFormat::PositionTextureNormal);
+		mesh.BakeInterleavedVertices(VertexFormat::PositionTextureNormalCompact);
+
+		const MeshSpans& spans = mesh.Spans();
+		const ArraySpan<uint8_t> fullVertices = mesh.InterleavedVertices(VertexFormat::PositionTextureNormal);
+		const ArraySpan<uint8_t> compactVertices = mesh.InterleavedVertices(VertexFormat::PositionTextureNormalCompact);
+		const uint32_t sphereVertexCount = spans.Vertices.Size();
+
+		XMFLOAT3 positionOffset;
+		XMFLOAT3 positionScale;
+		VertexFormatHelper::PositionQuantization(spans.Vertices, positionOffset, positionScale);
+
+		// What the compact layout gives up, measured against the vertices it was baked from. Normal error is taken from the
+		// chord between the normals, since the arc cosine of their dot product is too coarse near 1 to see it
+		float positionError = 0.0f;
+		float normalError = 0.0f;
+		float textureCoordinateError = 0.0f;
+		for (uint32_t i = 0; i < sphereVertexCount; ++i)
+		{
+			VertexPositionTextureNormalCompact compact;
+			memcpy(&compact, compactVertices.Data() + static_cast<size_t>(i) * sizeof(compact), sizeof(compact));
+			const VertexPositionTextureNormal decoded = VertexFormatHelper::Decompress(compact, positionOffset, positionScale);
+
+			const XMFLOAT3& uv = spans.TextureCoordinates[0][i];
+			positionError = max(positionError, XMVectorGetX(XMVector3Length(XMLoadFloat4(&decoded.Position) - XMLoadFloat3(&spans.Vertices[i]))));
+			const float chord = XMVectorGetX(XMVector3Length(XMLoadFloat3(&decoded.Normal) - XMLoadFloat3(&spans.Normals[i])));
+			normalError = max(normalError, 2.0f * asin(min(chord * 0.5f, 1.0f)));
+			textureCoordinateError = max(textureCoordinateError, max(fabs(decoded.TextureCoordinates.x - uv.x), fabs(decoded.TextureCoordinates.y - uv.y)));
+		}
+
+		const uint32_t copies = static_cast<uint32_t>(max<uint64_t>(1, StreamedBytes / fullVertices.Size()));
+		const vector<uint8_t> fullStream = Repeat(fullVertices, copies);
+		const vector<uint8_t> compactStream = Repeat(compactVertices, copies);
+		const double streamedVertexCount = static_cast<double>(sphereVertexCount) * copies;
+
+		cout << "Compact vertices: " << slices << "x" << stacks << " sphere, " << sphereVertexCount << " vertices, streamed " << copies << " times, " << Iterations << " iterations" << endl;
+
+		// Raw fetches stand in for the input assembler, which converts UNORM, FLOAT16 and SNORM for free; the decoded fetch
+		// adds the octahedral unfolding and dequantization the vertex shader does. Each timed pass must match an untimed one.
+		auto fetchFull = [&fullStream]()
+		{
+			return Fetch<VertexPositionTextureNormal>(fullStream, [](const VertexPositionTextureNormal& vertex) { return vertex.Position.x + vertex.TextureCoordinates.x + vertex.Normal.x; });
+		};
+
+		auto fetchCompact = [&compactStream]()
+		{
+			return Fetch<VertexPositionTextureNormalCompact>(compactStream, [](const VertexPositionTextureNormalCompact& vertex) { return static_cast<float>(vertex.Position.x + vertex.TextureCoordinates.x + vertex.Normal.x); });
+		};
+
+		auto fetchDecoded = [&compactStream, &positionOffset, &positionScale]()
+		{
+			return Fetch<VertexPositionTextureNormalCompact>(compactStream, [&](const VertexPositionTextureNormalCompact& vertex)
+			{
+				const VertexPositionTextureNormal decoded = VertexFormatHelper::Decompress(vertex, positionOffset, positionScale);
+				return decoded.Position.x + decoded.TextureCoordinates.x + decoded.Normal.x;
+			});
+		};
+
+		const double expectedFull = fetchFull();
+		const double expectedCompact = fetchCompact();
+		const double expectedDecoded = fetchDecoded();
+		uint32_t mismatches = 0;
+		const double fullSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]() { mismatches += (fetchFull() == expectedFull ? 0 : 1); });
+		const double compactSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]() { mismatches += (fetchCompact() == expectedCompact ? 0 : 1); });
+		const double decodedSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]() { mismatches += (fetchDecoded() == expectedDecoded ? 0 : 1); });
+
+		const double megabyte = 1024.0 * 1024.0;
+		BenchmarkHelper::ReportValue("Stride (full)", sizeof(VertexPositionTextureNormal), "bytes");
+		BenchmarkHelper::ReportValue("Stride (compact)", sizeof(VertexPositionTextureNormalCompact), "bytes");
+		BenchmarkHelper::ReportValue("  sphere buffer (full)", fullVertices.Size() / megabyte, "MB");
+		BenchmarkHelper::ReportValue("  sphere buffer (compact)", compactVertices.Size() / megabyte, "MB");
+		BenchmarkHelper::ReportValue("  memory saved", 100.0 * (1.0 - static_cast<double>(compactVertices.Size()) / fullVertices.Size()), "%");
+		BenchmarkHelper::ReportThroughput("Fetch (full)", streamedVertexCount / fullSeconds, "vertices");
+		BenchmarkHelper::ReportThroughput("Fetch (compact)", streamedVertexCount / compactSeconds, "vertices");
+		BenchmarkHelper::ReportThroughput("Fetch (compact, decoded)", streamedVertexCount / decodedSeconds, "vertices");
+		BenchmarkHelper::ReportThroughput("  bandwidth (full)", fullStream.size() / megabyte / fullSeconds, "MB");
+		BenchmarkHelper::ReportThroughput("  bandwidth (compact)", compactStream.size() / megabyte / compactSeconds, "MB");
+		BenchmarkHelper::ReportValue("  fetch speedup", fullSeconds / compactSeconds, "x");
+		BenchmarkHelper::ReportValue("  decoded fetch speedup", fullSeconds / decodedSeconds, "x");
+		BenchmarkHelper::ReportValue("  max position error", positionError / SphereMesh::Radius * 100.0, "% of radius");
+		BenchmarkHelper::ReportValue("  max normal error", XMConvertToDegrees(normalError), "degrees");
+		BenchmarkHelper::ReportValue("  max texture coordinate error", textureCoordinateError, "");
+		BenchmarkHelper::ReportValue("  mismatches", mismatches, "");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class CompactVertexBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t vertexCount);
+
+		CompactVertexBenchmark() = delete;
+		CompactVertexBenchmark(const CompactVertexBenchmark&) = delete;
+		CompactVertexBenchmark& operator=(const CompactVertexBenchmark&) = delete;
+		CompactVertexBenchmark(CompactVertexBenchmark&&) = delete;
+		CompactVertexBenchmark& operator=(CompactVertexBenchmark&&) = delete;
+		~CompactVertexBenchmark() = default;
+	};
+}
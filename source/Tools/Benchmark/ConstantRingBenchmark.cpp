@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "ConstantRingAllocator.h"
+#include "ConstantBufferRing.h"
+
+using namespace std;
+using namespace Library;
+
+namespace Benchmark
+{
+	namespace
+	{
+		// Per-object constants of the solar system render: a world-view-projection and a world matrix
+		const uint32_t ObjectConstantsSize = 128;
+		const uint32_t FrameCount = 240;
+
+		bool Throws(ConstantRingAllocator& allocator, uint32_t size)
+		{
+			try
+			{
+				allocator.Allocate(size);
+			}
+			catch (const GameException&)
+			{
+				return true;
+			}
+
+			return false;
+		}
+
+		bool IsAllocation(const RingAllocation& allocation, uint32_t offset, uint32_t size, bool discard)
+		{
+			return (allocation.Offset == offset && allocation.Size == size && allocation.Discard == discard);
+		}
+
+		// The boundaries the frame replay rarely lands on exactly: empty and oversized requests, a block that fills the
+		// whole ring, a run of blocks that ends exactly at the capacity, and the discard that has to follow every wrap
+		uint32_t CheckEdgeCases()
+		{
+			const uint32_t blockSize = ConstantRingAllocator::Alignment;
+			const uint32_t blockCount = 4;
+			ConstantRingAllocator allocator(blockSize * blockCount + blockSize / 2);
+
+			uint32_t violations = 0;
+			violations += (allocator.Capacity() == blockSize * blockCount ? 0 : 1);
+			violations += (Throws(allocator, 0) ? 0 : 1);
+			violations += (Throws(allocator, allocator.Capacity() + 1) ? 0 : 1);
+			violations += (allocator.AllocationCount() == 0 && allocator.Head() == 0 ? 0 : 1);
+
+			// One block the size of the ring, then another that has to wrap onto it
+			violations += (IsAllocation(allocator.Allocate(allocator.Capacity()), 0, allocator.Capacity(), true) ? 0 : 1);
+			violations += (allocator.Head() == allocator.Capacity() ? 0 : 1);
+			violations += (IsAllocation(allocator.Allocate(1), 0, blockSize, true) ? 0 : 1);
+
+			// Blocks that end exactly at the capacity stay in this pass, and only the one after them wraps and discards
+			for (uint32_t block = 1; block < blockCount; ++block)
+			{
+				violations += (IsAllocation(allocator.Allocate(blockSize), block * blockSize, blockSize, false) ? 0 : 1);
+			}
+
+			violations += (allocator.Head() == allocator.Capacity() ? 0 : 1);
+			violations += (IsAllocation(allocator.Allocate(blockSize), 0, blockSize, true) ? 0 : 1);
+			violations += (IsAllocation(allocator.Allocate(blockSize), blockSize, blockSize, false) ? 0 : 1);
+
+			// A block too large for what is left wraps early, and a reset asks for a discard before anything is written
+			violations += (IsAllocation(allocator.Allocate(blockSize * 3), 0, blockSize * 3, true) ? 0 : 1);
+			violations += (allocator.DiscardCount() == 4 ? 0 : 1);
+			allocator.Reset();
+			violations += (IsAllocation(allocator.Allocate(blockSize), 0, blockSize, true) ? 0 : 1);
+
+			return violations;
+		}
+	}
+
+	void ConstantRingBenchmark::Run(uint32_t drawCount)
+	{
+		// Sizes up to the 4096-constant limit of one binding, weighted towards small blocks the way real constants are
+		mt19937 generator(12345);
+		geometric_distribution<uint32_t> constantsDistribution(0.1);
+		vector<uint32_t> sizes(drawCount);
+		for (uint32_t& size : sizes)
+		{
+			size = 16 * min(4096U, constantsDistribution(generator) + 1);
+		}
+
+		ConstantRingAllocator allocator(ConstantBufferRing::DefaultCapacity);
+		const uint32_t iterations = max(1U, 10000000U / max(1U, drawCount));
+
+		cout << "Constant ring: " << drawCount << " draws per frame, " << allocator.Capacity() << " byte ring, " << iterations << " iterations" << endl;
+
+		const double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]()
+		{
+			for (uint32_t i = 0; i < drawCount; ++i)
+			{
+				allocator.Allocate(ObjectConstantsSize);
+			}
+		});
+		BenchmarkHelper::ReportThroughput("Allocate (object constants)", drawCount / seconds, "allocations");
+
+		const double mixedSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]()
+		{
+			for (uint32_t size : sizes)
+			{
+				allocator.Allocate(size);
+			}
+		});
+		BenchmarkHelper::ReportThroughput("Allocate (mixed sizes)", drawCount / mixedSeconds, "allocations");
+
+		// Replays frames of object constants, checking every block: aligned, inside the ring, and clear of everything handed
+		// out since the last discard, since only a discard makes it safe to write over earlier blocks
+		allocator.Reset();
+		uint32_t violations = 0;
+		uint32_t end = 0;
+		bool first = true;
+		for (uint32_t frame = 0; frame < FrameCount; ++frame)
+		{
+			for (uint32_t i = 0; i < drawCount; ++i)
+			{
+				const uint32_t size = (i % 2 == 0 ? ObjectConstantsSize : sizes[i]);
+				const RingAllocation allocation = allocator.Allocate(size);
+				const bool aligned = (allocation.Offset % ConstantRingAllocator::Alignment == 0 && allocation.Size % ConstantRingAllocator::Alignment == 0 && allocation.Size >= size);
+				const bool inside = (allocation.Offset + allocation.Size <= allocator.Capacity());
+				const bool clear = (allocation.Discard ? allocation.Offset == 0 : (!first && allocation.Offset >= end));
+				violations += (aligned && inside && clear ? 0 : 1);
+				end = allocation.Offset + allocation.Size;
+				first = false;
+			}
+		}
+
+		violations += CheckEdgeCases();
+
+		BenchmarkHelper::ReportValue("  discards per frame", static_cast<double>(allocator.DiscardCount()) / FrameCount, "");
+		BenchmarkHelper::ReportValue("  violations", violations, "");
+		if (violations > 0)
+		{
+			throw exception("The constant ring handed out a block that overlaps, overruns or skips a discard.");
+		}
+	}
+}
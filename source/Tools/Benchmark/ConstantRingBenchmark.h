@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class ConstantRingBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t drawCount);
+
+		ConstantRingBenchmark() = delete;
+		ConstantRingBenchmark(const ConstantRingBenchmark&) = delete;
+		ConstantRingBenchmark& operator=(const ConstantRingBenchmark&) = delete;
+		ConstantRingBenchmark(ConstantRingBenchmark&&) = delete;
+		ConstantRingBenchmark& operator=(ConstantRingBenchmark&&) = delete;
+		~ConstantRingBenchmark() = default;
+	};
+}
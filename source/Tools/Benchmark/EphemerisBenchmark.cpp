@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "CelestialBodyStore.h"
+#include "EphemerisTable.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		const uint32_t SampleCount = 256;
+		const double SampleInterval = 0.1;
+		const uint32_t AccuracyLookupCount = 64;
+
+		// Planets on circular and eccentric orbits around a few stars, with moons around the planets
+		void PopulateStore(CelestialBodyStore& store, uint32_t bodyCount)
+		{
+			mt19937 generator(12345);
+			uniform_real_distribution<float> rateDistribution(-1.0f, 1.0f);
+			uniform_real_distribution<float> angleDistribution(0.0f, XM_2PI);
+			uniform_real_distribution<float> scaleDistribution(0.01f, 20.0f);
+			uniform_real_distribution<float> orbitDistribution(5.0f, 20000.0f);
+			uniform_real_distribution<float> eccentricityDistribution(0.0f, 0.5f);
+
+			store.Reserve(bodyCount);
+			const uint32_t starCount = max(1U, bodyCount / 1000);
+			const uint32_t planetCount = max(1U, bodyCount / 10);
+			for (uint32_t i = 0; i < bodyCount; ++i)
+			{
+				uint32_t parent = CelestialBodyStore::NoParent;
+				if (i >= starCount + planetCount)
+				{
+					parent = starCount + (i % planetCount);
+				}
+				else if (i >= starCount)
+				{
+					parent = i % starCount;
+				}
+
+				if (i % 4 == 0)
+				{
+					const OrbitalElements orbit = { orbitDistribution(generator), eccentricityDistribution(generator), angleDistribution(generator), angleDistribution(generator), angleDistribution(generator), angleDistribution(generator), rateDistribution(generator) };
+					store.AddKeplerian(rateDistribution(generator), angleDistribution(generator), orbit, scaleDistribution(generator), parent, true);
+				}
+				else
+				{
+					store.Add(rateDistribution(generator), angleDistribution(generator), orbitDistribution(generator), scaleDistribution(generator), rateDistribution(generator), parent, true);
+				}
+			}
+
+			store.SortByDepth();
+		}
+
+		void GatherPositions(const CelestialBodyStore& store, vector<XMFLOAT3>& positions)
+		{
+			for (uint32_t body = 0; body < store.Size(); ++body)
+			{
+				const XMFLOAT4X4& worldMatrix = store.WorldMatrices()[store.Slot(body)];
+				positions[body] = XMFLOAT3(worldMatrix._41, worldMatrix._42, worldMatrix._43);
+			}
+		}
+	}
+
+	void EphemerisBenchmark::Run(uint32_t count)
+	{
+		// A table holds every body at every sample, so a tenth of the count keeps it to tens of megabytes
+		const uint32_t bodyCount = max(1U, count / 10);
+		CelestialBodyStore store;
+		PopulateStore(store, bodyCount);
+
+		JobSystem jobSystem;
+		EphemerisTable table;
+		const uint32_t iterations = max(1U, 1000000U / bodyCount);
+
+		cout << "Ephemeris: " << bodyCount << " bodies, " << SampleCount << " samples every " << SampleInterval << " s, " << iterations << " iterations" << endl;
+
+		const double buildSeconds = BenchmarkHelper::MeasureSeconds(1, [&]() { table.Build(store, 0.0, SampleInterval, SampleCount, jobSystem); });
+		BenchmarkHelper::ReportValue("Build", buildSeconds * 1000.0, "ms");
+		BenchmarkHelper::ReportValue("  table size", table.SizeInBytes() / (1024.0 * 1024.0), "MB");
+
+		// Lookups wander across the whole table so the rows are not all in cache
+		mt19937 generator(54321);
+		uniform_real_distribution<double> timeDistribution(table.StartTime(), table.EndTime());
+		vector<double> times(iterations);
+		generate(times.begin(), times.end(), [&]() { return timeDistribution(generator); });
+
+		vector<XMFLOAT3> interpolated(bodyCount);
+		uint32_t lookup = 0;
+		const double evaluateSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { store.EvaluateAt(times[lookup++ % iterations]); GatherPositions(store, interpolated); });
+		BenchmarkHelper::ReportThroughput("Evaluate bodies", bodyCount / evaluateSeconds, "bodies");
+
+		lookup = 0;
+		const double lookupSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { table.Positions(times[lookup++ % iterations], interpolated.data()); });
+		BenchmarkHelper::ReportThroughput("Ephemeris lookup", bodyCount / lookupSeconds, "bodies");
+		BenchmarkHelper::ReportValue("  speed-up", evaluateSeconds / lookupSeconds, "x");
+
+		// Halfway between samples is where the interpolation is furthest from the data it was built from
+		vector<XMFLOAT3> exact(bodyCount);
+		double maxError = 0.0;
+		double sumSquaredError = 0.0;
+		for (uint32_t i = 0; i < AccuracyLookupCount; ++i)
+		{
+			const double time = table.StartTime() + ((i * (SampleCount - 1)) / AccuracyLookupCount + 0.5) * SampleInterval;
+			store.EvaluateAt(time);
+			GatherPositions(store, exact);
+			table.Positions(time, interpolated.data());
+
+			for (uint32_t body = 0; body < bodyCount; ++body)
+			{
+				const double errorX = interpolated[body].x - exact[body].x;
+				const double errorY = interpolated[body].y - exact[body].y;
+				const double errorZ = interpolated[body].z - exact[body].z;
+				const double squaredError = errorX * errorX + errorY * errorY + errorZ * errorZ;
+				maxError = max(maxError, sqrt(squaredError));
+				sumSquaredError += squaredError;
+			}
+		}
+
+		BenchmarkHelper::ReportValue("  max position error", maxError, "units");
+		BenchmarkHelper::ReportValue("  rms position error", sqrt(sumSquaredError / (static_cast<double>(AccuracyLookupCount) * bodyCount)), "units");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class EphemerisBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		EphemerisBenchmark() = delete;
+		EphemerisBenchmark(const EphemerisBenchmark&) = delete;
+		EphemerisBenchmark& operator=(const EphemerisBenchmark&) = delete;
+		EphemerisBenchmark(EphemerisBenchmark&&) = delete;
+		EphemerisBenchmark& operator=(EphemerisBenchmark&&) = delete;
+		~EphemerisBenchmark() = default;
+	};
+}
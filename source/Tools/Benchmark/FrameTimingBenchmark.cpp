@@ -0,0 +1,128 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+
+namespace Benchmark
+{
+	namespace
+	{
+		const double FrameRate = 240.0;
+		const double FrameTimeNoise = 500e-6;
+		const float OrbitRadius = 100.0f;
+		const float RevolutionRate = XM_PI / 365.0f;
+		const double MaxPreciseStepError = 1e-6;
+
+		struct JitterResult
+		{
+			double RmsStepError;
+			double MaxStepError;
+			double FinalPositionError;
+			nanoseconds TotalTimeError;
+		};
+
+		// Feeds the frame times to a game clock as counter values and advances a body around a circular orbit by the elapsed
+		// time read back through the given accessor, comparing every frame's movement against that over the true frame time
+		JitterResult MeasureJitter(const vector<nanoseconds>& frameTimes, const function<float(const GameTime&)>& elapsedSeconds)
+		{
+			const high_resolution_clock::time_point startTime;
+			high_resolution_clock::time_point counter = startTime;
+			GameClock gameClock;
+			gameClock.Reset(startTime);
+
+			GameTime gameTime;
+			double angle = 0.0;
+			double trueAngle = 0.0;
+			double sumSquaredError = 0.0;
+			double maxError = 0.0;
+
+			for (const auto& frameTime : frameTimes)
+			{
+				counter += duration_cast<high_resolution_clock::duration>(frameTime);
+				gameClock.UpdateGameTime(gameTime, counter);
+
+				const float step = RevolutionRate * elapsedSeconds(gameTime);
+				const double trueStep = RevolutionRate * duration<double>(frameTime).count();
+				angle += step;
+				trueAngle += trueStep;
+
+				const double error = fabs(step - trueStep) / trueStep;
+				sumSquaredError += error * error;
+				maxError = max(maxError, error);
+			}
+
+			const double finalError = OrbitRadius * 2.0 * fabs(sin((angle - trueAngle) * 0.5));
+			const nanoseconds totalTimeError = gameTime.TotalGameTimeNanoseconds() - duration_cast<nanoseconds>(counter - startTime);
+			return { sqrt(sumSquaredError / max<size_t>(1, frameTimes.size())), maxError, finalError, totalTimeError };
+		}
+
+		// Fixed steps taken over the same frames; the time they cover must trail the clock by less than one step, since
+		// no frame is long enough to hit the catch-up limit
+		nanoseconds MeasureFixedStepDrift(const vector<nanoseconds>& frameTimes, uint32_t& stepCount)
+		{
+			const high_resolution_clock::time_point startTime;
+			high_resolution_clock::time_point counter = startTime;
+			GameClock gameClock;
+			gameClock.Reset(startTime);
+			gameClock.SetFixedTimeStepEnabled(true);
+
+			GameTime gameTime;
+			stepCount = 0;
+			for (const auto& frameTime : frameTimes)
+			{
+				counter += duration_cast<high_resolution_clock::duration>(frameTime);
+				gameClock.UpdateGameTime(gameTime, counter);
+				while (gameClock.StepFixedGameTime(gameTime))
+				{
+					++stepCount;
+				}
+			}
+
+			return duration_cast<nanoseconds>(counter - startTime) - gameClock.FixedTimeStep() * stepCount;
+		}
+	}
+
+	void FrameTimingBenchmark::Run(uint32_t frameCount)
+	{
+		// Frame times around 240 FPS, with a little scheduling noise as a real present interval has
+		mt19937 generator(12345);
+		uniform_real_distribution<double> noiseDistribution(-FrameTimeNoise, FrameTimeNoise);
+		vector<nanoseconds> frameTimes(frameCount);
+		for (auto& frameTime : frameTimes)
+		{
+			frameTime = duration_cast<nanoseconds>(duration<double>(1.0 / FrameRate + noiseDistribution(generator)));
+		}
+
+		cout << "Frame timing: " << frameCount << " frames at " << FrameRate << " FPS, orbit radius " << OrbitRadius << endl;
+
+		// Both read the same clock; the millisecond accessor is what callers saw before elapsed time was kept in nanoseconds
+		const JitterResult truncated = MeasureJitter(frameTimes, [](const GameTime& gameTime) { return duration_cast<duration<float>>(gameTime.ElapsedGameTime()).count(); });
+		BenchmarkHelper::ReportValue("Milliseconds: RMS step error", truncated.RmsStepError * 100.0, "%");
+		BenchmarkHelper::ReportValue("  max step error", truncated.MaxStepError * 100.0, "%");
+		BenchmarkHelper::ReportValue("  final position error", truncated.FinalPositionError, "units");
+
+		const JitterResult precise = MeasureJitter(frameTimes, [](const GameTime& gameTime) { return gameTime.ElapsedGameTimeSeconds().count(); });
+		BenchmarkHelper::ReportValue("Nanoseconds: RMS step error", precise.RmsStepError * 100.0, "%");
+		BenchmarkHelper::ReportValue("  max step error", precise.MaxStepError * 100.0, "%");
+		BenchmarkHelper::ReportValue("  final position error", precise.FinalPositionError, "units");
+		BenchmarkHelper::ReportValue("  total time error", static_cast<double>(precise.TotalTimeError.count()), "ns");
+
+		uint32_t stepCount;
+		const nanoseconds drift = MeasureFixedStepDrift(frameTimes, stepCount);
+		BenchmarkHelper::ReportValue("Fixed steps: steps per frame", static_cast<double>(stepCount) / max(1U, frameCount), "");
+		BenchmarkHelper::ReportValue("  time not yet stepped", static_cast<double>(drift.count()), "ns");
+
+		// A float holds a frame time to about one part in ten million, so anything much worse means the clock lost precision
+		if (precise.TotalTimeError != nanoseconds::zero() || precise.MaxStepError > MaxPreciseStepError)
+		{
+			throw exception("The game clock's elapsed time does not match the counter.");
+		}
+
+		if (drift < nanoseconds::zero() || drift >= GameClock::DefaultFixedTimeStep)
+		{
+			throw exception("The game clock's fixed steps drifted from the counter.");
+		}
+	}
+}
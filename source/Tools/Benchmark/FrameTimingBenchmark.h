@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class FrameTimingBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t frameCount);
+
+		FrameTimingBenchmark() = delete;
+		FrameTimingBenchmark(const FrameTimingBenchmark&) = delete;
+		FrameTimingBenchmark& operator=(const FrameTimingBenchmark&) = delete;
+		FrameTimingBenchmark(FrameTimingBenchmark&&) = delete;
+		FrameTimingBenchmark& operator=(FrameTimingBenchmark&&) = delete;
+		~FrameTimingBenchmark() = default;
+	};
+}
@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "FrustumCullingKernel.h"
+#include "CelestialBodyStore.h"
+#include "Frustum.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	void FrustumCullingBenchmark::Run(uint32_t bodyCount)
+	{
+		mt19937 generator(12345);
+		uniform_real_distribution<float> rateDistribution(-1.0f, 1.0f);
+		uniform_real_distribution<float> tiltDistribution(0.0f, XM_PI);
+		uniform_real_distribution<float> scaleDistribution(0.01f, 20.0f);
+		uniform_real_distribution<float> orbitDistribution(5.0f, 20000.0f);
+
+		CelestialBodyStore store;
+		store.Reserve(bodyCount);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			store.Add(rateDistribution(generator), tiltDistribution(generator), orbitDistribution(generator), scaleDistribution(generator), rateDistribution(generator), CelestialBodyStore::NoParent, true);
+		}
+
+		store.Update(1.0f / 60.0f);
+		store.Update(1.0f / 60.0f);
+
+		// The default camera, looking in at the Sun from the edge of the inner system
+		const Frustum frustum(XMMatrixLookAtLH(XMVectorSet(0.0f, 2.5f, 500.0f, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) * XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.01f, 100000.0f));
+		const FrustumCullingInputs inputs = { store.PreviousWorldMatrices(), store.WorldMatrices(), store.Scales(), 1.0f, 0.5f };
+		vector<uint32_t> scalarVisible(bodyCount);
+		vector<uint32_t> vectorVisible(bodyCount);
+		const uint32_t iterations = max(1U, 10000000U / max(1U, bodyCount));
+
+		cout << "Frustum culling: " << bodyCount << " bodies, " << iterations << " iterations" << endl;
+
+		uint32_t scalarCount = 0;
+		const double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { scalarCount = FrustumCullingKernel::CullScalar(frustum, inputs, 0, bodyCount, scalarVisible.data()); });
+		BenchmarkHelper::ReportThroughput("Scalar", bodyCount / seconds, "bodies");
+
+		uint32_t vectorCount = 0;
+		const double vectorSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { vectorCount = FrustumCullingKernel::Cull(frustum, inputs, 0, bodyCount, vectorVisible.data()); });
+		BenchmarkHelper::ReportThroughput("XMVECTOR (4 wide)", bodyCount / vectorSeconds, "bodies");
+		BenchmarkHelper::ReportValue("  speed-up", seconds / vectorSeconds, "x");
+		BenchmarkHelper::ReportValue("  culled", 100.0 * (bodyCount - vectorCount) / max(1U, bodyCount), "%");
+
+		// Both paths must keep the same bodies, in the same order
+		const bool matches = (scalarCount == vectorCount && equal(scalarVisible.begin(), scalarVisible.begin() + scalarCount, vectorVisible.begin()));
+		BenchmarkHelper::ReportValue("  mismatches", (matches ? 0 : 1), "");
+	}
+}
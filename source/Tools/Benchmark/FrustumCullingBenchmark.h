@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class FrustumCullingBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		FrustumCullingBenchmark() = delete;
+		FrustumCullingBenchmark(const FrustumCullingBenchmark&) = delete;
+		FrustumCullingBenchmark& operator=(const FrustumCullingBenchmark&) = delete;
+		FrustumCullingBenchmark(FrustumCullingBenchmark&&) = delete;
+		FrustumCullingBenchmark& operator=(FrustumCullingBenchmark&&) = delete;
+		~FrustumCullingBenchmark() = default;
+	};
+}
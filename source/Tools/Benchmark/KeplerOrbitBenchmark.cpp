@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "KeplerOrbitKernel.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		// Converged double-precision Newton solution, as the accuracy reference for the fixed-iteration solver
+		double ReferenceEccentricAnomaly(double meanAnomaly, double eccentricity)
+		{
+			double anomaly = meanAnomaly + (meanAnomaly < 0.0 ? -0.85 : 0.85) * eccentricity;
+			for (uint32_t i = 0; i < 100; ++i)
+			{
+				const double step = (anomaly - eccentricity * sin(anomaly) - meanAnomaly) / (1.0 - eccentricity * cos(anomaly));
+				anomaly -= step;
+				if (fabs(step) < 1e-15)
+				{
+					break;
+				}
+			}
+
+			return anomaly;
+		}
+
+		float MaxPositionError(const KeplerOrbitInputs& inputs, const AlignedVector<XMFLOAT4X4>& results)
+		{
+			float maxError = 0.0f;
+			for (size_t i = 0; i < results.size(); ++i)
+			{
+				const double eccentricAnomaly = ReferenceEccentricAnomaly(XMScalarModAngle(inputs.MeanAnomalies[i]), inputs.Eccentricities[i]);
+				const double x = cos(eccentricAnomaly) - inputs.Eccentricities[i];
+				const double y = sin(eccentricAnomaly);
+
+				const double errorX = results[i]._41 - (inputs.MajorAxesX[i] * x + inputs.MinorAxesX[i] * y);
+				const double errorY = results[i]._42 - (inputs.MajorAxesY[i] * x + inputs.MinorAxesY[i] * y);
+				const double errorZ = results[i]._43 - (inputs.MajorAxesZ[i] * x + inputs.MinorAxesZ[i] * y);
+				maxError = max(maxError, static_cast<float>(sqrt(errorX * errorX + errorY * errorY + errorZ * errorZ)));
+			}
+
+			return maxError;
+		}
+	}
+
+	void KeplerOrbitBenchmark::Run(uint32_t bodyCount)
+	{
+		AlignedVector<float> meanAnomalies(bodyCount);
+		AlignedVector<float> eccentricities(bodyCount);
+		AlignedVector<float> majorAxesX(bodyCount);
+		AlignedVector<float> majorAxesY(bodyCount);
+		AlignedVector<float> majorAxesZ(bodyCount);
+		AlignedVector<float> minorAxesX(bodyCount);
+		AlignedVector<float> minorAxesY(bodyCount);
+		AlignedVector<float> minorAxesZ(bodyCount);
+
+		// Unit semi-major axes, so the position error reads as a fraction of the orbit size
+		mt19937 generator(12345);
+		uniform_real_distribution<float> angleDistribution(-XM_2PI, XM_2PI);
+		uniform_real_distribution<float> eccentricityDistribution(0.0f, 0.99f);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			const OrbitalElements orbit = { 1.0f, eccentricityDistribution(generator), angleDistribution(generator), angleDistribution(generator), angleDistribution(generator), angleDistribution(generator), 0.0f };
+
+			XMFLOAT3 majorAxis, minorAxis;
+			KeplerOrbitKernel::OrbitAxes(orbit, majorAxis, minorAxis);
+
+			meanAnomalies[i] = orbit.MeanAnomalyAtEpoch;
+			eccentricities[i] = orbit.Eccentricity;
+			majorAxesX[i] = majorAxis.x;
+			majorAxesY[i] = majorAxis.y;
+			majorAxesZ[i] = majorAxis.z;
+			minorAxesX[i] = minorAxis.x;
+			minorAxesY[i] = minorAxis.y;
+			minorAxesZ[i] = minorAxis.z;
+		}
+
+		const KeplerOrbitInputs inputs = { meanAnomalies.data(), eccentricities.data(), majorAxesX.data(), majorAxesY.data(), majorAxesZ.data(), minorAxesX.data(), minorAxesY.data(), minorAxesZ.data() };
+		AlignedVector<XMFLOAT4X4> results(bodyCount);
+		const uint32_t iterations = max(1U, 10000000U / max(1U, bodyCount));
+
+		cout << "Kepler orbits: " << bodyCount << " bodies, " << iterations << " iterations, " << KeplerOrbitKernel::SolverIterations << " solver iterations" << endl;
+
+		double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { KeplerOrbitKernel::ComputeScalar(inputs, 0, bodyCount, results.data()); });
+		BenchmarkHelper::ReportThroughput("Scalar", bodyCount / seconds, "bodies");
+		BenchmarkHelper::ReportValue("  max position error", MaxPositionError(inputs, results), "a");
+
+		seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { KeplerOrbitKernel::Compute(inputs, 0, bodyCount, results.data()); });
+		BenchmarkHelper::ReportThroughput("XMVECTOR (4 wide)", bodyCount / seconds, "bodies");
+		BenchmarkHelper::ReportValue("  max position error", MaxPositionError(inputs, results), "a");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class KeplerOrbitBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		KeplerOrbitBenchmark() = delete;
+		KeplerOrbitBenchmark(const KeplerOrbitBenchmark&) = delete;
+		KeplerOrbitBenchmark& operator=(const KeplerOrbitBenchmark&) = delete;
+		KeplerOrbitBenchmark(KeplerOrbitBenchmark&&) = delete;
+		KeplerOrbitBenchmark& operator=(KeplerOrbitBenchmark&&) = delete;
+		~KeplerOrbitBenchmark() = default;
+	};
+}
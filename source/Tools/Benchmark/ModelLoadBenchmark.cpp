@@ -0,0 +1,211 @@
+#include "pch.h"
+#include "Model.h"
+#include "Mesh.h"
+#include "ModelMaterial.h"
+#include "ModelFile.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace Benchmark
+{
+	namespace
+	{
+		const uint32_t Iterations = 5;
+		const string StreamFilename = "ModelLoadStream.bin";
+		const string MappedFilename = "ModelLoadMapped.bin";
+
+		// A mesh with everything the model pipeline writes for a body: positions, normals, tangents, binormals, one set of
+		// texture coordinates and two triangles per vertex
+		void CreateMesh(Model& model, uint32_t vertexCount)
+		{
+			mt19937 generator(12345);
+			uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+			uniform_int_distribution<uint32_t> indexDistribution(0, max(vertexCount, 1U) - 1);
+			auto randomVector = [&]() { return XMFLOAT3(distribution(generator), distribution(generator), distribution(generator)); };
+
+			MeshData meshData;
+			meshData.Name = "Benchmark";
+			meshData.TextureCoordinates.push_back(new vector<XMFLOAT3>());
+			for (uint32_t i = 0; i < vertexCount; ++i)
+			{
+				meshData.Vertices.push_back(randomVector());
+				meshData.Normals.push_back(randomVector());
+				meshData.Tangents.push_back(randomVector());
+				meshData.BiNormals.push_back(randomVector());
+				meshData.TextureCoordinates[0]->push_back(randomVector());
+			}
+
+			meshData.FaceCount = vertexCount * 2;
+			meshData.Indices.resize(meshData.FaceCount * 3);
+			for (uint32_t& index : meshData.Indices)
+			{
+				index = indexDistribution(generator);
+			}
+
+			model.Data().Meshes.push_back(make_shared<Mesh>(model, move(meshData)));
+		}
+
+		// How Mesh::Load read the stream layout before it had bulk reads: one stream call per component
+		void ReadComponents(InputStreamHelper& streamHelper, vector<XMFLOAT3>& values)
+		{
+			uint32_t count;
+			streamHelper >> count;
+			values.clear();
+			values.reserve(count);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				XMFLOAT3 value;
+				streamHelper >> value.x >> value.y >> value.z;
+				values.push_back(value);
+			}
+		}
+
+		void ReadComponents(InputStreamHelper& streamHelper, vector<uint32_t>& values)
+		{
+			uint32_t count;
+			streamHelper >> count;
+			values.clear();
+			values.reserve(count);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				uint32_t value;
+				streamHelper >> value;
+				values.push_back(value);
+			}
+		}
+
+		// Reads the one material-less mesh CreateMesh makes, as the stream layout stores it
+		void LoadComponentwise(const string& filename, MeshData& meshData)
+		{
+			ifstream file(filename.c_str(), ios::binary);
+			InputStreamHelper streamHelper(file);
+
+			uint32_t materialCount;
+			uint32_t meshCount;
+			string materialName;
+			streamHelper >> materialCount >> meshCount >> materialName >> meshData.Name;
+			assert(materialCount == 0 && meshCount == 1);
+
+			ReadComponents(streamHelper, meshData.Vertices);
+			ReadComponents(streamHelper, meshData.Normals);
+			ReadComponents(streamHelper, meshData.Tangents);
+			ReadComponents(streamHelper, meshData.BiNormals);
+
+			uint32_t textureCoordinateCount;
+			streamHelper >> textureCoordinateCount;
+			for (uint32_t i = 0; i < textureCoordinateCount; ++i)
+			{
+				unique_ptr<vector<XMFLOAT3>> uvs = make_unique<vector<XMFLOAT3>>();
+				ReadComponents(streamHelper, *uvs);
+				meshData.TextureCoordinates.push_back(uvs.release());
+			}
+
+			uint32_t vertexColorCount;
+			streamHelper >> vertexColorCount;
+			assert(vertexColorCount == 0);
+
+			streamHelper >> meshData.FaceCount;
+			ReadComponents(streamHelper, meshData.Indices);
+		}
+
+		// Every timed load is followed by one pass over the positions, so a mapped file pays for the pages it reads
+		float SumPositions(const ArraySpan<XMFLOAT3>& vertices)
+		{
+			float sum = 0.0f;
+			for (const XMFLOAT3& vertex : vertices)
+			{
+				sum += vertex.x;
+			}
+
+			return sum;
+		}
+
+		bool SameContents(const MeshSpans& lhs, const MeshSpans& rhs)
+		{
+			auto same = [](const auto& left, const auto& right)
+			{
+				return (left.Size() == right.Size() && equal(left.begin(), left.end(), right.begin(), [](const auto& a, const auto& b) { return memcmp(&a, &b, sizeof(a)) == 0; }));
+			};
+
+			return same(lhs.Vertices, rhs.Vertices) && same(lhs.Normals, rhs.Normals) && same(lhs.Tangents, rhs.Tangents) && same(lhs.BiNormals, rhs.BiNormals) &&
+				lhs.TextureCoordinates.size() == rhs.TextureCoordinates.size() && same(lhs.TextureCoordinates[0], rhs.TextureCoordinates[0]) && same(lhs.Indices, rhs.Indices);
+		}
+	}
+
+	void ModelLoadBenchmark::Run(uint32_t vertexCount)
+	{
+		Model source;
+		CreateMesh(source, vertexCount);
+		const MeshSpans& sourceSpans = source.Meshes().front()->Spans();
+
+		// The same mesh in the legacy stream layout and in the mapped layout
+		{
+			ofstream file(StreamFilename.c_str(), ios::binary);
+			source.Save(file);
+		}
+		source.Save(MappedFilename);
+
+		ifstream streamFile(StreamFilename.c_str(), ios::binary | ios::ate);
+		ifstream mappedFile(MappedFilename.c_str(), ios::binary | ios::ate);
+		const double streamMegabytes = static_cast<double>(streamFile.tellg()) / (1024.0 * 1024.0);
+		const double mappedMegabytes = static_cast<double>(mappedFile.tellg()) / (1024.0 * 1024.0);
+		streamFile.close();
+		mappedFile.close();
+
+		cout << "Model load: " << vertexCount << " vertices, " << sourceSpans.Indices.Size() << " indices, " << Iterations << " iterations" << endl;
+
+		// The files are read back from the file cache, so this measures the parsing and copying rather than the disk
+		const float expectedSum = SumPositions(sourceSpans.Vertices);
+		uint32_t mismatches = 0;
+		const double componentSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]()
+		{
+			Model model;
+			MeshData meshData;
+			LoadComponentwise(StreamFilename, meshData);
+			Mesh mesh(model, move(meshData));
+			mismatches += (SumPositions(mesh.Spans().Vertices) == expectedSum ? 0 : 1);
+		});
+
+		const double bulkSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]()
+		{
+			Model model(StreamFilename);
+			mismatches += (SumPositions(model.Meshes().front()->Spans().Vertices) == expectedSum ? 0 : 1);
+		});
+
+		const double mappedSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]()
+		{
+			Model model(MappedFilename);
+			mismatches += (SumPositions(model.Meshes().front()->Spans().Vertices) == expectedSum ? 0 : 1);
+		});
+
+		// Outside the timing, every stream of every loader is checked against the mesh that was saved
+		{
+			Model componentModel;
+			MeshData meshData;
+			LoadComponentwise(StreamFilename, meshData);
+			Mesh componentMesh(componentModel, move(meshData));
+			Model bulkModel(StreamFilename);
+			Model mappedModel(MappedFilename);
+			mismatches += (SameContents(sourceSpans, componentMesh.Spans()) ? 0 : 1);
+			mismatches += (SameContents(sourceSpans, bulkModel.Meshes().front()->Spans()) ? 0 : 1);
+			mismatches += (mappedModel.Meshes().front()->IsMapped() && SameContents(sourceSpans, mappedModel.Meshes().front()->Spans()) ? 0 : 1);
+		}
+
+		BenchmarkHelper::ReportThroughput("Load (per component)", streamMegabytes / componentSeconds, "MB");
+		BenchmarkHelper::ReportThroughput("Load (bulk stream)", streamMegabytes / bulkSeconds, "MB");
+		BenchmarkHelper::ReportThroughput("Load (mapped)", mappedMegabytes / mappedSeconds, "MB");
+		BenchmarkHelper::ReportValue("  per component", componentSeconds * 1000.0, "ms");
+		BenchmarkHelper::ReportValue("  bulk stream", bulkSeconds * 1000.0, "ms");
+		BenchmarkHelper::ReportValue("  mapped", mappedSeconds * 1000.0, "ms");
+		BenchmarkHelper::ReportValue("  bulk speedup", componentSeconds / bulkSeconds, "x");
+		BenchmarkHelper::ReportValue("  mapped speedup", componentSeconds / mappedSeconds, "x");
+		BenchmarkHelper::ReportValue("  stream file", streamMegabytes, "MB");
+		BenchmarkHelper::ReportValue("  mapped file", mappedMegabytes, "MB");
+		BenchmarkHelper::ReportValue("  mismatches", mismatches, "");
+
+		remove(StreamFilename.c_str());
+		remove(MappedFilename.c_str());
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class ModelLoadBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t vertexCount);
+
+		ModelLoadBenchmark() = delete;
+		ModelLoadBenchmark(const ModelLoadBenchmark&) = delete;
+		ModelLoadBenchmark& operator=(const ModelLoadBenchmark&) = delete;
+		ModelLoadBenchmark(ModelLoadBenchmark&&) = delete;
+		ModelLoadBenchmark& operator=(ModelLoadBenchmark&&) = delete;
+		~ModelLoadBenchmark() = default;
+	};
+}
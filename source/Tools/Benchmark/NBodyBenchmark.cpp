@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "NBodySimulation.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		const uint32_t AccuracySampleCount = 256;
+
+		// A heavy central body inside a thin disc of light particles on circular orbits
+		void PopulateDisc(NBodySimulation& simulation, uint32_t particleCount)
+		{
+			mt19937 generator(12345);
+			uniform_real_distribution<float> angleDistribution(0.0f, XM_2PI);
+			uniform_real_distribution<float> radiusDistribution(1.0f, 10.0f);
+			uniform_real_distribution<float> heightDistribution(-0.05f, 0.05f);
+
+			const float centralMass = 1.0f;
+			const float particleMass = 1e-3f / max(1U, particleCount);
+			simulation.Reserve(particleCount + 1);
+			simulation.Add(centralMass, XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+			for (uint32_t i = 0; i < particleCount; ++i)
+			{
+				const float angle = angleDistribution(generator);
+				const float radius = radiusDistribution(generator);
+				const float speed = sqrtf(simulation.GravitationalConstant() * centralMass / radius);
+				simulation.Add(particleMass, XMFLOAT3(radius * cosf(angle), heightDistribution(generator), -radius * sinf(angle)), XMFLOAT3(-speed * sinf(angle), 0.0f, -speed * cosf(angle)));
+			}
+
+			simulation.RemoveNetMomentum();
+		}
+
+		// Relative error of the accelerations the last step left behind against a direct O(N^2) sum, over an evenly spaced
+		// sample of particles
+		float MaxRelativeError(const NBodySimulation& simulation)
+		{
+			const uint32_t count = simulation.Size();
+			const float softeningSquared = simulation.Softening() * simulation.Softening();
+			const double gravitationalConstant = simulation.GravitationalConstant();
+			const uint32_t stride = max(1U, count / AccuracySampleCount);
+
+			float maxError = 0.0f;
+			for (uint32_t i = 0; i < count; i += stride)
+			{
+				const XMFLOAT3 position = simulation.Position(i);
+				const XMFLOAT3 approximate = simulation.Acceleration(i);
+
+				double exactX = 0.0, exactY = 0.0, exactZ = 0.0;
+				for (uint32_t j = 0; j < count; ++j)
+				{
+					if (j == i)
+					{
+						continue;
+					}
+
+					const XMFLOAT3 other = simulation.Position(j);
+					const double dx = other.x - position.x;
+					const double dy = other.y - position.y;
+					const double dz = other.z - position.z;
+					const double inverseDistance = 1.0 / sqrt(dx * dx + dy * dy + dz * dz + softeningSquared);
+					const double strength = gravitationalConstant * simulation.Mass(j) * inverseDistance * inverseDistance * inverseDistance;
+					exactX += strength * dx;
+					exactY += strength * dy;
+					exactZ += strength * dz;
+				}
+
+				const double errorX = approximate.x - exactX;
+				const double errorY = approximate.y - exactY;
+				const double errorZ = approximate.z - exactZ;
+				const double exactLength = sqrt(exactX * exactX + exactY * exactY + exactZ * exactZ);
+				if (exactLength > 0.0)
+				{
+					maxError = max(maxError, static_cast<float>(sqrt(errorX * errorX + errorY * errorY + errorZ * errorZ) / exactLength));
+				}
+			}
+
+			return maxError;
+		}
+	}
+
+	void NBodyBenchmark::Run(uint32_t particleCount)
+	{
+		JobSystem jobSystem;
+		NBodySimulation simulation;
+		PopulateDisc(simulation, particleCount);
+
+		const float timeStep = 1.0f / 120.0f;
+		const uint32_t iterations = max(1U, 1000000U / max(1U, particleCount));
+
+		cout << "N-body: " << simulation.Size() << " particles, " << iterations << " steps, " << jobSystem.ThreadCount() << " threads, opening angle " << simulation.OpeningAngle() << endl;
+
+		double seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { simulation.Step(timeStep, jobSystem); });
+		BenchmarkHelper::ReportThroughput("Leapfrog step (Barnes-Hut)", simulation.Size() / seconds, "particles");
+		BenchmarkHelper::ReportValue("  step time", seconds * 1000.0, "ms");
+		BenchmarkHelper::ReportValue("  steps per second", 1.0 / seconds, "");
+		BenchmarkHelper::ReportValue("  tree nodes", simulation.Tree().NodeCount(), "");
+		BenchmarkHelper::ReportValue("  body groups", simulation.Tree().GroupCount(), "");
+		BenchmarkHelper::ReportValue("  max relative force error", MaxRelativeError(simulation), "");
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class NBodyBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		NBodyBenchmark() = delete;
+		NBodyBenchmark(const NBodyBenchmark&) = delete;
+		NBodyBenchmark& operator=(const NBodyBenchmark&) = delete;
+		NBodyBenchmark(NBodyBenchmark&&) = delete;
+		NBodyBenchmark& operator=(NBodyBenchmark&&) = delete;
+		~NBodyBenchmark() = default;
+	};
+}
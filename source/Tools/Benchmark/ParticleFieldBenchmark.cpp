@@ -0,0 +1,69 @@
+#include "pch.h"
+#include "ParticleField.h"
+#include "CelestialBodyStore.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		float MaxPositionDifference(const AlignedVector<ParticleInstance>& first, const AlignedVector<ParticleInstance>& second)
+		{
+			float maxDifference = 0.0f;
+			for (size_t i = 0; i < first.size(); ++i)
+			{
+				maxDifference = max(maxDifference, fabsf(first[i].Position.x - second[i].Position.x));
+				maxDifference = max(maxDifference, fabsf(first[i].Position.y - second[i].Position.y));
+				maxDifference = max(maxDifference, fabsf(first[i].Position.z - second[i].Position.z));
+			}
+
+			return maxDifference;
+		}
+	}
+
+	void ParticleFieldBenchmark::Run(uint32_t particleCount)
+	{
+		// A tilted belt the size of the scene's main belt
+		const ParticleFieldDescription description = { particleCount, CelestialBodyStore::NoParent, 1100.0f, 1650.0f, 50.0f, 0.1f, 0.02f, 0.12f, 0.0026f, 1801 };
+		const XMFLOAT3 center(0.0f, 0.0f, 0.0f);
+
+		unique_ptr<ParticleField> field;
+		double seconds = BenchmarkHelper::MeasureSeconds(1, [&]() { field = make_unique<ParticleField>(description); });
+
+		JobSystem jobSystem;
+		AlignedVector<ParticleInstance> scalarInstances(particleCount);
+		AlignedVector<ParticleInstance> vectorInstances(particleCount);
+		AlignedVector<ParticleInstance> parallelInstances(particleCount);
+		const double frameSeconds = 1.0 / 60.0;
+		const uint32_t iterations = max(1U, 10000000U / max(1U, particleCount));
+
+		cout << "Particle field: " << particleCount << " particles, " << sizeof(ParticleInstance) * particleCount / 1024 << " KB of instances, " << iterations << " iterations, " << jobSystem.ThreadCount() << " threads" << endl;
+		BenchmarkHelper::ReportThroughput("Generate", particleCount / seconds, "particles");
+
+		// Each iteration is a frame later, as it would be when drawn
+		double time = 0.0;
+		seconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { field->EvaluateScalar(time, center, scalarInstances.data()); time += frameSeconds; });
+		BenchmarkHelper::ReportThroughput("Scalar", particleCount / seconds, "particles");
+
+		time = 0.0;
+		const double vectorSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { field->Evaluate(time, center, vectorInstances.data()); time += frameSeconds; });
+		BenchmarkHelper::ReportThroughput("XMVECTOR (4 wide)", particleCount / vectorSeconds, "particles");
+		BenchmarkHelper::ReportValue("  speed-up", seconds / vectorSeconds, "x");
+		BenchmarkHelper::ReportValue("  max difference", MaxPositionDifference(scalarInstances, vectorInstances), "");
+
+		time = 0.0;
+		const double parallelSeconds = BenchmarkHelper::MeasureSeconds(iterations, [&]() { field->Evaluate(time, center, parallelInstances.data(), jobSystem); time += frameSeconds; });
+		BenchmarkHelper::ReportThroughput("XMVECTOR + job system", particleCount / parallelSeconds, "particles");
+		BenchmarkHelper::ReportValue("  speed-up", seconds / parallelSeconds, "x");
+		BenchmarkHelper::ReportValue("  max difference", MaxPositionDifference(scalarInstances, parallelInstances), "");
+
+		// Far from the epoch the phases are rebased in double precision first, so a warp costs one slow frame
+		const double warpTime = 1000.0 * 365.25 * 24.0 * 3600.0;
+		const double warpSeconds = BenchmarkHelper::MeasureSeconds(1, [&]() { field->Evaluate(warpTime, center, vectorInstances.data()); });
+		BenchmarkHelper::ReportValue("  warp 1000 years", warpSeconds * 1000.0, "ms");
+	}
+}
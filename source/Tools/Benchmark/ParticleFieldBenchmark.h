@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class ParticleFieldBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t particleCount);
+
+		ParticleFieldBenchmark() = delete;
+		ParticleFieldBenchmark(const ParticleFieldBenchmark&) = delete;
+		ParticleFieldBenchmark& operator=(const ParticleFieldBenchmark&) = delete;
+		ParticleFieldBenchmark(ParticleFieldBenchmark&&) = delete;
+		ParticleFieldBenchmark& operator=(ParticleFieldBenchmark&&) = delete;
+		~ParticleFieldBenchmark() = default;
+	};
+}
@@ -0,0 +1,79 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Benchmark;
+
+namespace
+{
+	const uint32_t DefaultCount = 100000;
+
+	const map<string, function<void(uint32_t)>> Benchmarks =
+	{
+		{ "transforms", BodyTransformBenchmark::Run },
+		{ "updates", BodyUpdateBenchmark::Run },
+		{ "kepler", KeplerOrbitBenchmark::Run },
+		{ "nbody", NBodyBenchmark::Run },
+		{ "timing", FrameTimingBenchmark::Run },
+		{ "ephemeris", EphemerisBenchmark::Run },
+		{ "scene", SceneBenchmark::Run },
+		{ "particles", ParticleFieldBenchmark::Run },
+		{ "instances", BodyInstanceBenchmark::Run },
+		{ "culling", FrustumCullingBenchmark::Run },
+		{ "lod", BodyLodBenchmark::Run },
+		{ "constants", ConstantRingBenchmark::Run },
+		{ "recording", CommandRecordingBenchmark::Run },
+		{ "raster", SoftwareRenderBenchmark::Run },
+		{ "models", ModelLoadBenchmark::Run },
+		{ "compact", CompactVertexBenchmark::Run }
+	};
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(DEBUG) | defined(_DEBUG)
+	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+	try
+	{
+		if (argc < 2)
+		{
+			string usage = "Usage: Benchmark <name|all> [count]\nBenchmarks:";
+			for (const auto& benchmark : Benchmarks)
+			{
+				usage += " " + benchmark.first;
+			}
+
+			throw exception(usage.c_str());
+		}
+
+		string name = argv[1];
+		uint32_t count = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : DefaultCount);
+
+		if (name == "all")
+		{
+			for (const auto& benchmark : Benchmarks)
+			{
+				benchmark.second(count);
+				cout << endl;
+			}
+		}
+		else
+		{
+			auto benchmark = Benchmarks.find(name);
+			if (benchmark == Benchmarks.end())
+			{
+				throw exception(("Unknown benchmark: " + name).c_str());
+			}
+
+			benchmark->second(count);
+		}
+	}
+	catch (exception ex)
+	{
+		cout << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "CelestialBodyStore.h"
+#include "SolarSystemScene.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace Benchmark
+{
+	namespace
+	{
+		const wstring CatalogFilename = L"SceneBenchmark.scene";
+		const uint32_t Iterations = 5;
+
+		// The built-in bodies followed by a minor-planet catalog: eccentric, inclined orbits around the Sun and the odd Jupiter moon
+		vector<BodyDescription> CreateCatalog(uint32_t minorPlanetCount)
+		{
+			vector<BodyDescription> bodies = SolarSystemScene::Bodies();
+			const uint32_t sun = SolarSystemScene::FindBody(bodies, "Sun");
+			const uint32_t jupiter = SolarSystemScene::FindBody(bodies, "Jupiter");
+
+			mt19937 generator(12345);
+			uniform_real_distribution<float> angleDistribution(0.0f, XM_2PI);
+			uniform_real_distribution<float> distanceDistribution(1000.0f, 2500.0f);
+			uniform_real_distribution<float> eccentricityDistribution(0.0f, 0.3f);
+			uniform_real_distribution<float> inclinationDistribution(0.0f, 0.5f);
+
+			bodies.reserve(bodies.size() + minorPlanetCount);
+			for (uint32_t i = 0; i < minorPlanetCount; ++i)
+			{
+				BodyDescription body;
+				body.Name = "MinorPlanet" + to_string(i);
+				body.RotationRate = angleDistribution(generator);
+				body.AxialTilt = angleDistribution(generator);
+				body.OrbitalDistance = 0.0f;
+				body.Scale = 0.01f;
+				body.RevolutionRate = 0.0f;
+				body.Motion = MotionModel::Keplerian;
+				body.Parent = (i % 100 == 0 ? jupiter : sun);
+				body.IsLit = true;
+				body.Mass = 1e-9f;
+
+				const float semiMajorAxis = (body.Parent == jupiter ? distanceDistribution(generator) / 10.0f : distanceDistribution(generator));
+				body.Orbit = { semiMajorAxis, eccentricityDistribution(generator), inclinationDistribution(generator), angleDistribution(generator), angleDistribution(generator), angleDistribution(generator), 1000.0f / (semiMajorAxis * sqrtf(semiMajorAxis)) };
+				bodies.push_back(move(body));
+			}
+
+			return bodies;
+		}
+	}
+
+	void SceneBenchmark::Run(uint32_t count)
+	{
+		const vector<BodyDescription> catalog = CreateCatalog(count);
+		SolarSystemScene::Save(CatalogFilename, catalog);
+
+		cout << "Scene: " << catalog.size() << " bodies, " << Iterations << " iterations" << endl;
+
+		vector<BodyDescription> bodies;
+		const double loadSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]() { bodies = SolarSystemScene::Load(CatalogFilename); });
+		BenchmarkHelper::ReportThroughput("Load scene", bodies.size() / loadSeconds, "bodies");
+		BenchmarkHelper::ReportValue("  load time", loadSeconds * 1000.0, "ms");
+
+		const double populateSeconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]() { CelestialBodyStore store; SolarSystemScene::Populate(store, bodies); });
+		BenchmarkHelper::ReportValue("  populate time", populateSeconds * 1000.0, "ms");
+
+		// Every field must come back exactly, or a saved scene would drift from the one it was saved from
+		uint32_t mismatchCount = 0;
+		for (size_t body = 0; body < bodies.size(); ++body)
+		{
+			const BodyDescription& expected = catalog[body];
+			const BodyDescription& actual = bodies[body];
+			const bool matches = (actual.Name == expected.Name && actual.Texture == expected.Texture && actual.Parent == expected.Parent && actual.IsLit == expected.IsLit && actual.Motion == expected.Motion &&
+				actual.Mass == expected.Mass && actual.Scale == expected.Scale && actual.RotationRate == expected.RotationRate && actual.AxialTilt == expected.AxialTilt &&
+				actual.OrbitalDistance == expected.OrbitalDistance && actual.RevolutionRate == expected.RevolutionRate && memcmp(&actual.Orbit, &expected.Orbit, sizeof(OrbitalElements)) == 0);
+			mismatchCount += (matches ? 0 : 1);
+		}
+
+		BenchmarkHelper::ReportValue("  round-trip mismatches", mismatchCount + static_cast<double>(catalog.size() - bodies.size()), "bodies");
+
+		_wremove(CatalogFilename.c_str());
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class SceneBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		SceneBenchmark() = delete;
+		SceneBenchmark(const SceneBenchmark&) = delete;
+		SceneBenchmark& operator=(const SceneBenchmark&) = delete;
+		SceneBenchmark(SceneBenchmark&&) = delete;
+		SceneBenchmark& operator=(SceneBenchmark&&) = delete;
+		~SceneBenchmark() = default;
+	};
+}
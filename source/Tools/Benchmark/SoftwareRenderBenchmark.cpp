@@ -0,0 +1,181 @@
+#include "pch.h"
+#include "SoftwareBodyRenderer.h"
+#include "SoftwareTexture.h"
+#include "CelestialBodyStore.h"
+#include "BodyLodSelector.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace SolarSystem;
+using namespace Rendering;
+
+namespace Benchmark
+{
+	namespace
+	{
+		// The slices and stacks of SphereLod0.bin to SphereLod3.bin, built the way the model pipeline builds them
+		const uint32_t SphereLevels[BodyLodSelector::LodCount][2] = { { 48, 24 }, { 24, 12 }, { 12, 8 }, { 8, 6 } };
+		const uint32_t ViewportWidth = 1280;
+		const uint32_t ViewportHeight = 720;
+		const uint32_t TextureCount = 8;
+		const uint32_t Iterations = 20;
+		const string ImageFilename = "SoftwareRender.tga";
+
+		SoftwareMesh CreateSphere(uint32_t slices, uint32_t stacks)
+		{
+			SoftwareMesh mesh;
+			for (uint32_t stack = 0; stack <= stacks; ++stack)
+			{
+				const float v = static_cast<float>(stack) / stacks;
+				float sinTheta;
+				float cosTheta;
+				XMScalarSinCos(&sinTheta, &cosTheta, XM_PI * v);
+
+				for (uint32_t slice = 0; slice <= slices; ++slice)
+				{
+					const float u = static_cast<float>(slice) / slices;
+					float sinPhi;
+					float cosPhi;
+					XMScalarSinCos(&sinPhi, &cosPhi, XM_2PI * u);
+
+					const XMFLOAT3 normal(sinTheta * cosPhi, cosTheta, -sinTheta * sinPhi);
+					mesh.Vertices.push_back(VertexPositionTextureNormal(XMFLOAT4(normal.x * SphereMesh::Radius, normal.y * SphereMesh::Radius, normal.z * SphereMesh::Radius, 1.0f), XMFLOAT2(u, v), normal));
+				}
+			}
+
+			const uint32_t columnCount = slices + 1;
+			for (uint32_t stack = 0; stack < stacks; ++stack)
+			{
+				for (uint32_t slice = 0; slice < slices; ++slice)
+				{
+					const uint32_t topLeft = stack * columnCount + slice;
+					const uint32_t bottomLeft = topLeft + columnCount;
+					if (stack > 0)
+					{
+						mesh.Indices.insert(mesh.Indices.end(), { topLeft, topLeft + 1, bottomLeft });
+					}
+
+					if (stack < stacks - 1)
+					{
+						mesh.Indices.insert(mesh.Indices.end(), { topLeft + 1, bottomLeft + 1, bottomLeft });
+					}
+				}
+			}
+
+			return mesh;
+		}
+
+		// Latitude bands in one hue per texture, enough for the lighting and the texture mapping to show in the image
+		SoftwareTexture CreateBandedTexture(uint32_t seed)
+		{
+			const uint32_t width = 64;
+			const uint32_t height = 32;
+			const XMVECTOR hue = XMVectorSet(0.4f + 0.6f * ((seed * 37) % 8) / 7.0f, 0.4f + 0.6f * ((seed * 11) % 8) / 7.0f, 0.4f + 0.6f * ((seed * 5) % 8) / 7.0f, 1.0f);
+
+			vector<uint32_t> texels(width * height);
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				const float band = 0.6f + 0.4f * sinf(y * 0.8f + seed);
+				for (uint32_t x = 0; x < width; ++x)
+				{
+					const float checker = ((x / 8 + y / 8) % 2 == 0 ? 1.0f : 0.85f);
+					texels[y * width + x] = SoftwareTexture::PackColor(XMVectorSetW(XMVectorScale(hue, band * checker), 1.0f));
+				}
+			}
+
+			return SoftwareTexture(width, height, move(texels));
+		}
+
+		void SaveImage(const string& filename, const SoftwareRasterizer& rasterizer)
+		{
+			// Uncompressed 32-bit TGA, top row first
+			const uint8_t header[18] = { 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+				static_cast<uint8_t>(rasterizer.Width() & 0xFF), static_cast<uint8_t>(rasterizer.Width() >> 8),
+				static_cast<uint8_t>(rasterizer.Height() & 0xFF), static_cast<uint8_t>(rasterizer.Height() >> 8), 32, 0x28 };
+
+			ofstream file(filename.c_str(), ios::binary);
+			file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+			vector<uint8_t> row(rasterizer.Width() * 4);
+			for (uint32_t y = 0; y < rasterizer.Height(); ++y)
+			{
+				const uint32_t* colors = rasterizer.ColorBuffer() + static_cast<size_t>(y) * rasterizer.RowPitch();
+				for (uint32_t x = 0; x < rasterizer.Width(); ++x)
+				{
+					row[x * 4] = static_cast<uint8_t>(colors[x] >> 16);
+					row[x * 4 + 1] = static_cast<uint8_t>(colors[x] >> 8);
+					row[x * 4 + 2] = static_cast<uint8_t>(colors[x]);
+					row[x * 4 + 3] = static_cast<uint8_t>(colors[x] >> 24);
+				}
+
+				file.write(reinterpret_cast<const char*>(row.data()), row.size());
+			}
+		}
+	}
+
+	void SoftwareRenderBenchmark::Run(uint32_t bodyCount)
+	{
+		// The field of bodies the culling and level-of-detail benchmarks use, around a Sun that lights them
+		mt19937 generator(12345);
+		uniform_real_distribution<float> rateDistribution(-1.0f, 1.0f);
+		uniform_real_distribution<float> tiltDistribution(0.0f, XM_PI);
+		uniform_real_distribution<float> scaleDistribution(0.01f, 20.0f);
+		uniform_real_distribution<float> orbitDistribution(5.0f, 20000.0f);
+
+		CelestialBodyStore store;
+		store.Reserve(bodyCount + 1);
+		store.Add(0.1f, 0.0f, 0.0f, 10.0f, 0.0f, CelestialBodyStore::NoParent, false);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			store.Add(rateDistribution(generator), tiltDistribution(generator), orbitDistribution(generator), scaleDistribution(generator), rateDistribution(generator), CelestialBodyStore::NoParent, true);
+		}
+
+		store.Update(1.0f / 60.0f);
+		store.Update(1.0f / 60.0f);
+
+		vector<SoftwareTexture> textures;
+		for (uint32_t texture = 0; texture < TextureCount; ++texture)
+		{
+			textures.push_back(CreateBandedTexture(texture));
+		}
+
+		vector<const SoftwareTexture*> bodyTextures(store.Size());
+		for (uint32_t body = 0; body < store.Size(); ++body)
+		{
+			bodyTextures[body] = &textures[body % TextureCount];
+		}
+
+		vector<SoftwareMesh> sphereLods;
+		for (const auto& level : SphereLevels)
+		{
+			sphereLods.push_back(CreateSphere(level[0], level[1]));
+		}
+
+		JobSystem jobSystem;
+		SoftwareBodyRenderer renderer(jobSystem, ViewportWidth, ViewportHeight);
+		renderer.SetSphereLods(move(sphereLods));
+
+		// The default camera, looking in at the Sun from the edge of the inner system
+		const XMVECTOR cameraPosition = XMVectorSet(0.0f, 2.5f, 500.0f, 1.0f);
+		const XMMATRIX viewMatrix = XMMatrixLookAtLH(cameraPosition, XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		const XMMATRIX projectionMatrix = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<float>(ViewportWidth) / ViewportHeight, 0.01f, 100000.0f);
+
+		cout << "Software render: " << store.Size() << " bodies at " << ViewportWidth << "x" << ViewportHeight << ", " << jobSystem.ThreadCount() << " threads, " << Iterations << " iterations" << endl;
+
+		const double seconds = BenchmarkHelper::MeasureSeconds(Iterations, [&]() { renderer.Render(store, bodyTextures, viewMatrix, projectionMatrix, cameraPosition, 0.5f); });
+		const SoftwareRasterizerStats& stats = renderer.Rasterizer().Stats();
+		BenchmarkHelper::ReportThroughput("Render", 1.0 / seconds, "frames");
+		BenchmarkHelper::ReportValue("  frame time", seconds * 1000.0, "ms");
+		BenchmarkHelper::ReportValue("  bodies drawn", renderer.VisibleCount(), "");
+		BenchmarkHelper::ReportValue("  impostors", renderer.BodiesAtLod(BodyLodSelector::ImpostorLod), "");
+		BenchmarkHelper::ReportValue("  triangles", stats.Triangles, "");
+		BenchmarkHelper::ReportValue("  triangles rasterized", stats.TrianglesBinned, "");
+		BenchmarkHelper::ReportValue("  triangles clipped", stats.TrianglesClipped, "");
+		BenchmarkHelper::ReportValue("  pixels shaded", static_cast<double>(stats.PixelsShaded), "");
+		BenchmarkHelper::ReportThroughput("  triangle rate", stats.Triangles / seconds, "triangles");
+
+		SaveImage(ImageFilename, renderer.Rasterizer());
+		cout << "Last frame written to " << ImageFilename << endl;
+	}
+}
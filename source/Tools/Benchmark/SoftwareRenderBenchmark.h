@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmark
+{
+	class SoftwareRenderBenchmark final
+	{
+	public:
+		static void Run(std::uint32_t bodyCount);
+
+		SoftwareRenderBenchmark() = delete;
+		SoftwareRenderBenchmark(const SoftwareRenderBenchmark&) = delete;
+		SoftwareRenderBenchmark& operator=(const SoftwareRenderBenchmark&) = delete;
+		SoftwareRenderBenchmark(SoftwareRenderBenchmark&&) = delete;
+		SoftwareRenderBenchmark& operator=(SoftwareRenderBenchmark&&) = delete;
+		~SoftwareRenderBenchmark() = default;
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+// Windows
+#include <SDKDDKVer.h>
+#define NOMINMAX
+#include <windows.h>
+#include <stdio.h>
+#include <wrl.h>
+
+// DirectX
+#include <DirectXMath.h>
+
+// Standard
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <algorithm>
+
+#if defined(DEBUG) || defined(_DEBUG)
+#define _CRTDBG_MAP_ALLOC
+#include <stdlib.h>
+#include <crtdbg.h>
+#endif
+
+// Library
+#include "AlignedAllocator.h"
+#include "GameException.h"
+#include "GameClock.h"
+#include "GameTime.h"
+#include "JobSystem.h"
+#include "MatrixHelper.h"
+#include "MemoryMappedFile.h"
+#include "SphereMesh.h"
+#include "StreamHelper.h"
+#include "Utility.h"
+
+// Local
+#include "BenchmarkHelper.h"
+#include "BodyTransformBenchmark.h"
+#include "BodyUpdateBenchmark.h"
+#include "KeplerOrbitBenchmark.h"
+#include "NBodyBenchmark.h"
+#include "FrameTimingBenchmark.h"
+#include "EphemerisBenchmark.h"
+#include "SceneBenchmark.h"
+#include "ParticleFieldBenchmark.h"
+#include "BodyInstanceBenchmark.h"
+#include "FrustumCullingBenchmark.h"
+#include "BodyLodBenchmark.h"
+#include "ConstantRingBenchmark.h"
+#include "CommandRecordingBenchmark.h"
+#include "SoftwareRenderBenchmark.h"
+#include "ModelLoadBenchmark.h"
+#include "CompactVertexBenchmark.h"
@@ -0,0 +1,57 @@
+#include "pch.h"
+#include "CelestialBodyStore.h"
+#include "EphemerisTable.h"
+#include "SolarSystemScene.h"
+
+using namespace std;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace
+{
+	// The fastest moon goes round in under two seconds of simulation time, so it needs several samples per second
+	const double DefaultYears = 10.0;
+	const uint32_t DefaultSamplesPerYear = 8192;
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(DEBUG) | defined(_DEBUG)
+	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+	try
+	{
+		if (argc < 2)
+		{
+			throw exception("Usage: EphemerisBuilder <output> [years] [samples per year]");
+		}
+
+		const string outputFilename = argv[1];
+		const double years = (argc > 2 ? stod(argv[2]) : DefaultYears);
+		const uint32_t samplesPerYear = (argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : DefaultSamplesPerYear);
+		if (years <= 0.0 || samplesPerYear == 0)
+		{
+			throw exception("The table must cover a positive number of years with at least one sample per year.");
+		}
+
+		CelestialBodyStore store;
+		SolarSystemScene::Populate(store);
+
+		const double yearLength = SolarSystemScene::YearLength();
+		const uint32_t sampleCount = static_cast<uint32_t>(ceil(years * samplesPerYear)) + 1;
+
+		JobSystem jobSystem;
+		EphemerisTable table;
+		table.Build(store, 0.0, yearLength / samplesPerYear, sampleCount, jobSystem);
+		table.Save(Utility::ToWideString(outputFilename));
+
+		cout << "Wrote " << outputFilename << ": " << table.BodyCount() << " bodies, " << table.SampleCount() << " samples over " << years << " years, " << table.SizeInBytes() / (1024.0 * 1024.0) << " MB" << endl;
+	}
+	catch (exception ex)
+	{
+		cout << ex.what() << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Windows
+#include <SDKDDKVer.h>
+#define NOMINMAX
+#include <windows.h>
+#include <stdio.h>
+#include <wrl.h>
+
+// DirectX
+#include <DirectXMath.h>
+
+// Standard
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#if defined(DEBUG) || defined(_DEBUG)
+#define _CRTDBG_MAP_ALLOC
+#include <stdlib.h>
+#include <crtdbg.h>
+#endif
+
+// Library
+#include "AlignedAllocator.h"
+#include "GameException.h"
+#include "JobSystem.h"
+#include "MatrixHelper.h"
+#include "MemoryMappedFile.h"
+#include "SphereMesh.h"
+#include "Utility.h"
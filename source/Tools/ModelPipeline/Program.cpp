@@ -14,7 +14,44 @@ int main(int argc, char* argv[])
 	{
 		if (argc < 2)
 		{
-			throw exception("Usage: ...TODO");
+			throw exception("Usage: ModelPipeline <input file> [-format <vertex format>]... | ModelPipeline -spheres [output directory]");
+		}
+
+		string command = argv[1];
+		if (command == "-spheres")
+		{
+			// Writes SphereLod0.bin (finest) onwards, the level-of-detail set the solar system renderer loads, baked into
+			// the layout its body shaders read
+			if (argc > 2)
+			{
+				SetCurrentDirectory(Library::Utility::ToWideString(argv[2]).c_str());
+			}
+
+			for (uint32_t level = 0; level < SphereProcessor::LevelCount; ++level)
+			{
+				const SphereLevel& sphereLevel = SphereProcessor::Levels[level];
+				Model model = SphereProcessor::CreateSphere(sphereLevel.Slices, sphereLevel.Stacks);
+				for (const auto& mesh : model.Meshes())
+				{
+					mesh->BakeInterleavedVertices(VertexFormat::PositionTextureNormalCompact);
+				}
+
+				model.Save("SphereLod" + to_string(level) + ".bin");
+			}
+
+			return 0;
+		}
+
+		// Each -format names a vertex layout from VertexDeclarations.h to bake into every mesh
+		vector<VertexFormat> formats;
+		for (int i = 2; i < argc; ++i)
+		{
+			if (string(argv[i]) != "-format" || i + 1 >= argc)
+			{
+				throw exception("Expected -format <vertex format>.");
+			}
+
+			formats.push_back(VertexFormatHelper::Parse(argv[++i]));
 		}
 
 		string inputFile = argv[1];
@@ -28,6 +65,13 @@ int main(int argc, char* argv[])
 
 		SetCurrentDirectory(Library::Utility::ToWideString(inputDirectory).c_str());		
 		Model model = ModelProcessor::LoadModel(inputFilename, true);
+		for (const auto& mesh : model.Meshes())
+		{
+			for (VertexFormat format : formats)
+			{
+				mesh->BakeInterleavedVertices(format);
+			}
+		}
 		
 		string outputFilename = inputFilename + ".bin";		
 		model.Save(outputFilename);
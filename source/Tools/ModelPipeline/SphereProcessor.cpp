@@ -0,0 +1,102 @@
+#include "pch.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+namespace ModelPipeline
+{
+	const uint32_t SphereProcessor::LevelCount;
+
+	// Finest first; the renderer loads these as SphereLod0.bin onwards and picks between them by projected size
+	const SphereLevel SphereProcessor::Levels[] =
+	{
+		{ 48, 24 },
+		{ 24, 12 },
+		{ 12, 8 },
+		{ 8, 6 }
+	};
+
+	Library::Model SphereProcessor::CreateSphere(uint32_t slices, uint32_t stacks, float radius)
+	{
+		if (slices < 3 || stacks < 2)
+		{
+			throw exception("A sphere needs at least 3 slices and 2 stacks.");
+		}
+
+		Library::Model model;
+		ModelData& modelData = model.Data();
+
+		ModelMaterialData materialData;
+		materialData.Name = "DefaultMaterial";
+		modelData.Materials.push_back(make_shared<ModelMaterial>(model, move(materialData)));
+
+		MeshData meshData;
+		meshData.Material = modelData.Materials.front();
+
+		// Same layout as Sphere.obj: v runs from the north pole (0) to the south pole (1), the seam column is duplicated so u can
+		// reach 1, and each pole has its own vertex per slice so the texture does not pinch to a single u
+		const uint32_t columnCount = slices + 1;
+		const uint32_t vertexCount = columnCount * (stacks + 1);
+		meshData.Vertices.reserve(vertexCount);
+		meshData.Normals.reserve(vertexCount);
+
+		vector<XMFLOAT3>* textureCoordinates = new vector<XMFLOAT3>();
+		textureCoordinates->reserve(vertexCount);
+		meshData.TextureCoordinates.push_back(textureCoordinates);
+
+		for (uint32_t stack = 0; stack <= stacks; ++stack)
+		{
+			const float v = static_cast<float>(stack) / stacks;
+			float sinTheta;
+			float cosTheta;
+			XMScalarSinCos(&sinTheta, &cosTheta, XM_PI * v);
+
+			for (uint32_t slice = 0; slice <= slices; ++slice)
+			{
+				const float u = static_cast<float>(slice) / slices;
+				float sinPhi;
+				float cosPhi;
+				XMScalarSinCos(&sinPhi, &cosPhi, XM_2PI * u);
+
+				const XMFLOAT3 normal(sinTheta * cosPhi, cosTheta, -sinTheta * sinPhi);
+				meshData.Vertices.push_back(XMFLOAT3(normal.x * radius, normal.y * radius, normal.z * radius));
+				meshData.Normals.push_back(normal);
+				textureCoordinates->push_back(XMFLOAT3(u, v, 0.0f));
+			}
+		}
+
+		// The cap rows only get the one triangle per slice that is not degenerate; winding matches the flipped order the
+		// model pipeline gives imported meshes
+		meshData.FaceCount = 2 * slices * (stacks - 1);
+		meshData.Indices.reserve(meshData.FaceCount * 3);
+		for (uint32_t stack = 0; stack < stacks; ++stack)
+		{
+			for (uint32_t slice = 0; slice < slices; ++slice)
+			{
+				const uint32_t topLeft = stack * columnCount + slice;
+				const uint32_t topRight = topLeft + 1;
+				const uint32_t bottomLeft = topLeft + columnCount;
+				const uint32_t bottomRight = bottomLeft + 1;
+
+				if (stack > 0)
+				{
+					meshData.Indices.push_back(topLeft);
+					meshData.Indices.push_back(topRight);
+					meshData.Indices.push_back(bottomLeft);
+				}
+
+				if (stack < stacks - 1)
+				{
+					meshData.Indices.push_back(topRight);
+					meshData.Indices.push_back(bottomRight);
+					meshData.Indices.push_back(bottomLeft);
+				}
+			}
+		}
+
+		modelData.Meshes.push_back(make_shared<Mesh>(model, move(meshData)));
+
+		return model;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include "Model.h"
+
+namespace ModelPipeline
+{
+	struct SphereLevel
+	{
+		std::uint32_t Slices;
+		std::uint32_t Stacks;
+	};
+
+	class SphereProcessor
+	{
+	public:
+		SphereProcessor() = delete;
+
+		static const std::uint32_t LevelCount = 4;
+		static const SphereLevel Levels[LevelCount];
+		static Library::Model CreateSphere(std::uint32_t slices, std::uint32_t stacks, float radius = Library::SphereMesh::Radius);
+	};
+}
\ No newline at end of file
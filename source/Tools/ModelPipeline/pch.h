@@ -32,6 +32,7 @@
 #include "..\Library.Shared\Model.h"
 #include "..\Library.Shared\Mesh.h"
 #include "..\Library.Shared\ModelMaterial.h"
+#include "..\Library.Shared\SphereMesh.h"
 
 // Library.Desktop
 #include "UtilityWin32.h"
@@ -39,4 +40,5 @@
  // Local
 #include "ModelProcessor.h"
 #include "MeshProcessor.h"
-#include "ModelMaterialProcessor.h"
\ No newline at end of file
+#include "ModelMaterialProcessor.h"
+#include "SphereProcessor.h"
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "SolarSystemScene.h"
+#include "SolarSystemSimulation.h"
+#include "SimulationRecording.h"
+#include "SimulationRecorder.h"
+#include "SimulationPlayer.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+using namespace SimulationRunner;
+using namespace SolarSystem;
+
+namespace
+{
+	const uint32_t DefaultFrameCount = 100000;
+	const uint32_t DefaultUpdateRate = 120;
+	const char* Usage = "Usage: SimulationRunner [frames] [updates per second] [nbody] [scene <file>] [record <file> | replay <file>]";
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(DEBUG) | defined(_DEBUG)
+	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+	try
+	{
+		if (argc > 1 && string(argv[1]) == "-?")
+		{
+			throw exception(Usage);
+		}
+
+		uint32_t frameCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : DefaultFrameCount);
+		const uint32_t updateRate = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : DefaultUpdateRate);
+		if (updateRate == 0)
+		{
+			throw exception("The update rate must be at least one update per second.");
+		}
+
+		bool nbodyEnabled = false;
+		string sceneFilename = Utility::ToString(SolarSystemScene::DefaultSceneFilename);
+		string recordFilename;
+		string replayFilename;
+		for (int i = 3; i < argc; ++i)
+		{
+			const string argument = argv[i];
+			if (argument == "nbody")
+			{
+				nbodyEnabled = true;
+			}
+			else if (argument == "scene" && i + 1 < argc)
+			{
+				sceneFilename = argv[++i];
+			}
+			else if (argument == "record" && i + 1 < argc)
+			{
+				recordFilename = argv[++i];
+			}
+			else if (argument == "replay" && i + 1 < argc)
+			{
+				replayFilename = argv[++i];
+			}
+			else
+			{
+				throw exception(Usage);
+			}
+		}
+
+		SimulationGame game(Utility::ToWideString(sceneFilename));
+		game.Initialize();
+
+		SolarSystemSimulation& simulation = game.Simulation();
+		simulation.SetNBodyEnabled(nbodyEnabled);
+		if (simulation.NBodyEnabled() != nbodyEnabled)
+		{
+			throw exception("The scene has massless bodies or bodies on top of their parents, so N-body gravity cannot start.");
+		}
+
+		const nanoseconds frameTime(duration_cast<nanoseconds>(seconds(1)) / updateRate);
+		const uint32_t bodyCount = simulation.BodyStore().Size();
+
+		double wallSeconds;
+		if (!replayFilename.empty())
+		{
+			// The recording carries its own starting state and frame times, so the frame count and rate are ignored
+			SimulationRecording recording;
+			recording.Load(Utility::ToWideString(replayFilename));
+			frameCount = recording.FrameCount();
+			cout << "Replaying " << frameCount << " frames of " << bodyCount << " bodies from " << replayFilename << ", " << game.Jobs().ThreadCount() << " threads" << endl;
+
+			const auto start = high_resolution_clock::now();
+			game.Player().Start(recording);
+			while (game.Player().IsPlaying())
+			{
+				game.Step(frameTime);
+			}
+			wallSeconds = duration<double>(high_resolution_clock::now() - start).count();
+		}
+		else
+		{
+			cout << "Simulating " << frameCount << " frames of " << bodyCount << " bodies at " << updateRate << " updates per second" << (nbodyEnabled ? " with N-body gravity" : "") << ", " << game.Jobs().ThreadCount() << " threads" << endl;
+
+			if (!recordFilename.empty())
+			{
+				game.Recorder().Start();
+			}
+
+			const auto start = high_resolution_clock::now();
+			game.Step(frameTime, frameCount);
+			wallSeconds = duration<double>(high_resolution_clock::now() - start).count();
+
+			if (!recordFilename.empty())
+			{
+				game.Recorder().Stop();
+				game.Recorder().Recording().Save(Utility::ToWideString(recordFilename));
+				cout << "Recorded " << recordFilename << ": " << game.Recorder().Recording().SizeInBytes() << " bytes" << endl;
+			}
+		}
+
+		const double simulatedSeconds = simulation.SimulationTime();
+		cout << fixed << setprecision(3);
+		cout << "Wall time:        " << wallSeconds << " s" << endl;
+		cout << "Frames/s:         " << frameCount / wallSeconds << endl;
+		cout << "Bodies/s:         " << static_cast<double>(frameCount) * bodyCount / wallSeconds << endl;
+		cout << "Simulated:        " << simulatedSeconds / simulation.YearLength() << " years (" << simulatedSeconds / wallSeconds << "x real time)" << endl;
+
+		XMFLOAT3 referencePosition;
+		MatrixHelper::GetTranslation(simulation.BodyStore().WorldMatrix(simulation.ReferenceBody()), referencePosition);
+		cout << "Reference body:   " << simulation.Bodies()[simulation.ReferenceBody()].Name << " at " << referencePosition.x << ", " << referencePosition.y << ", " << referencePosition.z << endl;
+		cout << "Checksum:         " << hex << setw(16) << setfill('0') << simulation.Checksum() << dec << endl;
+
+		if (!replayFilename.empty())
+		{
+			cout << "Replay:           " << (game.Player().Matched() ? "matches the recording bit for bit" : "DIVERGED from the recording") << endl;
+		}
+
+		game.Shutdown();
+	}
+	catch (exception ex)
+	{
+		cout << ex.what() << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+#include "pch.h"
+#include "SolarSystemSimulation.h"
+#include "SimulationRecorder.h"
+#include "SimulationPlayer.h"
+
+using namespace std;
+using namespace Library;
+using namespace SolarSystem;
+
+namespace SimulationRunner
+{
+	RTTI_DEFINITIONS(SimulationGame)
+
+	SimulationGame::SimulationGame(const wstring& sceneFilename) :
+		mSceneFilename(sceneFilename)
+	{
+	}
+
+	void SimulationGame::Initialize()
+	{
+		mSimulation = make_shared<SolarSystemSimulation>(*this, mSceneFilename);
+
+		// Both sample or drive each update just before the simulation runs it
+		mRecorder = make_shared<SimulationRecorder>(*this, mSimulation);
+		mComponents.push_back(mRecorder);
+
+		mPlayer = make_shared<SimulationPlayer>(*this, mSimulation);
+		mComponents.push_back(mPlayer);
+
+		mComponents.push_back(mSimulation);
+		mServices.AddService(SolarSystemSimulation::TypeIdClass(), mSimulation.get());
+
+		HeadlessGame::Initialize();
+	}
+
+	SolarSystemSimulation& SimulationGame::Simulation()
+	{
+		assert(mSimulation != nullptr);
+		return *mSimulation;
+	}
+
+	SimulationRecorder& SimulationGame::Recorder()
+	{
+		assert(mRecorder != nullptr);
+		return *mRecorder;
+	}
+
+	SimulationPlayer& SimulationGame::Player()
+	{
+		assert(mPlayer != nullptr);
+		return *mPlayer;
+	}
+}
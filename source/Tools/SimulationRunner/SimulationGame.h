@@ -0,0 +1,36 @@
+#pragma once
+
+#include "HeadlessGame.h"
+#include "SolarSystemScene.h"
+#include <memory>
+#include <string>
+
+namespace SolarSystem
+{
+	class SolarSystemSimulation;
+	class SimulationRecorder;
+	class SimulationPlayer;
+}
+
+namespace SimulationRunner
+{
+	class SimulationGame final : public Library::HeadlessGame
+	{
+		RTTI_DECLARATIONS(SimulationGame, Library::HeadlessGame)
+
+	public:
+		explicit SimulationGame(const std::wstring& sceneFilename = SolarSystem::SolarSystemScene::DefaultSceneFilename);
+
+		virtual void Initialize() override;
+
+		SolarSystem::SolarSystemSimulation& Simulation();
+		SolarSystem::SimulationRecorder& Recorder();
+		SolarSystem::SimulationPlayer& Player();
+
+	private:
+		std::wstring mSceneFilename;
+		std::shared_ptr<SolarSystem::SolarSystemSimulation> mSimulation;
+		std::shared_ptr<SolarSystem::SimulationRecorder> mRecorder;
+		std::shared_ptr<SolarSystem::SimulationPlayer> mPlayer;
+	};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Windows
+#include <SDKDDKVer.h>
+#define NOMINMAX
+#include <windows.h>
+#include <stdio.h>
+#include <wrl.h>
+
+// DirectX
+#include <DirectXMath.h>
+
+// Standard
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#if defined(DEBUG) || defined(_DEBUG)
+#define _CRTDBG_MAP_ALLOC
+#include <stdlib.h>
+#include <crtdbg.h>
+#endif
+
+// Library
+#include "RTTI.h"
+#include "AlignedAllocator.h"
+#include "GameException.h"
+#include "GameClock.h"
+#include "GameTime.h"
+#include "JobSystem.h"
+#include "Game.h"
+#include "HeadlessGame.h"
+#include "GameComponent.h"
+#include "Camera.h"
+#include "VectorHelper.h"
+#include "MatrixHelper.h"
+#include "StreamHelper.h"
+#include "MemoryMappedFile.h"
+#include "SphereMesh.h"
+#include "Utility.h"
+
+// Local
+#include "SimulationGame.h"